@@ -0,0 +1,257 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+/*************************************************
+ * Benchmark Timing Helpers (desktop)
+ *
+ * Shared by the programs in bench/. Header-only, so each benchmark
+ * stays a single translation unit plus the library sources.
+ *
+ *   bench_cycles()  time-stamp counter (rdtsc on x86, cntvct_el0 on
+ *                   AArch64), falling back to nanoseconds elsewhere.
+ *                   rdtsc ticks at the nominal frequency, not the
+ *                   current core clock; use --perf for core cycles.
+ *   bench_ns()      CLOCK_MONOTONIC in nanoseconds
+ *   bench_perf_*    optional hardware counters via perf_event_open
+ *                   (cycles, instructions, cache misses), Linux only.
+ *                   Usually needs perf_event_paranoid <= 2.
+ *   bench_stats_*   median / p90 / p99 over per-call samples
+ *   bench_mann_whitney  one-sided rank test between two sample sets
+ *                   (link with -lm)
+ *************************************************/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static inline uint64_t bench_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t bench_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  uint64_t t;
+  __asm__ __volatile__("isb; mrs %0, cntvct_el0" : "=r"(t));
+  return t;
+#else
+  return bench_ns();
+#endif
+}
+
+// Name of the unit bench_cycles() counts in, for report headers
+static inline const char *bench_cycles_unit(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  return "tsc";
+#elif defined(__aarch64__)
+  return "cntvct";
+#else
+  return "ns";
+#endif
+}
+
+/*************************************************
+ * Per-call samples and percentiles
+ *************************************************/
+
+typedef struct {
+  uint64_t *v;
+  size_t n;
+} bench_samples;
+
+typedef struct {
+  uint64_t median;
+  uint64_t p90;
+  uint64_t p99;
+  uint64_t min;
+  double mean;
+} bench_stats;
+
+static inline int bench_cmp_u64(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+  return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of a sorted array, p in [0, 100]
+static inline uint64_t bench_percentile(const uint64_t *sorted, size_t n,
+                                        double p) {
+  size_t rank = (size_t)(p / 100.0 * (double)n + 0.5);
+  if (rank == 0)
+    rank = 1;
+  if (rank > n)
+    rank = n;
+  return sorted[rank - 1];
+}
+
+// Sorts the samples in place
+static inline void bench_stats_compute(bench_stats *st, bench_samples *s) {
+  double sum = 0;
+  size_t i;
+
+  memset(st, 0, sizeof(*st));
+  if (s->n == 0)
+    return;
+
+  qsort(s->v, s->n, sizeof(uint64_t), bench_cmp_u64);
+  for (i = 0; i < s->n; i++)
+    sum += (double)s->v[i];
+
+  st->min = s->v[0];
+  st->median = bench_percentile(s->v, s->n, 50);
+  st->p90 = bench_percentile(s->v, s->n, 90);
+  st->p99 = bench_percentile(s->v, s->n, 99);
+  st->mean = sum / (double)s->n;
+}
+
+// Picks n evenly spaced order statistics of a sorted array
+static inline void bench_downsample(uint64_t *out, size_t n,
+                                    const uint64_t *sorted, size_t len) {
+  size_t i;
+  for (i = 0; i < n; i++)
+    out[i] = sorted[(n > 1) ? i * (len - 1) / (n - 1) : len / 2];
+}
+
+/*************************************************
+ * Mann-Whitney U test
+ *
+ * One-sided p-value for "b tends to be larger than a", from the
+ * normal approximation with tie and continuity correction. Both
+ * arrays must be sorted. Unlike a t-test it is not thrown off by the
+ * long right tail of latency samples (interrupts, migrations).
+ *************************************************/
+static inline double bench_mann_whitney(const uint64_t *a, size_t na,
+                                        const uint64_t *b, size_t nb) {
+  double rank_b = 0, ties = 0, n = (double)(na + nb);
+  double u, mean, var, z;
+  size_t i = 0, j = 0, ca, cb, t;
+  uint64_t v;
+
+  if (na == 0 || nb == 0)
+    return 1.0;
+
+  // Walk both arrays in order, one group of equal values at a time
+  while (i < na || j < nb) {
+    v = (j >= nb || (i < na && a[i] <= b[j])) ? a[i] : b[j];
+    for (ca = 0; i < na && a[i] == v; i++)
+      ca++;
+    for (cb = 0; j < nb && b[j] == v; j++)
+      cb++;
+    t = ca + cb;
+    // Group occupies ranks (i + j - t + 1) .. (i + j); use the mean
+    rank_b += (double)cb * ((double)(i + j - t) + ((double)t + 1) / 2);
+    ties += (double)t * (double)t * (double)t - (double)t;
+  }
+
+  u = rank_b - (double)nb * ((double)nb + 1) / 2;
+  mean = (double)na * (double)nb / 2;
+  var = (double)na * (double)nb / 12 * ((n + 1) - ties / (n * (n - 1)));
+  if (var <= 0)
+    return 1.0;
+  z = (u - mean - 0.5) / sqrt(var);
+  return 0.5 * erfc(z / sqrt(2.0));
+}
+
+/*************************************************
+ * Hardware counters (perf_event_open)
+ *************************************************/
+
+#define BENCH_PERF_CYCLES 0
+#define BENCH_PERF_INSTRUCTIONS 1
+#define BENCH_PERF_CACHE_MISSES 2
+#define BENCH_PERF_COUNTERS 3
+
+typedef struct {
+  int fd[BENCH_PERF_COUNTERS];
+  uint64_t count[BENCH_PERF_COUNTERS];
+} bench_perf;
+
+// Returns 0 if at least one counter could be opened, -1 otherwise
+static inline int bench_perf_open(bench_perf *p) {
+  int i, ok = 0;
+
+  memset(p, 0, sizeof(*p));
+  for (i = 0; i < BENCH_PERF_COUNTERS; i++)
+    p->fd[i] = -1;
+
+#if defined(__linux__)
+  {
+    static const uint64_t config[BENCH_PERF_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES};
+    struct perf_event_attr attr;
+
+    for (i = 0; i < BENCH_PERF_COUNTERS; i++) {
+      memset(&attr, 0, sizeof(attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof(attr);
+      attr.config = config[i];
+      attr.disabled = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      p->fd[i] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+      if (p->fd[i] >= 0)
+        ok = 1;
+    }
+  }
+#endif
+  return ok ? 0 : -1;
+}
+
+static inline void bench_perf_start(bench_perf *p) {
+#if defined(__linux__)
+  int i;
+  for (i = 0; i < BENCH_PERF_COUNTERS; i++) {
+    if (p->fd[i] < 0)
+      continue;
+    ioctl(p->fd[i], PERF_EVENT_IOC_RESET, 0);
+    ioctl(p->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+  }
+#else
+  (void)p;
+#endif
+}
+
+// Stores the counts since bench_perf_start in p->count (0 if unavailable)
+static inline void bench_perf_stop(bench_perf *p) {
+  int i;
+  for (i = 0; i < BENCH_PERF_COUNTERS; i++) {
+    p->count[i] = 0;
+#if defined(__linux__)
+    if (p->fd[i] < 0)
+      continue;
+    ioctl(p->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    if (read(p->fd[i], &p->count[i], sizeof(uint64_t)) != sizeof(uint64_t))
+      p->count[i] = 0;
+#endif
+  }
+}
+
+static inline void bench_perf_close(bench_perf *p) {
+  int i;
+  for (i = 0; i < BENCH_PERF_COUNTERS; i++) {
+#if defined(__linux__)
+    if (p->fd[i] >= 0)
+      close(p->fd[i]);
+#endif
+    p->fd[i] = -1;
+  }
+}
+
+#endif /* BENCH_H */
@@ -0,0 +1,97 @@
+/*************************************************
+ * Batch KEM Scaling Benchmark
+ *
+ * Runs crypto_kem_{keypair,enc,dec}_batch with 1..N worker threads
+ * and reports throughput in operations per second.
+ *
+ * Build (from the repository root):
+ *   gcc -O3 -Iinclude bench/bench_batch.c src/kem_batch.c src/kem.c \
+ *       src/indcpa.c src/poly.c src/polyvec.c src/ntt.c src/fips202.c \
+ *       src/randombytes.c src/utils.c -pthread -o build/bench_batch
+ *
+ * Usage: bench_batch [max_threads] [batch_size]
+ *************************************************/
+
+#include "../include/kem.h"
+#include "../include/kem_batch.h"
+#include "../include/params.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static double now_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char **argv) {
+  unsigned int max_threads, t;
+  size_t n;
+  uint8_t *pk, *sk, *ct, *ss, *ss2;
+  double t0, keygen, enc, dec;
+  long ncpu = sysconf(_SC_NPROCESSORS_ONLN);
+
+  max_threads = (argc > 1) ? (unsigned int)atoi(argv[1])
+                           : (ncpu > 0 ? (unsigned int)ncpu : 1);
+  n = (argc > 2) ? (size_t)atol(argv[2]) : 2048;
+  if (max_threads == 0 || n == 0) {
+    fprintf(stderr, "usage: %s [max_threads] [batch_size]\n", argv[0]);
+    return 1;
+  }
+
+  pk = malloc(n * KYBER_PUBLICKEYBYTES);
+  sk = malloc(n * KYBER_SECRETKEYBYTES);
+  ct = malloc(n * KYBER_CIPHERTEXTBYTES);
+  ss = malloc(n * KYBER_SSBYTES);
+  ss2 = malloc(n * KYBER_SSBYTES);
+  if (!pk || !sk || !ct || !ss || !ss2) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  printf("============================================\n");
+  printf("  Kyber Batch Scaling (K=%d, batch=%zu)\n", KYBER_K, n);
+  printf("============================================\n\n");
+  printf("%8s %14s %14s %14s\n", "threads", "keygen/s", "encaps/s",
+         "decaps/s");
+
+  for (t = 1; t <= max_threads; t++) {
+    if (kyber_batch_init(t) != 0) {
+      fprintf(stderr, "failed to start %u threads\n", t);
+      return 1;
+    }
+
+    // Warm-up: fault in buffers and spin up all helpers
+    crypto_kem_keypair_batch(pk, sk, n);
+
+    t0 = now_seconds();
+    crypto_kem_keypair_batch(pk, sk, n);
+    keygen = now_seconds() - t0;
+
+    t0 = now_seconds();
+    crypto_kem_enc_batch(ct, ss, pk, n);
+    enc = now_seconds() - t0;
+
+    t0 = now_seconds();
+    crypto_kem_dec_batch(ss2, ct, sk, n);
+    dec = now_seconds() - t0;
+
+    if (memcmp(ss, ss2, n * KYBER_SSBYTES) != 0) {
+      fprintf(stderr, "shared secrets do NOT match (%u threads)\n", t);
+      return 1;
+    }
+
+    printf("%8u %14.0f %14.0f %14.0f\n", t, n / keygen, n / enc, n / dec);
+    kyber_batch_shutdown();
+  }
+
+  free(pk);
+  free(sk);
+  free(ct);
+  free(ss);
+  free(ss2);
+  return 0;
+}
@@ -0,0 +1,315 @@
+/*************************************************
+ * Constant-Time Check (dudect-style)
+ *
+ * Runs decapsulation and the kernels that touch secret data on two
+ * classes of input, one fixed and one random, interleaved at random,
+ * and applies Welch's t-test to the cycle counts of the two classes.
+ * A constant-time kernel gives |t| around 0 to 2 however many
+ * measurements are taken; |t| above 4.5 means the latency depends on
+ * the input class and is reported as a leak. As in dudect, besides the
+ * raw data the test is repeated on measurements cropped at several
+ * percentiles (taken from a first, discarded batch), which removes
+ * interrupt outliers and exposes leaks that only shift the bulk of
+ * the distribution. The table shows the largest |t| per kernel.
+ *
+ * Classes per kernel:
+ *   crypto_kem_dec, indcpa_dec   valid ciphertext / random ciphertext
+ *   poly_tomsg, poly_ntt, ...    all-zero polynomial / random one
+ *   poly_frommsg, poly_cbd_eta1  all-zero bytes / random bytes
+ *   ct_memcmp                    equal / random buffer
+ *   ct_cmov                      condition 0 / random condition
+ *
+ * Check a new or optimised kernel (say, a SIMD NTT, or poly_tomsg
+ * built for a core without a hardware divider) by adding it to the
+ * table. Leaks are a property of the compiled code: build with the
+ * same compiler and flags as production, and run this next to the
+ * performance gate, e.g.
+ *   bench_kem --check base.txt && bench_ct
+ * Both exit with status 2 when they find a problem.
+ *
+ * Build (from the repository root):
+ *   gcc -O3 -Iinclude bench/bench_ct.c src/kem.c src/indcpa.c \
+ *       src/poly.c src/polyvec.c src/ntt.c src/fips202.c \
+ *       src/randombytes.c src/utils.c -pthread -lm -o build/bench_ct
+ *
+ * Add -DKYBER_K=3 or -DKYBER_K=4 for the other parameter sets.
+ *
+ * Usage: bench_ct [-n measurements] [kernel ...]
+ *************************************************/
+
+#include "../include/indcpa.h"
+#include "../include/kem.h"
+#include "../include/params.h"
+#include "../include/poly.h"
+#include "../include/utils.h"
+#include "bench.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BATCH 1000
+#define NUM_CROPS 5
+#define NUM_TESTS (1 + NUM_CROPS)
+#define T_THRESHOLD 4.5
+
+static const double crop_pct[NUM_CROPS] = {50, 75, 90, 95, 99};
+
+/*************************************************
+ * Input generation. A cheap xorshift stream is enough to pick classes
+ * and fill random inputs; it is not used for any key material.
+ *************************************************/
+static uint64_t prng_state = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t prng(void) {
+  prng_state ^= prng_state >> 12;
+  prng_state ^= prng_state << 25;
+  prng_state ^= prng_state >> 27;
+  return prng_state * 0x2545F4914F6CDD1DULL;
+}
+
+static void prng_bytes(uint8_t *p, size_t n) {
+  size_t i;
+
+  for (i = 0; i < n; i++)
+    p[i] = (uint8_t)(prng() >> 56);
+}
+
+static void prng_poly(poly *a) {
+  unsigned int i;
+
+  for (i = 0; i < KYBER_N; i++)
+    a->coeffs[i] = (int16_t)(prng() % KYBER_Q);
+}
+
+/*************************************************
+ * Kernels. prepare() fills one input of class 0 (fixed) or 1 (random),
+ * run() consumes it; only run() is timed.
+ *************************************************/
+static uint8_t pk[KYBER_PUBLICKEYBYTES];
+static uint8_t sk[KYBER_SECRETKEYBYTES];
+static uint8_t valid_ct[KYBER_CIPHERTEXTBYTES];
+static uint8_t out[KYBER_CIPHERTEXTBYTES];
+static poly work;
+static int sink;
+
+static void prep_ct(uint8_t *in, int cls) {
+  if (cls == 0)
+    memcpy(in, valid_ct, KYBER_CIPHERTEXTBYTES);
+  else
+    prng_bytes(in, KYBER_CIPHERTEXTBYTES);
+}
+
+static void prep_poly(uint8_t *in, int cls) {
+  poly a;
+
+  memset(&a, 0, sizeof(a));
+  if (cls == 1)
+    prng_poly(&a);
+  memcpy(in, &a, sizeof(a));
+}
+
+static void prep_msg(uint8_t *in, int cls) {
+  memset(in, 0, KYBER_SYMBYTES);
+  if (cls == 1)
+    prng_bytes(in, KYBER_SYMBYTES);
+}
+
+static void prep_noise(uint8_t *in, int cls) {
+  memset(in, 0, KYBER_ETA1 * KYBER_N / 4);
+  if (cls == 1)
+    prng_bytes(in, KYBER_ETA1 * KYBER_N / 4);
+}
+
+static void prep_cmov(uint8_t *in, int cls) {
+  in[0] = (cls == 1) ? (uint8_t)(prng() & 1) : 0;
+  prng_bytes(in + 1, KYBER_SYMBYTES);
+}
+
+static void run_kem_dec(const uint8_t *in) { crypto_kem_dec(out, in, sk); }
+static void run_indcpa_dec(const uint8_t *in) { indcpa_dec(out, in, sk); }
+static void run_tomsg(const uint8_t *in) {
+  memcpy(&work, in, sizeof(work));
+  poly_tomsg(out, &work);
+}
+static void run_frommsg(const uint8_t *in) { poly_frommsg(&work, in); }
+static void run_ntt(const uint8_t *in) {
+  memcpy(&work, in, sizeof(work));
+  poly_ntt(&work);
+}
+static void run_invntt(const uint8_t *in) {
+  memcpy(&work, in, sizeof(work));
+  poly_invntt(&work);
+}
+static void run_compress(const uint8_t *in) {
+  memcpy(&work, in, sizeof(work));
+  poly_compress(out, &work, KYBER_DV);
+}
+static void run_cbd(const uint8_t *in) { poly_cbd_eta1(&work, in); }
+static void run_memcmp(const uint8_t *in) {
+  sink += ct_memcmp(in, valid_ct, KYBER_CIPHERTEXTBYTES);
+}
+static void run_cmov(const uint8_t *in) {
+  ct_cmov(out, in + 1, KYBER_SYMBYTES, in[0]);
+}
+
+typedef struct {
+  const char *name;
+  size_t in_bytes;
+  void (*prepare)(uint8_t *in, int cls);
+  void (*run)(const uint8_t *in);
+} kernel;
+
+static const kernel kernels[] = {
+    {"crypto_kem_dec", KYBER_CIPHERTEXTBYTES, prep_ct, run_kem_dec},
+    {"indcpa_dec", KYBER_CIPHERTEXTBYTES, prep_ct, run_indcpa_dec},
+    {"poly_tomsg", sizeof(poly), prep_poly, run_tomsg},
+    {"poly_frommsg", KYBER_SYMBYTES, prep_msg, run_frommsg},
+    {"poly_ntt", sizeof(poly), prep_poly, run_ntt},
+    {"poly_invntt", sizeof(poly), prep_poly, run_invntt},
+    {"poly_compress", sizeof(poly), prep_poly, run_compress},
+    {"poly_cbd_eta1", KYBER_ETA1 * KYBER_N / 4, prep_noise, run_cbd},
+    {"ct_memcmp", KYBER_CIPHERTEXTBYTES, prep_ct, run_memcmp},
+    {"ct_cmov", 1 + KYBER_SYMBYTES, prep_cmov, run_cmov},
+};
+
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+/*************************************************
+ * Welch's t-test with running (Welford) means and variances
+ *************************************************/
+typedef struct {
+  double n[2];
+  double mean[2];
+  double m2[2];
+} welch;
+
+static void welch_push(welch *w, int cls, double x) {
+  double delta = x - w->mean[cls];
+
+  w->n[cls] += 1;
+  w->mean[cls] += delta / w->n[cls];
+  w->m2[cls] += delta * (x - w->mean[cls]);
+}
+
+static double welch_t(const welch *w) {
+  double v0, v1;
+
+  if (w->n[0] < 2 || w->n[1] < 2)
+    return 0;
+  v0 = w->m2[0] / (w->n[0] - 1);
+  v1 = w->m2[1] / (w->n[1] - 1);
+  if (v0 + v1 == 0)
+    return 0;
+  return (w->mean[0] - w->mean[1]) / sqrt(v0 / w->n[0] + v1 / w->n[1]);
+}
+
+// One batch of randomly interleaved measurements
+static void measure(const kernel *k, uint8_t *inputs, int *cls,
+                    uint64_t *ticks) {
+  uint64_t t0;
+  size_t i;
+
+  for (i = 0; i < BATCH; i++) {
+    cls[i] = (int)(prng() & 1);
+    k->prepare(inputs + i * k->in_bytes, cls[i]);
+  }
+  for (i = 0; i < BATCH; i++) {
+    t0 = bench_cycles();
+    k->run(inputs + i * k->in_bytes);
+    ticks[i] = bench_cycles() - t0;
+  }
+}
+
+// Largest |t| over the raw and cropped tests; -1 if out of memory
+static double test_kernel(const kernel *k, size_t n) {
+  uint8_t *inputs = malloc(BATCH * k->in_bytes);
+  int cls[BATCH];
+  uint64_t ticks[BATCH], sorted[BATCH], crop[NUM_CROPS];
+  welch tests[NUM_TESTS];
+  double t, tmax = 0;
+  size_t done, i, c;
+
+  if (inputs == NULL)
+    return -1;
+  memset(tests, 0, sizeof(tests));
+
+  // Warm-up batch, only used to place the crop thresholds
+  measure(k, inputs, cls, ticks);
+  memcpy(sorted, ticks, sizeof(sorted));
+  qsort(sorted, BATCH, sizeof(uint64_t), bench_cmp_u64);
+  for (c = 0; c < NUM_CROPS; c++)
+    crop[c] = bench_percentile(sorted, BATCH, crop_pct[c]);
+
+  for (done = 0; done < n; done += BATCH) {
+    measure(k, inputs, cls, ticks);
+    for (i = 0; i < BATCH; i++) {
+      welch_push(&tests[0], cls[i], (double)ticks[i]);
+      for (c = 0; c < NUM_CROPS; c++)
+        if (ticks[i] <= crop[c])
+          welch_push(&tests[1 + c], cls[i], (double)ticks[i]);
+    }
+  }
+
+  for (c = 0; c < NUM_TESTS; c++) {
+    t = fabs(welch_t(&tests[c]));
+    if (t > tmax)
+      tmax = t;
+  }
+  free(inputs);
+  return tmax;
+}
+
+static int selected(const char *name, int argc, char **argv, int first) {
+  int i;
+
+  if (first == argc)
+    return 1;
+  for (i = first; i < argc; i++)
+    if (strcmp(argv[i], name) == 0)
+      return 1;
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  size_t n = 100000, i;
+  int first = 1, leaks = 0;
+  uint8_t ss[KYBER_SSBYTES];
+  double t;
+
+  if (argc > 2 && strcmp(argv[1], "-n") == 0) {
+    n = (size_t)atol(argv[2]);
+    first = 3;
+  }
+  if (n == 0) {
+    fprintf(stderr, "usage: %s [-n measurements] [kernel ...]\n", argv[0]);
+    return 1;
+  }
+
+  crypto_kem_keypair(pk, sk);
+  crypto_kem_enc(valid_ct, ss, pk);
+
+  printf("============================================\n");
+  printf("  Kyber Constant-Time Check (K=%d)\n", KYBER_K);
+  printf("============================================\n\n");
+  printf("%-20s %10s %10s  %s\n", "kernel", "samples", "max |t|", "verdict");
+
+  for (i = 0; i < NUM_KERNELS; i++) {
+    if (!selected(kernels[i].name, argc, argv, first))
+      continue;
+    t = test_kernel(&kernels[i], n);
+    if (t < 0) {
+      fprintf(stderr, "out of memory\n");
+      return 1;
+    }
+    printf("%-20s %10zu %10.2f  %s\n", kernels[i].name,
+           (n + BATCH - 1) / BATCH * BATCH, t,
+           t > T_THRESHOLD ? "LEAK" : "ok");
+    if (t > T_THRESHOLD)
+      leaks++;
+  }
+
+  printf("\n|t| > %.1f: the latency depends on the input class\n",
+         T_THRESHOLD);
+  return leaks ? 2 : 0;
+}
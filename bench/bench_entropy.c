@@ -0,0 +1,105 @@
+/*************************************************
+ * Entropy Ring Latency Benchmark (Linux stand-in)
+ *
+ * Emulates an MCU TRNG that delivers one 32-bit word every word_ns
+ * nanoseconds and compares the latency of a 64-byte randombytes()
+ * draw (one keygen's worth) when it
+ *   - blocks on the TRNG word by word (current MCU behaviour), and
+ *   - drains a ring prefilled by a producer thread,
+ * with work_us microseconds of computation between draws.
+ *
+ * The producer thread stands in for an interrupt handler, so run on a
+ * machine with at least two CPUs; on one CPU it competes with the
+ * consumer for time slices and the max latency reflects the scheduler.
+ *
+ * Build (from the repository root):
+ *   gcc -O3 -Iinclude bench/bench_entropy.c src/entropy_ring.c \
+ *       src/utils.c -pthread -o build/bench_entropy
+ *
+ * Usage: bench_entropy [word_ns] [work_us] [iterations]
+ *************************************************/
+
+#include "../include/entropy_ring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DRAW_BYTES 64
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Stand-in for the KEM arithmetic between two draws
+static void busy_us(unsigned int us) {
+  uint64_t end = now_ns() + (uint64_t)us * 1000;
+  while (now_ns() < end)
+    ;
+}
+
+static void report(const char *name, uint64_t total, uint64_t max,
+                   unsigned int iters) {
+  printf("%-22s %12.0f %12llu\n", name, (double)total / iters,
+         (unsigned long long)max);
+}
+
+int main(int argc, char **argv) {
+  static uint8_t storage[KYBER_ENTROPY_RING_BYTES];
+  kyber_entropy_ring ring;
+  kyber_entropy_sim sim;
+  uint8_t out[DRAW_BYTES];
+  unsigned int word_ns, work_us, iters, i;
+  uint64_t t0, dt, total, max;
+  size_t got;
+
+  word_ns = (argc > 1) ? (unsigned int)atoi(argv[1]) : 1000;
+  work_us = (argc > 2) ? (unsigned int)atoi(argv[2]) : 100;
+  iters = (argc > 3) ? (unsigned int)atoi(argv[3]) : 2000;
+  if (iters == 0) {
+    fprintf(stderr, "usage: %s [word_ns] [work_us] [iterations]\n", argv[0]);
+    return 1;
+  }
+
+  printf("============================================\n");
+  printf("  Entropy Ring Latency (%u-byte draws)\n", DRAW_BYTES);
+  printf("  TRNG word time %u ns, %u us work per draw\n", word_ns, work_us);
+  printf("============================================\n\n");
+  printf("%-22s %12s %12s\n", "mode", "mean ns", "max ns");
+
+  // Synchronous: block on every word
+  total = max = 0;
+  for (i = 0; i < iters; i++) {
+    t0 = now_ns();
+    if (kyber_entropy_sim_generate(out, DRAW_BYTES, word_ns) != 0)
+      return 1;
+    dt = now_ns() - t0;
+    total += dt;
+    max = (dt > max) ? dt : max;
+    busy_us(work_us);
+  }
+  report("synchronous TRNG", total, max, iters);
+
+  // Prefetched: producer thread keeps the ring topped up
+  kyber_entropy_ring_init(&ring, storage, sizeof(storage));
+  if (kyber_entropy_sim_start(&sim, &ring, word_ns) != 0)
+    return 1;
+  while (kyber_entropy_ring_space(&ring) >= 4)
+    busy_us(10);
+
+  total = max = 0;
+  for (i = 0; i < iters; i++) {
+    t0 = now_ns();
+    for (got = 0; got < DRAW_BYTES;)
+      got += kyber_entropy_ring_pop(&ring, out + got, DRAW_BYTES - got);
+    dt = now_ns() - t0;
+    total += dt;
+    max = (dt > max) ? dt : max;
+    busy_us(work_us);
+  }
+  kyber_entropy_sim_stop(&sim);
+  report("prefetched ring", total, max, iters);
+
+  return 0;
+}
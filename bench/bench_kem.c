@@ -0,0 +1,620 @@
+/*************************************************
+ * KEM Latency Benchmark
+ *
+ * Times crypto_kem_keypair/enc/dec one call at a time for every
+ * parameter set built into the library and reports median, p90 and
+ * p99 per operation, in time-stamp counter ticks and nanoseconds.
+ * With --perf the whole run of each operation is also measured with
+ * hardware counters (core cycles, instructions, cache misses; Linux).
+ *
+ * Results can be written as JSON and/or appended to a CSV file, one
+ * row per (label, parameter set, backend, operation), so runs of
+ * different library versions and backends accumulate in one table.
+ *
+ * Regression gate: --save-baseline stores the cycle samples of every
+ * (set, op) in a versioned text file; --check re-runs the suite and
+ * compares against it. An operation regresses when its median grew by
+ * more than --threshold percent (default 3) AND a one-sided
+ * Mann-Whitney test says the slowdown is real (p < --alpha, default
+ * 0.01), so run-to-run noise does not trip the gate. The exit status
+ * is 2 if any operation regressed or is missing from the baseline, and
+ * 1 if the baseline is short or malformed. Compare like with like: same
+ * machine, same backend, frequency scaling off. bench_ct is the
+ * matching constant-time gate for the same build.
+ *
+ * Build (from the repository root), all three sets in one binary:
+ *   for k in 2 3 4; do for f in poly polyvec indcpa kem; do
+ *     gcc -O3 -Iinclude -DKYBER_MULTI_PARAMS -DKYBER_K=$k -c src/$f.c \
+ *         -o build/${f}_$k.o; done; done
+ *   gcc -O3 -Iinclude -DKYBER_MULTI_PARAMS bench/bench_kem.c \
+ *       build/{poly,polyvec,indcpa,kem}_{2,3,4}.o src/kyber_dispatch.c \
+ *       src/ntt.c src/fips202.c src/randombytes.c src/utils.c -pthread \
+ *       -lm -o build/bench_kem
+ *
+ * A single-set build (without KYBER_MULTI_PARAMS) benchmarks KYBER_K
+ * only. Select another backend with its own compile flags; the
+ * backend column comes from KYBER_BACKEND_NAME.
+ *
+ * --offload ns hashes on the emulated Keccak accelerator of
+ * keccak_backend.c, each permutation taking ns nanoseconds, to see
+ * what a co-processor of that latency would cost per operation. It
+ * needs a library built with -DKYBER_KECCAK_BACKEND (add
+ * src/keccak_backend.c) on Linux.
+ *
+ * Usage: bench_kem [-n iterations] [-w warmup] [--perf]
+ *                  [--label name] [--json file] [--csv file]
+ *                  [--save-baseline file] [--check file]
+ *                  [--threshold percent] [--alpha p] [--offload ns]
+ *************************************************/
+
+#include "../include/keccak_backend.h"
+#include "../include/kyber_dispatch.h"
+#include "../include/platform.h"
+#include "bench.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define OP_KEYPAIR 0
+#define OP_ENC 1
+#define OP_DEC 2
+#define NUM_OPS 3
+
+#define BASELINE_VERSION 1
+#define BASELINE_SAMPLES 2000 // per (set, op), evenly spaced quantiles
+#define BASELINE_LABEL_MAX 63  // read back with %63s, a single word
+
+static const char *const op_names[NUM_OPS] = {"keypair", "enc", "dec"};
+static const kyber_param_id all_sets[] = {KYBER_PARAM_512, KYBER_PARAM_768,
+                                          KYBER_PARAM_1024};
+
+typedef struct {
+  const char *set;
+  int op;
+  size_t iterations;
+  bench_stats cycles;
+  bench_stats ns;
+  double ops_per_sec;
+  int have_perf;
+  double perf[BENCH_PERF_COUNTERS]; // per call
+  uint64_t *samples;                 // sorted cycles, for baselines
+  size_t nsamples;
+} result;
+
+typedef struct {
+  size_t iterations;
+  size_t warmup;
+  int use_perf;
+  const char *label;
+  const char *json;
+  const char *csv;
+  const char *save_baseline;
+  const char *check;
+  double threshold; // percent
+  double alpha;
+  long offload_ns; // -1: software Keccak
+} options;
+
+static int parse_args(options *o, int argc, char **argv) {
+  int i;
+
+  o->iterations = 5000;
+  o->warmup = 100;
+  o->use_perf = 0;
+  o->label = "dev";
+  o->json = NULL;
+  o->csv = NULL;
+  o->save_baseline = NULL;
+  o->check = NULL;
+  o->threshold = 3.0;
+  o->alpha = 0.01;
+  o->offload_ns = -1;
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      o->iterations = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc)
+      o->warmup = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "--perf") == 0)
+      o->use_perf = 1;
+    else if (strcmp(argv[i], "--label") == 0 && i + 1 < argc)
+      o->label = argv[++i];
+    else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+      o->json = argv[++i];
+    else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+      o->csv = argv[++i];
+    else if (strcmp(argv[i], "--save-baseline") == 0 && i + 1 < argc)
+      o->save_baseline = argv[++i];
+    else if (strcmp(argv[i], "--check") == 0 && i + 1 < argc)
+      o->check = argv[++i];
+    else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc)
+      o->threshold = atof(argv[++i]);
+    else if (strcmp(argv[i], "--alpha") == 0 && i + 1 < argc)
+      o->alpha = atof(argv[++i]);
+    else if (strcmp(argv[i], "--offload") == 0 && i + 1 < argc)
+      o->offload_ns = atol(argv[++i]);
+    else
+      return -1;
+  }
+  return (o->iterations == 0) ? -1 : 0;
+}
+
+static int run_op(const kyber_kem_impl *impl, int op, uint8_t *pk,
+                  uint8_t *sk, uint8_t *ct, uint8_t *ss) {
+  switch (op) {
+  case OP_KEYPAIR:
+    return impl->keypair(pk, sk);
+  case OP_ENC:
+    return impl->enc(ct, ss, pk);
+  default:
+    return impl->dec(ss, ct, sk);
+  }
+}
+
+/*************************************************
+ * Benchmarks one operation of one parameter set. For enc and dec the
+ * key pair (and ciphertext) from the previous operation are reused.
+ *************************************************/
+static int bench_op(result *r, const kyber_kem_impl *impl, int op,
+                    const options *o, uint8_t *pk, uint8_t *sk, uint8_t *ct,
+                    uint8_t *ss, bench_samples *cyc, bench_samples *ns) {
+  bench_perf perf;
+  uint64_t c0, t0, total = 0;
+  size_t i;
+  int k;
+
+  for (i = 0; i < o->warmup; i++)
+    if (run_op(impl, op, pk, sk, ct, ss) != 0)
+      return -1;
+
+  r->have_perf = o->use_perf && bench_perf_open(&perf) == 0;
+  if (r->have_perf)
+    bench_perf_start(&perf);
+
+  for (i = 0; i < o->iterations; i++) {
+    t0 = bench_ns();
+    c0 = bench_cycles();
+    if (run_op(impl, op, pk, sk, ct, ss) != 0)
+      return -1;
+    cyc->v[i] = bench_cycles() - c0;
+    ns->v[i] = bench_ns() - t0;
+    total += ns->v[i];
+  }
+
+  if (r->have_perf) {
+    bench_perf_stop(&perf);
+    bench_perf_close(&perf);
+    for (k = 0; k < BENCH_PERF_COUNTERS; k++)
+      r->perf[k] = (double)perf.count[k] / (double)o->iterations;
+  }
+
+  cyc->n = ns->n = o->iterations;
+  r->set = impl->name;
+  r->op = op;
+  r->iterations = o->iterations;
+  bench_stats_compute(&r->cycles, cyc);
+  bench_stats_compute(&r->ns, ns);
+
+  // cyc is sorted now; keep a bounded copy for baselines
+  r->nsamples = (cyc->n < BASELINE_SAMPLES) ? cyc->n : BASELINE_SAMPLES;
+  r->samples = malloc(r->nsamples * sizeof(uint64_t));
+  if (r->samples == NULL)
+    return -1;
+  bench_downsample(r->samples, r->nsamples, cyc->v, cyc->n);
+  r->ops_per_sec = (total > 0) ? 1e9 * (double)o->iterations / (double)total
+                               : 0.0;
+  return 0;
+}
+
+static void print_result(const result *r) {
+  printf("%-11s %-8s %12llu %12llu %12llu %10.1f %10.0f", r->set,
+         op_names[r->op], (unsigned long long)r->cycles.median,
+         (unsigned long long)r->cycles.p90, (unsigned long long)r->cycles.p99,
+         (double)r->ns.median / 1000.0, r->ops_per_sec);
+  if (r->have_perf)
+    printf(" %12.0f %10.2f %8.1f", r->perf[BENCH_PERF_CYCLES],
+           r->perf[BENCH_PERF_CYCLES] > 0
+               ? r->perf[BENCH_PERF_INSTRUCTIONS] / r->perf[BENCH_PERF_CYCLES]
+               : 0.0,
+           r->perf[BENCH_PERF_CACHE_MISSES]);
+  printf("\n");
+}
+
+static int write_json(const char *path, const options *o, const result *res,
+                      size_t nres) {
+  FILE *f = fopen(path, "w");
+  size_t i;
+
+  if (f == NULL)
+    return -1;
+
+  fprintf(f, "{\n  \"label\": \"%s\",\n  \"backend\": \"%s\",\n", o->label,
+          KYBER_BACKEND_NAME);
+  fprintf(f, "  \"cycles_unit\": \"%s\",\n  \"results\": [\n",
+          bench_cycles_unit());
+  for (i = 0; i < nres; i++) {
+    const result *r = &res[i];
+    fprintf(f,
+            "    {\"set\": \"%s\", \"op\": \"%s\", \"iterations\": %zu, "
+            "\"median_cycles\": %llu, \"p90_cycles\": %llu, "
+            "\"p99_cycles\": %llu, \"median_ns\": %llu, \"p90_ns\": %llu, "
+            "\"p99_ns\": %llu, \"ops_per_sec\": %.1f",
+            r->set, op_names[r->op], r->iterations,
+            (unsigned long long)r->cycles.median,
+            (unsigned long long)r->cycles.p90,
+            (unsigned long long)r->cycles.p99,
+            (unsigned long long)r->ns.median, (unsigned long long)r->ns.p90,
+            (unsigned long long)r->ns.p99, r->ops_per_sec);
+    if (r->have_perf)
+      fprintf(f,
+              ", \"perf_cycles\": %.0f, \"perf_instructions\": %.0f, "
+              "\"perf_cache_misses\": %.1f",
+              r->perf[BENCH_PERF_CYCLES], r->perf[BENCH_PERF_INSTRUCTIONS],
+              r->perf[BENCH_PERF_CACHE_MISSES]);
+    fprintf(f, "}%s\n", (i + 1 < nres) ? "," : "");
+  }
+  fprintf(f, "  ]\n}\n");
+  return fclose(f) == 0 ? 0 : -1;
+}
+
+// Appends rows; writes the header first if the file is new or empty
+static int write_csv(const char *path, const options *o, const result *res,
+                     size_t nres) {
+  FILE *f = fopen(path, "a");
+  size_t i;
+
+  if (f == NULL)
+    return -1;
+
+  if (ftell(f) == 0)
+    fprintf(f, "label,set,backend,op,iterations,cycles_unit,median_cycles,"
+               "p90_cycles,p99_cycles,median_ns,p90_ns,p99_ns,ops_per_sec,"
+               "perf_cycles,perf_instructions,perf_cache_misses\n");
+
+  for (i = 0; i < nres; i++) {
+    const result *r = &res[i];
+    fprintf(f, "%s,%s,%s,%s,%zu,%s,%llu,%llu,%llu,%llu,%llu,%llu,%.1f,",
+            o->label, r->set, KYBER_BACKEND_NAME, op_names[r->op],
+            r->iterations, bench_cycles_unit(),
+            (unsigned long long)r->cycles.median,
+            (unsigned long long)r->cycles.p90,
+            (unsigned long long)r->cycles.p99,
+            (unsigned long long)r->ns.median, (unsigned long long)r->ns.p90,
+            (unsigned long long)r->ns.p99, r->ops_per_sec);
+    if (r->have_perf)
+      fprintf(f, "%.0f,%.0f,%.1f\n", r->perf[BENCH_PERF_CYCLES],
+              r->perf[BENCH_PERF_INSTRUCTIONS],
+              r->perf[BENCH_PERF_CACHE_MISSES]);
+    else
+      fprintf(f, ",,\n");
+  }
+  return fclose(f) == 0 ? 0 : -1;
+}
+
+/*************************************************
+ * Baselines
+ *
+ * Text format, one record per (set, op):
+ *   kyber-bench-baseline <version>
+ *   label <label>
+ *   backend <name>
+ *   cycles_unit <unit>
+ *   result <set> <op> <nsamples> <median>
+ *   <nsamples sorted cycle counts>
+ *
+ * Fields are single words, so the label must be 1 to
+ * BASELINE_LABEL_MAX characters without whitespace.
+ *************************************************/
+
+typedef struct {
+  char set[32];
+  char op[16];
+  size_t n;
+  uint64_t median;
+  uint64_t *v;
+} baseline_entry;
+
+typedef struct {
+  char label[BASELINE_LABEL_MAX + 1];
+  char backend[32];
+  char unit[16];
+  baseline_entry e[3 * NUM_OPS];
+  size_t count;
+} baseline;
+
+static int baseline_label_ok(const char *label) {
+  size_t i, len = strlen(label);
+
+  if (len == 0 || len > BASELINE_LABEL_MAX)
+    return 0;
+  for (i = 0; i < len; i++)
+    if (isspace((unsigned char)label[i]))
+      return 0;
+  return 1;
+}
+
+static int write_baseline(const char *path, const options *o,
+                          const result *res, size_t nres) {
+  FILE *f;
+  size_t i, j;
+
+  if (!baseline_label_ok(o->label) || (f = fopen(path, "w")) == NULL)
+    return -1;
+
+  fprintf(f, "kyber-bench-baseline %d\nlabel %s\nbackend %s\n",
+          BASELINE_VERSION, o->label, KYBER_BACKEND_NAME);
+  fprintf(f, "cycles_unit %s\n", bench_cycles_unit());
+  for (i = 0; i < nres; i++) {
+    fprintf(f, "result %s %s %zu %llu\n", res[i].set, op_names[res[i].op],
+            res[i].nsamples, (unsigned long long)res[i].cycles.median);
+    for (j = 0; j < res[i].nsamples; j++)
+      fprintf(f, "%llu%c", (unsigned long long)res[i].samples[j],
+              (j + 1 < res[i].nsamples) ? ' ' : '\n');
+  }
+  return fclose(f) == 0 ? 0 : -1;
+}
+
+static void free_baseline(baseline *bl) {
+  size_t i;
+  for (i = 0; i < bl->count; i++)
+    free(bl->e[i].v);
+  bl->count = 0;
+}
+
+// One result record and its samples; 0 only if it is complete
+static int read_entry(FILE *f, baseline_entry *e) {
+  unsigned long long x;
+  size_t j;
+
+  if (fscanf(f, "%31s %15s %zu %llu", e->set, e->op, &e->n, &x) != 4 ||
+      e->n == 0 || e->n > BASELINE_SAMPLES)
+    return -1;
+  e->median = x;
+  if ((e->v = malloc(e->n * sizeof(uint64_t))) == NULL)
+    return -1;
+  // bench_mann_whitney() needs the samples sorted
+  for (j = 0; j < e->n && fscanf(f, "%llu", &x) == 1; j++) {
+    if (j > 0 && x < e->v[j - 1])
+      break;
+    e->v[j] = x;
+  }
+  // A file cut inside the last number still parses; the writer ends
+  // every sample line with a newline
+  if (j != e->n || fgetc(f) != '\n') {
+    free(e->v);
+    e->v = NULL;
+    return -1;
+  }
+  return 0;
+}
+
+static int read_baseline(const char *path, baseline *bl) {
+  FILE *f = fopen(path, "r");
+  char tag[8];
+  int version, ok = 1;
+
+  memset(bl, 0, sizeof(*bl));
+  if (f == NULL)
+    return -1;
+
+  if (fscanf(f, "kyber-bench-baseline %d label %63s backend %31s "
+                "cycles_unit %15s",
+             &version, bl->label, bl->backend, bl->unit) != 4 ||
+      version != BASELINE_VERSION) {
+    fprintf(stderr, "%s: not a version %d baseline\n", path,
+            BASELINE_VERSION);
+    fclose(f);
+    return -1;
+  }
+
+  // Only complete records count; anything else rejects the file
+  while (ok && fscanf(f, " %7s", tag) == 1) {
+    if (strcmp(tag, "result") != 0 || bl->count == 3 * NUM_OPS ||
+        read_entry(f, &bl->e[bl->count]) != 0)
+      ok = 0;
+    else
+      bl->count++;
+  }
+
+  fclose(f);
+  if (!ok || bl->count == 0) {
+    fprintf(stderr, "%s: truncated or malformed after %zu results\n", path,
+            bl->count);
+    free_baseline(bl);
+    return -1;
+  }
+  return 0;
+}
+
+// Prints a per-operation comparison; returns the number of regressions
+// plus the number of operations the baseline does not cover
+static int check_baseline(const baseline *bl, const options *o,
+                          const result *res, size_t nres) {
+  const baseline_entry *e;
+  double delta, p_slower, p_faster;
+  const char *verdict;
+  int regressions = 0;
+  size_t i, k;
+
+  printf("\nBaseline %s (label %s), fail if median > +%.1f%% and "
+         "p < %.3g\n",
+         o->check, bl->label, o->threshold, o->alpha);
+  printf("%-11s %-8s %12s %12s %8s %10s  %s\n", "set", "op", "baseline",
+         "current", "delta", "p", "verdict");
+
+  for (i = 0; i < nres; i++) {
+    e = NULL;
+    for (k = 0; k < bl->count; k++)
+      if (strcmp(bl->e[k].set, res[i].set) == 0 &&
+          strcmp(bl->e[k].op, op_names[res[i].op]) == 0)
+        e = &bl->e[k];
+    if (e == NULL) {
+      printf("%-11s %-8s %12s %12llu %8s %10s  %s\n", res[i].set,
+             op_names[res[i].op], "-",
+             (unsigned long long)res[i].cycles.median, "-", "-", "MISSING");
+      regressions++;
+      continue;
+    }
+
+    delta = 100.0 * ((double)res[i].cycles.median - (double)e->median) /
+            (double)e->median;
+    p_slower = bench_mann_whitney(e->v, e->n, res[i].samples,
+                                  res[i].nsamples);
+    p_faster = bench_mann_whitney(res[i].samples, res[i].nsamples, e->v,
+                                  e->n);
+
+    if (delta > o->threshold && p_slower < o->alpha) {
+      verdict = "REGRESSION";
+      regressions++;
+    } else if (delta < -o->threshold && p_faster < o->alpha) {
+      verdict = "faster";
+    } else {
+      verdict = "ok";
+    }
+    printf("%-11s %-8s %12llu %12llu %+7.1f%% %10.3g  %s\n", res[i].set,
+           op_names[res[i].op], (unsigned long long)e->median,
+           (unsigned long long)res[i].cycles.median, delta,
+           (delta >= 0) ? p_slower : p_faster, verdict);
+  }
+  return regressions;
+}
+
+int main(int argc, char **argv) {
+  options o;
+  result res[3 * NUM_OPS];
+  size_t nres = 0, s;
+  bench_samples cyc, ns;
+  uint8_t pk[KYBER_MAX_PUBLICKEYBYTES], sk[KYBER_MAX_SECRETKEYBYTES];
+  uint8_t ct[KYBER_MAX_CIPHERTEXTBYTES], ss[32], ss2[32];
+  baseline bl;
+  int op, status = 0;
+#if defined(KYBER_KECCAK_BACKEND) && defined(__linux__)
+  kyber_keccak_offload offload;
+#endif
+
+  if (parse_args(&o, argc, argv) != 0) {
+    fprintf(stderr,
+            "usage: %s [-n iterations] [-w warmup] [--perf] [--label name] "
+            "[--json file] [--csv file] [--save-baseline file] "
+            "[--check file] [--threshold percent] [--alpha p] "
+            "[--offload ns]\n",
+            argv[0]);
+    return 1;
+  }
+  // Refuse before the run, not after it
+  if (o.save_baseline != NULL && !baseline_label_ok(o.label)) {
+    fprintf(stderr,
+            "--save-baseline needs a --label of 1 to %d characters "
+            "without whitespace\n",
+            BASELINE_LABEL_MAX);
+    return 1;
+  }
+
+  if (o.check != NULL) {
+    if (read_baseline(o.check, &bl) != 0) {
+      fprintf(stderr, "cannot read baseline %s\n", o.check);
+      return 1;
+    }
+    if (strcmp(bl.backend, KYBER_BACKEND_NAME) != 0 ||
+        strcmp(bl.unit, bench_cycles_unit()) != 0) {
+      fprintf(stderr, "baseline is for backend %s (%s), this is %s (%s)\n",
+              bl.backend, bl.unit, KYBER_BACKEND_NAME, bench_cycles_unit());
+      free_baseline(&bl);
+      return 1;
+    }
+  }
+
+  if (o.offload_ns >= 0) {
+#if defined(KYBER_KECCAK_BACKEND) && defined(__linux__)
+    if (kyber_keccak_offload_start(&offload, (unsigned int)o.offload_ns,
+                                   1) != 0 ||
+        kyber_keccak_register(&offload.backend) != 0) {
+      fprintf(stderr, "cannot start the Keccak offload thread\n");
+      return 1;
+    }
+#else
+    fprintf(stderr, "--offload needs -DKYBER_KECCAK_BACKEND on Linux\n");
+    return 1;
+#endif
+  }
+
+  cyc.v = malloc(o.iterations * sizeof(uint64_t));
+  ns.v = malloc(o.iterations * sizeof(uint64_t));
+  if (cyc.v == NULL || ns.v == NULL) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  printf("============================================\n");
+  printf("  Kyber KEM Latency (backend %s, %zu iterations)\n",
+         KYBER_BACKEND_NAME, o.iterations);
+  printf("============================================\n\n");
+  printf("%-11s %-8s %12s %12s %12s %10s %10s", "set", "op", "median",
+         "p90", "p99", "median_us", "ops/s");
+  if (o.use_perf)
+    printf(" %12s %10s %8s", "cycles", "IPC", "misses");
+  printf("\n(median/p90/p99 in %s ticks)\n", bench_cycles_unit());
+
+  for (s = 0; s < sizeof(all_sets) / sizeof(all_sets[0]); s++) {
+    const kyber_kem_impl *impl = kyber_kem_get(all_sets[s]);
+    if (impl == NULL)
+      continue;
+
+    for (op = 0; op < NUM_OPS; op++) {
+      if (bench_op(&res[nres], impl, op, &o, pk, sk, ct, ss, &cyc, &ns) !=
+          0) {
+        fprintf(stderr, "%s %s failed\n", impl->name, op_names[op]);
+        return 1;
+      }
+      print_result(&res[nres]);
+      nres++;
+    }
+
+    // Sanity check that the benchmarked set round-trips
+    impl->enc(ct, ss, pk);
+    impl->dec(ss2, ct, sk);
+    if (memcmp(ss, ss2, sizeof(ss)) != 0) {
+      fprintf(stderr, "%s: shared secrets do NOT match\n", impl->name);
+      status = 1;
+    }
+  }
+
+#if defined(KYBER_KECCAK_BACKEND) && defined(__linux__)
+  if (o.offload_ns >= 0) {
+    kyber_keccak_register(NULL);
+    kyber_keccak_offload_stop(&offload);
+    printf("\nKeccak offload: %llu permutations at %ld ns\n",
+           (unsigned long long)offload.completed, o.offload_ns);
+  }
+#endif
+
+  if (o.use_perf && nres > 0 && !res[0].have_perf)
+    fprintf(stderr, "note: perf_event_open unavailable, counters skipped\n");
+
+  if (o.json != NULL && write_json(o.json, &o, res, nres) != 0) {
+    fprintf(stderr, "cannot write %s\n", o.json);
+    status = 1;
+  }
+  if (o.csv != NULL && write_csv(o.csv, &o, res, nres) != 0) {
+    fprintf(stderr, "cannot write %s\n", o.csv);
+    status = 1;
+  }
+
+  if (o.save_baseline != NULL &&
+      write_baseline(o.save_baseline, &o, res, nres) != 0) {
+    fprintf(stderr, "cannot write %s\n", o.save_baseline);
+    status = 1;
+  }
+  if (o.check != NULL) {
+    if (check_baseline(&bl, &o, res, nres) > 0 && status == 0)
+      status = 2;
+    free_baseline(&bl);
+  }
+
+  for (s = 0; s < nres; s++)
+    free(res[s].samples);
+  free(cyc.v);
+  free(ns.v);
+  return status;
+}
@@ -0,0 +1,429 @@
+/*************************************************
+ * Per-Primitive Microbenchmark
+ *
+ * Times each arithmetic and hashing kernel of one parameter set on
+ * its own: matrix expansion, (inverse) NTT, base multiplication, CBD
+ * sampling, compression and Keccak. Every kernel gets a warm-up, then
+ * reps batches of calls; the reported figure is the median over the
+ * batches of ticks per call (per lane for multi-lane kernels).
+ *
+ * Kernels that exist in several backends (scalar, the vector-extension
+ * arithmetic of ntt_vec.c, the AArch64 NEON, RISC-V Vector and
+ * Cortex-M4 DSP kernels and the multi-lane fips202xn hashing) are
+ * listed side by side, one column per backend, so the per-call cost
+ * of each implementation can be compared row by row. A "-" means the
+ * backend has no version of that kernel.
+ *
+ * Build (from the repository root):
+ *   gcc -O3 -Iinclude bench/bench_primitives.c src/indcpa.c src/poly.c \
+ *       src/polyvec.c src/ntt.c src/fips202.c src/fips202xn.c \
+ *       src/ntt_vec.c src/ntt_neon.c src/fips202x2_neon.c \
+ *       src/ntt_rvv.c src/fips202xn_rvv.c src/ntt_m4.c src/keccak_bi32.c \
+ *       src/randombytes.c src/utils.c -pthread -o build/bench_primitives
+ *
+ * Add -DKYBER_K=3 or -DKYBER_K=4 for the other parameter sets.
+ *
+ * Usage: bench_primitives [reps] [calls_per_rep]
+ *************************************************/
+
+#include "../include/fips202.h"
+#include "../include/fips202xn.h"
+#include "../include/indcpa.h"
+#include "../include/keccak_bi32.h"
+#include "../include/fips202x2_neon.h"
+#include "../include/fips202xn_rvv.h"
+#include "../include/ntt_m4.h"
+#include "../include/ntt_neon.h"
+#include "../include/ntt_rvv.h"
+#include "../include/ntt_vec.h"
+#include "../include/params.h"
+#include "../include/platform.h"
+#include "../include/poly.h"
+#include "../include/polyvec.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define WARMUP_CALLS 64
+#define MAX_BACKENDS 6
+
+/*************************************************
+ * Shared operands. Kernels read and write these so the compiler
+ * cannot drop the calls.
+ *************************************************/
+static polyvec mat[KYBER_K];
+static polyvec va, vb;
+static poly pa, pb, pr;
+static uint8_t seed[KYBER_SYMBYTES];
+static uint8_t buf[KYBER_ETA1 * KYBER_N / 4 + KYBER_SYMBYTES];
+static uint8_t bytes[KYBER_POLYVECCOMPRESSEDBYTES + KYBER_POLYBYTES];
+static uint8_t hash_in[KYBER_XN_LANES][2 * KYBER_SYMBYTES];
+static uint8_t hash_out[KYBER_XN_LANES][KYBER_ETA2 * KYBER_N / 4];
+static uint64_t keccak_s[25];
+static uint8_t nonce;
+
+static void k_gen_matrix(void) { gen_matrix(mat, seed, 0); }
+static void k_gen_matrix_entry(void) { gen_matrix_entry(&pr, seed, 0, 1); }
+static void k_ntt(void) { poly_ntt(&pa); }
+static void k_invntt(void) { poly_invntt(&pa); }
+static void k_basemul(void) { poly_basemul_montgomery(&pr, &pa, &pb); }
+static void k_polyvec_acc(void) {
+  polyvec_pointwise_acc_montgomery(&pr, &va, &vb);
+}
+static void k_reduce(void) { poly_reduce(&pa); }
+static void k_cbd_eta1(void) { poly_cbd_eta1(&pr, buf); }
+static void k_cbd_eta2(void) { poly_cbd_eta2(&pr, buf); }
+static void k_getnoise_eta1(void) { poly_getnoise_eta1(&pr, seed, nonce++); }
+static void k_getnoise_eta2(void) { poly_getnoise_eta2(&pr, seed, nonce++); }
+static void k_poly_compress(void) { poly_compress(bytes, &pa, KYBER_DV); }
+static void k_poly_decompress(void) { poly_decompress(&pr, bytes, KYBER_DV); }
+static void k_polyvec_compress(void) { polyvec_compress(bytes, &va); }
+static void k_polyvec_decompress(void) { polyvec_decompress(&vb, bytes); }
+static void k_tobytes(void) { poly_tobytes(bytes, &pa); }
+static void k_frombytes(void) { poly_frombytes(&pr, bytes); }
+static void k_keccak_f1600(void) { KeccakF1600_StatePermute(keccak_s); }
+// Portable C, so always there to compare (on its own state layout)
+static void k_keccak_f1600_bi32(void) {
+  KeccakF1600_StatePermute_bi32(keccak_s);
+}
+
+// Hash inputs as in the KEM: H(pk) is one pk, G and PRF take 64 / 33 bytes
+static void k_sha3_256(void) {
+  sha3_256(hash_out[0], hash_in[0], sizeof(hash_in[0]));
+}
+static void k_sha3_512(void) {
+  sha3_512(hash_out[0], hash_in[0], sizeof(hash_in[0]));
+}
+static void k_shake256_prf(void) {
+  shake256(hash_out[0], sizeof(hash_out[0]), hash_in[0], KYBER_SYMBYTES + 1);
+}
+// The same through the single-block fast paths of the KEM
+static void k_sha3_512_64(void) { sha3_512_64(hash_out[0], hash_in[0]); }
+static void k_shake256_33(void) {
+  shake256_33(hash_out[0], sizeof(hash_out[0]), hash_in[0]);
+}
+// A block is larger than a hash_out row
+static void k_shake128_block(void) {
+  uint8_t block[SHAKE128_RATE];
+  keccak_state st;
+  shake128_absorb(&st, hash_in[0], KYBER_SYMBYTES + 2);
+  shake128_squeezeblocks(block, 1, &st);
+}
+
+static uint8_t *xn_out[KYBER_XN_LANES];
+static const uint8_t *xn_in[KYBER_XN_LANES];
+
+static void k_sha3_256xn(void) {
+  sha3_256xn(xn_out, xn_in, sizeof(hash_in[0]));
+}
+static void k_sha3_512xn(void) {
+  sha3_512xn(xn_out, xn_in, sizeof(hash_in[0]));
+}
+static void k_shake256xn_prf(void) {
+  shake256xn(xn_out, sizeof(hash_out[0]), xn_in, KYBER_SYMBYTES + 1);
+}
+
+// Vector kernels, called directly so they show next to the scalar ones
+#if defined(KYBER_HAVE_VEC) && !defined(KYBER_BACKEND_VEC)
+static void v_ntt(void) {
+  ntt_vec(pa.coeffs);
+  reduce_vec(pa.coeffs);
+}
+static void v_invntt(void) { invntt_vec(pa.coeffs); }
+static void v_basemul(void) { basemul_vec(pr.coeffs, pa.coeffs, pb.coeffs); }
+static void v_reduce(void) { reduce_vec(pa.coeffs); }
+#if KYBER_ETA1 == 3
+static void v_cbd_eta1(void) { cbd3_vec(pr.coeffs, buf); }
+#else
+static void v_cbd_eta1(void) { cbd2_vec(pr.coeffs, buf); }
+#endif
+static void v_cbd_eta2(void) { cbd2_vec(pr.coeffs, buf); }
+static void v_poly_compress(void) { compress_vec(bytes, pa.coeffs, KYBER_DV); }
+#define VEC_KERNEL(name, fn) {name, "vec", fn, 1},
+#else
+#define VEC_KERNEL(name, fn)
+#endif
+
+#if defined(KYBER_HAVE_NEON) && !defined(KYBER_BACKEND_NEON)
+static void n_ntt(void) {
+  ntt_neon(pa.coeffs);
+  reduce_neon(pa.coeffs);
+}
+static void n_invntt(void) { invntt_neon(pa.coeffs); }
+static void n_basemul(void) { basemul_neon(pr.coeffs, pa.coeffs, pb.coeffs); }
+static void n_reduce(void) { reduce_neon(pa.coeffs); }
+#if KYBER_ETA1 == 3
+static void n_cbd_eta1(void) { cbd3_neon(pr.coeffs, buf); }
+#else
+static void n_cbd_eta1(void) { cbd2_neon(pr.coeffs, buf); }
+#endif
+static void n_cbd_eta2(void) { cbd2_neon(pr.coeffs, buf); }
+static void n_poly_compress(void) {
+  compress_neon(bytes, pa.coeffs, KYBER_DV);
+}
+#define NEON_KERNEL(name, fn) {name, "neon", fn, 1},
+#else
+#define NEON_KERNEL(name, fn)
+#endif
+
+// The 2-way Keccak is compiled in whenever the target has NEON
+#if defined(KYBER_HAVE_NEON)
+static uint8_t x2_out[2][SHAKE128_RATE];
+
+static void n_shake128x2_block(void) {
+  shake128x2(x2_out[0], x2_out[1], SHAKE128_RATE, hash_in[0], hash_in[1],
+             KYBER_SYMBYTES + 2);
+}
+#define NEON_X2_KERNEL(name, fn) {name, "neon x2", fn, 2},
+#else
+#define NEON_X2_KERNEL(name, fn)
+#endif
+
+#if defined(KYBER_HAVE_RVV) && !defined(KYBER_BACKEND_RVV)
+static void r_ntt(void) {
+  ntt_rvv(pa.coeffs);
+  reduce_rvv(pa.coeffs);
+}
+static void r_invntt(void) { invntt_rvv(pa.coeffs); }
+static void r_basemul(void) { basemul_rvv(pr.coeffs, pa.coeffs, pb.coeffs); }
+static void r_reduce(void) { reduce_rvv(pa.coeffs); }
+#if KYBER_ETA1 == 3
+static void r_cbd_eta1(void) { cbd3_rvv(pr.coeffs, buf); }
+#else
+static void r_cbd_eta1(void) { cbd2_rvv(pr.coeffs, buf); }
+#endif
+static void r_cbd_eta2(void) { cbd2_rvv(pr.coeffs, buf); }
+static void r_poly_compress(void) { compress_rvv(bytes, pa.coeffs, KYBER_DV); }
+#define RVV_KERNEL(name, fn) {name, "rvv", fn, 1},
+#else
+#define RVV_KERNEL(name, fn)
+#endif
+
+// The multi-lane vector Keccak is compiled in whenever the target has RVV
+#if defined(KYBER_HAVE_RVV)
+static uint8_t xn_rvv_out[KYBER_RVV_MAX_LANES][SHAKE128_RATE];
+static uint8_t *xn_rvv_outp[KYBER_RVV_MAX_LANES];
+
+static void r_shake128xn_block(void) {
+  shake128xn_rvv(xn_rvv_outp, SHAKE128_RATE, xn_in, KYBER_SYMBYTES + 2,
+                 KYBER_RVV_MAX_LANES);
+}
+#define RVV_XN_KERNEL(name, fn)                                                \
+  {name, "rvv x" STR(KYBER_RVV_MAX_LANES), fn, KYBER_RVV_MAX_LANES},
+#else
+#define RVV_XN_KERNEL(name, fn)
+#endif
+
+#if defined(KYBER_HAVE_M4) && !defined(KYBER_BACKEND_M4)
+static void m_ntt(void) {
+  ntt_m4(pa.coeffs);
+  reduce_m4(pa.coeffs);
+}
+static void m_invntt(void) { invntt_m4(pa.coeffs); }
+static void m_basemul(void) { basemul_m4(pr.coeffs, pa.coeffs, pb.coeffs); }
+static void m_reduce(void) { reduce_m4(pa.coeffs); }
+#define M4_KERNEL(name, fn) {name, "m4", fn, 1},
+#else
+#define M4_KERNEL(name, fn)
+#endif
+
+typedef struct {
+  const char *name;
+  const char *backend;
+  void (*fn)(void);
+  unsigned int lanes; // calls are divided by this for per-lane figures
+} kernel;
+
+#define STR_(x) #x
+#define STR(x) STR_(x)
+#define XN_BACKEND "x" STR(KYBER_XN_LANES)
+
+static const kernel kernels[] = {
+    {"gen_matrix", KYBER_BACKEND_NAME, k_gen_matrix, 1},
+    {"gen_matrix_entry", KYBER_BACKEND_NAME, k_gen_matrix_entry, 1},
+    {"poly_ntt", KYBER_BACKEND_NAME, k_ntt, 1},
+    VEC_KERNEL("poly_ntt", v_ntt)
+    NEON_KERNEL("poly_ntt", n_ntt)
+    RVV_KERNEL("poly_ntt", r_ntt)
+    M4_KERNEL("poly_ntt", m_ntt)
+    {"poly_invntt", KYBER_BACKEND_NAME, k_invntt, 1},
+    VEC_KERNEL("poly_invntt", v_invntt)
+    NEON_KERNEL("poly_invntt", n_invntt)
+    RVV_KERNEL("poly_invntt", r_invntt)
+    M4_KERNEL("poly_invntt", m_invntt)
+    {"poly_basemul_montgomery", KYBER_BACKEND_NAME, k_basemul, 1},
+    VEC_KERNEL("poly_basemul_montgomery", v_basemul)
+    NEON_KERNEL("poly_basemul_montgomery", n_basemul)
+    RVV_KERNEL("poly_basemul_montgomery", r_basemul)
+    M4_KERNEL("poly_basemul_montgomery", m_basemul)
+    {"polyvec_pointwise_acc", KYBER_BACKEND_NAME, k_polyvec_acc, 1},
+    {"poly_reduce", KYBER_BACKEND_NAME, k_reduce, 1},
+    VEC_KERNEL("poly_reduce", v_reduce)
+    NEON_KERNEL("poly_reduce", n_reduce)
+    RVV_KERNEL("poly_reduce", r_reduce)
+    M4_KERNEL("poly_reduce", m_reduce)
+    {"poly_cbd_eta1", KYBER_BACKEND_NAME, k_cbd_eta1, 1},
+    VEC_KERNEL("poly_cbd_eta1", v_cbd_eta1)
+    NEON_KERNEL("poly_cbd_eta1", n_cbd_eta1)
+    RVV_KERNEL("poly_cbd_eta1", r_cbd_eta1)
+    {"poly_cbd_eta2", KYBER_BACKEND_NAME, k_cbd_eta2, 1},
+    VEC_KERNEL("poly_cbd_eta2", v_cbd_eta2)
+    NEON_KERNEL("poly_cbd_eta2", n_cbd_eta2)
+    RVV_KERNEL("poly_cbd_eta2", r_cbd_eta2)
+    {"poly_getnoise_eta1", KYBER_BACKEND_NAME, k_getnoise_eta1, 1},
+    {"poly_getnoise_eta2", KYBER_BACKEND_NAME, k_getnoise_eta2, 1},
+    {"poly_compress", KYBER_BACKEND_NAME, k_poly_compress, 1},
+    VEC_KERNEL("poly_compress", v_poly_compress)
+    NEON_KERNEL("poly_compress", n_poly_compress)
+    RVV_KERNEL("poly_compress", r_poly_compress)
+    {"poly_decompress", KYBER_BACKEND_NAME, k_poly_decompress, 1},
+    {"polyvec_compress", KYBER_BACKEND_NAME, k_polyvec_compress, 1},
+    {"polyvec_decompress", KYBER_BACKEND_NAME, k_polyvec_decompress, 1},
+    {"poly_tobytes", KYBER_BACKEND_NAME, k_tobytes, 1},
+    {"poly_frombytes", KYBER_BACKEND_NAME, k_frombytes, 1},
+    {"keccak_f1600", KYBER_BACKEND_NAME, k_keccak_f1600, 1},
+    {"keccak_f1600", "bi32", k_keccak_f1600_bi32, 1},
+    {"shake128_block", KYBER_BACKEND_NAME, k_shake128_block, 1},
+    NEON_X2_KERNEL("shake128_block", n_shake128x2_block)
+    RVV_XN_KERNEL("shake128_block", r_shake128xn_block)
+    {"sha3_256(64)", KYBER_BACKEND_NAME, k_sha3_256, 1},
+    {"sha3_256(64)", XN_BACKEND, k_sha3_256xn, KYBER_XN_LANES},
+    {"sha3_512(64)", KYBER_BACKEND_NAME, k_sha3_512, 1},
+    {"sha3_512(64)", XN_BACKEND, k_sha3_512xn, KYBER_XN_LANES},
+    {"sha3_512(64)", "fixed", k_sha3_512_64, 1},
+    {"shake256_prf(eta2)", KYBER_BACKEND_NAME, k_shake256_prf, 1},
+    {"shake256_prf(eta2)", XN_BACKEND, k_shake256xn_prf, KYBER_XN_LANES},
+    {"shake256_prf(eta2)", "fixed", k_shake256_33, 1},
+};
+
+#define NUM_KERNELS (sizeof(kernels) / sizeof(kernels[0]))
+
+static void init_operands(void) {
+  unsigned int i, j;
+
+  for (i = 0; i < sizeof(seed); i++)
+    seed[i] = (uint8_t)(i * 7 + 1);
+  for (i = 0; i < sizeof(buf); i++)
+    buf[i] = (uint8_t)(i * 13 + 5);
+  for (i = 0; i < KYBER_XN_LANES; i++) {
+    for (j = 0; j < sizeof(hash_in[i]); j++)
+      hash_in[i][j] = (uint8_t)(i + j);
+    xn_in[i] = hash_in[i];
+    xn_out[i] = hash_out[i];
+  }
+#if defined(KYBER_HAVE_RVV)
+  for (i = 0; i < KYBER_RVV_MAX_LANES; i++)
+    xn_rvv_outp[i] = xn_rvv_out[i];
+#endif
+
+  gen_matrix(mat, seed, 0);
+  va = mat[0];
+  vb = mat[KYBER_K - 1];
+  pa = mat[0].vec[0];
+  pb = mat[0].vec[KYBER_K - 1];
+  polyvec_reduce(&va);
+  polyvec_reduce(&vb);
+  memset(keccak_s, 0, sizeof(keccak_s));
+}
+
+// Median ticks per call (per lane) over reps batches of calls
+static double time_kernel(const kernel *k, uint64_t *samples, size_t reps,
+                          size_t calls) {
+  bench_samples s;
+  bench_stats st;
+  uint64_t t0;
+  size_t r, c;
+
+  for (c = 0; c < WARMUP_CALLS; c++)
+    k->fn();
+
+  for (r = 0; r < reps; r++) {
+    // Keep the operands in range between batches
+    poly_reduce(&pa);
+    t0 = bench_cycles();
+    for (c = 0; c < calls; c++)
+      k->fn();
+    samples[r] = bench_cycles() - t0;
+  }
+
+  s.v = samples;
+  s.n = reps;
+  bench_stats_compute(&st, &s);
+  return (double)st.median / (double)(calls * k->lanes);
+}
+
+int main(int argc, char **argv) {
+  size_t reps = (argc > 1) ? (size_t)atol(argv[1]) : 101;
+  size_t calls = (argc > 2) ? (size_t)atol(argv[2]) : 64;
+  const char *backends[MAX_BACKENDS];
+  const char *rows[NUM_KERNELS];
+  double cost[NUM_KERNELS][MAX_BACKENDS];
+  size_t nbackends = 0, nrows = 0, i, b, r;
+  uint64_t *samples;
+
+  if (reps == 0 || calls == 0) {
+    fprintf(stderr, "usage: %s [reps] [calls_per_rep]\n", argv[0]);
+    return 1;
+  }
+  samples = malloc(reps * sizeof(uint64_t));
+  if (samples == NULL) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  init_operands();
+
+  // Group kernels into rows by name and columns by backend
+  for (i = 0; i < NUM_KERNELS; i++) {
+    for (b = 0; b < nbackends; b++)
+      if (strcmp(backends[b], kernels[i].backend) == 0)
+        break;
+    if (b == nbackends && nbackends < MAX_BACKENDS)
+      backends[nbackends++] = kernels[i].backend;
+
+    for (r = 0; r < nrows; r++)
+      if (strcmp(rows[r], kernels[i].name) == 0)
+        break;
+    if (r == nrows) {
+      rows[nrows] = kernels[i].name;
+      for (b = 0; b < MAX_BACKENDS; b++)
+        cost[nrows][b] = -1;
+      nrows++;
+    }
+  }
+
+  for (i = 0; i < NUM_KERNELS; i++) {
+    for (b = 0; b < nbackends; b++)
+      if (strcmp(backends[b], kernels[i].backend) == 0)
+        break;
+    for (r = 0; r < nrows; r++)
+      if (strcmp(rows[r], kernels[i].name) == 0)
+        break;
+    if (b < nbackends)
+      cost[r][b] = time_kernel(&kernels[i], samples, reps, calls);
+  }
+
+  printf("============================================\n");
+  printf("  Kyber Primitives (K=%d, %s ticks per call)\n", KYBER_K,
+         bench_cycles_unit());
+  printf("============================================\n\n");
+
+  printf("%-26s", "kernel");
+  for (b = 0; b < nbackends; b++)
+    printf(" %12s", backends[b]);
+  printf("\n");
+  for (r = 0; r < nrows; r++) {
+    printf("%-26s", rows[r]);
+    for (b = 0; b < nbackends; b++) {
+      if (cost[r][b] < 0)
+        printf(" %12s", "-");
+      else
+        printf(" %12.1f", cost[r][b]);
+    }
+    printf("\n");
+  }
+
+  free(samples);
+  return 0;
+}
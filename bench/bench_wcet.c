@@ -0,0 +1,369 @@
+/*************************************************
+ * Worst-Case Execution Time Harness
+ *
+ * Kyber is constant time with respect to secrets, but not with respect
+ * to public inputs: gen_matrix rejection-samples the matrix A from
+ * SHAKE128(rho || i || j), and a public seed rho whose stream rejects
+ * more candidates costs extra SHAKE128 blocks in keypair, enc and dec.
+ * Average-case benchmarks never see those seeds, so they are useless
+ * for sizing a hard deadline.
+ *
+ * This harness searches randombytes_seed() values 0 .. N-1 (each one
+ * deterministically yields a key pair and therefore a rho) and, for
+ * every one:
+ *   - counts the Keccak permutations gen_matrix spends in keypair
+ *     (via the phase profiler; "extra" is the count above the fewest
+ *     seen, i.e. the retry blocks of rejection sampling),
+ *   - times keypair, enc and dec once.
+ * It reports the latency distribution per operation up to p99.999 and
+ * the maximum, the median latency per number of extra blocks, and then
+ * re-times the worst seeds found (-c of them, -r times each) to get
+ * their own maximum. The observed WCET of an operation is the larger
+ * of the two maxima; on a desktop it includes interrupts and frequency
+ * changes, so treat it as an upper estimate and re-measure on target.
+ *
+ * --corpus writes the worst seeds as a C header (pk, sk, a ct for that
+ * pk, rho and the block count per entry) that on-target deadline tests
+ * can include directly, without needing this search or a seeded RNG.
+ *
+ * Build (from the repository root), the profiler is required:
+ *   gcc -O3 -Iinclude -DKYBER_PROFILE bench/bench_wcet.c src/kem.c \
+ *       src/indcpa.c src/poly.c src/polyvec.c src/ntt.c src/fips202.c \
+ *       src/randombytes.c src/utils.c src/kyber_profile.c -pthread \
+ *       -o build/bench_wcet
+ *
+ * Add -DKYBER_K=3 or -DKYBER_K=4 for the other parameter sets.
+ * p99.999 is only meaningful with -n 100000 or more (the default).
+ *
+ * Usage: bench_wcet [-n seeds] [-c corpus_size] [-r reps]
+ *                   [--corpus file]
+ *************************************************/
+
+#include "../include/kem.h"
+#include "../include/kyber_profile.h"
+#include "../include/params.h"
+#include "../include/platform.h"
+#include "../include/randombytes.h"
+#include "bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(KYBER_PROFILE)
+#error "bench_wcet counts Keccak blocks with the profiler: -DKYBER_PROFILE"
+#endif
+
+#define OP_KEYPAIR 0
+#define OP_ENC 1
+#define OP_DEC 2
+#define NUM_OPS 3
+
+#define MAX_CORPUS 64
+#define MAX_EXTRA 16 // rows of the per-extra-block table
+
+static const char *const op_names[NUM_OPS] = {"keypair", "enc", "dec"};
+
+typedef struct {
+  size_t seeds;
+  size_t corpus;
+  size_t reps;
+  const char *corpus_file;
+} options;
+
+typedef struct {
+  uint32_t seed;
+  uint32_t blocks; // Keccak permutations in gen_matrix
+} candidate;
+
+static uint8_t pk[KYBER_PUBLICKEYBYTES];
+static uint8_t sk[KYBER_SECRETKEYBYTES];
+static uint8_t ct[KYBER_CIPHERTEXTBYTES];
+static uint8_t ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+
+static int parse_args(options *o, int argc, char **argv) {
+  int i;
+
+  o->seeds = 100000;
+  o->corpus = 8;
+  o->reps = 1000;
+  o->corpus_file = NULL;
+
+  for (i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+      o->seeds = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+      o->corpus = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+      o->reps = (size_t)atol(argv[++i]);
+    else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc)
+      o->corpus_file = argv[++i];
+    else
+      return -1;
+  }
+  if (o->seeds == 0 || o->reps == 0 || o->corpus == 0 ||
+      o->corpus > MAX_CORPUS || o->corpus > o->seeds)
+    return -1;
+  return 0;
+}
+
+// Regenerates the key pair of a seed; returns its gen_matrix blocks
+static uint32_t seeded_keypair(uint32_t seed) {
+  kyber_profile_stats ps;
+
+  randombytes_seed(seed);
+  kyber_profile_reset();
+  crypto_kem_keypair(pk, sk);
+  kyber_profile_read(&ps);
+  return ps.keccak[KYBER_PHASE_GEN_MATRIX];
+}
+
+// Keeps the n highest block counts, earliest seed first on ties
+static void track_worst(candidate *worst, size_t *len, size_t n,
+                        candidate c) {
+  size_t i;
+
+  if (*len == n && c.blocks <= worst[n - 1].blocks)
+    return;
+  i = (*len < n) ? (*len)++ : n - 1;
+  while (i > 0 && worst[i - 1].blocks < c.blocks) {
+    worst[i] = worst[i - 1];
+    i--;
+  }
+  worst[i] = c;
+}
+
+static void time_ops(uint64_t t[NUM_OPS], uint32_t seed) {
+  uint64_t t0;
+
+  randombytes_seed(seed);
+  t0 = bench_cycles();
+  crypto_kem_keypair(pk, sk);
+  t[OP_KEYPAIR] = bench_cycles() - t0;
+
+  t0 = bench_cycles();
+  crypto_kem_enc(ct, ss1, pk);
+  t[OP_ENC] = bench_cycles() - t0;
+
+  t0 = bench_cycles();
+  crypto_kem_dec(ss2, ct, sk);
+  t[OP_DEC] = bench_cycles() - t0;
+}
+
+static void write_bytes(FILE *f, const char *field, const uint8_t *p,
+                        size_t n) {
+  size_t i;
+
+  fprintf(f, "     .%s = {", field);
+  for (i = 0; i < n; i++)
+    fprintf(f, "%s0x%02x,", (i % 12 == 0) ? "\n         " : " ", p[i]);
+  fprintf(f, "},\n");
+}
+
+static int write_corpus(const char *path, const candidate *worst, size_t n,
+                        size_t searched, uint32_t base_blocks) {
+  FILE *f = fopen(path, "w");
+  size_t i;
+
+  if (f == NULL)
+    return -1;
+
+  fprintf(f,
+          "/*************************************************\n"
+          " * Worst-case public-input corpus, Kyber K=%d\n"
+          " *\n"
+          " * Generated by bench_wcet from %zu seeds. Each entry is a key\n"
+          " * pair whose public seed rho needs the most SHAKE128 blocks in\n"
+          " * gen_matrix (%u is the fewest seen), plus a ciphertext for pk.\n"
+          " * Run crypto_kem_enc(pk) and crypto_kem_dec(ct, sk) on every\n"
+          " * entry to check deadlines against the slowest public inputs.\n"
+          " *************************************************/\n\n",
+          KYBER_K, searched, base_blocks);
+  fprintf(f, "#ifndef KYBER_WCET_CORPUS_H\n#define KYBER_WCET_CORPUS_H\n\n");
+  fprintf(f, "#include <stdint.h>\n\n");
+  fprintf(f, "#if defined(KYBER_K) && KYBER_K != %d\n", KYBER_K);
+  fprintf(f, "#error \"corpus was generated for KYBER_K=%d\"\n#endif\n\n",
+          KYBER_K);
+  fprintf(f, "#define KYBER_WCET_CORPUS_K %d\n", KYBER_K);
+  fprintf(f, "#define KYBER_WCET_CORPUS_ENTRIES %zu\n", n);
+  fprintf(f, "#define KYBER_WCET_CORPUS_BASE_BLOCKS %u\n\n", base_blocks);
+  fprintf(f,
+          "typedef struct {\n"
+          "  uint32_t seed;              // randombytes_seed() value\n"
+          "  uint32_t gen_matrix_blocks; // Keccak permutations\n"
+          "  uint8_t rho[%d];\n"
+          "  uint8_t pk[%d];\n"
+          "  uint8_t sk[%d];\n"
+          "  uint8_t ct[%d];\n"
+          "} kyber_wcet_entry;\n\n",
+          KYBER_SYMBYTES, KYBER_PUBLICKEYBYTES, KYBER_SECRETKEYBYTES,
+          KYBER_CIPHERTEXTBYTES);
+  fprintf(f, "static const kyber_wcet_entry kyber_wcet_corpus[%zu] = {\n", n);
+
+  for (i = 0; i < n; i++) {
+    seeded_keypair(worst[i].seed);
+    crypto_kem_enc(ct, ss1, pk);
+    fprintf(f, "    {.seed = %u,\n     .gen_matrix_blocks = %u,\n",
+            worst[i].seed, worst[i].blocks);
+    write_bytes(f, "rho", pk + KYBER_POLYVECBYTES, KYBER_SYMBYTES);
+    write_bytes(f, "pk", pk, KYBER_PUBLICKEYBYTES);
+    write_bytes(f, "sk", sk, KYBER_SECRETKEYBYTES);
+    write_bytes(f, "ct", ct, KYBER_CIPHERTEXTBYTES);
+    fprintf(f, "    },\n");
+  }
+  fprintf(f, "};\n\n#endif /* KYBER_WCET_CORPUS_H */\n");
+
+  return fclose(f) == 0 ? 0 : -1;
+}
+
+int main(int argc, char **argv) {
+  options o;
+  candidate worst[MAX_CORPUS];
+  size_t nworst = 0, nsamples, i, r, op, e;
+  uint64_t *samples[NUM_OPS], *per_extra;
+  uint64_t t[NUM_OPS], seed_max[NUM_OPS], random_max[NUM_OPS];
+  uint32_t *blocks, base_blocks = 0xFFFFFFFF, max_extra = 0;
+  size_t extra_count[MAX_EXTRA];
+  bench_samples s;
+
+  if (parse_args(&o, argc, argv) != 0) {
+    fprintf(stderr,
+            "usage: %s [-n seeds] [-c corpus_size (<= %d)] [-r reps] "
+            "[--corpus file]\n",
+            argv[0], MAX_CORPUS);
+    return 1;
+  }
+
+  nsamples = (o.reps > o.seeds) ? o.reps : o.seeds;
+  blocks = malloc(o.seeds * sizeof(uint32_t));
+  per_extra = malloc(o.seeds * sizeof(uint64_t));
+  for (op = 0; op < NUM_OPS; op++)
+    samples[op] = malloc(nsamples * sizeof(uint64_t));
+  if (blocks == NULL || per_extra == NULL || samples[OP_KEYPAIR] == NULL ||
+      samples[OP_ENC] == NULL || samples[OP_DEC] == NULL) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  printf("============================================\n");
+  printf("  Kyber WCET (K=%d, %s ticks)\n", KYBER_K, bench_cycles_unit());
+  printf("============================================\n\n");
+
+  // Search: block count and one timing of every operation per seed
+  for (i = 0; i < o.seeds; i++) {
+    candidate c;
+
+    c.seed = (uint32_t)i;
+    c.blocks = seeded_keypair(c.seed);
+    blocks[i] = c.blocks;
+    if (c.blocks < base_blocks)
+      base_blocks = c.blocks;
+    track_worst(worst, &nworst, o.corpus, c);
+
+    time_ops(t, c.seed);
+    for (op = 0; op < NUM_OPS; op++)
+      samples[op][i] = t[op];
+  }
+
+  for (e = 0; e < MAX_EXTRA; e++)
+    extra_count[e] = 0;
+  for (i = 0; i < o.seeds; i++) {
+    e = blocks[i] - base_blocks;
+    extra_count[e < MAX_EXTRA ? e : MAX_EXTRA - 1]++;
+    if (e > max_extra)
+      max_extra = (uint32_t)e;
+  }
+
+  printf("Searched %zu seeds: gen_matrix takes %u to %u Keccak blocks\n\n",
+         o.seeds, base_blocks, base_blocks + max_extra);
+
+  // Median latency by number of extra blocks
+  printf("%-6s %10s", "extra", "seeds");
+  for (op = 0; op < NUM_OPS; op++)
+    printf(" %12s", op_names[op]);
+  printf("\n");
+  for (e = 0; e < MAX_EXTRA && e <= max_extra; e++) {
+    if (extra_count[e] == 0)
+      continue;
+    printf("%-6zu %10zu", e, extra_count[e]);
+    for (op = 0; op < NUM_OPS; op++) {
+      s.v = per_extra;
+      s.n = 0;
+      for (i = 0; i < o.seeds; i++)
+        if (blocks[i] - base_blocks == e ||
+            (e == MAX_EXTRA - 1 && blocks[i] - base_blocks > e))
+          per_extra[s.n++] = samples[op][i];
+      qsort(s.v, s.n, sizeof(uint64_t), bench_cmp_u64);
+      printf(" %12llu",
+             (unsigned long long)bench_percentile(s.v, s.n, 50));
+    }
+    printf("\n");
+  }
+
+  // Latency distribution over all seeds
+  printf("\n%-8s %12s %12s %12s %12s\n", "op", "median", "p99", "p99.999",
+         "max");
+  for (op = 0; op < NUM_OPS; op++) {
+    s.v = samples[op];
+    s.n = o.seeds;
+    qsort(s.v, s.n, sizeof(uint64_t), bench_cmp_u64);
+    random_max[op] = s.v[s.n - 1];
+    printf("%-8s %12llu %12llu %12llu %12llu\n", op_names[op],
+           (unsigned long long)bench_percentile(s.v, s.n, 50),
+           (unsigned long long)bench_percentile(s.v, s.n, 99),
+           (unsigned long long)bench_percentile(s.v, s.n, 99.999),
+           (unsigned long long)random_max[op]);
+  }
+  if (o.seeds < 100000)
+    printf("(p99.999 needs >= 100000 seeds; with fewer it is the max)\n");
+
+  // Re-time the worst seeds
+  printf("\nWorst seeds, %zu runs each (median / max):\n", o.reps);
+  printf("%-10s %6s", "seed", "extra");
+  for (op = 0; op < NUM_OPS; op++)
+    printf(" %23s", op_names[op]);
+  printf("\n");
+  for (op = 0; op < NUM_OPS; op++)
+    seed_max[op] = 0;
+  for (i = 0; i < nworst; i++) {
+    for (r = 0; r < o.reps; r++) {
+      time_ops(t, worst[i].seed);
+      for (op = 0; op < NUM_OPS; op++)
+        samples[op][r] = t[op];
+    }
+    printf("%-10u %6u", worst[i].seed, worst[i].blocks - base_blocks);
+    for (op = 0; op < NUM_OPS; op++) {
+      s.v = samples[op];
+      s.n = o.reps;
+      qsort(s.v, s.n, sizeof(uint64_t), bench_cmp_u64);
+      if (s.v[s.n - 1] > seed_max[op])
+        seed_max[op] = s.v[s.n - 1];
+      printf(" %11llu / %9llu",
+             (unsigned long long)bench_percentile(s.v, s.n, 50),
+             (unsigned long long)s.v[s.n - 1]);
+    }
+    printf("\n");
+  }
+
+  printf("\nObserved WCET:");
+  for (op = 0; op < NUM_OPS; op++)
+    printf("  %s %llu", op_names[op],
+           (unsigned long long)(seed_max[op] > random_max[op]
+                                    ? seed_max[op]
+                                    : random_max[op]));
+  printf("\n");
+
+  if (o.corpus_file != NULL) {
+    if (write_corpus(o.corpus_file, worst, nworst, o.seeds, base_blocks) !=
+        0) {
+      fprintf(stderr, "cannot write %s\n", o.corpus_file);
+      return 1;
+    }
+    printf("Wrote %zu worst-case entries to %s\n", nworst, o.corpus_file);
+  }
+
+  for (op = 0; op < NUM_OPS; op++)
+    free(samples[op]);
+  free(per_extra);
+  free(blocks);
+  return 0;
+}
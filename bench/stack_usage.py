@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""Static worst-case stack depth per KEM entry point.
+
+Reads the per-function frame sizes and call edges that gcc writes with
+-fstack-usage -fcallgraph-info=su (one .ci file per object, plus the
+.su files) and reports, for each root, the deepest call chain and its
+total stack in bytes. Unlike the painted measurement of
+kyber_stack_measure() this covers paths a given run did not take, and
+works with any cross compiler, so it is the figure to size MCU task
+stacks from.
+
+Build the library with the target compiler and flags, for example:
+  mkdir -p build/su && cd build/su
+  for f in kem indcpa poly polyvec ntt fips202 randombytes utils; do
+    arm-none-eabi-gcc -O3 -mcpu=cortex-m4 -I../../include \\
+        -fstack-usage -fcallgraph-info=su -c ../../src/$f.c; done
+  python3 ../../bench/stack_usage.py .
+
+Usage: stack_usage.py [--root name ...] [--tree] dir_or_file ...
+
+Roots default to crypto_kem_keypair/enc/dec; with KYBER_MULTI_PARAMS
+the namespaced names (kyber512_crypto_kem_dec, ...) match as well.
+Calls to functions without frame information (libc, inline assembly)
+count as 0 bytes and are listed; indirect calls and recursion are
+flagged because no static bound exists for them.
+"""
+
+import os
+import re
+import sys
+
+DEFAULT_ROOTS = ["crypto_kem_keypair", "crypto_kem_enc", "crypto_kem_dec"]
+
+NODE_RE = re.compile(r'node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE_RE = re.compile(r'edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+BYTES_RE = re.compile(r"\\n(\d+) bytes \(([a-z,]+)\)")
+SU_RE = re.compile(r"^(.*):\d+:\d+:([^\t]+)\t(\d+)\t(\S+)$")
+
+
+def local_name(title):
+    """Strips the file prefix gcc puts on static functions."""
+    return title.rsplit(":", 1)[-1] if ":" in title else title
+
+
+def load(paths):
+    frames = {}  # title -> (bytes, qualifier)
+    calls = {}  # title -> set of callee titles
+    files = []
+    for p in paths:
+        if os.path.isdir(p):
+            files += [os.path.join(p, f) for f in sorted(os.listdir(p))]
+        else:
+            files.append(p)
+
+    for f in files:
+        if f.endswith(".ci"):
+            with open(f) as fh:
+                for line in fh:
+                    m = NODE_RE.search(line)
+                    if m:
+                        b = BYTES_RE.search(m.group(2))
+                        if b:
+                            frames[m.group(1)] = (int(b.group(1)), b.group(2))
+                        continue
+                    m = EDGE_RE.search(line)
+                    if m:
+                        calls.setdefault(m.group(1), set()).add(m.group(2))
+        elif f.endswith(".su"):
+            with open(f) as fh:
+                for line in fh:
+                    m = SU_RE.match(line.rstrip("\n"))
+                    if m and m.group(2) not in frames:
+                        frames[m.group(2)] = (int(m.group(3)), m.group(4))
+    return frames, calls
+
+
+def worst_case(frames, calls):
+    memo = {}
+    notes = {"unknown": set(), "indirect": set(), "recursive": set(),
+             "dynamic": set()}
+
+    def depth(fn, active):
+        if fn in memo:
+            return memo[fn]
+        if fn in active:
+            notes["recursive"].add(local_name(fn))
+            return 0, [fn]
+        own, qual = frames.get(fn, (0, None))
+        if qual is None:
+            notes["unknown"].add(local_name(fn))
+        elif qual != "static":
+            notes["dynamic"].add(local_name(fn))
+        best, chain = 0, []
+        active.add(fn)
+        for callee in sorted(calls.get(fn, ())):
+            if callee == "__indirect_call":
+                notes["indirect"].add(local_name(fn))
+                continue
+            d, c = depth(callee, active)
+            if d > best:
+                best, chain = d, c
+        active.discard(fn)
+        memo[fn] = (own + best, [fn] + chain)
+        return memo[fn]
+
+    return depth, notes
+
+
+def main(argv):
+    roots, paths, tree = [], [], False
+    i = 1
+    while i < len(argv):
+        if argv[i] == "--root" and i + 1 < len(argv):
+            roots.append(argv[i + 1])
+            i += 2
+        elif argv[i] == "--tree":
+            tree = True
+            i += 1
+        else:
+            paths.append(argv[i])
+            i += 1
+    if not paths:
+        sys.stderr.write(__doc__)
+        return 1
+
+    frames, calls = load(paths)
+    if not frames:
+        sys.stderr.write("no .ci or .su data found\n")
+        return 1
+
+    wanted = roots or DEFAULT_ROOTS
+    found = sorted(t for t in frames
+                   if any(local_name(t) == r or local_name(t).endswith("_" + r)
+                          for r in wanted))
+    if not found:
+        sys.stderr.write("none of the roots were found\n")
+        return 1
+
+    depth, notes = worst_case(frames, calls)
+    for root in found:
+        total, chain = depth(root, set())
+        print("%-32s %7d bytes" % (local_name(root), total))
+        if tree:
+            for fn in chain:
+                print("    %-40s %6d" % (local_name(fn),
+                                         frames.get(fn, (0, None))[0]))
+
+    for kind, label in (("recursive", "recursion (unbounded)"),
+                        ("indirect", "indirect calls (not followed)"),
+                        ("dynamic", "dynamic frames (alloca/VLA)"),
+                        ("unknown", "no frame data, counted as 0")):
+        if notes[kind]:
+            print("%s: %s" % (label, " ".join(sorted(notes[kind]))))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
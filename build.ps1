@@ -1,6 +1,14 @@
 # Kyber C Implementation Build Script
 # 
 # This script compiles and runs the Kyber implementation with tests
+#
+# Usage: .\build.ps1 [-MultiParams]
+#   -MultiParams  Build Kyber-512, -768 and -1024 into one binary with
+#                 per-set symbol prefixes (see KYBER_NAMESPACE in params.h)
+
+param(
+    [switch]$MultiParams
+)
 
 $ErrorActionPreference = "Stop"
 
@@ -21,15 +29,40 @@ Write-Host "  Kyber C Implementation Build" -ForegroundColor Cyan
 Write-Host "============================================" -ForegroundColor Cyan
 Write-Host ""
 
-# Source files
-$SOURCES = @(
+# Parameter-independent sources (compiled once)
+$SHARED_SOURCES = @(
     "$SRC_DIR/ntt.c",
+    "$SRC_DIR/ntt_vec.c",
+    "$SRC_DIR/ntt_neon.c",
+    "$SRC_DIR/fips202.c",
+    "$SRC_DIR/keccak_bi32.c",
+    "$SRC_DIR/keccak_backend.c",
+    "$SRC_DIR/kyber_tune.c",
+    "$SRC_DIR/fips202xn.c",
+    "$SRC_DIR/fips202x2_neon.c",
+    "$SRC_DIR/ntt_rvv.c",
+    "$SRC_DIR/fips202xn_rvv.c",
+    "$SRC_DIR/ntt_m4.c",
+    "$SRC_DIR/entropy_ring.c",
+    "$SRC_DIR/kyber_dispatch.c",
+    "$SRC_DIR/kyber_profile.c",
+    "$SRC_DIR/kyber_metrics.c",
+    "$SRC_DIR/kyber_stack.c",
+    "$SRC_DIR/randombytes.c",
+    "$SRC_DIR/utils.c"
+)
+
+# Sources specialised for KYBER_K (compiled once per parameter set)
+$PARAM_SOURCES = @(
     "$SRC_DIR/poly.c",
     "$SRC_DIR/polyvec.c", 
-    "$SRC_DIR/fips202.c",
     "$SRC_DIR/indcpa.c",
     "$SRC_DIR/kem.c",
-    "$SRC_DIR/utils.c"
+    "$SRC_DIR/kem_pool.c",
+    "$SRC_DIR/kem_encq.c",
+    "$SRC_DIR/kem_batch.c",
+    "$SRC_DIR/kem_dec_xn.c",
+    "$SRC_DIR/kem_step.c"
 )
 
 # Compile flags
@@ -44,18 +77,35 @@ Write-Host "[1] Compiling Kyber library..." -ForegroundColor Yellow
 
 # Compile each source file to object
 $OBJ_FILES = @()
-foreach ($src in $SOURCES) {
-    $obj = "$BUILD_DIR\" + [System.IO.Path]::GetFileNameWithoutExtension($src) + ".o"
-    $OBJ_FILES += $obj
+function Compile-Source($src, $suffix, $extraFlags) {
+    $obj = "$BUILD_DIR\" + [System.IO.Path]::GetFileNameWithoutExtension($src) + "$suffix.o"
+    $script:OBJ_FILES += $obj
     
-    Write-Host "    Compiling $src..."
-    & $GCC -c $src -o $obj $CFLAGS
+    Write-Host "    Compiling $src $extraFlags..."
+    & $GCC -c $src -o $obj $CFLAGS $extraFlags
     if ($LASTEXITCODE -ne 0) {
         Write-Host "ERROR: Failed to compile $src" -ForegroundColor Red
         exit 1
     }
 }
 
+if ($MultiParams) {
+    $CFLAGS += "-DKYBER_MULTI_PARAMS"
+    foreach ($src in $SHARED_SOURCES) {
+        Compile-Source $src "" @()
+    }
+    foreach ($k in @(2, 3, 4)) {
+        foreach ($src in $PARAM_SOURCES) {
+            Compile-Source $src "_k$k" @("-DKYBER_K=$k")
+        }
+    }
+}
+else {
+    foreach ($src in $SHARED_SOURCES + $PARAM_SOURCES) {
+        Compile-Source $src "" @()
+    }
+}
+
 Write-Host "[2] Compiling test program..." -ForegroundColor Yellow
 
 # Compile test
@@ -69,7 +119,7 @@ Write-Host "[3] Linking..." -ForegroundColor Yellow
 
 # Link everything
 $ALL_OBJS = $OBJ_FILES + "$BUILD_DIR/test_kem.o"
-& $GCC $ALL_OBJS -o "$BUILD_DIR/test_kem.exe"
+& $GCC $ALL_OBJS -o "$BUILD_DIR/test_kem.exe" -pthread
 if ($LASTEXITCODE -ne 0) {
     Write-Host "ERROR: Failed to link" -ForegroundColor Red
     exit 1
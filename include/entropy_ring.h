@@ -0,0 +1,179 @@
+#ifndef ENTROPY_RING_H
+#define ENTROPY_RING_H
+
+#include "randombytes.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+/*************************************************
+ * Prefetching Entropy Ring
+ *
+ * Hardware RNGs on MCUs deliver one word every few microseconds, and
+ * randombytes() used to block on every word. The ring is filled ahead
+ * of time by a producer (RNG interrupt, DMA complete callback or idle
+ * task) and drained by randombytes(), so a KEM operation finds its
+ * 32-64 bytes already waiting.
+ *
+ * Single producer, single consumer, lock-free; the producer side is
+ * safe to call from an interrupt handler. Storage is caller-provided
+ * and its size must be a power of two. Consumed bytes are wiped.
+ *
+ * Build with KYBER_ENTROPY_RING to make randombytes() on STM32 and
+ * nRF52 drain the global ring kyber_entropy; see randombytes.c for the
+ * platform producers.
+ *************************************************/
+
+#ifndef KYBER_ENTROPY_RING_BYTES
+#define KYBER_ENTROPY_RING_BYTES 256
+#endif
+
+typedef struct {
+  uint8_t *buf;
+  size_t mask;
+  atomic_size_t head; // Written by the producer only
+  atomic_size_t tail; // Written by the consumer only
+} kyber_entropy_ring;
+
+// Static initializer, so a global ring is valid before main() runs
+#define KYBER_ENTROPY_RING_INIT(storage, capacity)                             \
+  { (storage), (capacity) - 1, 0, 0 }
+
+/*************************************************
+ * Name:        kyber_entropy_ring_init
+ *
+ * Description: Binds a ring to caller-owned storage
+ *
+ * Arguments:   - kyber_entropy_ring *r: ring to initialise
+ *              - uint8_t *storage: byte buffer
+ *              - size_t capacity: size of storage (power of two)
+ *
+ * Returns 0 on success, -1 if capacity is not a power of two
+ **************************************************/
+int kyber_entropy_ring_init(kyber_entropy_ring *r, uint8_t *storage,
+                            size_t capacity);
+
+/*************************************************
+ * Name:        kyber_entropy_ring_push
+ *
+ * Description: Producer side: appends up to len bytes. Never blocks;
+ *              callable from an interrupt handler.
+ *
+ * Arguments:   - kyber_entropy_ring *r: ring
+ *              - const uint8_t *in: fresh entropy
+ *              - size_t len: number of bytes offered
+ *
+ * Returns number of bytes stored (less than len if the ring is full)
+ **************************************************/
+size_t kyber_entropy_ring_push(kyber_entropy_ring *r, const uint8_t *in,
+                               size_t len);
+
+/*************************************************
+ * Name:        kyber_entropy_ring_pop
+ *
+ * Description: Consumer side: takes up to len bytes and wipes them
+ *              from the ring. Never blocks.
+ *
+ * Arguments:   - kyber_entropy_ring *r: ring
+ *              - uint8_t *out: output buffer
+ *              - size_t len: number of bytes wanted
+ *
+ * Returns number of bytes copied (less than len if the ring ran dry)
+ **************************************************/
+size_t kyber_entropy_ring_pop(kyber_entropy_ring *r, uint8_t *out,
+                              size_t len);
+
+/*************************************************
+ * Name:        kyber_entropy_ring_fill
+ *
+ * Description: Number of bytes ready to be consumed
+ **************************************************/
+size_t kyber_entropy_ring_fill(const kyber_entropy_ring *r);
+
+/*************************************************
+ * Name:        kyber_entropy_ring_space
+ *
+ * Description: Number of bytes the producer can still store
+ **************************************************/
+size_t kyber_entropy_ring_space(const kyber_entropy_ring *r);
+
+#if defined(KYBER_ENTROPY_RING)
+// Global ring drained by randombytes()
+extern kyber_entropy_ring kyber_entropy;
+
+#if defined(KYBER_PLATFORM_STM32)
+/*************************************************
+ * Name:        kyber_entropy_stm32_start
+ *
+ * Description: Starts interrupt-driven prefetching from the RNG
+ *              peripheral. Call once after MX_RNG_Init(); enable the
+ *              RNG interrupt in CubeMX. Until then randombytes()
+ *              polls HAL_RNG_GenerateRandomNumber as before. After a
+ *              seed or clock error randombytes() resets the
+ *              peripheral, polls the rest and prefetches again.
+ **************************************************/
+void kyber_entropy_stm32_start(void);
+#endif
+
+#if defined(KYBER_PLATFORM_NRF52)
+/*************************************************
+ * Name:        kyber_entropy_nrf52_idle
+ *
+ * Description: Tops up the ring from nrf_crypto_rng. Call from the
+ *              main loop before sleeping or from an RTOS idle hook.
+ *              Must not run concurrently with itself.
+ **************************************************/
+void kyber_entropy_nrf52_idle(void);
+#endif
+#endif /* KYBER_ENTROPY_RING */
+
+#if defined(__linux__)
+/*************************************************
+ * Linux stand-in for an MCU RNG
+ *
+ * Emulates a TRNG that delivers one 32-bit word every word_ns
+ * nanoseconds (bytes come from getrandom), so the ring and its
+ * latency benefit can be tested and benchmarked off-target.
+ *************************************************/
+typedef struct {
+  kyber_entropy_ring *ring;
+  unsigned int word_ns;
+  pthread_t thread;
+  atomic_int stop;
+} kyber_entropy_sim;
+
+/*************************************************
+ * Name:        kyber_entropy_sim_generate
+ *
+ * Description: Synchronous draw from the emulated TRNG, i.e. what
+ *              randombytes() does without the ring
+ *
+ * Returns 0 on success, -1 on failure
+ **************************************************/
+int kyber_entropy_sim_generate(uint8_t *out, size_t len,
+                               unsigned int word_ns);
+
+/*************************************************
+ * Name:        kyber_entropy_sim_start
+ *
+ * Description: Starts a producer thread that keeps the ring full at
+ *              the emulated TRNG rate
+ *
+ * Returns 0 on success, -1 if the thread could not be created
+ **************************************************/
+int kyber_entropy_sim_start(kyber_entropy_sim *s, kyber_entropy_ring *ring,
+                            unsigned int word_ns);
+
+/*************************************************
+ * Name:        kyber_entropy_sim_stop
+ *
+ * Description: Stops and joins the producer thread
+ **************************************************/
+void kyber_entropy_sim_stop(kyber_entropy_sim *s);
+#endif
+
+#endif /* ENTROPY_RING_H */
@@ -15,6 +15,9 @@ typedef struct {
   unsigned int output_len;
 } keccak_state;
 
+// Keccak-f[1600] permutation on a 25-word state
+void KeccakF1600_StatePermute(uint64_t state[25]);
+
 // SHA3-256
 void sha3_256(uint8_t *output, const uint8_t *input, size_t inlen);
 
@@ -29,6 +32,14 @@ void shake128(uint8_t *output, size_t outlen, const uint8_t *input,
 void shake256(uint8_t *output, size_t outlen, const uint8_t *input,
               size_t inlen);
 
+// Single-block hashes of fixed-length inputs, as the functions above
+// with inlen = 32, 33 or 64 but without the generic absorb loop
+void sha3_256_32(uint8_t output[32], const uint8_t input[32]);
+void sha3_512_32(uint8_t output[64], const uint8_t input[32]);
+void sha3_512_64(uint8_t output[64], const uint8_t input[64]);
+void shake256_33(uint8_t *output, size_t outlen, const uint8_t input[33]);
+void shake256_64(uint8_t *output, size_t outlen, const uint8_t input[64]);
+
 // Incremental SHAKE-128 (useful for generating matrix A)
 void shake128_absorb(keccak_state *state, const uint8_t *input, size_t inlen);
 void shake128_squeezeblocks(uint8_t *output, size_t nblocks,
@@ -41,4 +52,12 @@ void shake256_squeezeblocks(uint8_t *output, size_t nblocks,
                             keccak_state *state);
 void shake256_ctx_release(keccak_state *state);
 
+// Block-at-a-time SHA3-256: absorb full SHA3_256_RATE blocks one per
+// call, then finalize with the remaining inlen < SHA3_256_RATE bytes
+void sha3_256_inc_init(keccak_state *state);
+void sha3_256_inc_absorb_block(keccak_state *state,
+                               const uint8_t input[SHA3_256_RATE]);
+void sha3_256_inc_finalize(uint8_t output[32], keccak_state *state,
+                           const uint8_t *input, size_t inlen);
+
 #endif /* FIPS202_H */
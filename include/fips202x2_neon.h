@@ -0,0 +1,24 @@
+#ifndef FIPS202X2_NEON_H
+#define FIPS202X2_NEON_H
+
+#include "ntt_neon.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************
+ * 2-way SHAKE128 (AArch64 NEON)
+ *
+ * Two independent SHAKE128 instances in one set of NEON registers.
+ * Both inputs have the same length and both outputs are outlen bytes.
+ * Used by gen_matrix() when built with -DKYBER_BACKEND_NEON; only
+ * declared where KYBER_HAVE_NEON is set (see ntt_neon.h).
+ *************************************************/
+
+#if defined(KYBER_HAVE_NEON)
+
+void shake128x2(uint8_t *out0, uint8_t *out1, size_t outlen,
+                const uint8_t *in0, const uint8_t *in1, size_t inlen);
+
+#endif
+
+#endif /* FIPS202X2_NEON_H */
@@ -0,0 +1,39 @@
+#ifndef FIPS202XN_H
+#define FIPS202XN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************
+ * Multi-lane SHA3 / SHAKE
+ *
+ * Runs KYBER_XN_LANES independent Keccak instances side by side.
+ * The state is stored lane-major (s[word][lane]) so every step of
+ * the permutation is one straight-line loop over lanes, which the
+ * compiler turns into SIMD code without any shuffles.
+ *
+ * All lanes absorb inputs of the same length and squeeze outputs of
+ * the same length.
+ *************************************************/
+
+#ifndef KYBER_XN_LANES
+#define KYBER_XN_LANES 8
+#endif
+
+#if (KYBER_XN_LANES != 8) && (KYBER_XN_LANES != 16)
+#error "KYBER_XN_LANES must be 8 or 16"
+#endif
+
+// SHA3-256 of KYBER_XN_LANES inputs of inlen bytes each
+void sha3_256xn(uint8_t *const out[KYBER_XN_LANES],
+                const uint8_t *const in[KYBER_XN_LANES], size_t inlen);
+
+// SHA3-512 of KYBER_XN_LANES inputs of inlen bytes each
+void sha3_512xn(uint8_t *const out[KYBER_XN_LANES],
+                const uint8_t *const in[KYBER_XN_LANES], size_t inlen);
+
+// SHAKE-256 of KYBER_XN_LANES inputs, outlen bytes of output per lane
+void shake256xn(uint8_t *const out[KYBER_XN_LANES], size_t outlen,
+                const uint8_t *const in[KYBER_XN_LANES], size_t inlen);
+
+#endif /* FIPS202XN_H */
@@ -0,0 +1,31 @@
+#ifndef FIPS202XN_RVV_H
+#define FIPS202XN_RVV_H
+
+#include "ntt_rvv.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************
+ * Multi-lane Keccak (RISC-V Vector)
+ *
+ * Keccak-f[1600] on any number of instances in the lane-major layout
+ * of fips202xn.h, one instance per 64-bit vector element, and
+ * SHAKE128 of up to KYBER_RVV_MAX_LANES inputs of equal length. With
+ * -DKYBER_BACKEND_RVV, gen_matrix() expands a row of K matrix entries
+ * per call and fips202xn.c permutes through the vector code. Only
+ * declared where KYBER_HAVE_RVV is set (see ntt_rvv.h).
+ *************************************************/
+
+#if defined(KYBER_HAVE_RVV)
+
+// Instances per shake128xn_rvv() call; sizes its on-stack state
+#define KYBER_RVV_MAX_LANES 8
+
+void KeccakF1600_StatePermutexn_rvv(uint64_t *s, unsigned int lanes);
+
+void shake128xn_rvv(uint8_t *const *out, size_t outlen,
+                    const uint8_t *const *in, size_t inlen, unsigned int n);
+
+#endif
+
+#endif /* FIPS202XN_RVV_H */
@@ -2,6 +2,7 @@
 #define INDCPA_H
 
 #include "params.h"
+#include "polyvec.h"
 #include <stdint.h>
 
 
@@ -15,9 +16,13 @@
  *                             (of length KYBER_PUBLICKEYBYTES bytes)
  *              - uint8_t *sk: pointer to output private key
  *                             (of length KYBER_SECRETKEYBYTES bytes)
+ *
+ * Returns 0 on success, -1 if randombytes() failed (pk and sk are
+ * not written)
  **************************************************/
-void indcpa_keypair(uint8_t pk[KYBER_PUBLICKEYBYTES],
-                    uint8_t sk[KYBER_SECRETKEYBYTES]);
+#define indcpa_keypair KYBER_NAMESPACE(indcpa_keypair)
+int indcpa_keypair(uint8_t pk[KYBER_PUBLICKEYBYTES],
+                   uint8_t sk[KYBER_SECRETKEYBYTES]);
 
 /*************************************************
  * Name:        indcpa_enc
@@ -35,6 +40,7 @@ void indcpa_keypair(uint8_t pk[KYBER_PUBLICKEYBYTES],
  *                                      used as seed (of length KYBER_SYMBYTES
  * bytes) to deterministically generate all randomness
  **************************************************/
+#define indcpa_enc KYBER_NAMESPACE(indcpa_enc)
 void indcpa_enc(uint8_t c[KYBER_CIPHERTEXTBYTES],
                 const uint8_t m[KYBER_SYMBYTES],
                 const uint8_t pk[KYBER_PUBLICKEYBYTES],
@@ -53,8 +59,44 @@ void indcpa_enc(uint8_t c[KYBER_CIPHERTEXTBYTES],
  *              - const uint8_t *sk: pointer to input secret key
  *                                   (of length KYBER_SECRETKEYBYTES bytes)
  **************************************************/
+#define indcpa_dec KYBER_NAMESPACE(indcpa_dec)
 void indcpa_dec(uint8_t m[KYBER_SYMBYTES],
                 const uint8_t c[KYBER_CIPHERTEXTBYTES],
                 const uint8_t sk[KYBER_SECRETKEYBYTES]);
 
+/*************************************************
+ * Name:        gen_matrix
+ *
+ * Description: Deterministically generate matrix A (or the transpose of A)
+ *              from a seed. Entries are polynomials that look uniformly
+ *              random. Exposed so that batched kernels operating under one
+ *              key can expand A once and share it.
+ *
+ * Arguments:   - polyvec *a: pointer to output matrix A (KYBER_K rows)
+ *              - const uint8_t *seed: pointer to input seed
+ *                                     (of length KYBER_SYMBYTES bytes)
+ *              - int transposed: boolean deciding whether A or A^T
+ *                                is generated
+ **************************************************/
+#define gen_matrix KYBER_NAMESPACE(gen_matrix)
+void gen_matrix(polyvec *a, const uint8_t seed[KYBER_SYMBYTES],
+                int transposed);
+
+/*************************************************
+ * Name:        gen_matrix_entry
+ *
+ * Description: Samples a single matrix entry, Parse(SHAKE128(seed || x || y)).
+ *              A[i][j] uses (x, y) = (j, i), A^T[i][j] uses (i, j).
+ *              Lets callers expand A one entry at a time instead of
+ *              holding all KYBER_K * KYBER_K polynomials.
+ *
+ * Arguments:   - poly *r: pointer to output polynomial
+ *              - const uint8_t *seed: pointer to input seed
+ *                                     (of length KYBER_SYMBYTES bytes)
+ *              - uint8_t x, y: domain-separation indices
+ **************************************************/
+#define gen_matrix_entry KYBER_NAMESPACE(gen_matrix_entry)
+void gen_matrix_entry(poly *r, const uint8_t seed[KYBER_SYMBYTES], uint8_t x,
+                      uint8_t y);
+
 #endif /* INDCPA_H */
@@ -0,0 +1,194 @@
+#ifndef KECCAK_BACKEND_H
+#define KECCAK_BACKEND_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+/*************************************************
+ * Pluggable Keccak Backend
+ *
+ * SoCs with a SHA-3 engine or a crypto co-processor can take over the
+ * Keccak-f[1600] permutation, and optionally the whole absorb and
+ * squeeze steps, from the software code of fips202.c. A backend is a
+ * table of entry points registered once at init:
+ *
+ *   - permute: synchronous, returns with the state permuted
+ *   - submit/poll: asynchronous, for engines that are started and
+ *     later checked for completion (DMA or mailbox interfaces). The
+ *     caller may do other work between the two.
+ *   - absorb/squeeze: optional, for engines that consume whole
+ *     messages; NULL keeps the software sponge around permute
+ *
+ * A backend needs permute or submit and poll. Where only one style is
+ * provided the other is derived from it: kyber_keccak_permute() spins
+ * on poll, kyber_keccak_submit() completes at once through permute.
+ *
+ * Build the library with -DKYBER_KECCAK_BACKEND to route fips202.c
+ * through the registered backend (one indirect call per permutation);
+ * otherwise the software permutation stays hard-wired and this
+ * interface is only reachable directly. The backend sees states in
+ * the standard lane layout, so the option excludes KYBER_KECCAK_BI32.
+ * The multi-lane hashing of fips202xn.c is not routed.
+ *
+ * States handed to a backend hold secrets and are permuted in place;
+ * the caller must not touch a submitted state until poll reports it
+ * done.
+ *************************************************/
+
+#if defined(KYBER_KECCAK_BACKEND) && defined(KYBER_KECCAK_BI32)
+#error "KYBER_KECCAK_BACKEND cannot be combined with KYBER_KECCAK_BI32"
+#endif
+
+/*************************************************
+ * One asynchronous permutation. Set state, then pass the job to
+ * kyber_keccak_submit(); done is written by the backend.
+ *************************************************/
+typedef struct kyber_keccak_job {
+  uint64_t *state;               // 25 lanes, permuted in place
+  atomic_int done;               // 1 once the state is permuted
+  struct kyber_keccak_job *next; // Owned by the backend while queued
+} kyber_keccak_job;
+
+typedef struct {
+  const char *name;
+  void *ctx; // Passed to every entry point
+
+  // Synchronous permutation (may be NULL if submit and poll are set)
+  void (*permute)(void *ctx, uint64_t state[25]);
+
+  // Start a permutation: 0 if accepted, -1 if the engine is busy or
+  // its queue is full. poll returns 1 once the job is done, else 0.
+  int (*submit)(void *ctx, kyber_keccak_job *job);
+  int (*poll)(void *ctx, kyber_keccak_job *job);
+
+  // Whole-message absorb (state reset, padding with domain byte p)
+  // and full-block squeeze at rate r, as in fips202.c; may be NULL
+  void (*absorb)(void *ctx, uint64_t state[25], unsigned int r,
+                 const uint8_t *in, size_t inlen, uint8_t p);
+  void (*squeeze)(void *ctx, uint8_t *out, size_t nblocks,
+                  uint64_t state[25], unsigned int r);
+} kyber_keccak_backend;
+
+// Software reference backend: KeccakF1600_StatePermute of fips202.c
+extern const kyber_keccak_backend kyber_keccak_software;
+
+// The bit-interleaved permutation of keccak_bi32.c, converting the
+// lanes on every call (a candidate for kyber_tune.h on 32-bit cores)
+extern const kyber_keccak_backend kyber_keccak_software_bi32;
+
+/*************************************************
+ * Name:        kyber_keccak_register
+ *
+ * Description: Makes b the backend of all later hashing. Call at init,
+ *              before any thread hashes; b must stay valid while it is
+ *              registered.
+ *
+ * Arguments:   - const kyber_keccak_backend *b: backend, NULL for
+ *                kyber_keccak_software
+ *
+ * Returns 0 on success, -1 if b has neither permute nor submit and
+ * poll (the previous backend stays registered)
+ **************************************************/
+int kyber_keccak_register(const kyber_keccak_backend *b);
+
+/*************************************************
+ * Name:        kyber_keccak_backend_get
+ *
+ * Description: Currently registered backend (never NULL)
+ **************************************************/
+const kyber_keccak_backend *kyber_keccak_backend_get(void);
+
+/*************************************************
+ * Name:        kyber_keccak_permute
+ *
+ * Description: Synchronous permutation on the registered backend
+ *
+ * Arguments:   - uint64_t *state: 25 lanes, permuted in place
+ **************************************************/
+void kyber_keccak_permute(uint64_t state[25]);
+
+/*************************************************
+ * Name:        kyber_keccak_submit
+ *
+ * Description: Starts job on the registered backend
+ *
+ * Arguments:   - kyber_keccak_job *job: job with state set
+ *
+ * Returns 0 if accepted, -1 if the backend is busy (retry later)
+ **************************************************/
+int kyber_keccak_submit(kyber_keccak_job *job);
+
+/*************************************************
+ * Name:        kyber_keccak_poll
+ *
+ * Description: Checks a submitted job without blocking
+ *
+ * Returns 1 if the state is permuted, 0 if still running
+ **************************************************/
+int kyber_keccak_poll(kyber_keccak_job *job);
+
+/*************************************************
+ * Name:        kyber_keccak_wait
+ *
+ * Description: Spins on kyber_keccak_poll() until job is done
+ **************************************************/
+void kyber_keccak_wait(kyber_keccak_job *job);
+
+#if defined(__linux__)
+/*************************************************
+ * Linux stand-in for a Keccak accelerator
+ *
+ * A worker thread plays the engine: it takes submitted jobs in order
+ * from a queue of at most depth entries (queued plus running) and
+ * completes each latency_ns after it starts it, running the software
+ * permutation. The backend has submit and poll only, so the sponge
+ * waits on every permutation as it would on real hardware. Queueing,
+ * back-pressure and latency can be tested without the SoC.
+ *************************************************/
+typedef struct {
+  kyber_keccak_backend backend; // Register &o->backend
+  unsigned int latency_ns;
+  unsigned int depth;
+  unsigned int pending; // Queued or running
+  kyber_keccak_job *head;
+  kyber_keccak_job *tail;
+  // Statistics, stable once the worker is stopped
+  uint64_t completed;
+  uint64_t rejected; // Submits refused with a full queue
+  unsigned int peak; // Highest pending seen
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  int stop;
+} kyber_keccak_offload;
+
+/*************************************************
+ * Name:        kyber_keccak_offload_start
+ *
+ * Description: Starts the emulated accelerator and fills o->backend
+ *
+ * Arguments:   - kyber_keccak_offload *o: accelerator state
+ *              - unsigned int latency_ns: time per permutation
+ *              - unsigned int depth: queue depth (at least 1)
+ *
+ * Returns 0 on success, -1 on bad depth or if the thread could not
+ * be created
+ **************************************************/
+int kyber_keccak_offload_start(kyber_keccak_offload *o,
+                               unsigned int latency_ns, unsigned int depth);
+
+/*************************************************
+ * Name:        kyber_keccak_offload_stop
+ *
+ * Description: Finishes the queued jobs, then stops and joins the
+ *              worker. Unregister the backend first.
+ **************************************************/
+void kyber_keccak_offload_stop(kyber_keccak_offload *o);
+#endif
+
+#endif /* KECCAK_BACKEND_H */
@@ -0,0 +1,74 @@
+#ifndef KECCAK_BI32_H
+#define KECCAK_BI32_H
+
+#include <stdint.h>
+
+/*************************************************
+ * Bit-Interleaved Keccak-f[1600] for 32-bit Cores
+ *
+ * Each 64-bit lane is kept as two 32-bit words: bits 0, 2, ..., 62
+ * (even) in the low word and bits 1, 3, ..., 63 (odd) in the high
+ * word. A 64-bit rotation by 2k is then a rotation of both words by
+ * k, and a rotation by 2k + 1 swaps the words and rotates them by
+ * k + 1 and k, so every rotate is two 32-bit rotates instead of the
+ * four shifts and two ORs a 32-bit compiler emits for a 64-bit ROL.
+ *
+ * Build with -DKYBER_KECCAK_BI32 (Cortex-M, Xtensa, 32-bit RISC-V) to
+ * keep the sponge state of fips202.c in this form: input and output
+ * lanes are converted at absorb and squeeze, once per lane and block,
+ * and the permutation never sees the standard layout.
+ * KeccakF1600_StatePermute() keeps its meaning in both builds.
+ *************************************************/
+
+// Keccak-f[1600] on a state whose lanes are interleaved as above
+void KeccakF1600_StatePermute_bi32(uint64_t state[25]);
+
+// Even bits of x to bits 0-15, odd bits to bits 16-31
+static inline uint32_t keccak_bi32_unzip(uint32_t x) {
+  uint32_t t;
+
+  t = (x ^ (x >> 1)) & 0x22222222u;
+  x ^= t ^ (t << 1);
+  t = (x ^ (x >> 2)) & 0x0C0C0C0Cu;
+  x ^= t ^ (t << 2);
+  t = (x ^ (x >> 4)) & 0x00F000F0u;
+  x ^= t ^ (t << 4);
+  t = (x ^ (x >> 8)) & 0x0000FF00u;
+  x ^= t ^ (t << 8);
+  return x;
+}
+
+// Inverse of keccak_bi32_unzip()
+static inline uint32_t keccak_bi32_zip(uint32_t x) {
+  uint32_t t;
+
+  t = (x ^ (x >> 8)) & 0x0000FF00u;
+  x ^= t ^ (t << 8);
+  t = (x ^ (x >> 4)) & 0x00F000F0u;
+  x ^= t ^ (t << 4);
+  t = (x ^ (x >> 2)) & 0x0C0C0C0Cu;
+  x ^= t ^ (t << 2);
+  t = (x ^ (x >> 1)) & 0x22222222u;
+  x ^= t ^ (t << 1);
+  return x;
+}
+
+// Standard lane to (even word | odd word << 32)
+static inline uint64_t keccak_bi32_interleave(uint64_t lane) {
+  uint32_t lo = keccak_bi32_unzip((uint32_t)lane);
+  uint32_t hi = keccak_bi32_unzip((uint32_t)(lane >> 32));
+
+  return (lo & 0xFFFFu) | (hi << 16) |
+         (uint64_t)((lo >> 16) | (hi & 0xFFFF0000u)) << 32;
+}
+
+// Inverse of keccak_bi32_interleave()
+static inline uint64_t keccak_bi32_deinterleave(uint64_t x) {
+  uint32_t even = (uint32_t)x, odd = (uint32_t)(x >> 32);
+  uint32_t lo = keccak_bi32_zip((even & 0xFFFFu) | (odd << 16));
+  uint32_t hi = keccak_bi32_zip((even >> 16) | (odd & 0xFFFF0000u));
+
+  return lo | (uint64_t)hi << 32;
+}
+
+#endif /* KECCAK_BI32_H */
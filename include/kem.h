@@ -16,8 +16,9 @@
  *              - uint8_t *sk: pointer to output private key
  *                (an already allocated array of KYBER_SECRETKEYBYTES bytes)
  *
- * Returns 0 (success)
+ * Returns 0 on success, -1 if randombytes() failed (sk is then zeroed)
  **************************************************/
+#define crypto_kem_keypair KYBER_NAMESPACE(crypto_kem_keypair)
 int crypto_kem_keypair(uint8_t pk[KYBER_PUBLICKEYBYTES],
                        uint8_t sk[KYBER_SECRETKEYBYTES]);
 
@@ -34,8 +35,10 @@ int crypto_kem_keypair(uint8_t pk[KYBER_PUBLICKEYBYTES],
  *              - const uint8_t *pk: pointer to input public key
  *                (an already allocated array of KYBER_PUBLICKEYBYTES bytes)
  *
- * Returns 0 (success)
+ * Returns 0 on success, -1 if randombytes() failed (ct and ss are not
+ * written)
  **************************************************/
+#define crypto_kem_enc KYBER_NAMESPACE(crypto_kem_enc)
 int crypto_kem_enc(uint8_t ct[KYBER_CIPHERTEXTBYTES], uint8_t ss[KYBER_SSBYTES],
                    const uint8_t pk[KYBER_PUBLICKEYBYTES]);
 
@@ -54,6 +57,7 @@ int crypto_kem_enc(uint8_t ct[KYBER_CIPHERTEXTBYTES], uint8_t ss[KYBER_SSBYTES],
  *
  * Returns 0 for success, -1 for failure (implicit rejection)
  **************************************************/
+#define crypto_kem_dec KYBER_NAMESPACE(crypto_kem_dec)
 int crypto_kem_dec(uint8_t ss[KYBER_SSBYTES],
                    const uint8_t ct[KYBER_CIPHERTEXTBYTES],
                    const uint8_t sk[KYBER_SECRETKEYBYTES]);
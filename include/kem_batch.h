@@ -0,0 +1,99 @@
+#ifndef KEM_BATCH_H
+#define KEM_BATCH_H
+
+#include "params.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************
+ * Multi-threaded Batch KEM API
+ *
+ * Runs arrays of independent KEM operations on an internal
+ * work-stealing thread pool. Item i of every array lives at
+ * offset i * <size of one element>, e.g. pk + i * KYBER_PUBLICKEYBYTES.
+ *
+ * The calling thread works as worker 0; the remaining workers are
+ * persistent helper threads. Concurrent batch calls are serialised.
+ *
+ * Requires POSIX threads (desktop/server targets only).
+ *************************************************/
+
+/*************************************************
+ * Name:        kyber_batch_init
+ *
+ * Description: Starts the batch thread pool. Calling a batch function
+ *              without kyber_batch_init uses one worker per online CPU.
+ *
+ * Arguments:   - unsigned int threads: total workers including the
+ *                caller (0 = number of online CPUs)
+ *
+ * Returns 0 on success, -1 on failure or if already initialised
+ **************************************************/
+#define kyber_batch_init KYBER_NAMESPACE(kyber_batch_init)
+int kyber_batch_init(unsigned int threads);
+
+/*************************************************
+ * Name:        kyber_batch_shutdown
+ *
+ * Description: Stops and joins the helper threads
+ **************************************************/
+#define kyber_batch_shutdown KYBER_NAMESPACE(kyber_batch_shutdown)
+void kyber_batch_shutdown(void);
+
+/*************************************************
+ * Name:        kyber_batch_threads
+ *
+ * Description: Number of workers in the running pool (0 if stopped)
+ **************************************************/
+#define kyber_batch_threads KYBER_NAMESPACE(kyber_batch_threads)
+unsigned int kyber_batch_threads(void);
+
+/*************************************************
+ * Name:        crypto_kem_keypair_batch
+ *
+ * Description: Generates n keypairs
+ *
+ * Arguments:   - uint8_t *pk: output array of n * KYBER_PUBLICKEYBYTES bytes
+ *              - uint8_t *sk: output array of n * KYBER_SECRETKEYBYTES bytes
+ *              - size_t n: number of keypairs
+ *
+ * Returns 0 (success), -1 if the thread pool could not be started or
+ * randombytes() failed for any item (see crypto_kem_keypair)
+ **************************************************/
+#define crypto_kem_keypair_batch KYBER_NAMESPACE(crypto_kem_keypair_batch)
+int crypto_kem_keypair_batch(uint8_t *pk, uint8_t *sk, size_t n);
+
+/*************************************************
+ * Name:        crypto_kem_enc_batch
+ *
+ * Description: Encapsulates against n public keys
+ *
+ * Arguments:   - uint8_t *ct: output array of n * KYBER_CIPHERTEXTBYTES bytes
+ *              - uint8_t *ss: output array of n * KYBER_SSBYTES bytes
+ *              - const uint8_t *pk: n * KYBER_PUBLICKEYBYTES bytes
+ *              - size_t n: number of encapsulations
+ *
+ * Returns 0 (success), -1 if the thread pool could not be started or
+ * randombytes() failed for any item (see crypto_kem_enc)
+ **************************************************/
+#define crypto_kem_enc_batch KYBER_NAMESPACE(crypto_kem_enc_batch)
+int crypto_kem_enc_batch(uint8_t *ct, uint8_t *ss, const uint8_t *pk,
+                         size_t n);
+
+/*************************************************
+ * Name:        crypto_kem_dec_batch
+ *
+ * Description: Decapsulates n ciphertexts, each under its own secret key
+ *
+ * Arguments:   - uint8_t *ss: output array of n * KYBER_SSBYTES bytes
+ *              - const uint8_t *ct: n * KYBER_CIPHERTEXTBYTES bytes
+ *              - const uint8_t *sk: n * KYBER_SECRETKEYBYTES bytes
+ *              - size_t n: number of decapsulations
+ *
+ * Returns 0 (success), -1 if the thread pool could not be started
+ **************************************************/
+#define crypto_kem_dec_batch KYBER_NAMESPACE(crypto_kem_dec_batch)
+int crypto_kem_dec_batch(uint8_t *ss, const uint8_t *ct, const uint8_t *sk,
+                         size_t n);
+
+#endif /* KEM_BATCH_H */
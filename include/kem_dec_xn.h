@@ -0,0 +1,62 @@
+#ifndef KEM_DEC_XN_H
+#define KEM_DEC_XN_H
+
+#include "fips202xn.h"
+#include "params.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************
+ * Vertically Vectorised Batched Decapsulation
+ *
+ * Decapsulates KYBER_XN_LANES ciphertexts under one secret key in a
+ * single pass. Coefficient i of every ciphertext sits next to each
+ * other in memory (lane-major layout), so NTT, basemul, compression
+ * and Keccak run the same instruction over all lanes without any
+ * cross-lane shuffles. The secret key is unpacked and the matrix A
+ * for the re-encryption is expanded only once per batch.
+ *
+ * Stack usage grows with KYBER_XN_LANES; budget roughly
+ * (3 * KYBER_K + 4) * 512 * KYBER_XN_LANES bytes.
+ *************************************************/
+
+/*************************************************
+ * Name:        crypto_kem_dec_xn
+ *
+ * Description: Decapsulates KYBER_XN_LANES ciphertexts under one
+ *              secret key. Output is identical to calling
+ *              crypto_kem_dec on each ciphertext.
+ *
+ * Arguments:   - uint8_t ss[][KYBER_SSBYTES]: KYBER_XN_LANES output
+ *                shared secrets
+ *              - const uint8_t ct[][KYBER_CIPHERTEXTBYTES]:
+ *                KYBER_XN_LANES input ciphertexts
+ *              - const uint8_t *sk: pointer to input private key
+ *                (an already allocated array of KYBER_SECRETKEYBYTES bytes)
+ *
+ * Returns 0
+ **************************************************/
+#define crypto_kem_dec_xn KYBER_NAMESPACE(crypto_kem_dec_xn)
+int crypto_kem_dec_xn(uint8_t ss[KYBER_XN_LANES][KYBER_SSBYTES],
+                      const uint8_t ct[KYBER_XN_LANES][KYBER_CIPHERTEXTBYTES],
+                      const uint8_t sk[KYBER_SECRETKEYBYTES]);
+
+/*************************************************
+ * Name:        crypto_kem_dec_xn_batch
+ *
+ * Description: Decapsulates n ciphertexts under one secret key, using
+ *              the multi-lane kernel for every full group of
+ *              KYBER_XN_LANES and crypto_kem_dec for the remainder
+ *
+ * Arguments:   - uint8_t *ss: output array of n * KYBER_SSBYTES bytes
+ *              - const uint8_t *ct: n * KYBER_CIPHERTEXTBYTES bytes
+ *              - const uint8_t *sk: pointer to input private key
+ *              - size_t n: number of ciphertexts
+ *
+ * Returns 0
+ **************************************************/
+#define crypto_kem_dec_xn_batch KYBER_NAMESPACE(crypto_kem_dec_xn_batch)
+int crypto_kem_dec_xn_batch(uint8_t *ss, const uint8_t *ct,
+                            const uint8_t sk[KYBER_SECRETKEYBYTES], size_t n);
+
+#endif /* KEM_DEC_XN_H */
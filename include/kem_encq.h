@@ -0,0 +1,145 @@
+#ifndef KEM_ENCQ_H
+#define KEM_ENCQ_H
+
+#include "params.h"
+#include "randombytes.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(KYBER_PLATFORM_DESKTOP)
+#include <pthread.h>
+#endif
+
+/*************************************************
+ * Offline/Online Encapsulation Queue
+ *
+ * Encapsulation depends only on the public key and fresh randomness,
+ * so for a fixed server pk the (ct, ss) pairs can be computed while
+ * the device is idle. The queue is bound to one public key and holds
+ * ready pairs in a caller-provided bounded buffer; taking one at
+ * connection time is a copy instead of a full crypto_kem_enc.
+ *
+ * Producer side (exactly one of):
+ *   - kyber_encq_refill_step() from an RTOS idle hook or low-priority
+ *     task, one encapsulation per call
+ *   - kyber_encq_start() background thread (desktop/Linux)
+ * Consumer side: kyber_encq_get() from a single thread/task.
+ *************************************************/
+
+typedef struct {
+  uint8_t ct[KYBER_CIPHERTEXTBYTES];
+  uint8_t ss[KYBER_SSBYTES];
+} kyber_encq_entry;
+
+typedef struct {
+  uint8_t pk[KYBER_PUBLICKEYBYTES];
+  kyber_encq_entry *entries;
+  size_t mask;
+  atomic_size_t head; // Written by the producer only
+  atomic_size_t tail; // Written by the consumer only
+  uint32_t hits;
+  uint32_t misses;
+#if defined(KYBER_PLATFORM_DESKTOP)
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  atomic_int sleeping;
+  atomic_int stop;
+  int running;
+#endif
+} kyber_encq;
+
+/*************************************************
+ * Name:        kyber_encq_init
+ *
+ * Description: Binds a queue to a public key and to caller-owned entry
+ *              storage. No memory is allocated, so the queue and its
+ *              entries can live in static RAM on MCU targets.
+ *
+ * Arguments:   - kyber_encq *q: queue to initialise
+ *              - const uint8_t *pk: public key to encapsulate against
+ *                (of length KYBER_PUBLICKEYBYTES bytes, copied)
+ *              - kyber_encq_entry *entries: storage for queued pairs
+ *              - size_t capacity: number of entries (power of two)
+ *
+ * Returns 0 on success, -1 if capacity is not a power of two
+ **************************************************/
+#define kyber_encq_init KYBER_NAMESPACE(kyber_encq_init)
+int kyber_encq_init(kyber_encq *q, const uint8_t pk[KYBER_PUBLICKEYBYTES],
+                    kyber_encq_entry *entries, size_t capacity);
+
+/*************************************************
+ * Name:        kyber_encq_refill_step
+ *
+ * Description: Runs one crypto_kem_enc into the next free entry.
+ *              Intended for an RTOS idle hook; does nothing if full.
+ *
+ * Arguments:   - kyber_encq *q: queue
+ *
+ * Returns 1 if an entry was produced, 0 if the queue is full, -1 if
+ * randombytes() failed (nothing is queued)
+ **************************************************/
+#define kyber_encq_refill_step KYBER_NAMESPACE(kyber_encq_refill_step)
+int kyber_encq_refill_step(kyber_encq *q);
+
+/*************************************************
+ * Name:        kyber_encq_get
+ *
+ * Description: Takes one ready (ct, ss) pair. The shared secret is
+ *              wiped from the queue as it is consumed. If the queue is
+ *              empty, crypto_kem_enc runs inline and a miss is counted.
+ *
+ * Arguments:   - kyber_encq *q: queue
+ *              - uint8_t *ct: pointer to output cipher text
+ *                (an already allocated array of KYBER_CIPHERTEXTBYTES bytes)
+ *              - uint8_t *ss: pointer to output shared secret
+ *                (an already allocated array of KYBER_SSBYTES bytes)
+ *
+ * Returns 0 on success, -1 if the queue was empty and crypto_kem_enc
+ * failed
+ **************************************************/
+#define kyber_encq_get KYBER_NAMESPACE(kyber_encq_get)
+int kyber_encq_get(kyber_encq *q, uint8_t ct[KYBER_CIPHERTEXTBYTES],
+                   uint8_t ss[KYBER_SSBYTES]);
+
+/*************************************************
+ * Name:        kyber_encq_fill
+ *
+ * Description: Number of ready pairs in the queue
+ **************************************************/
+#define kyber_encq_fill KYBER_NAMESPACE(kyber_encq_fill)
+size_t kyber_encq_fill(const kyber_encq *q);
+
+/*************************************************
+ * Name:        kyber_encq_clear
+ *
+ * Description: Drops all queued pairs and wipes their shared secrets.
+ *              The producer must be stopped first.
+ **************************************************/
+#define kyber_encq_clear KYBER_NAMESPACE(kyber_encq_clear)
+void kyber_encq_clear(kyber_encq *q);
+
+#if defined(KYBER_PLATFORM_DESKTOP)
+/*************************************************
+ * Name:        kyber_encq_start
+ *
+ * Description: Starts a background thread that keeps the queue full.
+ *              The thread sleeps while the queue is full and is woken
+ *              by kyber_encq_get.
+ *
+ * Returns 0 on success, -1 if the thread could not be created
+ **************************************************/
+#define kyber_encq_start KYBER_NAMESPACE(kyber_encq_start)
+int kyber_encq_start(kyber_encq *q);
+
+/*************************************************
+ * Name:        kyber_encq_stop
+ *
+ * Description: Stops and joins the background thread
+ **************************************************/
+#define kyber_encq_stop KYBER_NAMESPACE(kyber_encq_stop)
+void kyber_encq_stop(kyber_encq *q);
+#endif
+
+#endif /* KEM_ENCQ_H */
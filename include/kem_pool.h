@@ -0,0 +1,95 @@
+#ifndef KEM_POOL_H
+#define KEM_POOL_H
+
+#include "params.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************
+ * Precomputed Keypair Pool
+ *
+ * Fixed-capacity lock-free ring of pre-generated (pk, sk) pairs for
+ * servers that use one ephemeral Kyber key per session. Background
+ * worker threads run crypto_kem_keypair and refill the ring whenever
+ * its fill level drops below the low watermark, so a pool hit on the
+ * connection-setup path costs only a dequeue.
+ *
+ * Requires POSIX threads (desktop/server targets only).
+ *************************************************/
+
+typedef struct {
+  size_t capacity;      // Number of keypairs held (rounded up to 2^n)
+  size_t low_watermark; // Workers start refilling below this fill level
+  unsigned int threads; // Number of background keygen workers
+} kyber_keypair_pool_config;
+
+typedef struct {
+  uint64_t hits;      // Keypairs served from the ring
+  uint64_t misses;    // Keypairs generated inline because ring was empty
+  uint64_t generated; // Keypairs produced by the background workers
+  size_t fill;        // Keypairs currently ready in the ring
+} kyber_keypair_pool_stats;
+
+typedef struct kyber_keypair_pool kyber_keypair_pool;
+
+/*************************************************
+ * Name:        kyber_keypair_pool_create
+ *
+ * Description: Allocates a keypair pool and starts its worker threads.
+ *              Workers immediately begin filling the ring to capacity.
+ *
+ * Arguments:   - kyber_keypair_pool **pool: output pool handle
+ *              - const kyber_keypair_pool_config *cfg: pool configuration
+ *
+ * Returns 0 on success, -1 on invalid configuration or allocation failure
+ **************************************************/
+#define kyber_keypair_pool_create KYBER_NAMESPACE(kyber_keypair_pool_create)
+int kyber_keypair_pool_create(kyber_keypair_pool **pool,
+                              const kyber_keypair_pool_config *cfg);
+
+/*************************************************
+ * Name:        kyber_keypair_pool_get
+ *
+ * Description: Takes one keypair out of the pool. The pool slot holding
+ *              the secret key is wiped before it is handed back to the
+ *              workers. If the ring is empty, a keypair is generated
+ *              inline and counted as a miss.
+ *
+ * Arguments:   - kyber_keypair_pool *pool: pool handle
+ *              - uint8_t *pk: pointer to output public key
+ *                (an already allocated array of KYBER_PUBLICKEYBYTES bytes)
+ *              - uint8_t *sk: pointer to output private key
+ *                (an already allocated array of KYBER_SECRETKEYBYTES bytes)
+ *
+ * Returns 0 on success, -1 if the ring was empty and crypto_kem_keypair
+ * failed
+ **************************************************/
+#define kyber_keypair_pool_get KYBER_NAMESPACE(kyber_keypair_pool_get)
+int kyber_keypair_pool_get(kyber_keypair_pool *pool,
+                           uint8_t pk[KYBER_PUBLICKEYBYTES],
+                           uint8_t sk[KYBER_SECRETKEYBYTES]);
+
+/*************************************************
+ * Name:        kyber_keypair_pool_get_stats
+ *
+ * Description: Reads the hit/miss counters and current fill level
+ *
+ * Arguments:   - const kyber_keypair_pool *pool: pool handle
+ *              - kyber_keypair_pool_stats *stats: output statistics
+ **************************************************/
+#define kyber_keypair_pool_get_stats KYBER_NAMESPACE(kyber_keypair_pool_get_stats)
+void kyber_keypair_pool_get_stats(const kyber_keypair_pool *pool,
+                                  kyber_keypair_pool_stats *stats);
+
+/*************************************************
+ * Name:        kyber_keypair_pool_destroy
+ *
+ * Description: Stops the worker threads, wipes all pooled secret keys
+ *              and frees the pool
+ *
+ * Arguments:   - kyber_keypair_pool *pool: pool handle (may be NULL)
+ **************************************************/
+#define kyber_keypair_pool_destroy KYBER_NAMESPACE(kyber_keypair_pool_destroy)
+void kyber_keypair_pool_destroy(kyber_keypair_pool *pool);
+
+#endif /* KEM_POOL_H */
@@ -0,0 +1,201 @@
+#ifndef KEM_STEP_H
+#define KEM_STEP_H
+
+#include "fips202.h"
+#include "params.h"
+#include "polyvec.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************
+ * Resumable (Time-Sliced) KEM Operations
+ *
+ * Incremental versions of crypto_kem_keypair/enc/dec for cooperative
+ * schedulers. Each *_step call does one bounded unit of work: one
+ * matrix entry (SHAKE128 + rejection sampling + basemul), one noise
+ * polynomial, one (inverse) NTT or one SHA3-256 block of H(pk)/H(c),
+ * then returns. All state lives in a caller-owned context, so a task
+ * can yield between steps and resume later; matrix entries are
+ * generated on the fly instead of storing A.
+ *
+ * Usage:
+ *   kyber_dec_start(&ctx, ss, ct, sk);
+ *   while (kyber_dec_step(&ctx) == KYBER_STEP_MORE)
+ *     yield();
+ *   kyber_dec_finish(&ctx);
+ *
+ * The buffers passed to *_start must stay valid until *_finish.
+ * Outputs are identical to the monolithic functions for the same
+ * randombytes() stream.
+ *
+ * Context sizes: keypair (KYBER_K + 3) polys, enc (2 * KYBER_K + 3)
+ * polys, dec the same plus one ciphertext; a poly is 512 bytes.
+ *************************************************/
+
+#define KYBER_STEP_DONE 0
+#define KYBER_STEP_MORE 1
+
+// Re-encryption state shared by encapsulation and decapsulation
+typedef struct {
+  int phase;
+  unsigned int i, j;
+  polyvec sp; // r in NTT domain
+  polyvec b;  // u, built row by row
+  poly v;
+  poly a; // current matrix entry / public key polynomial
+  poly t; // scratch
+} kyber_indcpa_enc_state;
+
+typedef struct {
+  int phase;
+  unsigned int i, j;
+  size_t off; // bytes of pk absorbed into H(pk)
+  uint8_t *pk;
+  uint8_t *sk;
+  uint8_t seed[2 * KYBER_SYMBYTES]; // publicseed || noiseseed
+  keccak_state hash;
+  polyvec skpv;
+  poly row; // current row of t = As + e
+  poly a;
+  poly t;
+} kyber_keypair_ctx;
+
+typedef struct {
+  int phase;
+  size_t off; // bytes absorbed into the running SHA3-256
+  uint8_t *ct;
+  uint8_t *ss;
+  const uint8_t *pk;
+  uint8_t buf[2 * KYBER_SYMBYTES];
+  uint8_t kr[2 * KYBER_SYMBYTES];
+  keccak_state hash;
+  kyber_indcpa_enc_state enc;
+} kyber_enc_ctx;
+
+typedef struct {
+  int phase;
+  size_t off;
+  uint8_t *ss;
+  const uint8_t *ct;
+  const uint8_t *sk;
+  uint8_t buf[2 * KYBER_SYMBYTES];
+  uint8_t kr[2 * KYBER_SYMBYTES];
+  uint8_t cmp[KYBER_CIPHERTEXTBYTES];
+  keccak_state hash;
+  kyber_indcpa_enc_state enc; // also holds u and m' while decrypting
+} kyber_dec_ctx;
+
+/*************************************************
+ * Name:        kyber_keypair_start
+ *
+ * Description: Prepares an incremental crypto_kem_keypair
+ *
+ * Arguments:   - kyber_keypair_ctx *ctx: caller-owned context
+ *              - uint8_t *pk: output public key
+ *                (an already allocated array of KYBER_PUBLICKEYBYTES bytes)
+ *              - uint8_t *sk: output private key
+ *                (an already allocated array of KYBER_SECRETKEYBYTES bytes)
+ **************************************************/
+#define kyber_keypair_start KYBER_NAMESPACE(kyber_keypair_start)
+void kyber_keypair_start(kyber_keypair_ctx *ctx,
+                         uint8_t pk[KYBER_PUBLICKEYBYTES],
+                         uint8_t sk[KYBER_SECRETKEYBYTES]);
+
+/*************************************************
+ * Name:        kyber_keypair_step
+ *
+ * Description: Runs one bounded unit of key generation
+ *
+ * Returns KYBER_STEP_MORE if more steps are needed, KYBER_STEP_DONE
+ * when pk and sk are complete, -1 if randombytes() failed
+ **************************************************/
+#define kyber_keypair_step KYBER_NAMESPACE(kyber_keypair_step)
+int kyber_keypair_step(kyber_keypair_ctx *ctx);
+
+/*************************************************
+ * Name:        kyber_keypair_finish
+ *
+ * Description: Runs any remaining steps and wipes the context
+ *
+ * Returns 0 on success, -1 if randombytes() failed
+ **************************************************/
+#define kyber_keypair_finish KYBER_NAMESPACE(kyber_keypair_finish)
+int kyber_keypair_finish(kyber_keypair_ctx *ctx);
+
+/*************************************************
+ * Name:        kyber_enc_start
+ *
+ * Description: Prepares an incremental crypto_kem_enc
+ *
+ * Arguments:   - kyber_enc_ctx *ctx: caller-owned context
+ *              - uint8_t *ct: output cipher text
+ *                (an already allocated array of KYBER_CIPHERTEXTBYTES bytes)
+ *              - uint8_t *ss: output shared secret
+ *                (an already allocated array of KYBER_SSBYTES bytes)
+ *              - const uint8_t *pk: input public key
+ *                (an already allocated array of KYBER_PUBLICKEYBYTES bytes)
+ **************************************************/
+#define kyber_enc_start KYBER_NAMESPACE(kyber_enc_start)
+void kyber_enc_start(kyber_enc_ctx *ctx, uint8_t ct[KYBER_CIPHERTEXTBYTES],
+                     uint8_t ss[KYBER_SSBYTES],
+                     const uint8_t pk[KYBER_PUBLICKEYBYTES]);
+
+/*************************************************
+ * Name:        kyber_enc_step
+ *
+ * Description: Runs one bounded unit of encapsulation
+ *
+ * Returns KYBER_STEP_MORE, KYBER_STEP_DONE, or -1 if randombytes() failed
+ **************************************************/
+#define kyber_enc_step KYBER_NAMESPACE(kyber_enc_step)
+int kyber_enc_step(kyber_enc_ctx *ctx);
+
+/*************************************************
+ * Name:        kyber_enc_finish
+ *
+ * Description: Runs any remaining steps and wipes the context
+ *
+ * Returns 0 on success, -1 if randombytes() failed
+ **************************************************/
+#define kyber_enc_finish KYBER_NAMESPACE(kyber_enc_finish)
+int kyber_enc_finish(kyber_enc_ctx *ctx);
+
+/*************************************************
+ * Name:        kyber_dec_start
+ *
+ * Description: Prepares an incremental crypto_kem_dec
+ *
+ * Arguments:   - kyber_dec_ctx *ctx: caller-owned context
+ *              - uint8_t *ss: output shared secret
+ *                (an already allocated array of KYBER_SSBYTES bytes)
+ *              - const uint8_t *ct: input cipher text
+ *                (an already allocated array of KYBER_CIPHERTEXTBYTES bytes)
+ *              - const uint8_t *sk: input private key
+ *                (an already allocated array of KYBER_SECRETKEYBYTES bytes)
+ **************************************************/
+#define kyber_dec_start KYBER_NAMESPACE(kyber_dec_start)
+void kyber_dec_start(kyber_dec_ctx *ctx, uint8_t ss[KYBER_SSBYTES],
+                     const uint8_t ct[KYBER_CIPHERTEXTBYTES],
+                     const uint8_t sk[KYBER_SECRETKEYBYTES]);
+
+/*************************************************
+ * Name:        kyber_dec_step
+ *
+ * Description: Runs one bounded unit of decapsulation
+ *
+ * Returns KYBER_STEP_MORE or KYBER_STEP_DONE
+ **************************************************/
+#define kyber_dec_step KYBER_NAMESPACE(kyber_dec_step)
+int kyber_dec_step(kyber_dec_ctx *ctx);
+
+/*************************************************
+ * Name:        kyber_dec_finish
+ *
+ * Description: Runs any remaining steps and wipes the context
+ *
+ * Returns 0
+ **************************************************/
+#define kyber_dec_finish KYBER_NAMESPACE(kyber_dec_finish)
+int kyber_dec_finish(kyber_dec_ctx *ctx);
+
+#endif /* KEM_STEP_H */
@@ -0,0 +1,120 @@
+#ifndef KYBER_DISPATCH_H
+#define KYBER_DISPATCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************
+ * Runtime Parameter-Set Dispatch
+ *
+ * Selects Kyber-512/768/1024 by ID at runtime. Each set is compiled
+ * fully specialised for its own KYBER_K (see KYBER_NAMESPACE in
+ * params.h); dispatch costs one table lookup and an indirect call.
+ *
+ * In a library built with KYBER_MULTI_PARAMS all three sets are
+ * available. In a regular single-set build only the set matching
+ * KYBER_K is, and the other IDs report failure.
+ *
+ * This header does not depend on KYBER_K and can be included next to
+ * any single-set header.
+ *************************************************/
+
+typedef enum {
+  KYBER_PARAM_512 = 2,
+  KYBER_PARAM_768 = 3,
+  KYBER_PARAM_1024 = 4
+} kyber_param_id;
+
+// Sizes per parameter set, for sizing buffers without params.h
+#define KYBER512_PUBLICKEYBYTES 800
+#define KYBER512_SECRETKEYBYTES 1632
+#define KYBER512_CIPHERTEXTBYTES 768
+
+#define KYBER768_PUBLICKEYBYTES 1184
+#define KYBER768_SECRETKEYBYTES 2400
+#define KYBER768_CIPHERTEXTBYTES 1088
+
+#define KYBER1024_PUBLICKEYBYTES 1568
+#define KYBER1024_SECRETKEYBYTES 3168
+#define KYBER1024_CIPHERTEXTBYTES 1568
+
+// Shared secret length, the same for every set
+#define KYBER_ALL_SSBYTES 32
+
+#define KYBER_MAX_PUBLICKEYBYTES KYBER1024_PUBLICKEYBYTES
+#define KYBER_MAX_SECRETKEYBYTES KYBER1024_SECRETKEYBYTES
+#define KYBER_MAX_CIPHERTEXTBYTES KYBER1024_CIPHERTEXTBYTES
+
+/*************************************************
+ * Name:        kyber_kem_impl
+ *
+ * Description: One compiled parameter set: sizes and entry points
+ *************************************************/
+typedef struct {
+  kyber_param_id id;
+  const char *name;
+  size_t publickeybytes;
+  size_t secretkeybytes;
+  size_t ciphertextbytes;
+  size_t ssbytes;
+  int (*keypair)(uint8_t *pk, uint8_t *sk);
+  int (*enc)(uint8_t *ct, uint8_t *ss, const uint8_t *pk);
+  int (*dec)(uint8_t *ss, const uint8_t *ct, const uint8_t *sk);
+} kyber_kem_impl;
+
+/*************************************************
+ * Name:        kyber_kem_get
+ *
+ * Description: Looks up a parameter set. Callers on a hot path can
+ *              keep the returned pointer and call through it directly.
+ *
+ * Arguments:   - kyber_param_id id: parameter set
+ *
+ * Returns pointer to the set, NULL if it is not built into the library
+ **************************************************/
+const kyber_kem_impl *kyber_kem_get(kyber_param_id id);
+
+/*************************************************
+ * Name:        kyber_kem_keypair
+ *
+ * Description: crypto_kem_keypair of the selected parameter set
+ *
+ * Arguments:   - kyber_param_id id: parameter set
+ *              - uint8_t *pk: output public key (publickeybytes)
+ *              - uint8_t *sk: output private key (secretkeybytes)
+ *
+ * Returns 0 (success), -1 if the set is not available
+ **************************************************/
+int kyber_kem_keypair(kyber_param_id id, uint8_t *pk, uint8_t *sk);
+
+/*************************************************
+ * Name:        kyber_kem_enc
+ *
+ * Description: crypto_kem_enc of the selected parameter set
+ *
+ * Arguments:   - kyber_param_id id: parameter set
+ *              - uint8_t *ct: output cipher text (ciphertextbytes)
+ *              - uint8_t *ss: output shared secret (ssbytes)
+ *              - const uint8_t *pk: input public key (publickeybytes)
+ *
+ * Returns 0 (success), -1 if the set is not available
+ **************************************************/
+int kyber_kem_enc(kyber_param_id id, uint8_t *ct, uint8_t *ss,
+                  const uint8_t *pk);
+
+/*************************************************
+ * Name:        kyber_kem_dec
+ *
+ * Description: crypto_kem_dec of the selected parameter set
+ *
+ * Arguments:   - kyber_param_id id: parameter set
+ *              - uint8_t *ss: output shared secret (ssbytes)
+ *              - const uint8_t *ct: input cipher text (ciphertextbytes)
+ *              - const uint8_t *sk: input private key (secretkeybytes)
+ *
+ * Returns 0 (success), -1 if the set is not available
+ **************************************************/
+int kyber_kem_dec(kyber_param_id id, uint8_t *ss, const uint8_t *ct,
+                  const uint8_t *sk);
+
+#endif /* KYBER_DISPATCH_H */
@@ -0,0 +1,127 @@
+#ifndef KYBER_METRICS_H
+#define KYBER_METRICS_H
+
+#include "kyber_profile.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************
+ * Operational Metrics
+ *
+ * Counters for production monitoring: number of keygens, encaps and
+ * decaps, their latency distribution, and how many decapsulations
+ * took the implicit-rejection path (a rising rate means corrupted or
+ * forged ciphertexts). Build the library with -DKYBER_METRICS to
+ * enable; otherwise the hooks compile to nothing and snapshots are
+ * all zero.
+ *
+ * Each thread updates one of KYBER_METRICS_SHARDS cache-line aligned
+ * shards with relaxed atomic adds: no locks, and threads only share a
+ * shard once there are more of them than shards. The hot path costs
+ * two clock reads and five to seven uncontended adds per operation.
+ * Exports sum the shards, each read while no update to it is in
+ * flight, so the counts, sums and buckets of a snapshot agree.
+ * On MCUs the counters are 32-bit atomics; each latency sum is kept
+ * in two of them, so it does not wrap after a few thousand operations.
+ *
+ * Latencies are in nanoseconds on Linux/macOS and in
+ * kyber_cycles_read() cycles elsewhere; the first operation timed
+ * calls kyber_cycles_init(), so the application need not enable the
+ * counter (on Cortex-M this restarts DWT CYCCNT from zero once).
+ * They are bucketed by powers of two:
+ * bucket 0 counts latencies <= 1, bucket b counts (2^(b-1), 2^b] and
+ * the last bucket also everything above.
+ *
+ * The rejection counter is updated without branching on the result
+ * of the ciphertext comparison, so decapsulation stays constant time.
+ *
+ * Every KEM entry point is counted. crypto_kem_dec_xn and the batch
+ * paths built on it time each group of lanes once and record every
+ * lane with its share, the group time divided by the lane count. The
+ * time-sliced operations of kem_step.h are counted when they finish
+ * but not timed: their wall time depends on the caller's scheduling,
+ * so they are in kyber_ops_total but not in the latency histogram.
+ *************************************************/
+
+#ifndef KYBER_METRICS_SHARDS
+#define KYBER_METRICS_SHARDS 16
+#endif
+
+#define KYBER_METRICS_BUCKETS 32
+#define KYBER_METRICS_VERSION 1
+
+#define KYBER_METRICS_UNIT_NS 0
+#define KYBER_METRICS_UNIT_CYCLES 1
+
+// Plain snapshot of all counters, summed over the shards
+typedef struct {
+  uint32_t version; // KYBER_METRICS_VERSION
+  uint32_t unit;    // KYBER_METRICS_UNIT_*
+  uint64_t ops[KYBER_OP_COUNT];
+  uint64_t latency_sum[KYBER_OP_COUNT];
+  uint64_t latency_hist[KYBER_OP_COUNT][KYBER_METRICS_BUCKETS];
+  uint64_t rejections; // decapsulations that returned the implicit key
+} kyber_metrics_snapshot;
+
+/*************************************************
+ * Name:        kyber_metrics_read
+ *
+ * Description: Sums all shards into a snapshot. Safe to call while
+ *              other threads are running KEM operations; an operation
+ *              that finishes concurrently is either fully included or
+ *              not at all (a shard busy for several retries in a row
+ *              is taken as read, and may be off by that operation;
+ *              on MCUs its latency sum may then be off by 2^32).
+ *
+ * Arguments:   - kyber_metrics_snapshot *out: output snapshot
+ **************************************************/
+void kyber_metrics_read(kyber_metrics_snapshot *out);
+
+/*************************************************
+ * Name:        kyber_metrics_reset
+ *
+ * Description: Zeroes all shards. Counts from operations running
+ *              concurrently may survive the reset.
+ **************************************************/
+void kyber_metrics_reset(void);
+
+/*************************************************
+ * Name:        kyber_metrics_prometheus
+ *
+ * Description: Formats a snapshot in the Prometheus text exposition
+ *              format (kyber_ops_total, kyber_implicit_rejections_total
+ *              and a kyber_op_latency_seconds histogram; the histogram
+ *              is kyber_op_latency_cycles on MCUs). The histogram's
+ *              +Inf bucket and _count are its bucket total.
+ *
+ * Arguments:   - const kyber_metrics_snapshot *s: snapshot to format
+ *              - char *buf: output buffer
+ *              - size_t len: size of buf
+ *
+ * Returns the length of the full text like snprintf; the output was
+ * truncated if the return value is >= len
+ **************************************************/
+size_t kyber_metrics_prometheus(const kyber_metrics_snapshot *s, char *buf,
+                                size_t len);
+
+#if defined(KYBER_METRICS)
+void kyber_metrics_op_begin(kyber_op op);
+void kyber_metrics_op_end(kyber_op op);
+void kyber_metrics_op_end_n(kyber_op op, unsigned int n);
+void kyber_metrics_op_untimed(kyber_op op);
+void kyber_metrics_rejection(uint8_t fail);
+
+#define KYBER_METRICS_OP_BEGIN(op) kyber_metrics_op_begin(op)
+#define KYBER_METRICS_OP_END(op) kyber_metrics_op_end(op)
+#define KYBER_METRICS_OP_END_N(op, n) kyber_metrics_op_end_n(op, n)
+#define KYBER_METRICS_OP_UNTIMED(op) kyber_metrics_op_untimed(op)
+#define KYBER_METRICS_REJECTION(fail) kyber_metrics_rejection(fail)
+#else
+#define KYBER_METRICS_OP_BEGIN(op) ((void)0)
+#define KYBER_METRICS_OP_END(op) ((void)0)
+#define KYBER_METRICS_OP_END_N(op, n) ((void)0)
+#define KYBER_METRICS_OP_UNTIMED(op) ((void)0)
+#define KYBER_METRICS_REJECTION(fail) ((void)(fail))
+#endif
+
+#endif /* KYBER_METRICS_H */
@@ -0,0 +1,120 @@
+#ifndef KYBER_PROFILE_H
+#define KYBER_PROFILE_H
+
+#include "kyber_trace.h"
+#include <stdint.h>
+
+/*************************************************
+ * Phase Profiler
+ *
+ * Optional instrumentation of the KEM hot paths. Build the library
+ * with -DKYBER_PROFILE to enable it; otherwise every hook below
+ * expands to nothing and the library is unchanged.
+ *
+ * Each phase of indcpa_keypair/enc/dec and crypto_kem_* accumulates
+ * its cycles (kyber_cycles_read() from platform.h) and the number of
+ * Keccak-f[1600] permutations run while it was active. Whole KEM
+ * operations are counted separately, so the untracked remainder is
+ * op_cycles minus the sum of the phases.
+ *
+ * Statistics are per thread on desktop and ESP32 and global on the
+ * single-threaded MCU targets. A permutation handed to an asynchronous
+ * Keccak backend (keccak_backend.h) is counted when it is submitted,
+ * on the submitting thread, wherever it then runs. Where the platform
+ * has no cycle counter only the call and permutation counts are filled
+ * in.
+ *************************************************/
+
+typedef enum {
+  KYBER_PHASE_OTHER = 0,  // outside any phase below
+  KYBER_PHASE_RANDOMBYTES, // randombytes()
+  KYBER_PHASE_GEN_MATRIX,  // expansion of A from the public seed
+  KYBER_PHASE_NOISE,       // PRF + CBD sampling
+  KYBER_PHASE_NTT,         // forward NTTs
+  KYBER_PHASE_INVNTT,      // inverse NTTs
+  KYBER_PHASE_MATVEC,      // basemul / accumulate, additions, reductions
+  KYBER_PHASE_PACK,        // (de)serialisation and (de)compression
+  KYBER_PHASE_HASH,        // G, H and KDF of the FO transform
+  KYBER_PHASE_COUNT
+} kyber_phase;
+
+typedef enum {
+  KYBER_OP_KEYPAIR = 0,
+  KYBER_OP_ENC,
+  KYBER_OP_DEC,
+  KYBER_OP_COUNT
+} kyber_op;
+
+typedef struct {
+  uint64_t cycles[KYBER_PHASE_COUNT];
+  uint64_t calls[KYBER_PHASE_COUNT];
+  uint64_t keccak[KYBER_PHASE_COUNT]; // permutations per phase
+  uint64_t op_cycles[KYBER_OP_COUNT];
+  uint64_t op_calls[KYBER_OP_COUNT];
+} kyber_profile_stats;
+
+/*************************************************
+ * Name:        kyber_profile_read
+ *
+ * Description: Copies the calling thread's statistics
+ *
+ * Arguments:   - kyber_profile_stats *out: output statistics
+ *                (all zero if the library was built without
+ *                KYBER_PROFILE)
+ **************************************************/
+void kyber_profile_read(kyber_profile_stats *out);
+
+/*************************************************
+ * Name:        kyber_profile_reset
+ *
+ * Description: Clears the calling thread's statistics and starts the
+ *              cycle counter where it needs enabling (STM32 DWT)
+ **************************************************/
+void kyber_profile_reset(void);
+
+/*************************************************
+ * Name:        kyber_profile_phase_name
+ *
+ * Description: Short name of a phase, for reports
+ **************************************************/
+const char *kyber_profile_phase_name(kyber_phase phase);
+
+/*************************************************
+ * Instrumentation hooks (library internal)
+ *
+ * Phases do not nest: each BEGIN is matched by the END of the same
+ * phase before the next BEGIN. Ops enclose phases. Phase boundaries
+ * also fire the phase_begin/phase_end USDT probes (kyber_trace.h).
+ *************************************************/
+#if defined(KYBER_PROFILE)
+void kyber_profile_begin(kyber_phase phase);
+void kyber_profile_end(kyber_phase phase);
+void kyber_profile_op_begin(kyber_op op);
+void kyber_profile_op_end(kyber_op op);
+void kyber_profile_keccak(void);
+
+#define KYBER_PROFILE_BEGIN_(phase) kyber_profile_begin(phase)
+#define KYBER_PROFILE_END_(phase) kyber_profile_end(phase)
+#define KYBER_PROFILE_OP_BEGIN(op) kyber_profile_op_begin(op)
+#define KYBER_PROFILE_OP_END(op) kyber_profile_op_end(op)
+#define KYBER_PROFILE_KECCAK() kyber_profile_keccak()
+#else
+#define KYBER_PROFILE_BEGIN_(phase) ((void)0)
+#define KYBER_PROFILE_END_(phase) ((void)0)
+#define KYBER_PROFILE_OP_BEGIN(op) ((void)0)
+#define KYBER_PROFILE_OP_END(op) ((void)0)
+#define KYBER_PROFILE_KECCAK() ((void)0)
+#endif
+
+#define KYBER_PROFILE_BEGIN(phase)                                             \
+  do {                                                                         \
+    KYBER_TRACE_PHASE(phase_begin, phase);                                     \
+    KYBER_PROFILE_BEGIN_(phase);                                               \
+  } while (0)
+#define KYBER_PROFILE_END(phase)                                               \
+  do {                                                                         \
+    KYBER_PROFILE_END_(phase);                                                 \
+    KYBER_TRACE_PHASE(phase_end, phase);                                       \
+  } while (0)
+
+#endif /* KYBER_PROFILE_H */
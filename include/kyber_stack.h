@@ -0,0 +1,61 @@
+#ifndef KYBER_STACK_H
+#define KYBER_STACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*************************************************
+ * Stack and Working-Set Measurement
+ *
+ * Measures the stack a call really uses by painting: the region below
+ * the current stack pointer is filled with a known pattern, the
+ * function runs on top of it, and the region is scanned afterwards.
+ * The deepest overwritten byte gives the high-water mark; the number
+ * of 64-byte lines that were written at all gives the stack part of
+ * the L1 data working set. Figures count from the measuring frame's
+ * stack pointer, so the call's return address is included, and
+ * anything else running on the same stack, such as interrupt handlers
+ * on an MCU, is included too.
+ *
+ * The painted region is KYBER_STACK_PAINT_BYTES long; it must fit in
+ * the free stack of the calling thread. If the function goes deeper
+ * the result is saturated and only a lower bound.
+ *
+ * The stack pointer is read with inline assembly on x86, Arm,
+ * RISC-V and Xtensa; elsewhere measuring fails. Writing below the
+ * stack pointer is outside what AddressSanitizer models (and its fake
+ * stacks move locals off the stack), so do not measure in ASan builds.
+ *
+ * This is a diagnostic for sizing task stacks, not for production
+ * paths. For the static worst case per call graph, build with
+ * -fstack-usage -fcallgraph-info=su and run bench/stack_usage.py.
+ *************************************************/
+
+#ifndef KYBER_STACK_PAINT_BYTES
+#define KYBER_STACK_PAINT_BYTES 32768
+#endif
+
+#define KYBER_STACK_LINE_BYTES 64
+
+typedef struct {
+  size_t stack_bytes; // high-water mark below the caller's frame
+  size_t stack_lines; // distinct 64-byte stack lines written
+  int saturated;      // 1 if the whole painted region was used
+} kyber_stack_usage;
+
+/*************************************************
+ * Name:        kyber_stack_measure
+ *
+ * Description: Runs fn(arg) on a painted stack and reports how much
+ *              of it was used
+ *
+ * Arguments:   - kyber_stack_usage *u: output usage
+ *              - void (*fn)(void *): function to measure
+ *              - void *arg: argument passed to fn
+ *
+ * Returns 0 on success, -1 if the painted region was exhausted or the
+ * target's stack pointer cannot be read
+ **************************************************/
+int kyber_stack_measure(kyber_stack_usage *u, void (*fn)(void *), void *arg);
+
+#endif /* KYBER_STACK_H */
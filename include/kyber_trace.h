@@ -0,0 +1,48 @@
+#ifndef KYBER_TRACE_H
+#define KYBER_TRACE_H
+
+#include "platform.h"
+
+/*************************************************
+ * USDT Tracepoints (Linux)
+ *
+ * Build the library with -DKYBER_USDT (needs <sys/sdt.h> from the
+ * systemtap-sdt-dev / systemtap-sdt-devel package) to place static
+ * probes of provider "kyber" at KEM operation and phase boundaries.
+ * A probe is a single nop until a tracer attaches, so they can stay
+ * compiled into production builds.
+ *
+ *   keypair_entry / keypair_return   crypto_kem_keypair
+ *   enc_entry / enc_return           crypto_kem_enc
+ *   dec_entry / dec_return           crypto_kem_dec
+ *   phase_begin / phase_end          indcpa and FO phases, see
+ *                                    kyber_phase in kyber_profile.h
+ *
+ * Arguments: arg0 = KYBER_K (2, 3, 4; the kyber_param_id), arg1 =
+ * KYBER_BACKEND_ID, and for phase probes arg2 = kyber_phase.
+ *
+ * Example, decapsulation latency histogram per parameter set:
+ *   bpftrace -e 'usdt:./app:kyber:dec_entry { @s[tid] = nsecs; }
+ *     usdt:./app:kyber:dec_return /@s[tid]/ {
+ *       @us[arg0] = hist((nsecs - @s[tid]) / 1000); delete(@s[tid]); }'
+ *
+ * With perf: perf buildid-cache --add ./app; perf probe sdt_kyber:'*';
+ * perf record -e 'sdt_kyber:*' -a.
+ *
+ * KYBER_K is taken from the including translation unit; the macros
+ * are only used in per-parameter-set sources.
+ *************************************************/
+
+#if defined(KYBER_USDT) && defined(__linux__)
+#include <sys/sdt.h>
+
+#define KYBER_TRACE(name)                                                      \
+  DTRACE_PROBE2(kyber, name, KYBER_K, KYBER_BACKEND_ID)
+#define KYBER_TRACE_PHASE(name, phase)                                         \
+  DTRACE_PROBE3(kyber, name, KYBER_K, KYBER_BACKEND_ID, (int)(phase))
+#else
+#define KYBER_TRACE(name) ((void)0)
+#define KYBER_TRACE_PHASE(name, phase) ((void)0)
+#endif
+
+#endif /* KYBER_TRACE_H */
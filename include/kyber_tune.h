@@ -0,0 +1,168 @@
+#ifndef KYBER_TUNE_H
+#define KYBER_TUNE_H
+
+#include "randombytes.h"
+#include <stdint.h>
+
+/*************************************************
+ * Kernel Autotuner
+ *
+ * Which implementation of a kernel is fastest is not always
+ * predictable from the target: wide SIMD can lose to narrower code
+ * when it lowers the clock, and on MCUs the answer changes with
+ * whether the code runs from flash or RAM. kyber_tune_run() times
+ * every implementation compiled into the library on the running
+ * machine and selects the fastest per kernel:
+ *
+ *   - ntt, invntt, basemul, reduce: "ref" (ntt.c) and whichever of
+ *     "vec", "neon", "rvv", "m4" the target supports
+ *   - keccak: "ref" (64-bit lanes) and "bi32" (bit-interleaved), as
+ *     Keccak backends, in a library built with KYBER_KECCAK_BACKEND;
+ *     otherwise the one compiled in. A backend registered by the
+ *     application (an accelerator) is left alone.
+ *
+ * Every candidate gives bit-identical results, so any mix is valid.
+ * Build the library with -DKYBER_AUTOTUNE to route poly.c through the
+ * selection (one indirect call per kernel); without it poly.c keeps
+ * the KYBER_BACKEND_* kernels and only the Keccak choice takes effect.
+ * Until a selection is made the KYBER_BACKEND_* kernels are used.
+ *
+ * The selection is saved as a KYBER_TUNE_BLOBBYTES blob for flash or
+ * a file. Loading it is a few comparisons instead of a measurement,
+ * and it is refused if it was made by a build with other candidates.
+ * kyber_tune_init() does the whole measure-once cycle with a file.
+ *
+ * Select at init, before other threads run KEM operations.
+ *************************************************/
+
+typedef enum {
+  KYBER_KERNEL_NTT = 0,
+  KYBER_KERNEL_INVNTT,
+  KYBER_KERNEL_BASEMUL,
+  KYBER_KERNEL_REDUCE,
+  KYBER_KERNEL_KECCAK,
+  KYBER_KERNEL_COUNT
+} kyber_kernel;
+
+// Candidate index per kernel, in the order of kyber_tune_candidate(),
+// or KYBER_TUNE_KEEP to leave the kernel as it is (the Keccak entry
+// while an application backend is registered)
+#define KYBER_TUNE_KEEP 0xFF
+
+typedef struct {
+  uint8_t choice[KYBER_KERNEL_COUNT];
+} kyber_tune_config;
+
+// Kernels behind poly.c in a KYBER_AUTOTUNE build
+typedef struct {
+  void (*ntt)(int16_t r[256]);
+  void (*invntt)(int16_t r[256]);
+  void (*basemul)(int16_t r[256], const int16_t a[256], const int16_t b[256]);
+  void (*reduce)(int16_t r[256]);
+} kyber_tune_kernels;
+
+extern kyber_tune_kernels kyber_tuned;
+
+#define KYBER_TUNE_BLOBBYTES 16
+
+// Timed batches per candidate; the fastest batch counts
+#ifndef KYBER_TUNE_SAMPLES
+#define KYBER_TUNE_SAMPLES 16
+#endif
+
+/*************************************************
+ * Name:        kyber_tune_candidate
+ *
+ * Description: Name of candidate i of kernel k, for enumeration
+ *
+ * Returns the name, NULL if i is past the last candidate
+ **************************************************/
+const char *kyber_tune_candidate(kyber_kernel k, unsigned int i);
+
+/*************************************************
+ * Name:        kyber_tune_selected
+ *
+ * Description: Name of the implementation currently used for k
+ **************************************************/
+const char *kyber_tune_selected(kyber_kernel k);
+
+/*************************************************
+ * Name:        kyber_tune_override
+ *
+ * Description: Forces an implementation, e.g. to pin the choice in a
+ *              product or to compare candidates end to end
+ *
+ * Arguments:   - kyber_kernel k: kernel
+ *              - const char *name: candidate name
+ *
+ * Returns 0 on success, -1 if the name is not a candidate of k or k
+ * is the Keccak kernel while an application backend is registered
+ **************************************************/
+int kyber_tune_override(kyber_kernel k, const char *name);
+
+/*************************************************
+ * Name:        kyber_tune_run
+ *
+ * Description: Times every candidate of every kernel, selects the
+ *              fastest of each and reports the choice
+ *
+ * Arguments:   - kyber_tune_config *cfg: output selection (may be NULL)
+ *
+ * Returns 0 on success, -1 if the platform has no timer (the current
+ * selection is kept)
+ **************************************************/
+int kyber_tune_run(kyber_tune_config *cfg);
+
+/*************************************************
+ * Name:        kyber_tune_current
+ *
+ * Description: Current selection, for saving
+ **************************************************/
+void kyber_tune_current(kyber_tune_config *cfg);
+
+/*************************************************
+ * Name:        kyber_tune_apply
+ *
+ * Description: Selects the implementations of cfg
+ *
+ * Returns 0 on success, -1 if an index is out of range (nothing is
+ * changed)
+ **************************************************/
+int kyber_tune_apply(const kyber_tune_config *cfg);
+
+/*************************************************
+ * Name:        kyber_tune_save
+ *
+ * Description: Serialises cfg with a fingerprint of this build's
+ *              candidates and a checksum
+ **************************************************/
+void kyber_tune_save(uint8_t blob[KYBER_TUNE_BLOBBYTES],
+                     const kyber_tune_config *cfg);
+
+/*************************************************
+ * Name:        kyber_tune_load
+ *
+ * Description: Parses a blob written by kyber_tune_save() (does not
+ *              apply it)
+ *
+ * Returns 0 on success, -1 if the blob is empty (e.g. erased flash),
+ * corrupt or from a build with other candidates
+ **************************************************/
+int kyber_tune_load(kyber_tune_config *cfg,
+                    const uint8_t blob[KYBER_TUNE_BLOBBYTES]);
+
+#if defined(KYBER_PLATFORM_DESKTOP)
+/*************************************************
+ * Name:        kyber_tune_init
+ *
+ * Description: Applies the selection saved in path; if there is none
+ *              usable, measures with kyber_tune_run() and saves it
+ *
+ * Returns 1 if loaded, 0 if measured and saved, -1 if the measurement
+ * failed or path could not be written (the measured selection is
+ * still applied in the latter case)
+ **************************************************/
+int kyber_tune_init(const char *path);
+#endif
+
+#endif /* KYBER_TUNE_H */
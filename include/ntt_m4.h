@@ -0,0 +1,57 @@
+#ifndef NTT_M4_H
+#define NTT_M4_H
+
+#include <stdint.h>
+
+/*************************************************
+ * Cortex-M4 DSP Backend
+ *
+ * Kernels for ARMv7E-M cores with the DSP extension (STM32F4/F7/L4,
+ * nRF52840, and the M7/M33 parts that have it). Two adjacent
+ * coefficients live in one 32-bit register: the halfword multiplies
+ * (smulbb/smultb/smlabt) do one Montgomery or Barrett reduction per
+ * coefficient and sadd16/ssub16 do both butterfly additions at once.
+ * The forward and inverse NTT merge three layers per pass, so a pass
+ * loads and stores eight words instead of sixteen per layer, and the
+ * final scaling of the inverse NTT is folded into its last pass.
+ * Results are bit-identical to the scalar kernels
+ * (test/test_ntt_m4.c).
+ *
+ * Build the library with -DKYBER_BACKEND_M4 to route poly.c through
+ * these kernels. On other targets this header declares nothing and
+ * ntt_m4.c compiles to an empty object.
+ *
+ * The kernels have not been run on a Cortex-M4 or under qemu yet, so
+ * there are no cycle or instruction counts for them. test/model/run.sh
+ * builds the same code on the host against a C model of the
+ * intrinsics (-DKYBER_M4_MODEL), which checks their logic against the
+ * scalar code but not code generation or speed.
+ *************************************************/
+
+#if defined(__ARM_FEATURE_DSP) && defined(__ARM_FEATURE_SIMD32) &&            \
+    defined(__GNUC__) && !defined(__aarch64__)
+#define KYBER_HAVE_M4 1
+#elif defined(KYBER_M4_MODEL)
+// Host build against test/model/m4/arm_acle.h
+#define KYBER_HAVE_M4 1
+#elif defined(KYBER_BACKEND_M4)
+#error "KYBER_BACKEND_M4 needs an ARMv7E-M (DSP) target and GCC 10+ or Clang"
+#endif
+
+#if defined(KYBER_HAVE_M4)
+
+// Forward NTT, as ntt()
+void ntt_m4(int16_t r[256]);
+
+// Inverse NTT with multiplication by 2^16, as invntt()
+void invntt_m4(int16_t r[256]);
+
+// Multiplication in the NTT domain, as poly_basemul_montgomery()
+void basemul_m4(int16_t r[256], const int16_t a[256], const int16_t b[256]);
+
+// Barrett reduction of every coefficient, as poly_reduce()
+void reduce_m4(int16_t r[256]);
+
+#endif /* KYBER_HAVE_M4 */
+
+#endif /* NTT_M4_H */
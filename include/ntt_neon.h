@@ -0,0 +1,65 @@
+#ifndef NTT_NEON_H
+#define NTT_NEON_H
+
+#include <stdint.h>
+
+/*************************************************
+ * AArch64 NEON Backend
+ *
+ * Intrinsics versions of the arithmetic kernels for Cortex-A53/A72
+ * class cores (ARMv8.0-A, no SHA3 extension needed). The data layout
+ * and twiddle tables are those of the portable vector backend
+ * (ntt_vec.c); the NEON code replaces the generic widening multiplies
+ * with sqdmulh/smull and the shuffles with zip/uzp/trn, and adds a
+ * vectorised rejection sampler. Outputs are bit-identical to the
+ * scalar kernels (test/test_ntt_neon.c).
+ *
+ * Build the library with -DKYBER_BACKEND_NEON to route poly.c and
+ * indcpa.c through these kernels and through the 2-way Keccak of
+ * fips202x2_neon.c for matrix expansion. On other targets this header
+ * declares nothing and ntt_neon.c compiles to an empty object.
+ *
+ * The kernels have not been run on AArch64 hardware or under qemu
+ * yet. test/model/run.sh builds the same code on the host against a C
+ * model of the intrinsics (-DKYBER_NEON_MODEL), which checks their
+ * logic against the scalar code but not code generation or speed.
+ *************************************************/
+
+#if defined(__aarch64__) && defined(__ARM_NEON) && defined(__GNUC__)
+#define KYBER_HAVE_NEON 1
+#elif defined(KYBER_NEON_MODEL)
+// Host build against test/model/neon/arm_neon.h
+#define KYBER_HAVE_NEON 1
+#elif defined(KYBER_BACKEND_NEON)
+#error "KYBER_BACKEND_NEON needs an AArch64 target with GCC or Clang"
+#endif
+
+#if defined(KYBER_HAVE_NEON)
+
+// Forward NTT, as ntt()
+void ntt_neon(int16_t r[256]);
+
+// Inverse NTT with multiplication by 2^16, as invntt()
+void invntt_neon(int16_t r[256]);
+
+// Multiplication in the NTT domain, as poly_basemul_montgomery()
+void basemul_neon(int16_t r[256], const int16_t a[256], const int16_t b[256]);
+
+// Barrett reduction of every coefficient, as poly_reduce()
+void reduce_neon(int16_t r[256]);
+
+// CBD sampling with eta = 2 (128 bytes) and eta = 3 (192 bytes)
+void cbd2_neon(int16_t r[256], const uint8_t *buf);
+void cbd3_neon(int16_t r[256], const uint8_t *buf);
+
+// Compression to d = 4 or 5 bits, as poly_compress()
+void compress_neon(uint8_t *r, const int16_t a[256], int d);
+
+// Rejection sampling of 12-bit values below q, as rej_uniform() in
+// indcpa.c: returns the number of coefficients written (at most len)
+unsigned int rej_uniform_neon(int16_t *r, unsigned int len,
+                              const uint8_t *buf, unsigned int buflen);
+
+#endif /* KYBER_HAVE_NEON */
+
+#endif /* NTT_NEON_H */
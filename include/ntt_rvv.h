@@ -0,0 +1,70 @@
+#ifndef NTT_RVV_H
+#define NTT_RVV_H
+
+#include <stdint.h>
+
+/*************************************************
+ * RISC-V Vector (RVV 1.0) Backend
+ *
+ * Vector-length agnostic versions of the arithmetic kernels: every
+ * loop asks vsetvl how many elements fit and strip-mines, so one
+ * binary runs on VLEN = 128 up to 65536 and gets wider per
+ * instruction as VLEN grows. The last two NTT layers are merged into
+ * one pass over 8-coefficient segments (vlseg8e16), and CBD,
+ * compression and rejection sampling use segment loads and stores
+ * for their byte layouts, so no access is wider than the int16 or
+ * byte element and no alignment is assumed. Outputs are bit-identical
+ * to the scalar kernels (test/test_ntt_rvv.c).
+ *
+ * Build the library with -DKYBER_BACKEND_RVV (and -march=rv64gcv) to
+ * route poly.c and indcpa.c through these kernels and matrix
+ * expansion and the multi-lane hashing through the vector Keccak of
+ * fips202xn_rvv.c. Needs the v0.12 or later intrinsics (GCC 14,
+ * Clang 17). On other targets this header declares nothing.
+ *
+ * The kernels have not been run on RISC-V hardware or under qemu yet.
+ * test/model/run.sh builds the same code on the host against a C
+ * model of the intrinsics (-DKYBER_RVV_MODEL) at VLEN 128 to 1024,
+ * which checks their logic against the scalar code but not code
+ * generation or speed.
+ *************************************************/
+
+#if defined(__riscv_vector) && defined(__riscv_v_intrinsic) &&                 \
+    __riscv_v_intrinsic >= 12000
+#define KYBER_HAVE_RVV 1
+#elif defined(KYBER_RVV_MODEL)
+// Host build against test/model/rvv/riscv_vector.h
+#define KYBER_HAVE_RVV 1
+#elif defined(KYBER_BACKEND_RVV)
+#error "KYBER_BACKEND_RVV needs -march=..v and the RVV 0.12+ intrinsics"
+#endif
+
+#if defined(KYBER_HAVE_RVV)
+
+// Forward NTT, as ntt()
+void ntt_rvv(int16_t r[256]);
+
+// Inverse NTT with multiplication by 2^16, as invntt()
+void invntt_rvv(int16_t r[256]);
+
+// Multiplication in the NTT domain, as poly_basemul_montgomery()
+void basemul_rvv(int16_t r[256], const int16_t a[256], const int16_t b[256]);
+
+// Barrett reduction of every coefficient, as poly_reduce()
+void reduce_rvv(int16_t r[256]);
+
+// CBD sampling with eta = 2 (128 bytes) and eta = 3 (192 bytes)
+void cbd2_rvv(int16_t r[256], const uint8_t *buf);
+void cbd3_rvv(int16_t r[256], const uint8_t *buf);
+
+// Compression to d = 4 or 5 bits, as poly_compress()
+void compress_rvv(uint8_t *r, const int16_t a[256], int d);
+
+// Rejection sampling of 12-bit values below q, as rej_uniform() in
+// indcpa.c: returns the number of coefficients written (at most len)
+unsigned int rej_uniform_rvv(int16_t *r, unsigned int len, const uint8_t *buf,
+                             unsigned int buflen);
+
+#endif /* KYBER_HAVE_RVV */
+
+#endif /* NTT_RVV_H */
@@ -0,0 +1,61 @@
+#ifndef NTT_VEC_H
+#define NTT_VEC_H
+
+#include <stdint.h>
+
+/*************************************************
+ * Portable SIMD Backend
+ *
+ * Vector versions of the arithmetic kernels in ntt.c and poly.c,
+ * written with the GCC/Clang vector extensions
+ * (__attribute__((vector_size)), __builtin_convertvector and
+ * shuffles) instead of intrinsics; the only exception is the 16-bit
+ * high multiply on x86, which GCC does not pattern-match. The
+ * compiler lowers them to whatever the target has: SSE2/AVX2 on x86,
+ * NEON on ARMv7/AArch64, RVV on RISC-V with vector support, or plain
+ * scalar code where there is no SIMD at all.
+ *
+ * Each kernel takes the same arguments as its scalar counterpart and
+ * produces bit-identical output (test/test_ntt_vec.c checks this), so
+ * the two are interchangeable. Build the library with
+ * -DKYBER_BACKEND_VEC to route poly.c through these kernels; the
+ * scalar ones stay compiled in as the reference.
+ *
+ * Needs GCC 9+ or Clang 3.7+.
+ *************************************************/
+
+#if defined(__GNUC__)
+#define KYBER_HAVE_VEC 1
+#elif defined(KYBER_BACKEND_VEC)
+#error "KYBER_BACKEND_VEC needs the GCC/Clang vector extensions"
+#endif
+
+#if defined(KYBER_HAVE_VEC)
+
+// Twiddle factors in vector lane order, see ntt_vec.c
+extern const int16_t zetas_ntt_vec[256];
+extern const int16_t zetas_invntt_vec[256];
+extern const int16_t zetas_basemul_vec[128];
+
+// Forward NTT, as ntt()
+void ntt_vec(int16_t r[256]);
+
+// Inverse NTT with multiplication by 2^16, as invntt()
+void invntt_vec(int16_t r[256]);
+
+// Multiplication in the NTT domain, as poly_basemul_montgomery()
+void basemul_vec(int16_t r[256], const int16_t a[256], const int16_t b[256]);
+
+// Barrett reduction of every coefficient, as poly_reduce()
+void reduce_vec(int16_t r[256]);
+
+// CBD sampling with eta = 2 (128 bytes) and eta = 3 (192 bytes)
+void cbd2_vec(int16_t r[256], const uint8_t *buf);
+void cbd3_vec(int16_t r[256], const uint8_t *buf);
+
+// Compression to d = 4 or 5 bits, as poly_compress()
+void compress_vec(uint8_t *r, const int16_t a[256], int d);
+
+#endif /* KYBER_HAVE_VEC */
+
+#endif /* NTT_VEC_H */
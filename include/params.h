@@ -13,6 +13,7 @@
 
 #define KYBER_SYMBYTES 32 // Size of hashes, seeds
 #define KYBER_SSBYTES 32  // Size of shared key
+#define KYBER_POLYBYTES 384 // Size of a serialized polynomial
 
 // Kyber-512 parameters (default)
 #ifndef KYBER_K
@@ -50,6 +51,28 @@
 #error "KYBER_K must be in {2,3,4}"
 #endif
 
+/*************************************************
+ * Symbol namespacing
+ *
+ * With KYBER_MULTI_PARAMS every function whose code depends on KYBER_K
+ * gets a per-set prefix (kyber512_, kyber768_, kyber1024_), so the
+ * K-dependent sources can be compiled once per parameter set and
+ * linked into one library. The parameter-independent modules (ntt,
+ * fips202, utils, randombytes) are compiled once and shared.
+ * See kyber_dispatch.h for runtime selection.
+ *************************************************/
+#if defined(KYBER_MULTI_PARAMS)
+#if (KYBER_K == 2)
+#define KYBER_NAMESPACE(s) kyber512_##s
+#elif (KYBER_K == 3)
+#define KYBER_NAMESPACE(s) kyber768_##s
+#else
+#define KYBER_NAMESPACE(s) kyber1024_##s
+#endif
+#else
+#define KYBER_NAMESPACE(s) s
+#endif
+
 // Derived sizes
 #define KYBER_PUBLICKEYBYTES (KYBER_POLYVECBYTES + KYBER_SYMBYTES)
 #define KYBER_SECRETKEYBYTES                                                   \
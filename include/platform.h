@@ -20,26 +20,33 @@
  * Tune these based on your target's RAM constraints
  *************************************************/
 
-// Stack usage estimates (in bytes) for key operations:
-// - crypto_kem_keypair: ~4KB
-// - crypto_kem_enc:     ~6KB
-// - crypto_kem_dec:     ~6KB
+// Stack high-water marks in bytes, measured by stack painting
+// (kyber_memory_info / kyber_stack_measure, x86-64 gcc -O3; 32-bit
+// MCU builds are within a few hundred bytes, check yours with
+// bench/stack_usage.py and -fstack-usage):
 //
-// Total peak RAM usage: ~8KB (including keys and ciphertext)
+//                       Kyber-512  Kyber-768  Kyber-1024
+// - crypto_kem_keypair:    8.7KB     10.7KB      15.8KB
+// - crypto_kem_enc:        9.4KB     14.0KB      19.6KB
+// - crypto_kem_dec:       10.2KB     15.2KB      21.3KB
+//
+// Decapsulation is the deepest (it re-encrypts), so the stack
+// for KEM calls is sized from it with some headroom for the caller
+// and interrupts. KYBER_K is only needed where the macro is used.
 
 #if defined(KYBER_PLATFORM_STM32)
 // STM32 typically has 64KB-512KB SRAM
-#define KYBER_STACK_SIZE 8192
+#define KYBER_STACK_SIZE (6144 * KYBER_K)
 #define KYBER_USE_STATIC_ALLOC 1
 
 #elif defined(KYBER_PLATFORM_ESP32)
 // ESP32 has ~320KB SRAM available
-#define KYBER_STACK_SIZE 8192
+#define KYBER_STACK_SIZE (6144 * KYBER_K)
 #define KYBER_USE_STATIC_ALLOC 1
 
 #elif defined(KYBER_PLATFORM_NRF52)
 // nRF52840 has 256KB SRAM, nRF52832 has 64KB
-#define KYBER_STACK_SIZE 8192
+#define KYBER_STACK_SIZE (6144 * KYBER_K)
 #define KYBER_USE_STATIC_ALLOC 1
 
 #else
@@ -90,10 +97,80 @@ static inline uint32_t kyber_cycles_read(void) {
 #define KYBER_HAS_CYCLE_COUNTER 0
 // For nRF52, use app_timer or RTC for timing
 
+#elif defined(__x86_64__) || defined(__i386__)
+// Desktop x86: time-stamp counter (constant rate, not core cycles)
+#include <x86intrin.h>
+#define KYBER_HAS_CYCLE_COUNTER 1
+
+static inline void kyber_cycles_init(void) {}
+
+static inline uint32_t kyber_cycles_read(void) {
+  return (uint32_t)__rdtsc();
+}
+
+#elif defined(__aarch64__)
+// Desktop/server AArch64: generic timer virtual count
+#define KYBER_HAS_CYCLE_COUNTER 1
+
+static inline void kyber_cycles_init(void) {}
+
+static inline uint32_t kyber_cycles_read(void) {
+  uint64_t t;
+  __asm__ __volatile__("isb; mrs %0, cntvct_el0" : "=r"(t));
+  return (uint32_t)t;
+}
+
 #else
 #define KYBER_HAS_CYCLE_COUNTER 0
 #endif
 
+/*************************************************
+ * Arithmetic Backend
+ *
+ * Name and numeric ID of the NTT/polynomial implementation compiled
+ * in, reported by the benchmarks and the USDT probes. Optimised
+ * backends define their own.
+ *************************************************/
+
+#if (defined(KYBER_BACKEND_VEC) + defined(KYBER_BACKEND_NEON) +               \
+     defined(KYBER_BACKEND_RVV) + defined(KYBER_BACKEND_M4)) > 1
+#error "Select only one of KYBER_BACKEND_VEC, _NEON, _RVV and _M4"
+#endif
+
+// Portable vector-extension kernels (src/ntt_vec.c), -DKYBER_BACKEND_VEC
+#if defined(KYBER_BACKEND_VEC) && !defined(KYBER_BACKEND_NAME)
+#define KYBER_BACKEND_NAME "vec"
+#define KYBER_BACKEND_ID 1
+#endif
+
+// AArch64 NEON kernels and 2-way Keccak (src/ntt_neon.c,
+// src/fips202x2_neon.c), -DKYBER_BACKEND_NEON
+#if defined(KYBER_BACKEND_NEON) && !defined(KYBER_BACKEND_NAME)
+#define KYBER_BACKEND_NAME "neon"
+#define KYBER_BACKEND_ID 2
+#endif
+
+// RISC-V Vector kernels and multi-lane Keccak (src/ntt_rvv.c,
+// src/fips202xn_rvv.c), -DKYBER_BACKEND_RVV
+#if defined(KYBER_BACKEND_RVV) && !defined(KYBER_BACKEND_NAME)
+#define KYBER_BACKEND_NAME "rvv"
+#define KYBER_BACKEND_ID 3
+#endif
+
+// Cortex-M4 DSP kernels (src/ntt_m4.c), -DKYBER_BACKEND_M4
+#if defined(KYBER_BACKEND_M4) && !defined(KYBER_BACKEND_NAME)
+#define KYBER_BACKEND_NAME "m4"
+#define KYBER_BACKEND_ID 4
+#endif
+
+#ifndef KYBER_BACKEND_NAME
+#define KYBER_BACKEND_NAME "ref"
+#endif
+
+#ifndef KYBER_BACKEND_ID
+#define KYBER_BACKEND_ID 0
+#endif
+
 /*************************************************
  * Endianness
  *************************************************/
@@ -19,51 +19,69 @@ typedef struct {
  *************************************************/
 
 // Initialize polynomial to zero
+#define poly_zero KYBER_NAMESPACE(poly_zero)
 void poly_zero(poly *p);
 
 // Add two polynomials: r = a + b
+#define poly_add KYBER_NAMESPACE(poly_add)
 void poly_add(poly *r, const poly *a, const poly *b);
 
 // Subtract two polynomials: r = a - b
+#define poly_sub KYBER_NAMESPACE(poly_sub)
 void poly_sub(poly *r, const poly *a, const poly *b);
 
 // Compress polynomial coefficients
+#define poly_compress KYBER_NAMESPACE(poly_compress)
 void poly_compress(uint8_t *r, const poly *a, int d);
 
 // Decompress polynomial coefficients
+#define poly_decompress KYBER_NAMESPACE(poly_decompress)
 void poly_decompress(poly *r, const uint8_t *a, int d);
 
 // Encode polynomial to bytes
+#define poly_tobytes KYBER_NAMESPACE(poly_tobytes)
 void poly_tobytes(uint8_t *r, const poly *a);
 
 // Decode polynomial from bytes
+#define poly_frombytes KYBER_NAMESPACE(poly_frombytes)
 void poly_frombytes(poly *r, const uint8_t *a);
 
 // Sample polynomial from centered binomial distribution
+#define poly_cbd_eta1 KYBER_NAMESPACE(poly_cbd_eta1)
 void poly_cbd_eta1(poly *r, const uint8_t *buf);
+#define poly_cbd_eta2 KYBER_NAMESPACE(poly_cbd_eta2)
 void poly_cbd_eta2(poly *r, const uint8_t *buf);
 
 // NTT and inverse NTT
+#define poly_ntt KYBER_NAMESPACE(poly_ntt)
 void poly_ntt(poly *r);
+#define poly_invntt KYBER_NAMESPACE(poly_invntt)
 void poly_invntt(poly *r);
 
 // Pointwise multiplication in NTT domain
+#define poly_basemul_montgomery KYBER_NAMESPACE(poly_basemul_montgomery)
 void poly_basemul_montgomery(poly *r, const poly *a, const poly *b);
 
 // Convert to Montgomery form
+#define poly_tomont KYBER_NAMESPACE(poly_tomont)
 void poly_tomont(poly *r);
 
 // Reduce coefficients mod q
+#define poly_reduce KYBER_NAMESPACE(poly_reduce)
 void poly_reduce(poly *r);
 
 // Sample polynomial from XOF (for matrix generation)
+#define poly_getnoise_eta1 KYBER_NAMESPACE(poly_getnoise_eta1)
 void poly_getnoise_eta1(poly *r, const uint8_t seed[KYBER_SYMBYTES],
                         uint8_t nonce);
+#define poly_getnoise_eta2 KYBER_NAMESPACE(poly_getnoise_eta2)
 void poly_getnoise_eta2(poly *r, const uint8_t seed[KYBER_SYMBYTES],
                         uint8_t nonce);
 
 // Message encoding/decoding
+#define poly_frommsg KYBER_NAMESPACE(poly_frommsg)
 void poly_frommsg(poly *r, const uint8_t msg[KYBER_SYMBYTES]);
+#define poly_tomsg KYBER_NAMESPACE(poly_tomsg)
 void poly_tomsg(uint8_t msg[KYBER_SYMBYTES], const poly *a);
 
 #endif /* POLY_H */
@@ -21,35 +21,45 @@ typedef struct {
  *************************************************/
 
 // Initialize vector to zero
+#define polyvec_zero KYBER_NAMESPACE(polyvec_zero)
 void polyvec_zero(polyvec *v);
 
 // Add two vectors: r = a + b
+#define polyvec_add KYBER_NAMESPACE(polyvec_add)
 void polyvec_add(polyvec *r, const polyvec *a, const polyvec *b);
 
 // Compress vector
+#define polyvec_compress KYBER_NAMESPACE(polyvec_compress)
 void polyvec_compress(uint8_t *r, const polyvec *a);
 
 // Decompress vector
+#define polyvec_decompress KYBER_NAMESPACE(polyvec_decompress)
 void polyvec_decompress(polyvec *r, const uint8_t *a);
 
 // Encode vector to bytes
+#define polyvec_tobytes KYBER_NAMESPACE(polyvec_tobytes)
 void polyvec_tobytes(uint8_t *r, const polyvec *a);
 
 // Decode vector from bytes
+#define polyvec_frombytes KYBER_NAMESPACE(polyvec_frombytes)
 void polyvec_frombytes(polyvec *r, const uint8_t *a);
 
 // Apply NTT to all polynomials in vector
+#define polyvec_ntt KYBER_NAMESPACE(polyvec_ntt)
 void polyvec_ntt(polyvec *r);
 
 // Apply inverse NTT to all polynomials in vector
+#define polyvec_invntt KYBER_NAMESPACE(polyvec_invntt)
 void polyvec_invntt(polyvec *r);
 
 // Pointwise multiplication and accumulation: r = a · b (dot product in NTT
 // domain)
+#define polyvec_pointwise_acc_montgomery KYBER_NAMESPACE(polyvec_pointwise_acc_montgomery)
 void polyvec_pointwise_acc_montgomery(poly *r, const polyvec *a,
                                       const polyvec *b);
 
 // Reduce all coefficients in vector
+#define polyvec_reduce KYBER_NAMESPACE(polyvec_reduce)
 void polyvec_reduce(polyvec *r);
 
 #endif /* POLYVEC_H */
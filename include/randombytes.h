@@ -14,12 +14,17 @@
  *   - STM32 (HAL_RNG)
  *   - ESP32 (esp_random)
  *   - nRF52 (nrf_crypto_rng)
- *   - Desktop (os.urandom or OpenSSL)
+ *   - Linux (per-thread SHAKE256 DRBG seeded from getrandom)
+ *   - Other desktop (LFSR, testing only)
  *************************************************/
 
 /**
  * @brief Fill buffer with cryptographically secure random bytes
  *
+ * On failure out is zeroed, never left partly filled. The STM32
+ * backend re-initialises the RNG peripheral after a seed or clock
+ * error and retries before giving up.
+ *
  * @param out   Output buffer
  * @param len   Number of bytes to generate
  * @return      0 on success, -1 on failure
@@ -42,4 +47,16 @@ int randombytes(uint8_t *out, size_t len);
 #define KYBER_PLATFORM_GENERIC
 #endif
 
+#if defined(KYBER_PLATFORM_DESKTOP) || defined(KYBER_PLATFORM_GENERIC)
+/**
+ * @brief Make randombytes() deterministic (tests only)
+ *
+ * On Linux this affects the calling thread only; other threads keep
+ * their OS-seeded streams.
+ *
+ * @param seed  Seed value
+ */
+void randombytes_seed(uint32_t seed);
+#endif
+
 #endif /* RANDOMBYTES_H */
@@ -31,4 +31,10 @@ int ct_memcmp(const uint8_t *a, const uint8_t *b, size_t len);
  */
 void ct_cmov(uint8_t *r, const uint8_t *x, size_t len, uint8_t b);
 
+/**
+ * Overwrite len bytes at p with zeros.
+ * Used to wipe secret material; the stores are not elided by the compiler.
+ */
+void secure_zero(void *p, size_t len);
+
 #endif /* UTILS_H */
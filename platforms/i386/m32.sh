@@ -0,0 +1,108 @@
+#!/bin/sh
+# Build the library and the unit tests as 32-bit x86 code (gcc -m32)
+# and run them natively: the desktop stand-in for the 32-bit MCUs,
+# where uint64_t arithmetic is split into register pairs.
+#
+# Needs 32-bit libc development files, e.g. on Debian/Ubuntu:
+#   apt install gcc-multilib
+#
+# Usage (from anywhere): platforms/i386/m32.sh [test|bench|all]
+#
+# Environment:
+#   CC       compiler                    (gcc)
+#   KECCAK   Keccak flags for test       (-DKYBER_KECCAK_BI32)
+#   OUT      build directory             (build/i386)
+#
+# The tests run once with KECCAK (the bit-interleaved permutation
+# behind fips202.c, checked against a 64-bit one by
+# test_keccak_bi32) and once with the 64-bit permutation, for all
+# three parameter sets. bench_primitives times keccak_f1600 both ways
+# (the ref and bi32 columns of that row), bench_kem the whole KEM.
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+CC=${CC:-gcc}
+KECCAK=${KECCAK:--DKYBER_KECCAK_BI32}
+OUT=${OUT:-$ROOT/build/i386}
+WHAT=${1:-all}
+
+CFLAGS="-O3 -m32 -I$ROOT/include -I$ROOT/test/vendor"
+LDFLAGS="-m32 -pthread -lm"
+
+# build_lib <dir> <flags...>: one static library per parameter set
+build_lib() {
+  dir=$1
+  shift
+  mkdir -p "$dir"
+  objs=""
+  for src in "$ROOT"/src/*.c; do
+    name=$(basename "$src" .c)
+    case $name in
+    kyber_embedded | testing-the-test) continue ;;
+    esac
+    $CC $CFLAGS "$@" -c "$src" -o "$dir/$name.o"
+    objs="$objs $dir/$name.o"
+  done
+  rm -f "$dir/libkyber.a"
+  ar rcs "$dir/libkyber.a" $objs
+}
+
+run_tests() {
+  label=$1
+  shift
+  failed=0
+  for k in 2 3 4; do
+    dir="$OUT/$label/k$k"
+    build_lib "$dir" -DKYBER_K=$k "$@"
+    $CC $CFLAGS -c "$ROOT/test/vendor/unity.c" -o "$dir/unity.o"
+    ar rcs "$dir/libunity.a" "$dir/unity.o"
+    mkdir -p "$OUT/bin"
+    for t in "$ROOT"/test/test_*.c; do
+      name=$(basename "$t" .c)
+      bin="$OUT/bin/${name}_${label}_k$k"
+      if $CC $CFLAGS -DKYBER_K=$k "$@" "$t" "$dir/libunity.a" \
+        "$dir/libkyber.a" $LDFLAGS -o "$bin" &&
+        "$bin" >"$bin.log" 2>&1; then
+        echo "  ok    $name ($label, K=$k)"
+      else
+        echo "  FAIL  $name ($label, K=$k), see $bin.log"
+        failed=1
+      fi
+    done
+  done
+  return $failed
+}
+
+run_bench() {
+  mkdir -p "$OUT/bin"
+  # 64-bit permutation build: bench_primitives adds the bi32 column
+  build_lib "$OUT/ref/k3" -DKYBER_K=3
+  $CC $CFLAGS -DKYBER_K=3 "$ROOT/bench/bench_primitives.c" \
+    "$OUT/ref/k3/libkyber.a" $LDFLAGS -o "$OUT/bin/bench_primitives"
+  "$OUT/bin/bench_primitives" 21 16
+
+  # End to end, 64-bit permutation against KECCAK
+  for label in ref bi32; do
+    flags=""
+    [ "$label" = bi32 ] && flags=$KECCAK
+    build_lib "$OUT/$label/k3" -DKYBER_K=3 $flags
+    $CC $CFLAGS -DKYBER_K=3 $flags "$ROOT/bench/bench_kem.c" \
+      "$OUT/$label/k3/libkyber.a" $LDFLAGS -o "$OUT/bin/bench_kem_$label"
+    "$OUT/bin/bench_kem_$label" -n 200 --label "$label"
+  done
+}
+
+status=0
+case $WHAT in
+test | all)
+  echo "== tests ($KECCAK)"
+  run_tests bi32 $KECCAK || status=1
+  echo "== tests (64-bit Keccak)"
+  run_tests ref || status=1
+  ;;
+esac
+case $WHAT in
+bench | all) run_bench ;;
+esac
+exit $status
@@ -27,6 +27,9 @@
 
 #include "kem.h"
 #include "params.h"
+#ifdef KYBER_ENTROPY_RING
+#include "entropy_ring.h"
+#endif
 
 /* LED definitions for nRF52840-DK */
 #define LED_1 NRF_GPIO_PIN_MAP(0, 13)
@@ -186,6 +189,9 @@ int main(void) {
   timer_init();
   leds_init();
   crypto_init();
+#ifdef KYBER_ENTROPY_RING
+  kyber_entropy_nrf52_idle(); // Prime the entropy ring
+#endif
 
   NRF_LOG_INFO("nRF52 Kyber Demo Starting...");
   NRF_LOG_FLUSH();
@@ -201,6 +207,9 @@ int main(void) {
   // Idle loop
   while (true) {
     NRF_LOG_FLUSH();
+#ifdef KYBER_ENTROPY_RING
+    kyber_entropy_nrf52_idle(); // Top up the entropy ring before sleeping
+#endif
     __WFE();
   }
 }
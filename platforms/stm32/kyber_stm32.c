@@ -16,6 +16,9 @@
 
 #include "kem.h"
 #include "params.h"
+#ifdef KYBER_ENTROPY_RING
+#include "entropy_ring.h"
+#endif
 
 /* RNG Handle - must be initialized in CubeMX */
 extern RNG_HandleTypeDef hrng;
@@ -149,6 +152,11 @@ void kyber_stm32_main(void) {
   // Wait for UART to be ready
   HAL_Delay(100);
 
+#ifdef KYBER_ENTROPY_RING
+  // Prefetch RNG output in the background (RNG interrupt required)
+  kyber_entropy_stm32_start();
+#endif
+
   // Run benchmark
   kyber_benchmark();
 
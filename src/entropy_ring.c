@@ -0,0 +1,215 @@
+/*************************************************
+ * Prefetching Entropy Ring
+ *
+ * Lock-free single-producer single-consumer byte ring. head and tail
+ * are free-running counters; the producer publishes bytes with a
+ * release store of head, the consumer hands slots back with a release
+ * store of tail after wiping them.
+ *************************************************/
+
+#include "../include/entropy_ring.h"
+#include "../include/utils.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+/*************************************************
+ * Name:        kyber_entropy_ring_init
+ *
+ * Description: Binds a ring to caller-owned storage
+ *************************************************/
+int kyber_entropy_ring_init(kyber_entropy_ring *r, uint8_t *storage,
+                            size_t capacity) {
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+    return -1;
+
+  r->buf = storage;
+  r->mask = capacity - 1;
+  atomic_init(&r->head, 0);
+  atomic_init(&r->tail, 0);
+  return 0;
+}
+
+/*************************************************
+ * Name:        kyber_entropy_ring_fill
+ *
+ * Description: Number of bytes ready to be consumed
+ *************************************************/
+size_t kyber_entropy_ring_fill(const kyber_entropy_ring *r) {
+  size_t head = atomic_load(&r->head);
+  size_t tail = atomic_load(&r->tail);
+  return head - tail;
+}
+
+/*************************************************
+ * Name:        kyber_entropy_ring_space
+ *
+ * Description: Number of bytes the producer can still store
+ *************************************************/
+size_t kyber_entropy_ring_space(const kyber_entropy_ring *r) {
+  if (r->buf == NULL)
+    return 0;
+  return r->mask + 1 - kyber_entropy_ring_fill(r);
+}
+
+/*************************************************
+ * Name:        kyber_entropy_ring_push
+ *
+ * Description: Producer side: appends up to len bytes
+ *************************************************/
+size_t kyber_entropy_ring_push(kyber_entropy_ring *r, const uint8_t *in,
+                               size_t len) {
+  size_t head = atomic_load_explicit(&r->head, memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&r->tail, memory_order_acquire);
+  size_t space, first, n;
+
+  if (r->buf == NULL)
+    return 0;
+
+  space = r->mask + 1 - (head - tail);
+  n = (len < space) ? len : space;
+
+  // Copy in at most two pieces: up to the end of storage, then wrapped
+  first = r->mask + 1 - (head & r->mask);
+  if (first > n)
+    first = n;
+  memcpy(r->buf + (head & r->mask), in, first);
+  memcpy(r->buf, in + first, n - first);
+
+  atomic_store_explicit(&r->head, head + n, memory_order_release);
+  return n;
+}
+
+/*************************************************
+ * Name:        kyber_entropy_ring_pop
+ *
+ * Description: Consumer side: takes up to len bytes and wipes them
+ *************************************************/
+size_t kyber_entropy_ring_pop(kyber_entropy_ring *r, uint8_t *out,
+                              size_t len) {
+  size_t tail = atomic_load_explicit(&r->tail, memory_order_relaxed);
+  size_t head = atomic_load_explicit(&r->head, memory_order_acquire);
+  size_t avail = head - tail;
+  size_t first, n;
+
+  n = (len < avail) ? len : avail;
+  if (n == 0)
+    return 0;
+
+  first = r->mask + 1 - (tail & r->mask);
+  if (first > n)
+    first = n;
+  memcpy(out, r->buf + (tail & r->mask), first);
+  secure_zero(r->buf + (tail & r->mask), first);
+  memcpy(out + first, r->buf, n - first);
+  secure_zero(r->buf, n - first);
+
+  atomic_store_explicit(&r->tail, tail + n, memory_order_release);
+  return n;
+}
+
+/*************************************************
+ * Linux stand-in for an MCU RNG
+ *************************************************/
+#if defined(__linux__)
+
+#include <errno.h>
+#include <sys/random.h>
+#include <time.h>
+
+#define SIM_CHUNK 64
+
+// Busy-wait: TRNG word times are far below the sleep granularity
+static void sim_delay(unsigned int ns) {
+  struct timespec t0, t;
+  long elapsed;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  do {
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    elapsed = (long)(t.tv_sec - t0.tv_sec) * 1000000000L +
+              (t.tv_nsec - t0.tv_nsec);
+  } while (elapsed < (long)ns);
+}
+
+static int sim_getrandom(uint8_t *out, size_t len) {
+  ssize_t r;
+
+  while (len > 0) {
+    r = getrandom(out, len, 0);
+    if (r < 0) {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    out += r;
+    len -= (size_t)r;
+  }
+  return 0;
+}
+
+/*************************************************
+ * Name:        kyber_entropy_sim_generate
+ *
+ * Description: Synchronous draw from the emulated TRNG
+ *************************************************/
+int kyber_entropy_sim_generate(uint8_t *out, size_t len,
+                               unsigned int word_ns) {
+  size_t words = (len + 3) / 4;
+
+  while (words--)
+    sim_delay(word_ns);
+  return sim_getrandom(out, len);
+}
+
+static void *sim_producer(void *arg) {
+  kyber_entropy_sim *s = arg;
+  uint8_t chunk[SIM_CHUNK];
+  size_t pos = SIM_CHUNK;
+  struct timespec idle = {0, 20000};
+
+  while (!atomic_load_explicit(&s->stop, memory_order_relaxed)) {
+    if (kyber_entropy_ring_space(s->ring) < 4) {
+      nanosleep(&idle, NULL);
+      continue;
+    }
+    if (pos == SIM_CHUNK) {
+      if (sim_getrandom(chunk, SIM_CHUNK) != 0)
+        break;
+      pos = 0;
+    }
+    // One word per word_ns, like the RNG data-ready interrupt
+    sim_delay(s->word_ns);
+    kyber_entropy_ring_push(s->ring, chunk + pos, 4);
+    secure_zero(chunk + pos, 4);
+    pos += 4;
+  }
+
+  secure_zero(chunk, sizeof(chunk));
+  return NULL;
+}
+
+/*************************************************
+ * Name:        kyber_entropy_sim_start
+ *
+ * Description: Starts the emulated TRNG producer thread
+ *************************************************/
+int kyber_entropy_sim_start(kyber_entropy_sim *s, kyber_entropy_ring *ring,
+                            unsigned int word_ns) {
+  s->ring = ring;
+  s->word_ns = word_ns;
+  atomic_init(&s->stop, 0);
+  return (pthread_create(&s->thread, NULL, sim_producer, s) == 0) ? 0 : -1;
+}
+
+/*************************************************
+ * Name:        kyber_entropy_sim_stop
+ *
+ * Description: Stops and joins the producer thread
+ *************************************************/
+void kyber_entropy_sim_stop(kyber_entropy_sim *s) {
+  atomic_store(&s->stop, 1);
+  pthread_join(s->thread, NULL);
+}
+
+#endif
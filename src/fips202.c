@@ -5,9 +5,37 @@
  *************************************************/
 
 #include "../include/fips202.h"
+#if defined(KYBER_KECCAK_BI32)
+#include "../include/keccak_bi32.h"
+#endif
+#if defined(KYBER_KECCAK_BACKEND)
+#include "../include/keccak_backend.h"
+#endif
+#include "../include/kyber_profile.h"
 #include <stdint.h>
 #include <string.h>
 
+#if defined(KYBER_KECCAK_BI32)
+/*************************************************
+ * Name:        KeccakF1600_StatePermute
+ *
+ * Description: The Keccak F1600 Permutation on a standard state, run
+ *              as the bit-interleaved one of keccak_bi32.c
+ *************************************************/
+void KeccakF1600_StatePermute(uint64_t state[25]) {
+  unsigned int i;
+
+  for (i = 0; i < 25; i++)
+    state[i] = keccak_bi32_interleave(state[i]);
+  KeccakF1600_StatePermute_bi32(state);
+  for (i = 0; i < 25; i++)
+    state[i] = keccak_bi32_deinterleave(state[i]);
+}
+
+// The sponge state below stays interleaved between permutations
+#define KECCAK_PERMUTE KeccakF1600_StatePermute_bi32
+#define KECCAK_LANE_IN(x) keccak_bi32_interleave(x)
+#else
 #define NROUNDS 24
 #define ROL(a, offset) ((a << offset) ^ (a >> (64 - offset)))
 
@@ -29,7 +57,7 @@ static const uint64_t KeccakF_RoundConstants[NROUNDS] = {
  *
  * Description: The Keccak F1600 Permutation
  *************************************************/
-static void KeccakF1600_StatePermute(uint64_t state[25]) {
+void KeccakF1600_StatePermute(uint64_t state[25]) {
   int round;
   uint64_t Aba, Abe, Abi, Abo, Abu;
   uint64_t Aga, Age, Agi, Ago, Agu;
@@ -44,6 +72,8 @@ static void KeccakF1600_StatePermute(uint64_t state[25]) {
   uint64_t Ema, Eme, Emi, Emo, Emu;
   uint64_t Esa, Ese, Esi, Eso, Esu;
 
+  KYBER_PROFILE_KECCAK();
+
   // copyFromState(A, state)
   Aba = state[0];
   Abe = state[1];
@@ -289,6 +319,34 @@ static void KeccakF1600_StatePermute(uint64_t state[25]) {
   state[24] = Asu;
 }
 
+#if defined(KYBER_KECCAK_BACKEND)
+// Through the backend registered with kyber_keccak_register()
+#define KECCAK_PERMUTE kyber_keccak_permute
+#else
+#define KECCAK_PERMUTE KeccakF1600_StatePermute
+#endif
+#define KECCAK_LANE_IN(x) (x)
+#endif /* KYBER_KECCAK_BI32 */
+
+/*************************************************
+ * Name:        keccak_extract
+ *
+ * Description: First len bytes of the sponge state
+ *************************************************/
+static void keccak_extract(uint8_t *out, const uint64_t s[25], size_t len) {
+#if defined(KYBER_KECCAK_BI32)
+  uint64_t lane;
+  size_t i;
+
+  for (i = 0; i < len; i += 8) {
+    lane = keccak_bi32_deinterleave(s[i / 8]);
+    memcpy(out + i, &lane, len - i < 8 ? len - i : 8);
+  }
+#else
+  memcpy(out, s, len);
+#endif
+}
+
 /*************************************************
  * Name:        keccak_absorb
  *
@@ -298,13 +356,21 @@ static void keccak_absorb(uint64_t s[25], unsigned int r, const uint8_t *m,
                           size_t mlen, uint8_t p) {
   size_t i;
   uint8_t t[200];
+#if defined(KYBER_KECCAK_BACKEND)
+  const kyber_keccak_backend *b = kyber_keccak_backend_get();
+
+  if (b->absorb != NULL) {
+    b->absorb(b->ctx, s, r, m, mlen, p);
+    return;
+  }
+#endif
 
   memset(s, 0, sizeof(uint64_t) * 25);
 
   while (mlen >= r) {
     for (i = 0; i < r / 8; i++)
-      s[i] ^= ((uint64_t *)m)[i];
-    KeccakF1600_StatePermute(s);
+      s[i] ^= KECCAK_LANE_IN(((uint64_t *)m)[i]);
+    KECCAK_PERMUTE(s);
     mlen -= r;
     m += r;
   }
@@ -314,7 +380,7 @@ static void keccak_absorb(uint64_t s[25], unsigned int r, const uint8_t *m,
   t[mlen] = p;
   t[r - 1] |= 128;
   for (i = 0; i < r / 8; i++)
-    s[i] ^= ((uint64_t *)t)[i];
+    s[i] ^= KECCAK_LANE_IN(((uint64_t *)t)[i]);
 }
 
 /*************************************************
@@ -324,14 +390,61 @@ static void keccak_absorb(uint64_t s[25], unsigned int r, const uint8_t *m,
  *************************************************/
 static void keccak_squeezeblocks(uint8_t *out, size_t nblocks, uint64_t s[25],
                                  unsigned int r) {
+#if defined(KYBER_KECCAK_BACKEND)
+  const kyber_keccak_backend *b = kyber_keccak_backend_get();
+
+  if (b->squeeze != NULL) {
+    b->squeeze(b->ctx, out, nblocks, s, r);
+    return;
+  }
+#endif
   while (nblocks > 0) {
-    KeccakF1600_StatePermute(s);
-    memcpy(out, s, r);
+    KECCAK_PERMUTE(s);
+    keccak_extract(out, s, r);
     out += r;
     nblocks--;
   }
 }
 
+/*************************************************
+ * Name:        keccak_absorb_short
+ *
+ * Description: keccak_absorb() for inlen < r, writing the state word by
+ *              word with the padding merged in: no memset of the state,
+ *              no staging buffer, no second pass to XOR it in. Called
+ *              with constant lengths, so the loops unroll into plain
+ *              loads and stores.
+ *************************************************/
+static inline void keccak_absorb_short(uint64_t s[25], unsigned int r,
+                                       const uint8_t *in, size_t inlen,
+                                       uint8_t p) {
+  uint64_t w;
+  size_t i, j;
+#if defined(KYBER_KECCAK_BACKEND)
+  const kyber_keccak_backend *b = kyber_keccak_backend_get();
+
+  if (b->absorb != NULL) {
+    b->absorb(b->ctx, s, r, in, inlen, p);
+    return;
+  }
+#endif
+
+  for (i = 0; i < inlen / 8; i++) {
+    memcpy(&w, in + 8 * i, 8);
+    s[i] = KECCAK_LANE_IN(w);
+  }
+
+  // Trailing inlen % 8 bytes and the domain separation byte
+  w = (uint64_t)p << (8 * (inlen % 8));
+  for (j = 0; j < inlen % 8; j++)
+    w |= (uint64_t)in[8 * i + j] << (8 * j);
+  s[i] = KECCAK_LANE_IN(w);
+
+  for (i++; i < 25; i++)
+    s[i] = 0;
+  s[r / 8 - 1] ^= KECCAK_LANE_IN(1ULL << 63);
+}
+
 /*************************************************
  * Public API functions
  *************************************************/
@@ -339,7 +452,6 @@ static void keccak_squeezeblocks(uint8_t *out, size_t nblocks, uint64_t s[25],
 void shake128(uint8_t *output, size_t outlen, const uint8_t *input,
               size_t inlen) {
   uint64_t s[25];
-  uint8_t t[SHAKE128_RATE];
   size_t nblocks;
 
   keccak_absorb(s, SHAKE128_RATE, input, inlen, 0x1F);
@@ -350,16 +462,14 @@ void shake128(uint8_t *output, size_t outlen, const uint8_t *input,
   output += nblocks * SHAKE128_RATE;
 
   if (outlen) {
-    KeccakF1600_StatePermute(s);
-    memcpy(t, s, SHAKE128_RATE);
-    memcpy(output, t, outlen);
+    KECCAK_PERMUTE(s);
+    keccak_extract(output, s, outlen);
   }
 }
 
 void shake256(uint8_t *output, size_t outlen, const uint8_t *input,
               size_t inlen) {
   uint64_t s[25];
-  uint8_t t[SHAKE256_RATE];
   size_t nblocks;
 
   keccak_absorb(s, SHAKE256_RATE, input, inlen, 0x1F);
@@ -370,24 +480,86 @@ void shake256(uint8_t *output, size_t outlen, const uint8_t *input,
   output += nblocks * SHAKE256_RATE;
 
   if (outlen) {
-    KeccakF1600_StatePermute(s);
-    memcpy(t, s, SHAKE256_RATE);
-    memcpy(output, t, outlen);
+    KECCAK_PERMUTE(s);
+    keccak_extract(output, s, outlen);
   }
 }
 
 void sha3_256(uint8_t *output, const uint8_t *input, size_t inlen) {
   uint64_t s[25];
   keccak_absorb(s, SHA3_256_RATE, input, inlen, 0x06);
-  KeccakF1600_StatePermute(s);
-  memcpy(output, s, 32);
+  KECCAK_PERMUTE(s);
+  keccak_extract(output, s, 32);
 }
 
 void sha3_512(uint8_t *output, const uint8_t *input, size_t inlen) {
   uint64_t s[25];
   keccak_absorb(s, SHA3_512_RATE, input, inlen, 0x06);
-  KeccakF1600_StatePermute(s);
-  memcpy(output, s, 64);
+  KECCAK_PERMUTE(s);
+  keccak_extract(output, s, 64);
+}
+
+/*************************************************
+ * Fixed-length single-block hashes
+ *
+ * The inputs of Kyber's hash calls all fit in one block, so these
+ * absorb with keccak_absorb_short() and squeeze with one permutation.
+ * Outputs are identical to the generic functions above.
+ *************************************************/
+
+void sha3_256_32(uint8_t output[32], const uint8_t input[32]) {
+  uint64_t s[25];
+  keccak_absorb_short(s, SHA3_256_RATE, input, 32, 0x06);
+  KECCAK_PERMUTE(s);
+  keccak_extract(output, s, 32);
+}
+
+void sha3_512_32(uint8_t output[64], const uint8_t input[32]) {
+  uint64_t s[25];
+  keccak_absorb_short(s, SHA3_512_RATE, input, 32, 0x06);
+  KECCAK_PERMUTE(s);
+  keccak_extract(output, s, 64);
+}
+
+void sha3_512_64(uint8_t output[64], const uint8_t input[64]) {
+  uint64_t s[25];
+  keccak_absorb_short(s, SHA3_512_RATE, input, 64, 0x06);
+  KECCAK_PERMUTE(s);
+  keccak_extract(output, s, 64);
+}
+
+void shake256_33(uint8_t *output, size_t outlen, const uint8_t input[33]) {
+  uint64_t s[25];
+  size_t nblocks;
+
+  keccak_absorb_short(s, SHAKE256_RATE, input, 33, 0x1F);
+
+  nblocks = outlen / SHAKE256_RATE;
+  keccak_squeezeblocks(output, nblocks, s, SHAKE256_RATE);
+  outlen -= nblocks * SHAKE256_RATE;
+  output += nblocks * SHAKE256_RATE;
+
+  if (outlen) {
+    KECCAK_PERMUTE(s);
+    keccak_extract(output, s, outlen);
+  }
+}
+
+void shake256_64(uint8_t *output, size_t outlen, const uint8_t input[64]) {
+  uint64_t s[25];
+  size_t nblocks;
+
+  keccak_absorb_short(s, SHAKE256_RATE, input, 64, 0x1F);
+
+  nblocks = outlen / SHAKE256_RATE;
+  keccak_squeezeblocks(output, nblocks, s, SHAKE256_RATE);
+  outlen -= nblocks * SHAKE256_RATE;
+  output += nblocks * SHAKE256_RATE;
+
+  if (outlen) {
+    KECCAK_PERMUTE(s);
+    keccak_extract(output, s, outlen);
+  }
 }
 
 // Incremental API for SHAKE128
@@ -417,3 +589,31 @@ void shake256_squeezeblocks(uint8_t *output, size_t nblocks,
 void shake256_ctx_release(keccak_state *state) {
   (void)state; // Nothing to free
 }
+
+// Block-at-a-time SHA3-256 (resumable operations)
+void sha3_256_inc_init(keccak_state *state) {
+  memset(state->s, 0, sizeof(state->s));
+}
+
+void sha3_256_inc_absorb_block(keccak_state *state,
+                               const uint8_t input[SHA3_256_RATE]) {
+  size_t i;
+  for (i = 0; i < SHA3_256_RATE / 8; i++)
+    state->s[i] ^= KECCAK_LANE_IN(((uint64_t *)input)[i]);
+  KECCAK_PERMUTE(state->s);
+}
+
+void sha3_256_inc_finalize(uint8_t output[32], keccak_state *state,
+                           const uint8_t *input, size_t inlen) {
+  size_t i;
+  uint8_t t[SHA3_256_RATE];
+
+  memset(t, 0, SHA3_256_RATE);
+  memcpy(t, input, inlen);
+  t[inlen] = 0x06;
+  t[SHA3_256_RATE - 1] |= 128;
+  for (i = 0; i < SHA3_256_RATE / 8; i++)
+    state->s[i] ^= KECCAK_LANE_IN(((uint64_t *)t)[i]);
+  KECCAK_PERMUTE(state->s);
+  keccak_extract(output, state->s, 32);
+}
@@ -0,0 +1,153 @@
+/*************************************************
+ * 2-way SHAKE128 with AArch64 NEON
+ *
+ * Two Keccak-f[1600] states interleaved in uint64x2_t registers, one
+ * instance per 64-bit lane, so each step of the permutation runs on
+ * both states with the same instruction. Rotations are shl + sri,
+ * which ARMv8.0 cores (Cortex-A53/A72) issue at one per cycle; cores
+ * with the SHA3 extension could use rax1/xar/bcax instead.
+ *
+ * Matrix expansion is the only large hashing job with two or more
+ * independent inputs of equal length, so only SHAKE128 is provided.
+ *************************************************/
+
+#include "../include/fips202x2_neon.h"
+#include "../include/fips202.h"
+#include "../include/kyber_profile.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(KYBER_HAVE_NEON)
+
+#include <arm_neon.h>
+
+#define NROUNDS 24
+#define ROL(a, n) vsriq_n_u64(vshlq_n_u64(a, n), a, 64 - (n))
+
+// Same constants as the scalar permutation in fips202.c
+static const uint64_t KeccakF_RoundConstants[NROUNDS] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutex2
+ *
+ * Description: Keccak-f[1600] on both states; rho offsets and pi
+ *              destinations are those of fips202xn.c, unrolled
+ *              because the NEON shifts take immediates
+ *************************************************/
+static void KeccakF1600_StatePermutex2(uint64x2_t s[25]) {
+  uint64x2_t C[5], D[5], B[25];
+  unsigned int round, x, y;
+
+  // Counted as two permutations, like two calls of the scalar one
+  KYBER_PROFILE_KECCAK();
+  KYBER_PROFILE_KECCAK();
+
+  for (round = 0; round < NROUNDS; round++) {
+    // Theta
+    for (x = 0; x < 5; x++)
+      C[x] = veorq_u64(veorq_u64(s[x], s[x + 5]),
+                       veorq_u64(veorq_u64(s[x + 10], s[x + 15]), s[x + 20]));
+    for (x = 0; x < 5; x++)
+      D[x] = veorq_u64(C[(x + 4) % 5], ROL(C[(x + 1) % 5], 1));
+
+    // Theta (apply), rho and pi
+    B[0] = veorq_u64(s[0], D[0]);
+    B[10] = ROL(veorq_u64(s[1], D[1]), 1);
+    B[20] = ROL(veorq_u64(s[2], D[2]), 62);
+    B[5] = ROL(veorq_u64(s[3], D[3]), 28);
+    B[15] = ROL(veorq_u64(s[4], D[4]), 27);
+    B[16] = ROL(veorq_u64(s[5], D[0]), 36);
+    B[1] = ROL(veorq_u64(s[6], D[1]), 44);
+    B[11] = ROL(veorq_u64(s[7], D[2]), 6);
+    B[21] = ROL(veorq_u64(s[8], D[3]), 55);
+    B[6] = ROL(veorq_u64(s[9], D[4]), 20);
+    B[7] = ROL(veorq_u64(s[10], D[0]), 3);
+    B[17] = ROL(veorq_u64(s[11], D[1]), 10);
+    B[2] = ROL(veorq_u64(s[12], D[2]), 43);
+    B[12] = ROL(veorq_u64(s[13], D[3]), 25);
+    B[22] = ROL(veorq_u64(s[14], D[4]), 39);
+    B[23] = ROL(veorq_u64(s[15], D[0]), 41);
+    B[8] = ROL(veorq_u64(s[16], D[1]), 45);
+    B[18] = ROL(veorq_u64(s[17], D[2]), 15);
+    B[3] = ROL(veorq_u64(s[18], D[3]), 21);
+    B[13] = ROL(veorq_u64(s[19], D[4]), 8);
+    B[14] = ROL(veorq_u64(s[20], D[0]), 18);
+    B[24] = ROL(veorq_u64(s[21], D[1]), 2);
+    B[9] = ROL(veorq_u64(s[22], D[2]), 61);
+    B[19] = ROL(veorq_u64(s[23], D[3]), 56);
+    B[4] = ROL(veorq_u64(s[24], D[4]), 14);
+
+    // Chi
+    for (y = 0; y < 25; y += 5)
+      for (x = 0; x < 5; x++)
+        s[y + x] = veorq_u64(B[y + x],
+                             vbicq_u64(B[y + (x + 2) % 5], B[y + (x + 1) % 5]));
+
+    // Iota
+    s[0] = veorq_u64(s[0], vdupq_n_u64(KeccakF_RoundConstants[round]));
+  }
+}
+
+// One little-endian 64-bit word from each of two byte strings
+static inline uint64x2_t load64x2(const uint8_t *a, const uint8_t *b) {
+  return vcombine_u64(vreinterpret_u64_u8(vld1_u8(a)),
+                      vreinterpret_u64_u8(vld1_u8(b)));
+}
+
+/*************************************************
+ * Name:        shake128x2
+ *
+ * Description: SHAKE128 of two inputs of inlen bytes each, outlen
+ *              bytes of output per input; the same bytes as two
+ *              calls of shake128()
+ *************************************************/
+void shake128x2(uint8_t *out0, uint8_t *out1, size_t outlen,
+                const uint8_t *in0, const uint8_t *in1, size_t inlen) {
+  uint64x2_t s[25];
+  uint8_t t[2][SHAKE128_RATE];
+  uint64_t lanes[2];
+  size_t off = 0, n;
+  unsigned int i;
+
+  for (i = 0; i < 25; i++)
+    s[i] = vdupq_n_u64(0);
+
+  // Absorb
+  while (inlen - off >= SHAKE128_RATE) {
+    for (i = 0; i < SHAKE128_RATE / 8; i++)
+      s[i] = veorq_u64(s[i], load64x2(in0 + off + 8 * i, in1 + off + 8 * i));
+    KeccakF1600_StatePermutex2(s);
+    off += SHAKE128_RATE;
+  }
+  memset(t, 0, sizeof(t));
+  memcpy(t[0], in0 + off, inlen - off);
+  memcpy(t[1], in1 + off, inlen - off);
+  t[0][inlen - off] = t[1][inlen - off] = 0x1F;
+  t[0][SHAKE128_RATE - 1] |= 128;
+  t[1][SHAKE128_RATE - 1] |= 128;
+  for (i = 0; i < SHAKE128_RATE / 8; i++)
+    s[i] = veorq_u64(s[i], load64x2(t[0] + 8 * i, t[1] + 8 * i));
+
+  // Squeeze
+  for (off = 0; off < outlen; off += n) {
+    KeccakF1600_StatePermutex2(s);
+    n = (outlen - off < SHAKE128_RATE) ? outlen - off : SHAKE128_RATE;
+    for (i = 0; i < SHAKE128_RATE / 8; i++) {
+      vst1q_u64(lanes, s[i]);
+      memcpy(t[0] + 8 * i, &lanes[0], 8);
+      memcpy(t[1] + 8 * i, &lanes[1], 8);
+    }
+    memcpy(out0 + off, t[0], n);
+    memcpy(out1 + off, t[1], n);
+  }
+}
+
+#endif /* KYBER_HAVE_NEON */
@@ -0,0 +1,180 @@
+/*************************************************
+ * Multi-lane SHA3 / SHAKE
+ *
+ * KYBER_XN_LANES Keccak-f[1600] instances in lane-major layout.
+ * Each permutation step (theta, rho-pi, chi, iota) is a loop over the
+ * lanes with identical control flow, so it vectorises vertically.
+ *************************************************/
+
+#include "../include/fips202xn.h"
+#include "../include/fips202.h"
+#if defined(KYBER_BACKEND_RVV)
+#include "../include/fips202xn_rvv.h"
+#endif
+#include <stdint.h>
+#include <string.h>
+
+#define NROUNDS 24
+#define L KYBER_XN_LANES
+
+static uint64_t load64(const uint8_t x[8]) {
+  uint64_t r = 0;
+  for (unsigned int i = 0; i < 8; i++)
+    r |= (uint64_t)x[i] << (8 * i);
+  return r;
+}
+
+static void store64(uint8_t x[8], uint64_t u) {
+  for (unsigned int i = 0; i < 8; i++)
+    x[i] = (uint8_t)(u >> (8 * i));
+}
+
+#if defined(KYBER_BACKEND_RVV)
+// Same permutation on the vector unit, see fips202xn_rvv.c
+static void KeccakF1600_StatePermutexn(uint64_t s[25][L]) {
+  KeccakF1600_StatePermutexn_rvv(&s[0][0], L);
+}
+#else
+// Same constants as the scalar permutation in fips202.c
+static const uint64_t KeccakF_RoundConstants[NROUNDS] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+// Rotation offset of lane (x, y), indexed by x + 5*y
+static const unsigned int KeccakF_RhoOffsets[25] = {
+    0,  1,  62, 28, 27, 36, 44, 6,  55, 20, 3,  10, 43,
+    25, 39, 41, 45, 15, 21, 8,  18, 2,  61, 56, 14};
+
+// Destination of lane x + 5*y under pi: (y, 2x + 3y)
+static const unsigned int KeccakF_PiLane[25] = {
+    0,  10, 20, 5,  15, 16, 1,  11, 21, 6,  7,  17, 2,
+    12, 22, 23, 8,  18, 3,  13, 14, 24, 9,  19, 4};
+
+static inline uint64_t rol64(uint64_t a, unsigned int n) {
+  return (a << n) | (a >> ((64 - n) & 63));
+}
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutexn
+ *
+ * Description: Keccak-f[1600] on all lanes
+ *************************************************/
+static void KeccakF1600_StatePermutexn(uint64_t s[25][L]) {
+  uint64_t C[5][L], D[5][L], B[25][L];
+  unsigned int round, x, y, i, l;
+
+  for (round = 0; round < NROUNDS; round++) {
+    // Theta
+    for (x = 0; x < 5; x++)
+      for (l = 0; l < L; l++)
+        C[x][l] = s[x][l] ^ s[x + 5][l] ^ s[x + 10][l] ^ s[x + 15][l] ^
+                  s[x + 20][l];
+    for (x = 0; x < 5; x++)
+      for (l = 0; l < L; l++)
+        D[x][l] = C[(x + 4) % 5][l] ^ rol64(C[(x + 1) % 5][l], 1);
+
+    // Theta (apply), rho and pi
+    for (i = 0; i < 25; i++)
+      for (l = 0; l < L; l++)
+        B[KeccakF_PiLane[i]][l] =
+            rol64(s[i][l] ^ D[i % 5][l], KeccakF_RhoOffsets[i]);
+
+    // Chi
+    for (y = 0; y < 25; y += 5)
+      for (x = 0; x < 5; x++)
+        for (l = 0; l < L; l++)
+          s[y + x][l] = B[y + x][l] ^
+                        ((~B[y + (x + 1) % 5][l]) & B[y + (x + 2) % 5][l]);
+
+    // Iota
+    for (l = 0; l < L; l++)
+      s[0][l] ^= KeccakF_RoundConstants[round];
+  }
+}
+#endif /* KYBER_BACKEND_RVV */
+
+/*************************************************
+ * Name:        keccakxn_absorb
+ *
+ * Description: Absorb one equal-length input per lane
+ *************************************************/
+static void keccakxn_absorb(uint64_t s[25][L], unsigned int r,
+                            const uint8_t *const in[L], size_t inlen,
+                            uint8_t p) {
+  size_t off = 0, rem;
+  unsigned int i, l;
+  uint8_t t[200];
+
+  memset(s, 0, sizeof(uint64_t) * 25 * L);
+
+  while (inlen - off >= r) {
+    for (i = 0; i < r / 8; i++)
+      for (l = 0; l < L; l++)
+        s[i][l] ^= load64(in[l] + off + 8 * i);
+    KeccakF1600_StatePermutexn(s);
+    off += r;
+  }
+
+  rem = inlen - off;
+  for (l = 0; l < L; l++) {
+    memset(t, 0, r);
+    memcpy(t, in[l] + off, rem);
+    t[rem] = p;
+    t[r - 1] |= 128;
+    for (i = 0; i < r / 8; i++)
+      s[i][l] ^= load64(t + 8 * i);
+  }
+}
+
+/*************************************************
+ * Name:        keccakxn_squeeze
+ *
+ * Description: Squeeze outlen bytes per lane
+ *************************************************/
+static void keccakxn_squeeze(uint8_t *const out[L], size_t outlen,
+                             uint64_t s[25][L], unsigned int r) {
+  size_t off = 0, n;
+  unsigned int i, l;
+  uint8_t t[8];
+
+  while (off < outlen) {
+    KeccakF1600_StatePermutexn(s);
+    n = (outlen - off < r) ? outlen - off : r;
+    for (l = 0; l < L; l++) {
+      for (i = 0; i < n / 8; i++)
+        store64(out[l] + off + 8 * i, s[i][l]);
+      if (n % 8) {
+        store64(t, s[n / 8][l]);
+        memcpy(out[l] + off + 8 * (n / 8), t, n % 8);
+      }
+    }
+    off += n;
+  }
+}
+
+void sha3_256xn(uint8_t *const out[L], const uint8_t *const in[L],
+                size_t inlen) {
+  uint64_t s[25][L];
+  keccakxn_absorb(s, SHA3_256_RATE, in, inlen, 0x06);
+  keccakxn_squeeze(out, 32, s, SHA3_256_RATE);
+}
+
+void sha3_512xn(uint8_t *const out[L], const uint8_t *const in[L],
+                size_t inlen) {
+  uint64_t s[25][L];
+  keccakxn_absorb(s, SHA3_512_RATE, in, inlen, 0x06);
+  keccakxn_squeeze(out, 64, s, SHA3_512_RATE);
+}
+
+void shake256xn(uint8_t *const out[L], size_t outlen,
+                const uint8_t *const in[L], size_t inlen) {
+  uint64_t s[25][L];
+  keccakxn_absorb(s, SHAKE256_RATE, in, inlen, 0x1F);
+  keccakxn_squeeze(out, outlen, s, SHAKE256_RATE);
+}
@@ -0,0 +1,205 @@
+/*************************************************
+ * Multi-lane SHAKE128 and Keccak-f[1600] with RVV
+ *
+ * The lane-major state of fips202xn.c (word i of lane l at
+ * s[i * lanes + l]) is exactly what vle64 wants: word i of vl lanes
+ * is one unit-stride load. The permutation keeps all 25 words of vl
+ * lanes in registers for the 24 rounds, so it handles as many
+ * instances per pass as the vector length allows (2 at VLEN = 128,
+ * 16 at VLEN = 1024) and loops for the rest.
+ *
+ * Vector types cannot be array elements, so the state is 25 named
+ * registers and rho-pi is written out, with the offsets and
+ * destinations of fips202xn.c.
+ *************************************************/
+
+#include "../include/fips202xn_rvv.h"
+#include "../include/fips202.h"
+#include "../include/kyber_profile.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(KYBER_HAVE_RVV)
+
+#include <riscv_vector.h>
+
+#define NROUNDS 24
+#define ROL(a, n)                                                              \
+  __riscv_vor_vv_u64m1(__riscv_vsll_vx_u64m1(a, n, vl),                        \
+                       __riscv_vsrl_vx_u64m1(a, 64 - (n), vl), vl)
+#define XOR5(a, b, c, d, e)                                                    \
+  __riscv_vxor_vv_u64m1(                                                       \
+      __riscv_vxor_vv_u64m1(__riscv_vxor_vv_u64m1(a, b, vl),                   \
+                            __riscv_vxor_vv_u64m1(c, d, vl), vl),              \
+      e, vl)
+// a ^ (~b & c)
+#define CHI(a, b, c)                                                           \
+  __riscv_vxor_vv_u64m1(                                                       \
+      a, __riscv_vand_vv_u64m1(__riscv_vnot_v_u64m1(b, vl), c, vl), vl)
+#define CHI_ROW(o0, o1, o2, o3, o4, i0, i1, i2, i3, i4)                        \
+  do {                                                                         \
+    o0 = CHI(i0, i1, i2);                                                      \
+    o1 = CHI(i1, i2, i3);                                                      \
+    o2 = CHI(i2, i3, i4);                                                      \
+    o3 = CHI(i3, i4, i0);                                                      \
+    o4 = CHI(i4, i0, i1);                                                      \
+  } while (0)
+
+// Word i of lanes l .. l + vl - 1 to and from register a<i>
+#define LD(i) a##i = __riscv_vle64_v_u64m1(s + (i) * lanes + l, vl);
+#define ST(i) __riscv_vse64_v_u64m1(s + (i) * lanes + l, a##i, vl);
+#define EACH_WORD(X)                                                           \
+  X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7) X(8) X(9) X(10) X(11) X(12) X(13)    \
+      X(14) X(15) X(16) X(17) X(18) X(19) X(20) X(21) X(22) X(23) X(24)
+
+// Same constants as the scalar permutation in fips202.c
+static const uint64_t KeccakF_RoundConstants[NROUNDS] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL,
+    0x8000000080008000ULL, 0x000000000000808bULL, 0x0000000080000001ULL,
+    0x8000000080008081ULL, 0x8000000000008009ULL, 0x000000000000008aULL,
+    0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL,
+    0x8000000000008003ULL, 0x8000000000008002ULL, 0x8000000000000080ULL,
+    0x000000000000800aULL, 0x800000008000000aULL, 0x8000000080008081ULL,
+    0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermutexn_rvv
+ *
+ * Description: Keccak-f[1600] on lanes instances, s[25 * lanes]
+ *              in lane-major order
+ *************************************************/
+void KeccakF1600_StatePermutexn_rvv(uint64_t *s, unsigned int lanes) {
+  vuint64m1_t a0, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12;
+  vuint64m1_t a13, a14, a15, a16, a17, a18, a19, a20, a21, a22, a23, a24;
+  vuint64m1_t b0, b1, b2, b3, b4, b5, b6, b7, b8, b9, b10, b11, b12;
+  vuint64m1_t b13, b14, b15, b16, b17, b18, b19, b20, b21, b22, b23, b24;
+  vuint64m1_t c0, c1, c2, c3, c4, d0, d1, d2, d3, d4;
+  unsigned int l, round;
+  size_t vl;
+
+  for (l = 0; l < lanes; l += vl) {
+    vl = __riscv_vsetvl_e64m1(lanes - l);
+    EACH_WORD(LD)
+
+    for (round = 0; round < NROUNDS; round++) {
+      // Theta
+      c0 = XOR5(a0, a5, a10, a15, a20);
+      c1 = XOR5(a1, a6, a11, a16, a21);
+      c2 = XOR5(a2, a7, a12, a17, a22);
+      c3 = XOR5(a3, a8, a13, a18, a23);
+      c4 = XOR5(a4, a9, a14, a19, a24);
+      d0 = __riscv_vxor_vv_u64m1(c4, ROL(c1, 1), vl);
+      d1 = __riscv_vxor_vv_u64m1(c0, ROL(c2, 1), vl);
+      d2 = __riscv_vxor_vv_u64m1(c1, ROL(c3, 1), vl);
+      d3 = __riscv_vxor_vv_u64m1(c2, ROL(c4, 1), vl);
+      d4 = __riscv_vxor_vv_u64m1(c3, ROL(c0, 1), vl);
+
+      // Theta (apply), rho and pi
+      b0 = __riscv_vxor_vv_u64m1(a0, d0, vl);
+      b10 = ROL(__riscv_vxor_vv_u64m1(a1, d1, vl), 1);
+      b20 = ROL(__riscv_vxor_vv_u64m1(a2, d2, vl), 62);
+      b5 = ROL(__riscv_vxor_vv_u64m1(a3, d3, vl), 28);
+      b15 = ROL(__riscv_vxor_vv_u64m1(a4, d4, vl), 27);
+      b16 = ROL(__riscv_vxor_vv_u64m1(a5, d0, vl), 36);
+      b1 = ROL(__riscv_vxor_vv_u64m1(a6, d1, vl), 44);
+      b11 = ROL(__riscv_vxor_vv_u64m1(a7, d2, vl), 6);
+      b21 = ROL(__riscv_vxor_vv_u64m1(a8, d3, vl), 55);
+      b6 = ROL(__riscv_vxor_vv_u64m1(a9, d4, vl), 20);
+      b7 = ROL(__riscv_vxor_vv_u64m1(a10, d0, vl), 3);
+      b17 = ROL(__riscv_vxor_vv_u64m1(a11, d1, vl), 10);
+      b2 = ROL(__riscv_vxor_vv_u64m1(a12, d2, vl), 43);
+      b12 = ROL(__riscv_vxor_vv_u64m1(a13, d3, vl), 25);
+      b22 = ROL(__riscv_vxor_vv_u64m1(a14, d4, vl), 39);
+      b23 = ROL(__riscv_vxor_vv_u64m1(a15, d0, vl), 41);
+      b8 = ROL(__riscv_vxor_vv_u64m1(a16, d1, vl), 45);
+      b18 = ROL(__riscv_vxor_vv_u64m1(a17, d2, vl), 15);
+      b3 = ROL(__riscv_vxor_vv_u64m1(a18, d3, vl), 21);
+      b13 = ROL(__riscv_vxor_vv_u64m1(a19, d4, vl), 8);
+      b14 = ROL(__riscv_vxor_vv_u64m1(a20, d0, vl), 18);
+      b24 = ROL(__riscv_vxor_vv_u64m1(a21, d1, vl), 2);
+      b9 = ROL(__riscv_vxor_vv_u64m1(a22, d2, vl), 61);
+      b19 = ROL(__riscv_vxor_vv_u64m1(a23, d3, vl), 56);
+      b4 = ROL(__riscv_vxor_vv_u64m1(a24, d4, vl), 14);
+
+      // Chi
+      CHI_ROW(a0, a1, a2, a3, a4, b0, b1, b2, b3, b4);
+      CHI_ROW(a5, a6, a7, a8, a9, b5, b6, b7, b8, b9);
+      CHI_ROW(a10, a11, a12, a13, a14, b10, b11, b12, b13, b14);
+      CHI_ROW(a15, a16, a17, a18, a19, b15, b16, b17, b18, b19);
+      CHI_ROW(a20, a21, a22, a23, a24, b20, b21, b22, b23, b24);
+
+      // Iota
+      a0 = __riscv_vxor_vx_u64m1(a0, KeccakF_RoundConstants[round], vl);
+    }
+
+    EACH_WORD(ST)
+  }
+}
+
+static uint64_t load64(const uint8_t x[8]) {
+  uint64_t r = 0;
+  for (unsigned int i = 0; i < 8; i++)
+    r |= (uint64_t)x[i] << (8 * i);
+  return r;
+}
+
+static void store64(uint8_t x[8], uint64_t u) {
+  for (unsigned int i = 0; i < 8; i++)
+    x[i] = (uint8_t)(u >> (8 * i));
+}
+
+/*************************************************
+ * Name:        shake128xn_rvv
+ *
+ * Description: SHAKE128 of n inputs of inlen bytes each, outlen bytes
+ *              of output per input; the same bytes as n calls of
+ *              shake128()
+ *************************************************/
+void shake128xn_rvv(uint8_t *const *out, size_t outlen,
+                    const uint8_t *const *in, size_t inlen, unsigned int n) {
+  uint64_t s[25 * KYBER_RVV_MAX_LANES];
+  uint8_t t[SHAKE128_RATE];
+  size_t off = 0, m;
+  unsigned int i, l;
+
+  memset(s, 0, sizeof(uint64_t) * 25 * n);
+
+  // Absorb
+  while (inlen - off >= SHAKE128_RATE) {
+    for (i = 0; i < SHAKE128_RATE / 8; i++)
+      for (l = 0; l < n; l++)
+        s[i * n + l] ^= load64(in[l] + off + 8 * i);
+    KeccakF1600_StatePermutexn_rvv(s, n);
+    // Counted per instance, like n calls of the scalar permutation
+    for (l = 0; l < n; l++)
+      KYBER_PROFILE_KECCAK();
+    off += SHAKE128_RATE;
+  }
+  for (l = 0; l < n; l++) {
+    memset(t, 0, sizeof(t));
+    memcpy(t, in[l] + off, inlen - off);
+    t[inlen - off] = 0x1F;
+    t[SHAKE128_RATE - 1] |= 128;
+    for (i = 0; i < SHAKE128_RATE / 8; i++)
+      s[i * n + l] ^= load64(t + 8 * i);
+  }
+
+  // Squeeze
+  for (off = 0; off < outlen; off += m) {
+    KeccakF1600_StatePermutexn_rvv(s, n);
+    for (l = 0; l < n; l++)
+      KYBER_PROFILE_KECCAK();
+    m = (outlen - off < SHAKE128_RATE) ? outlen - off : SHAKE128_RATE;
+    for (l = 0; l < n; l++) {
+      for (i = 0; i < m / 8; i++)
+        store64(out[l] + off + 8 * i, s[i * n + l]);
+      if (m % 8) {
+        store64(t, s[(m / 8) * n + l]);
+        memcpy(out[l] + off + 8 * (m / 8), t, m % 8);
+      }
+    }
+  }
+}
+
+#endif /* KYBER_HAVE_RVV */
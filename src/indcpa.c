@@ -6,10 +6,19 @@
 
 #include "../include/indcpa.h"
 #include "../include/fips202.h"
+#include "../include/kyber_profile.h"
 #include "../include/ntt.h"
+#if defined(KYBER_BACKEND_NEON)
+#include "../include/fips202x2_neon.h"
+#include "../include/ntt_neon.h"
+#elif defined(KYBER_BACKEND_RVV)
+#include "../include/fips202xn_rvv.h"
+#include "../include/ntt_rvv.h"
+#endif
 #include "../include/params.h"
 #include "../include/poly.h"
 #include "../include/polyvec.h"
+#include "../include/randombytes.h"
 #include <stdint.h>
 #include <string.h>
 
@@ -85,6 +94,11 @@ static void unpack_ciphertext(polyvec *b, poly *v,
  *************************************************/
 static unsigned int rej_uniform(int16_t *r, unsigned int len,
                                 const uint8_t *buf, unsigned int buflen) {
+#if defined(KYBER_BACKEND_NEON)
+  return rej_uniform_neon(r, len, buf, buflen);
+#elif defined(KYBER_BACKEND_RVV)
+  return rej_uniform_rvv(r, len, buf, buflen);
+#else
   unsigned int ctr, pos;
   uint16_t val0, val1;
 
@@ -101,56 +115,126 @@ static unsigned int rej_uniform(int16_t *r, unsigned int len,
   }
 
   return ctr;
+#endif
 }
 
 #define GEN_A_NBLOCKS                                                          \
   ((12 * KYBER_N / 8 * (1 << 12) / KYBER_Q + SHAKE128_RATE) / SHAKE128_RATE)
 
+/*************************************************
+ * Name:        gen_matrix_sample
+ *
+ * Description: Rejection-samples one matrix entry from the first
+ *              GEN_A_NBLOCKS blocks of its XOF output in buf, and
+ *              from further SHAKE128(extseed) blocks if needed
+ *************************************************/
+static void gen_matrix_sample(poly *r,
+                              uint8_t buf[GEN_A_NBLOCKS * SHAKE128_RATE + 2],
+                              const uint8_t extseed[KYBER_SYMBYTES + 2]) {
+  unsigned int ctr, k;
+  unsigned int buflen, off;
+
+  buflen = GEN_A_NBLOCKS * SHAKE128_RATE;
+  ctr = rej_uniform(r->coeffs, KYBER_N, buf, buflen);
+
+  while (ctr < KYBER_N) {
+    off = buflen % 3;
+    for (k = 0; k < off; k++)
+      buf[k] = buf[buflen - off + k];
+    shake128(buf + off, SHAKE128_RATE, extseed, KYBER_SYMBYTES + 2);
+    buflen = off + SHAKE128_RATE;
+    ctr += rej_uniform(r->coeffs + ctr, KYBER_N - ctr, buf, buflen);
+  }
+}
+
+/*************************************************
+ * Name:        gen_matrix_entry
+ *
+ * Description: Samples one matrix entry from SHAKE128(seed || x || y)
+ *************************************************/
+void gen_matrix_entry(poly *r, const uint8_t seed[KYBER_SYMBYTES], uint8_t x,
+                      uint8_t y) {
+  uint8_t buf[GEN_A_NBLOCKS * SHAKE128_RATE + 2];
+  uint8_t extseed[KYBER_SYMBYTES + 2];
+
+  // Absorb seed || indices
+  memcpy(extseed, seed, KYBER_SYMBYTES);
+  extseed[KYBER_SYMBYTES] = x;
+  extseed[KYBER_SYMBYTES + 1] = y;
+
+  shake128(buf, sizeof(buf), extseed, sizeof(extseed));
+  gen_matrix_sample(r, buf, extseed);
+}
+
 /*************************************************
  * Name:        gen_matrix
  *
  * Description: Deterministically generate matrix A (or transposed)
  *              from a seed. Entries are polynomials that look uniformly random.
  *************************************************/
-static void gen_matrix(polyvec *a, const uint8_t seed[KYBER_SYMBYTES],
-                       int transposed) {
-  unsigned int ctr, i, j, k;
-  unsigned int buflen, off;
-  uint8_t buf[GEN_A_NBLOCKS * SHAKE128_RATE + 2];
-  keccak_state state;
+void gen_matrix(polyvec *a, const uint8_t seed[KYBER_SYMBYTES],
+                int transposed) {
+  unsigned int i, j;
+#if defined(KYBER_BACKEND_NEON)
+  // Entries in row-major order, two at a time through the 2-way XOF
+  uint8_t buf[2][GEN_A_NBLOCKS * SHAKE128_RATE + 2];
+  uint8_t extseed[2][KYBER_SYMBYTES + 2];
+  unsigned int e, l;
+
+  for (e = 0; e + 1 < KYBER_K * KYBER_K; e += 2) {
+    for (l = 0; l < 2; l++) {
+      i = (e + l) / KYBER_K;
+      j = (e + l) % KYBER_K;
+      memcpy(extseed[l], seed, KYBER_SYMBYTES);
+      extseed[l][KYBER_SYMBYTES] = (uint8_t)(transposed ? i : j);
+      extseed[l][KYBER_SYMBYTES + 1] = (uint8_t)(transposed ? j : i);
+    }
+    shake128x2(buf[0], buf[1], sizeof(buf[0]), extseed[0], extseed[1],
+               sizeof(extseed[0]));
+    for (l = 0; l < 2; l++)
+      gen_matrix_sample(&a[(e + l) / KYBER_K].vec[(e + l) % KYBER_K], buf[l],
+                        extseed[l]);
+  }
+
+  // Odd number of entries (K = 3): the last one alone
+  if (e < KYBER_K * KYBER_K) {
+    i = e / KYBER_K;
+    j = e % KYBER_K;
+    if (transposed)
+      gen_matrix_entry(&a[i].vec[j], seed, i, j);
+    else
+      gen_matrix_entry(&a[i].vec[j], seed, j, i);
+  }
+#elif defined(KYBER_BACKEND_RVV)
+  // One row of K entries per call, one instance per 64-bit vector
+  // element; all K*K at once would add 12 KB of stack at K = 4
+  uint8_t buf[KYBER_K][GEN_A_NBLOCKS * SHAKE128_RATE + 2];
+  uint8_t extseed[KYBER_K][KYBER_SYMBYTES + 2];
+  uint8_t *out[KYBER_K];
+  const uint8_t *in[KYBER_K];
 
   for (i = 0; i < KYBER_K; i++) {
     for (j = 0; j < KYBER_K; j++) {
-      if (transposed) {
-        buf[0] = i;
-        buf[1] = j;
-      } else {
-        buf[0] = j;
-        buf[1] = i;
-      }
-
-      // Absorb seed || indices
-      uint8_t extseed[KYBER_SYMBYTES + 2];
-      memcpy(extseed, seed, KYBER_SYMBYTES);
-      extseed[KYBER_SYMBYTES] = buf[0];
-      extseed[KYBER_SYMBYTES + 1] = buf[1];
-
-      shake128(buf, sizeof(buf), extseed, sizeof(extseed));
-
-      buflen = GEN_A_NBLOCKS * SHAKE128_RATE;
-      ctr = rej_uniform(a[i].vec[j].coeffs, KYBER_N, buf, buflen);
-
-      while (ctr < KYBER_N) {
-        off = buflen % 3;
-        for (k = 0; k < off; k++)
-          buf[k] = buf[buflen - off + k];
-        shake128(buf + off, SHAKE128_RATE, extseed, sizeof(extseed));
-        buflen = off + SHAKE128_RATE;
-        ctr +=
-            rej_uniform(a[i].vec[j].coeffs + ctr, KYBER_N - ctr, buf, buflen);
-      }
+      memcpy(extseed[j], seed, KYBER_SYMBYTES);
+      extseed[j][KYBER_SYMBYTES] = (uint8_t)(transposed ? i : j);
+      extseed[j][KYBER_SYMBYTES + 1] = (uint8_t)(transposed ? j : i);
+      out[j] = buf[j];
+      in[j] = extseed[j];
     }
+    shake128xn_rvv(out, sizeof(buf[0]), in, sizeof(extseed[0]), KYBER_K);
+    for (j = 0; j < KYBER_K; j++)
+      gen_matrix_sample(&a[i].vec[j], buf[j], extseed[j]);
   }
+#else
+  for (i = 0; i < KYBER_K; i++) {
+    for (j = 0; j < KYBER_K; j++) {
+      if (transposed)
+        gen_matrix_entry(&a[i].vec[j], seed, i, j);
+      else
+        gen_matrix_entry(&a[i].vec[j], seed, j, i);
+    }
+  }
+#endif
 }
 
 /*************************************************
@@ -160,26 +244,34 @@ static void gen_matrix(polyvec *a, const uint8_t seed[KYBER_SYMBYTES],
  *
  * Algorithm 4 from Kyber spec
  *************************************************/
-void indcpa_keypair(uint8_t pk[KYBER_PUBLICKEYBYTES],
-                    uint8_t sk[KYBER_SECRETKEYBYTES]) {
+int indcpa_keypair(uint8_t pk[KYBER_PUBLICKEYBYTES],
+                   uint8_t sk[KYBER_SECRETKEYBYTES]) {
   unsigned int i;
+  int ret;
   uint8_t buf[2 * KYBER_SYMBYTES];
   const uint8_t *publicseed = buf;
   const uint8_t *noiseseed = buf + KYBER_SYMBYTES;
   polyvec a[KYBER_K], e, pkpv, skpv;
   uint8_t nonce = 0;
 
-  // Generate random bytes
-  // In production, use a secure RNG. For now, we'll use a placeholder.
-  // randombytes(buf, KYBER_SYMBYTES);
-  memset(buf, 0x42, KYBER_SYMBYTES); // Placeholder - replace with real RNG
+  // Generate random seed d
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_RANDOMBYTES);
+  ret = randombytes(buf, KYBER_SYMBYTES);
+  KYBER_PROFILE_END(KYBER_PHASE_RANDOMBYTES);
+  if (ret != 0)
+    return -1;
 
   // Hash to get public seed and noise seed
-  sha3_512(buf, buf, KYBER_SYMBYTES);
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_HASH);
+  sha3_512_32(buf, buf);
+  KYBER_PROFILE_END(KYBER_PHASE_HASH);
 
   // Generate matrix A
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_GEN_MATRIX);
   gen_matrix(a, publicseed, 0);
+  KYBER_PROFILE_END(KYBER_PHASE_GEN_MATRIX);
 
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_NOISE);
   // Sample secret vector s
   for (i = 0; i < KYBER_K; i++)
     poly_getnoise_eta1(&skpv.vec[i], noiseseed, nonce++);
@@ -187,12 +279,16 @@ void indcpa_keypair(uint8_t pk[KYBER_PUBLICKEYBYTES],
   // Sample error vector e
   for (i = 0; i < KYBER_K; i++)
     poly_getnoise_eta1(&e.vec[i], noiseseed, nonce++);
+  KYBER_PROFILE_END(KYBER_PHASE_NOISE);
 
   // Convert s to NTT domain
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_NTT);
   polyvec_ntt(&skpv);
   polyvec_ntt(&e);
+  KYBER_PROFILE_END(KYBER_PHASE_NTT);
 
   // Compute t = As + e
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_MATVEC);
   for (i = 0; i < KYBER_K; i++) {
     polyvec_pointwise_acc_montgomery(&pkpv.vec[i], &a[i], &skpv);
     poly_tomont(&pkpv.vec[i]);
@@ -200,10 +296,14 @@ void indcpa_keypair(uint8_t pk[KYBER_PUBLICKEYBYTES],
 
   polyvec_add(&pkpv, &pkpv, &e);
   polyvec_reduce(&pkpv);
+  KYBER_PROFILE_END(KYBER_PHASE_MATVEC);
 
   // Pack keys
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_PACK);
   pack_sk(sk, &skpv);
   pack_pk(pk, &pkpv, publicseed);
+  KYBER_PROFILE_END(KYBER_PHASE_PACK);
+  return 0;
 }
 
 /*************************************************
@@ -224,14 +324,19 @@ void indcpa_enc(uint8_t c[KYBER_CIPHERTEXTBYTES],
   poly v, k, epp;
 
   // Unpack public key
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_PACK);
   unpack_pk(&pkpv, seed, pk);
 
   // Encode message as polynomial
   poly_frommsg(&k, m);
+  KYBER_PROFILE_END(KYBER_PHASE_PACK);
 
   // Generate transposed matrix A^T
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_GEN_MATRIX);
   gen_matrix(at, seed, 1);
+  KYBER_PROFILE_END(KYBER_PHASE_GEN_MATRIX);
 
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_NOISE);
   // Sample secret vector r (sp)
   for (i = 0; i < KYBER_K; i++)
     poly_getnoise_eta1(&sp.vec[i], coins, nonce++);
@@ -242,27 +347,38 @@ void indcpa_enc(uint8_t c[KYBER_CIPHERTEXTBYTES],
 
   // Sample error polynomial e2 (epp)
   poly_getnoise_eta2(&epp, coins, nonce++);
+  KYBER_PROFILE_END(KYBER_PHASE_NOISE);
 
   // NTT(r)
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_NTT);
   polyvec_ntt(&sp);
+  KYBER_PROFILE_END(KYBER_PHASE_NTT);
 
-  // Compute u = A^T * r + e1
+  // Compute u = A^T * r and v = t^T * r
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_MATVEC);
   for (i = 0; i < KYBER_K; i++)
     polyvec_pointwise_acc_montgomery(&b.vec[i], &at[i], &sp);
+  polyvec_pointwise_acc_montgomery(&v, &pkpv, &sp);
+  KYBER_PROFILE_END(KYBER_PHASE_MATVEC);
 
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_INVNTT);
   polyvec_invntt(&b);
+  poly_invntt(&v);
+  KYBER_PROFILE_END(KYBER_PHASE_INVNTT);
+
+  // u += e1, v += e2 + m
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_MATVEC);
   polyvec_add(&b, &b, &ep);
   polyvec_reduce(&b);
-
-  // Compute v = t^T * r + e2 + m
-  polyvec_pointwise_acc_montgomery(&v, &pkpv, &sp);
-  poly_invntt(&v);
   poly_add(&v, &v, &epp);
   poly_add(&v, &v, &k);
   poly_reduce(&v);
+  KYBER_PROFILE_END(KYBER_PHASE_MATVEC);
 
   // Pack ciphertext
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_PACK);
   pack_ciphertext(c, &b, &v);
+  KYBER_PROFILE_END(KYBER_PHASE_PACK);
 }
 
 /*************************************************
@@ -279,21 +395,34 @@ void indcpa_dec(uint8_t m[KYBER_SYMBYTES],
   poly v, mp;
 
   // Unpack ciphertext and secret key
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_PACK);
   unpack_ciphertext(&b, &v, c);
   unpack_sk(&skpv, sk);
+  KYBER_PROFILE_END(KYBER_PHASE_PACK);
 
   // NTT(u)
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_NTT);
   polyvec_ntt(&b);
+  KYBER_PROFILE_END(KYBER_PHASE_NTT);
 
   // Compute m = v - s^T * u
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_MATVEC);
   polyvec_pointwise_acc_montgomery(&mp, &skpv, &b);
+  KYBER_PROFILE_END(KYBER_PHASE_MATVEC);
+
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_INVNTT);
   poly_invntt(&mp);
+  KYBER_PROFILE_END(KYBER_PHASE_INVNTT);
 
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_MATVEC);
   poly_sub(&mp, &v, &mp);
   poly_reduce(&mp);
+  KYBER_PROFILE_END(KYBER_PHASE_MATVEC);
 
   // Decode message
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_PACK);
   poly_tomsg(m, &mp);
+  KYBER_PROFILE_END(KYBER_PHASE_PACK);
 }
 
 /*************************************************
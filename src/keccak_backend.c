@@ -0,0 +1,270 @@
+/*************************************************
+ * Pluggable Keccak Backend
+ *
+ * Registry of the backend behind fips202.c, the software reference
+ * backend and, on Linux, a worker thread emulating an accelerator.
+ *************************************************/
+
+#include "../include/keccak_backend.h"
+#include "../include/fips202.h"
+#include "../include/keccak_bi32.h"
+#include "../include/kyber_profile.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+static void software_permute(void *ctx, uint64_t state[25]) {
+  (void)ctx;
+  KeccakF1600_StatePermute(state);
+}
+
+const kyber_keccak_backend kyber_keccak_software = {
+    "software", NULL, software_permute, NULL, NULL, NULL, NULL};
+
+static void software_bi32_permute(void *ctx, uint64_t state[25]) {
+  unsigned int i;
+
+  (void)ctx;
+  for (i = 0; i < 25; i++)
+    state[i] = keccak_bi32_interleave(state[i]);
+  KeccakF1600_StatePermute_bi32(state);
+  for (i = 0; i < 25; i++)
+    state[i] = keccak_bi32_deinterleave(state[i]);
+}
+
+const kyber_keccak_backend kyber_keccak_software_bi32 = {
+    "bi32", NULL, software_bi32_permute, NULL, NULL, NULL, NULL};
+
+// Set at init only, so plain loads are enough on the hashing side
+static const kyber_keccak_backend *keccak_backend = &kyber_keccak_software;
+
+// Lets the other side of a busy-wait run, e.g. on a single-core host
+static inline void backend_relax(void) {
+#if defined(__linux__)
+  sched_yield();
+#endif
+}
+
+/*************************************************
+ * Name:        kyber_keccak_register
+ *
+ * Description: Selects the backend of all later hashing
+ *************************************************/
+int kyber_keccak_register(const kyber_keccak_backend *b) {
+  if (b == NULL)
+    b = &kyber_keccak_software;
+  if (b->permute == NULL && (b->submit == NULL || b->poll == NULL))
+    return -1;
+  keccak_backend = b;
+  return 0;
+}
+
+/*************************************************
+ * Name:        kyber_keccak_backend_get
+ *
+ * Description: Currently registered backend
+ *************************************************/
+const kyber_keccak_backend *kyber_keccak_backend_get(void) {
+  return keccak_backend;
+}
+
+/*************************************************
+ * Name:        kyber_keccak_submit
+ *
+ * Description: Starts job; without submit it completes at once
+ *************************************************/
+int kyber_keccak_submit(kyber_keccak_job *job) {
+  const kyber_keccak_backend *b = keccak_backend;
+
+  if (b->submit != NULL) {
+    atomic_store_explicit(&job->done, 0, memory_order_relaxed);
+    if (b->submit(b->ctx, job) != 0)
+      return -1;
+    // The permutation runs elsewhere; count it here, on the submitting
+    // thread and in its current phase
+    KYBER_PROFILE_KECCAK();
+    return 0;
+  }
+  b->permute(b->ctx, job->state);
+  atomic_store_explicit(&job->done, 1, memory_order_release);
+  return 0;
+}
+
+/*************************************************
+ * Name:        kyber_keccak_poll
+ *
+ * Description: 1 if job is done, 0 if still running
+ *************************************************/
+int kyber_keccak_poll(kyber_keccak_job *job) {
+  const kyber_keccak_backend *b = keccak_backend;
+
+  if (b->poll != NULL)
+    return b->poll(b->ctx, job);
+  return atomic_load_explicit(&job->done, memory_order_acquire);
+}
+
+/*************************************************
+ * Name:        kyber_keccak_wait
+ *
+ * Description: Spins until job is done
+ *************************************************/
+void kyber_keccak_wait(kyber_keccak_job *job) {
+  while (!kyber_keccak_poll(job))
+    backend_relax();
+}
+
+/*************************************************
+ * Name:        kyber_keccak_permute
+ *
+ * Description: Synchronous permutation; a submit/poll-only backend is
+ *              driven to completion, retrying while it is busy
+ *************************************************/
+void kyber_keccak_permute(uint64_t state[25]) {
+  const kyber_keccak_backend *b = keccak_backend;
+  kyber_keccak_job job;
+
+  if (b->permute != NULL) {
+    b->permute(b->ctx, state);
+    return;
+  }
+
+  job.state = state;
+  while (kyber_keccak_submit(&job) != 0)
+    backend_relax();
+  kyber_keccak_wait(&job);
+}
+
+/*************************************************
+ * Linux stand-in for a Keccak accelerator
+ *************************************************/
+#if defined(__linux__)
+
+#include <time.h>
+
+static int64_t offload_now_ns(void) {
+  struct timespec t;
+
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+static void *offload_worker(void *arg) {
+  kyber_keccak_offload *o = arg;
+  kyber_keccak_job *job;
+  int64_t deadline;
+
+  pthread_mutex_lock(&o->lock);
+  for (;;) {
+    while (o->head == NULL && !o->stop)
+      pthread_cond_wait(&o->wake, &o->lock);
+    if (o->head == NULL)
+      break; // Stopped and drained
+
+    // The job stays at the head (and pending) while it runs
+    job = o->head;
+    pthread_mutex_unlock(&o->lock);
+
+    // Under KYBER_PROFILE this also counts in the worker's own
+    // statistics, which nobody reads; kyber_keccak_submit() counted it
+    deadline = offload_now_ns() + o->latency_ns;
+    KeccakF1600_StatePermute(job->state);
+    while (offload_now_ns() < deadline)
+      backend_relax();
+
+    pthread_mutex_lock(&o->lock);
+    o->head = job->next;
+    if (o->head == NULL)
+      o->tail = NULL;
+    o->pending--;
+    o->completed++;
+    // Last: once done is seen the submitter may reuse the job
+    atomic_store_explicit(&job->done, 1, memory_order_release);
+  }
+  pthread_mutex_unlock(&o->lock);
+  return NULL;
+}
+
+static int offload_submit(void *ctx, kyber_keccak_job *job) {
+  kyber_keccak_offload *o = ctx;
+
+  pthread_mutex_lock(&o->lock);
+  if (o->pending == o->depth) {
+    o->rejected++;
+    pthread_mutex_unlock(&o->lock);
+    return -1;
+  }
+  job->next = NULL;
+  if (o->tail != NULL)
+    o->tail->next = job;
+  else
+    o->head = job;
+  o->tail = job;
+  if (++o->pending > o->peak)
+    o->peak = o->pending;
+  pthread_cond_signal(&o->wake);
+  pthread_mutex_unlock(&o->lock);
+  return 0;
+}
+
+static int offload_poll(void *ctx, kyber_keccak_job *job) {
+  (void)ctx;
+  return atomic_load_explicit(&job->done, memory_order_acquire);
+}
+
+/*************************************************
+ * Name:        kyber_keccak_offload_start
+ *
+ * Description: Starts the emulated accelerator
+ *************************************************/
+int kyber_keccak_offload_start(kyber_keccak_offload *o,
+                               unsigned int latency_ns, unsigned int depth) {
+  if (depth == 0)
+    return -1;
+
+  o->backend.name = "offload";
+  o->backend.ctx = o;
+  o->backend.permute = NULL;
+  o->backend.submit = offload_submit;
+  o->backend.poll = offload_poll;
+  o->backend.absorb = NULL;
+  o->backend.squeeze = NULL;
+  o->latency_ns = latency_ns;
+  o->depth = depth;
+  o->pending = 0;
+  o->head = NULL;
+  o->tail = NULL;
+  o->completed = 0;
+  o->rejected = 0;
+  o->peak = 0;
+  o->stop = 0;
+  pthread_mutex_init(&o->lock, NULL);
+  pthread_cond_init(&o->wake, NULL);
+
+  if (pthread_create(&o->thread, NULL, offload_worker, o) != 0) {
+    pthread_cond_destroy(&o->wake);
+    pthread_mutex_destroy(&o->lock);
+    return -1;
+  }
+  return 0;
+}
+
+/*************************************************
+ * Name:        kyber_keccak_offload_stop
+ *
+ * Description: Drains the queue, then stops and joins the worker
+ *************************************************/
+void kyber_keccak_offload_stop(kyber_keccak_offload *o) {
+  pthread_mutex_lock(&o->lock);
+  o->stop = 1;
+  pthread_cond_signal(&o->wake);
+  pthread_mutex_unlock(&o->lock);
+
+  pthread_join(o->thread, NULL);
+  pthread_cond_destroy(&o->wake);
+  pthread_mutex_destroy(&o->lock);
+}
+
+#endif
@@ -0,0 +1,120 @@
+/*************************************************
+ * Bit-Interleaved Keccak-f[1600]
+ *
+ * The permutation of fips202.c on 32-bit words, see keccak_bi32.h
+ * for the lane layout. Rho and pi are written out lane by lane so
+ * every rotation count is a constant; theta and chi are loops over
+ * five columns that the compiler unrolls.
+ *************************************************/
+
+#include "../include/keccak_bi32.h"
+#include "../include/kyber_profile.h"
+#include <stdint.h>
+
+#define NROUNDS 24
+
+#define ROL32(a, n) (((a) << (n)) | ((a) >> ((32 - (n)) & 31)))
+
+// KeccakF_RoundConstants of fips202.c, split into even and odd bits
+static const uint32_t KeccakF_RoundConstantsBI[NROUNDS][2] = {
+    {0x00000001, 0x00000000}, {0x00000000, 0x00000089},
+    {0x00000000, 0x8000008b}, {0x00000000, 0x80008080},
+    {0x00000001, 0x0000008b}, {0x00000001, 0x00008000},
+    {0x00000001, 0x80008088}, {0x00000001, 0x80000082},
+    {0x00000000, 0x0000000b}, {0x00000000, 0x0000000a},
+    {0x00000001, 0x00008082}, {0x00000000, 0x00008003},
+    {0x00000001, 0x0000808b}, {0x00000001, 0x8000000b},
+    {0x00000001, 0x8000008a}, {0x00000001, 0x80000081},
+    {0x00000000, 0x80000081}, {0x00000000, 0x80000008},
+    {0x00000000, 0x00000083}, {0x00000000, 0x80008003},
+    {0x00000001, 0x80008088}, {0x00000000, 0x80000088},
+    {0x00000001, 0x00008000}, {0x00000000, 0x80008082}};
+
+/*************************************************
+ * Theta (apply), rho by r and pi of lane i into lane j of B. An odd
+ * r moves the odd bits to even positions and vice versa.
+ *************************************************/
+#define RHO_PI(i, r, j)                                                        \
+  do {                                                                         \
+    uint32_t e_ = E[i] ^ De[(i) % 5];                                          \
+    uint32_t o_ = O[i] ^ Do[(i) % 5];                                          \
+    if ((r) & 1) {                                                             \
+      BE[j] = ROL32(o_, ((r) + 1) / 2);                                        \
+      BO[j] = ROL32(e_, (r) / 2);                                              \
+    } else {                                                                   \
+      BE[j] = ROL32(e_, (r) / 2);                                              \
+      BO[j] = ROL32(o_, (r) / 2);                                              \
+    }                                                                          \
+  } while (0)
+
+/*************************************************
+ * Name:        KeccakF1600_StatePermute_bi32
+ *
+ * Description: Keccak-f[1600] on a bit-interleaved state
+ *************************************************/
+void KeccakF1600_StatePermute_bi32(uint64_t state[25]) {
+  uint32_t E[25], O[25], BE[25], BO[25];
+  uint32_t Ce[5], Co[5], De[5], Do[5];
+  unsigned int round, x, y;
+
+  KYBER_PROFILE_KECCAK();
+
+  for (x = 0; x < 25; x++) {
+    E[x] = (uint32_t)state[x];
+    O[x] = (uint32_t)(state[x] >> 32);
+  }
+
+  for (round = 0; round < NROUNDS; round++) {
+    // Theta: D[x] = C[x - 1] ^ ROL(C[x + 1], 1)
+    for (x = 0; x < 5; x++) {
+      Ce[x] = E[x] ^ E[x + 5] ^ E[x + 10] ^ E[x + 15] ^ E[x + 20];
+      Co[x] = O[x] ^ O[x + 5] ^ O[x + 10] ^ O[x + 15] ^ O[x + 20];
+    }
+    for (x = 0; x < 5; x++) {
+      De[x] = Ce[(x + 4) % 5] ^ ROL32(Co[(x + 1) % 5], 1);
+      Do[x] = Co[(x + 4) % 5] ^ Ce[(x + 1) % 5];
+    }
+
+    // Rho offsets and pi destinations as in fips202xn.c
+    RHO_PI(0, 0, 0);
+    RHO_PI(1, 1, 10);
+    RHO_PI(2, 62, 20);
+    RHO_PI(3, 28, 5);
+    RHO_PI(4, 27, 15);
+    RHO_PI(5, 36, 16);
+    RHO_PI(6, 44, 1);
+    RHO_PI(7, 6, 11);
+    RHO_PI(8, 55, 21);
+    RHO_PI(9, 20, 6);
+    RHO_PI(10, 3, 7);
+    RHO_PI(11, 10, 17);
+    RHO_PI(12, 43, 2);
+    RHO_PI(13, 25, 12);
+    RHO_PI(14, 39, 22);
+    RHO_PI(15, 41, 23);
+    RHO_PI(16, 45, 8);
+    RHO_PI(17, 15, 18);
+    RHO_PI(18, 21, 3);
+    RHO_PI(19, 8, 13);
+    RHO_PI(20, 18, 14);
+    RHO_PI(21, 2, 24);
+    RHO_PI(22, 61, 9);
+    RHO_PI(23, 56, 19);
+    RHO_PI(24, 14, 4);
+
+    // Chi, on both halves independently
+    for (y = 0; y < 25; y += 5) {
+      for (x = 0; x < 5; x++) {
+        E[y + x] = BE[y + x] ^ (~BE[y + (x + 1) % 5] & BE[y + (x + 2) % 5]);
+        O[y + x] = BO[y + x] ^ (~BO[y + (x + 1) % 5] & BO[y + (x + 2) % 5]);
+      }
+    }
+
+    // Iota
+    E[0] ^= KeccakF_RoundConstantsBI[round][0];
+    O[0] ^= KeccakF_RoundConstantsBI[round][1];
+  }
+
+  for (x = 0; x < 25; x++)
+    state[x] = E[x] | (uint64_t)O[x] << 32;
+}
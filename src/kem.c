@@ -10,12 +10,33 @@
 #include "../include/kem.h"
 #include "../include/fips202.h"
 #include "../include/indcpa.h"
+#include "../include/kyber_dispatch.h"
+#include "../include/kyber_metrics.h"
+#include "../include/kyber_profile.h"
+#include "../include/kyber_trace.h"
 #include "../include/params.h"
 #include "../include/randombytes.h"
 #include "../include/utils.h"
 #include <stdint.h>
 #include <string.h>
 
+// kyber_dispatch.h hard-codes the sizes of every set for callers without
+// params.h; check them against this set's
+#if (KYBER_K == 2)
+#define KYBER_SET_BYTES(x) KYBER512_##x
+#elif (KYBER_K == 3)
+#define KYBER_SET_BYTES(x) KYBER768_##x
+#else
+#define KYBER_SET_BYTES(x) KYBER1024_##x
+#endif
+_Static_assert(KYBER_SET_BYTES(PUBLICKEYBYTES) == KYBER_PUBLICKEYBYTES,
+               "kyber_dispatch.h public key size");
+_Static_assert(KYBER_SET_BYTES(SECRETKEYBYTES) == KYBER_SECRETKEYBYTES,
+               "kyber_dispatch.h secret key size");
+_Static_assert(KYBER_SET_BYTES(CIPHERTEXTBYTES) == KYBER_CIPHERTEXTBYTES,
+               "kyber_dispatch.h ciphertext size");
+_Static_assert(KYBER_ALL_SSBYTES == KYBER_SSBYTES,
+               "kyber_dispatch.h shared secret size");
 
 /*************************************************
  * Name:        crypto_kem_keypair
@@ -26,20 +47,40 @@
  *************************************************/
 int crypto_kem_keypair(uint8_t pk[KYBER_PUBLICKEYBYTES],
                        uint8_t sk[KYBER_SECRETKEYBYTES]) {
-  // Generate IND-CPA keypair
-  indcpa_keypair(pk, sk);
-
-  // Append public key to secret key
-  memcpy(sk + KYBER_POLYVECBYTES, pk, KYBER_PUBLICKEYBYTES);
+  int ret;
 
-  // Append H(pk) to secret key
-  sha3_256(sk + KYBER_SECRETKEYBYTES - 2 * KYBER_SYMBYTES, pk,
-           KYBER_PUBLICKEYBYTES);
+  KYBER_TRACE(keypair_entry);
+  KYBER_METRICS_OP_BEGIN(KYBER_OP_KEYPAIR);
+  KYBER_PROFILE_OP_BEGIN(KYBER_OP_KEYPAIR);
 
-  // Append random z to secret key (for implicit rejection)
-  randombytes(sk + KYBER_SECRETKEYBYTES - KYBER_SYMBYTES, KYBER_SYMBYTES);
-
-  return 0;
+  // Generate IND-CPA keypair
+  ret = indcpa_keypair(pk, sk);
+
+  if (ret == 0) {
+    // Append public key to secret key
+    memcpy(sk + KYBER_POLYVECBYTES, pk, KYBER_PUBLICKEYBYTES);
+
+    // Append H(pk) to secret key
+    KYBER_PROFILE_BEGIN(KYBER_PHASE_HASH);
+    sha3_256(sk + KYBER_SECRETKEYBYTES - 2 * KYBER_SYMBYTES, pk,
+             KYBER_PUBLICKEYBYTES);
+    KYBER_PROFILE_END(KYBER_PHASE_HASH);
+
+    // Append random z to secret key (for implicit rejection)
+    KYBER_PROFILE_BEGIN(KYBER_PHASE_RANDOMBYTES);
+    ret = randombytes(sk + KYBER_SECRETKEYBYTES - KYBER_SYMBYTES,
+                      KYBER_SYMBYTES);
+    KYBER_PROFILE_END(KYBER_PHASE_RANDOMBYTES);
+  }
+
+  // A key whose z is not random must not be usable
+  if (ret != 0)
+    secure_zero(sk, KYBER_SECRETKEYBYTES);
+
+  KYBER_PROFILE_OP_END(KYBER_OP_KEYPAIR);
+  KYBER_METRICS_OP_END(KYBER_OP_KEYPAIR);
+  KYBER_TRACE(keypair_return);
+  return ret;
 }
 
 /*************************************************
@@ -53,25 +94,41 @@ int crypto_kem_enc(uint8_t ct[KYBER_CIPHERTEXTBYTES], uint8_t ss[KYBER_SSBYTES],
                    const uint8_t pk[KYBER_PUBLICKEYBYTES]) {
   uint8_t buf[2 * KYBER_SYMBYTES];
   uint8_t kr[2 * KYBER_SYMBYTES]; // (K_bar, r)
+  int ret;
 
-  // Generate random message m
-  randombytes(buf, KYBER_SYMBYTES);
-
-  // Hash m to get m_hash (the "hash of shame")
-  sha3_256(buf, buf, KYBER_SYMBYTES);
+  KYBER_TRACE(enc_entry);
+  KYBER_METRICS_OP_BEGIN(KYBER_OP_ENC);
+  KYBER_PROFILE_OP_BEGIN(KYBER_OP_ENC);
 
-  // Compute (K_bar, r) = G(m || H(pk))
-  sha3_256(buf + KYBER_SYMBYTES, pk, KYBER_PUBLICKEYBYTES);
-  sha3_512(kr, buf, 2 * KYBER_SYMBYTES);
-
-  // Encrypt m using r as randomness
-  indcpa_enc(ct, buf, pk, kr + KYBER_SYMBYTES);
-
-  // Compute shared key K = KDF(K_bar || H(c))
-  sha3_256(kr + KYBER_SYMBYTES, ct, KYBER_CIPHERTEXTBYTES);
-  shake256(ss, KYBER_SSBYTES, kr, 2 * KYBER_SYMBYTES);
-
-  return 0;
+  // Generate random message m
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_RANDOMBYTES);
+  ret = randombytes(buf, KYBER_SYMBYTES);
+  KYBER_PROFILE_END(KYBER_PHASE_RANDOMBYTES);
+
+  if (ret == 0) {
+    KYBER_PROFILE_BEGIN(KYBER_PHASE_HASH);
+    // Hash m to get m_hash (the "hash of shame")
+    sha3_256_32(buf, buf);
+
+    // Compute (K_bar, r) = G(m || H(pk))
+    sha3_256(buf + KYBER_SYMBYTES, pk, KYBER_PUBLICKEYBYTES);
+    sha3_512_64(kr, buf);
+    KYBER_PROFILE_END(KYBER_PHASE_HASH);
+
+    // Encrypt m using r as randomness
+    indcpa_enc(ct, buf, pk, kr + KYBER_SYMBYTES);
+
+    // Compute shared key K = KDF(K_bar || H(c))
+    KYBER_PROFILE_BEGIN(KYBER_PHASE_HASH);
+    sha3_256(kr + KYBER_SYMBYTES, ct, KYBER_CIPHERTEXTBYTES);
+    shake256_64(ss, KYBER_SSBYTES, kr);
+    KYBER_PROFILE_END(KYBER_PHASE_HASH);
+  }
+
+  KYBER_PROFILE_OP_END(KYBER_OP_ENC);
+  KYBER_METRICS_OP_END(KYBER_OP_ENC);
+  KYBER_TRACE(enc_return);
+  return ret;
 }
 
 /*************************************************
@@ -92,12 +149,18 @@ int crypto_kem_dec(uint8_t ss[KYBER_SSBYTES],
   const uint8_t *z = sk + KYBER_SECRETKEYBYTES - KYBER_SYMBYTES;
   uint8_t fail;
 
+  KYBER_TRACE(dec_entry);
+  KYBER_METRICS_OP_BEGIN(KYBER_OP_DEC);
+  KYBER_PROFILE_OP_BEGIN(KYBER_OP_DEC);
+
   // Decrypt to get m'
   indcpa_dec(buf, ct, sk);
 
   // Compute (K_bar', r') = G(m' || H(pk))
   memcpy(buf + KYBER_SYMBYTES, h_pk, KYBER_SYMBYTES);
-  sha3_512(kr, buf, 2 * KYBER_SYMBYTES);
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_HASH);
+  sha3_512_64(kr, buf);
+  KYBER_PROFILE_END(KYBER_PHASE_HASH);
 
   // Re-encrypt to get c'
   indcpa_enc(cmp, buf, pk, kr + KYBER_SYMBYTES);
@@ -108,7 +171,9 @@ int crypto_kem_dec(uint8_t ss[KYBER_SSBYTES],
     fail |= ct[i] ^ cmp[i];
 
   // Compute H(c)
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_HASH);
   sha3_256(kr + KYBER_SYMBYTES, ct, KYBER_CIPHERTEXTBYTES);
+  KYBER_PROFILE_END(KYBER_PHASE_HASH);
 
   // If fail, compute garbage key from z
   // This is implicit rejection - always output something
@@ -117,14 +182,21 @@ int crypto_kem_dec(uint8_t ss[KYBER_SSBYTES],
   memcpy(garbage + KYBER_SYMBYTES, kr + KYBER_SYMBYTES, KYBER_SYMBYTES);
 
   // Constant-time selection: if fail != 0, use garbage instead of kr
-  // fail should be 0 or non-zero; convert to 0 or 1
-  fail = (fail | (-fail)) >> 7; // 0 if equal, 1 if different
+  // fail should be 0 or non-zero; convert to 0 or 1 via the sign bit
+  // of -fail (computed in 32 bits so the result is exactly 0 or 1)
+  fail = (uint8_t)((0u - (uint32_t)fail) >> 31); // 0 if equal, 1 if different
+  KYBER_METRICS_REJECTION(fail);
 
   // Select between real key and garbage in constant time
   select_bytes(kr, garbage, kr, 2 * KYBER_SYMBYTES, (uint8_t)(1 - fail));
 
   // Derive shared secret
-  shake256(ss, KYBER_SSBYTES, kr, 2 * KYBER_SYMBYTES);
+  KYBER_PROFILE_BEGIN(KYBER_PHASE_HASH);
+  shake256_64(ss, KYBER_SSBYTES, kr);
+  KYBER_PROFILE_END(KYBER_PHASE_HASH);
 
+  KYBER_PROFILE_OP_END(KYBER_OP_DEC);
+  KYBER_METRICS_OP_END(KYBER_OP_DEC);
+  KYBER_TRACE(dec_return);
   return 0;
 }
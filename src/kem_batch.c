@@ -0,0 +1,394 @@
+/*************************************************
+ * Multi-threaded Batch KEM API
+ *
+ * Work-stealing scheduler for arrays of independent KEM operations.
+ * Each worker owns a contiguous index range packed into one 64-bit
+ * word (lo | hi << 32). The owner takes items from the front with a
+ * CAS on lo; an idle worker steals the back half of a victim's range
+ * with a CAS on hi. Both sides CAS the same word, so every index is
+ * handed out exactly once.
+ *
+ * Items run through the plain crypto_kem_* calls, so their working
+ * state is in ordinary stack frames: there are no per-worker buffers.
+ * Helper stacks are sized by BATCH_STACK_SIZE; worker 0 runs on the
+ * caller's stack. Range words are padded to a cache line, so workers
+ * share nothing on the hot path except the victim's range word during
+ * a steal.
+ *************************************************/
+
+#include "../include/kem_batch.h"
+#include "../include/kem.h"
+#include "../include/params.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define BATCH_CACHELINE 64
+#define BATCH_STACK_SIZE (256 * 1024)
+#define BATCH_MAX_ITEMS 0x7FFFFFFFu
+
+typedef struct {
+  atomic_uint_fast64_t range;
+  uint8_t pad[BATCH_CACHELINE - sizeof(atomic_uint_fast64_t)];
+} batch_worker;
+
+typedef struct batch_job {
+  void (*run)(const struct batch_job *job, size_t i);
+  uint8_t *out0;
+  uint8_t *out1;
+  const uint8_t *in0;
+  const uint8_t *in1;
+} batch_job;
+
+typedef struct {
+  batch_worker *workers;
+  pthread_t *threads;
+  unsigned int nworkers;
+
+  pthread_mutex_t lock;
+  pthread_cond_t work_cv;
+  pthread_cond_t done_cv;
+  const batch_job *job; // Open batch, NULL once the caller has closed it
+  atomic_int failed;    // An item of the open batch returned an error
+  uint64_t generation;
+  unsigned int busy; // Helpers currently inside a batch
+  int stop;
+} batch_pool;
+
+static batch_pool pool;
+static int pool_running = 0;
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+#define RANGE(lo, hi) ((uint64_t)(lo) | ((uint64_t)(hi) << 32))
+#define RANGE_LO(r) ((uint32_t)(r))
+#define RANGE_HI(r) ((uint32_t)((r) >> 32))
+
+/*************************************************
+ * Name:        batch_take
+ *
+ * Description: Take one index from the front of the worker's own range
+ *
+ * Returns 0 and sets *i on success, -1 if the range is empty
+ *************************************************/
+static int batch_take(batch_worker *w, size_t *i) {
+  uint64_t r = atomic_load_explicit(&w->range, memory_order_relaxed);
+
+  while (RANGE_LO(r) < RANGE_HI(r)) {
+    if (atomic_compare_exchange_weak_explicit(
+            &w->range, &r, RANGE(RANGE_LO(r) + 1, RANGE_HI(r)),
+            memory_order_acq_rel, memory_order_relaxed)) {
+      *i = RANGE_LO(r);
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/*************************************************
+ * Name:        batch_steal
+ *
+ * Description: Move the back half of some other worker's range into
+ *              worker self's (empty) range
+ *
+ * Returns 0 on success, -1 if every other range is empty
+ *************************************************/
+static int batch_steal(unsigned int self) {
+  unsigned int k, v;
+  uint32_t lo, hi, take;
+  uint64_t r;
+
+  for (k = 1; k < pool.nworkers; k++) {
+    v = (self + k) % pool.nworkers;
+    r = atomic_load_explicit(&pool.workers[v].range, memory_order_relaxed);
+    for (;;) {
+      lo = RANGE_LO(r);
+      hi = RANGE_HI(r);
+      if (lo >= hi)
+        break;
+      take = (hi - lo + 1) / 2;
+      if (atomic_compare_exchange_weak_explicit(
+              &pool.workers[v].range, &r, RANGE(lo, hi - take),
+              memory_order_acq_rel, memory_order_relaxed)) {
+        atomic_store_explicit(&pool.workers[self].range,
+                              RANGE(hi - take, hi), memory_order_release);
+        return 0;
+      }
+    }
+  }
+  return -1;
+}
+
+/*************************************************
+ * Name:        batch_work
+ *
+ * Description: Run items until neither the own range nor any victim
+ *              has work left
+ *************************************************/
+static void batch_work(const batch_job *job, unsigned int self) {
+  size_t i;
+
+  for (;;) {
+    while (batch_take(&pool.workers[self], &i) == 0)
+      job->run(job, i);
+    if (batch_steal(self) != 0)
+      return;
+  }
+}
+
+/*************************************************
+ * Name:        batch_helper
+ *
+ * Description: Helper thread main loop
+ *************************************************/
+static void *batch_helper(void *arg) {
+  unsigned int self = (unsigned int)(uintptr_t)arg;
+  uint64_t seen = 0;
+  const batch_job *job;
+
+  pthread_mutex_lock(&pool.lock);
+  for (;;) {
+    while (!pool.stop && (pool.job == NULL || pool.generation == seen))
+      pthread_cond_wait(&pool.work_cv, &pool.lock);
+    if (pool.stop)
+      break;
+
+    seen = pool.generation;
+    job = pool.job;
+    pool.busy++;
+    pthread_mutex_unlock(&pool.lock);
+
+    batch_work(job, self);
+
+    pthread_mutex_lock(&pool.lock);
+    if (--pool.busy == 0)
+      pthread_cond_signal(&pool.done_cv);
+  }
+  pthread_mutex_unlock(&pool.lock);
+  return NULL;
+}
+
+/*************************************************
+ * Name:        batch_start
+ *
+ * Description: Start the pool; caller holds pool_lock
+ *************************************************/
+static int batch_start(unsigned int threads) {
+  pthread_attr_t attr;
+  unsigned int t;
+
+  if (threads == 0) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (n > 0) ? (unsigned int)n : 1;
+  }
+
+  pool.workers = (batch_worker *)calloc(threads, sizeof(batch_worker));
+  pool.threads = (pthread_t *)calloc(threads, sizeof(pthread_t));
+  if (pool.workers == NULL || pool.threads == NULL) {
+    free(pool.workers);
+    free(pool.threads);
+    return -1;
+  }
+
+  pool.nworkers = threads;
+  pool.job = NULL;
+  pool.generation = 0;
+  pool.busy = 0;
+  pool.stop = 0;
+  pthread_mutex_init(&pool.lock, NULL);
+  pthread_cond_init(&pool.work_cv, NULL);
+  pthread_cond_init(&pool.done_cv, NULL);
+
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, BATCH_STACK_SIZE);
+
+  // Worker 0 is the calling thread
+  for (t = 1; t < threads; t++) {
+    if (pthread_create(&pool.threads[t], &attr, batch_helper,
+                       (void *)(uintptr_t)t) != 0) {
+      pool.nworkers = t;
+      break;
+    }
+  }
+  pthread_attr_destroy(&attr);
+
+  pool_running = 1;
+  return 0;
+}
+
+/*************************************************
+ * Name:        batch_stop
+ *
+ * Description: Stop the pool; caller holds pool_lock
+ *************************************************/
+static void batch_stop(void) {
+  unsigned int t;
+
+  pthread_mutex_lock(&pool.lock);
+  pool.stop = 1;
+  pthread_cond_broadcast(&pool.work_cv);
+  pthread_mutex_unlock(&pool.lock);
+
+  for (t = 1; t < pool.nworkers; t++)
+    pthread_join(pool.threads[t], NULL);
+
+  pthread_cond_destroy(&pool.done_cv);
+  pthread_cond_destroy(&pool.work_cv);
+  pthread_mutex_destroy(&pool.lock);
+  free(pool.workers);
+  free(pool.threads);
+  pool.nworkers = 0;
+  pool_running = 0;
+}
+
+/*************************************************
+ * Name:        batch_run
+ *
+ * Description: Split n items evenly over the workers, work as worker 0
+ *              and wait until every helper has left the batch
+ *************************************************/
+static int batch_run(const batch_job *job, size_t n) {
+  unsigned int t, nw;
+  uint32_t lo, hi;
+
+  pthread_mutex_lock(&pool_lock);
+  if (!pool_running && batch_start(0) != 0) {
+    pthread_mutex_unlock(&pool_lock);
+    return -1;
+  }
+
+  nw = pool.nworkers;
+  for (t = 0; t < nw; t++) {
+    lo = (uint32_t)((uint64_t)n * t / nw);
+    hi = (uint32_t)((uint64_t)n * (t + 1) / nw);
+    atomic_store_explicit(&pool.workers[t].range, RANGE(lo, hi),
+                          memory_order_relaxed);
+  }
+
+  atomic_store_explicit(&pool.failed, 0, memory_order_relaxed);
+  pthread_mutex_lock(&pool.lock);
+  pool.job = job;
+  pool.generation++;
+  pthread_cond_broadcast(&pool.work_cv);
+  pthread_mutex_unlock(&pool.lock);
+
+  batch_work(job, 0);
+
+  // Close the batch: late helpers see NULL and skip it, running ones
+  // are waited for, so job and ranges can be reused on return
+  pthread_mutex_lock(&pool.lock);
+  pool.job = NULL;
+  while (pool.busy > 0)
+    pthread_cond_wait(&pool.done_cv, &pool.lock);
+  pthread_mutex_unlock(&pool.lock);
+
+  pthread_mutex_unlock(&pool_lock);
+  // Read after the helpers are done; pool.lock orders their stores
+  return atomic_load_explicit(&pool.failed, memory_order_relaxed) ? -1 : 0;
+}
+
+/*************************************************
+ * Name:        batch_run_chunked
+ *
+ * Description: Keep each batch below the 32-bit range limit
+ *************************************************/
+static int batch_run_chunked(batch_job *job, size_t n, size_t s0, size_t s1,
+                             size_t s2, size_t s3) {
+  size_t chunk;
+
+  while (n > 0) {
+    chunk = (n > BATCH_MAX_ITEMS) ? BATCH_MAX_ITEMS : n;
+    if (batch_run(job, chunk) != 0)
+      return -1;
+    n -= chunk;
+    job->out0 += chunk * s0;
+    if (job->out1)
+      job->out1 += chunk * s1;
+    if (job->in0)
+      job->in0 += chunk * s2;
+    if (job->in1)
+      job->in1 += chunk * s3;
+  }
+  return 0;
+}
+
+static void run_keypair(const batch_job *job, size_t i) {
+  if (crypto_kem_keypair(job->out0 + i * KYBER_PUBLICKEYBYTES,
+                         job->out1 + i * KYBER_SECRETKEYBYTES) != 0)
+    atomic_store_explicit(&pool.failed, 1, memory_order_relaxed);
+}
+
+static void run_enc(const batch_job *job, size_t i) {
+  if (crypto_kem_enc(job->out0 + i * KYBER_CIPHERTEXTBYTES,
+                     job->out1 + i * KYBER_SSBYTES,
+                     job->in0 + i * KYBER_PUBLICKEYBYTES) != 0)
+    atomic_store_explicit(&pool.failed, 1, memory_order_relaxed);
+}
+
+static void run_dec(const batch_job *job, size_t i) {
+  crypto_kem_dec(job->out0 + i * KYBER_SSBYTES,
+                 job->in0 + i * KYBER_CIPHERTEXTBYTES,
+                 job->in1 + i * KYBER_SECRETKEYBYTES);
+}
+
+/*************************************************
+ * Name:        kyber_batch_init
+ *
+ * Description: Starts the batch thread pool
+ *************************************************/
+int kyber_batch_init(unsigned int threads) {
+  int ret = -1;
+
+  pthread_mutex_lock(&pool_lock);
+  if (!pool_running)
+    ret = batch_start(threads);
+  pthread_mutex_unlock(&pool_lock);
+  return ret;
+}
+
+/*************************************************
+ * Name:        kyber_batch_shutdown
+ *
+ * Description: Stops and joins the helper threads
+ *************************************************/
+void kyber_batch_shutdown(void) {
+  pthread_mutex_lock(&pool_lock);
+  if (pool_running)
+    batch_stop();
+  pthread_mutex_unlock(&pool_lock);
+}
+
+/*************************************************
+ * Name:        kyber_batch_threads
+ *
+ * Description: Number of workers in the running pool
+ *************************************************/
+unsigned int kyber_batch_threads(void) {
+  unsigned int n;
+
+  pthread_mutex_lock(&pool_lock);
+  n = pool_running ? pool.nworkers : 0;
+  pthread_mutex_unlock(&pool_lock);
+  return n;
+}
+
+int crypto_kem_keypair_batch(uint8_t *pk, uint8_t *sk, size_t n) {
+  batch_job job = {run_keypair, pk, sk, NULL, NULL};
+  return batch_run_chunked(&job, n, KYBER_PUBLICKEYBYTES, KYBER_SECRETKEYBYTES,
+                           0, 0);
+}
+
+int crypto_kem_enc_batch(uint8_t *ct, uint8_t *ss, const uint8_t *pk,
+                         size_t n) {
+  batch_job job = {run_enc, ct, ss, pk, NULL};
+  return batch_run_chunked(&job, n, KYBER_CIPHERTEXTBYTES, KYBER_SSBYTES,
+                           KYBER_PUBLICKEYBYTES, 0);
+}
+
+int crypto_kem_dec_batch(uint8_t *ss, const uint8_t *ct, const uint8_t *sk,
+                         size_t n) {
+  batch_job job = {run_dec, ss, NULL, ct, sk};
+  return batch_run_chunked(&job, n, KYBER_SSBYTES, 0, KYBER_CIPHERTEXTBYTES,
+                           KYBER_SECRETKEYBYTES);
+}
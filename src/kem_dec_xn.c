@@ -0,0 +1,624 @@
+/*************************************************
+ * Vertically Vectorised Batched Decapsulation
+ *
+ * crypto_kem_dec for KYBER_XN_LANES ciphertexts under one secret key.
+ * Polynomials are stored lane-major: coeffs[i][lane] holds coefficient
+ * i of every ciphertext side by side, so each arithmetic loop runs the
+ * scalar reference formula across all lanes at once. The secret key,
+ * public key and matrix A^T are shared and handled once per batch.
+ *
+ * Every formula below mirrors the scalar code in ntt.c, poly.c,
+ * polyvec.c and indcpa.c bit for bit; the output must be identical to
+ * crypto_kem_dec, including on the implicit-rejection path.
+ *************************************************/
+
+#include "../include/kem_dec_xn.h"
+#include "../include/fips202xn.h"
+#include "../include/indcpa.h"
+#include "../include/kem.h"
+#include "../include/kyber_metrics.h"
+#include "../include/ntt.h"
+#include "../include/params.h"
+#include "../include/poly.h"
+#include "../include/polyvec.h"
+#include "../include/utils.h"
+#include <stdint.h>
+#include <string.h>
+
+#define L KYBER_XN_LANES
+
+typedef struct {
+  int16_t coeffs[KYBER_N][L];
+} polyxn;
+
+typedef struct {
+  polyxn vec[KYBER_K];
+} polyvecxn;
+
+/*************************************************
+ * Modular arithmetic (inlined copies of ntt.c so the lane loops
+ * can be vectorised)
+ *************************************************/
+static inline int16_t xn_montgomery_reduce(int32_t a) {
+  int16_t t;
+  t = (int16_t)a * QINV;
+  t = (a - (int32_t)t * KYBER_Q) >> 16;
+  return t;
+}
+
+static inline int16_t xn_barrett_reduce(int16_t a) {
+  int16_t t;
+  const int16_t v = ((1 << 26) + KYBER_Q / 2) / KYBER_Q;
+
+  t = ((int32_t)v * a + (1 << 25)) >> 26;
+  t *= KYBER_Q;
+  return a - t;
+}
+
+static inline int16_t xn_fqmul(int16_t a, int16_t b) {
+  return xn_montgomery_reduce((int32_t)a * b);
+}
+
+/*************************************************
+ * Lane-major polynomial arithmetic
+ *************************************************/
+static void polyxn_reduce(polyxn *r) {
+  unsigned int i, l;
+  for (i = 0; i < KYBER_N; i++)
+    for (l = 0; l < L; l++)
+      r->coeffs[i][l] = xn_barrett_reduce(r->coeffs[i][l]);
+}
+
+static void polyxn_add(polyxn *r, const polyxn *a, const polyxn *b) {
+  unsigned int i, l;
+  for (i = 0; i < KYBER_N; i++)
+    for (l = 0; l < L; l++)
+      r->coeffs[i][l] = a->coeffs[i][l] + b->coeffs[i][l];
+}
+
+static void polyxn_sub(polyxn *r, const polyxn *a, const polyxn *b) {
+  unsigned int i, l;
+  for (i = 0; i < KYBER_N; i++)
+    for (l = 0; l < L; l++)
+      r->coeffs[i][l] = a->coeffs[i][l] - b->coeffs[i][l];
+}
+
+// NTT followed by Barrett reduction (poly_ntt)
+static void polyxn_ntt(polyxn *r) {
+  unsigned int len, start, j, k, l;
+  int16_t t, zeta;
+
+  k = 1;
+  for (len = 128; len >= 2; len >>= 1) {
+    for (start = 0; start < 256; start = j + len) {
+      zeta = zetas[k++];
+      for (j = start; j < start + len; j++) {
+        for (l = 0; l < L; l++) {
+          t = xn_fqmul(zeta, r->coeffs[j + len][l]);
+          r->coeffs[j + len][l] = r->coeffs[j][l] - t;
+          r->coeffs[j][l] = r->coeffs[j][l] + t;
+        }
+      }
+    }
+  }
+  polyxn_reduce(r);
+}
+
+static void polyxn_invntt(polyxn *r) {
+  unsigned int start, len, j, k, l;
+  int16_t t, zeta;
+  const int16_t f = 1441; // mont^2/128
+
+  k = 127;
+  for (len = 2; len <= 128; len <<= 1) {
+    for (start = 0; start < 256; start = j + len) {
+      zeta = zetas[k--];
+      for (j = start; j < start + len; j++) {
+        for (l = 0; l < L; l++) {
+          t = r->coeffs[j][l];
+          r->coeffs[j][l] = xn_barrett_reduce(t + r->coeffs[j + len][l]);
+          r->coeffs[j + len][l] = r->coeffs[j + len][l] - t;
+          r->coeffs[j + len][l] = xn_fqmul(zeta, r->coeffs[j + len][l]);
+        }
+      }
+    }
+  }
+
+  for (j = 0; j < 256; j++)
+    for (l = 0; l < L; l++)
+      r->coeffs[j][l] = xn_fqmul(r->coeffs[j][l], f);
+}
+
+// r = a (shared, scalar) * b (per lane) in the NTT domain
+static void polyxn_basemul_montgomery(polyxn *r, const poly *a,
+                                      const polyxn *b) {
+  unsigned int i, o, l;
+  int16_t a0, a1, zeta, r0, r1;
+
+  for (i = 0; i < KYBER_N / 4; i++) {
+    for (o = 0; o < 4; o += 2) {
+      zeta = (o == 0) ? zetas[64 + i] : -zetas[64 + i];
+      a0 = a->coeffs[4 * i + o];
+      a1 = a->coeffs[4 * i + o + 1];
+      for (l = 0; l < L; l++) {
+        r0 = xn_fqmul(a1, b->coeffs[4 * i + o + 1][l]);
+        r0 = xn_fqmul(r0, zeta);
+        r0 += xn_fqmul(a0, b->coeffs[4 * i + o][l]);
+        r1 = xn_fqmul(a0, b->coeffs[4 * i + o + 1][l]);
+        r1 += xn_fqmul(a1, b->coeffs[4 * i + o][l]);
+        r->coeffs[4 * i + o][l] = r0;
+        r->coeffs[4 * i + o + 1][l] = r1;
+      }
+    }
+  }
+}
+
+// Inner product of a shared vector a and per-lane vector b
+static void polyvecxn_pointwise_acc_montgomery(polyxn *r, const polyvec *a,
+                                               const polyvecxn *b) {
+  unsigned int i;
+  polyxn t;
+
+  polyxn_basemul_montgomery(r, &a->vec[0], &b->vec[0]);
+  for (i = 1; i < KYBER_K; i++) {
+    polyxn_basemul_montgomery(&t, &a->vec[i], &b->vec[i]);
+    polyxn_add(r, r, &t);
+  }
+  polyxn_reduce(r);
+}
+
+/*************************************************
+ * Lane-major (de)compression and message encoding
+ *************************************************/
+static void polyvecxn_compress(uint8_t *const r[L], const polyvecxn *a) {
+  unsigned int i, j, k, l;
+  uint8_t *o;
+
+#if (KYBER_DU == 10)
+  uint16_t t[4];
+  for (i = 0; i < KYBER_K; i++) {
+    for (j = 0; j < KYBER_N / 4; j++) {
+      for (l = 0; l < L; l++) {
+        for (k = 0; k < 4; k++) {
+          t[k] = a->vec[i].coeffs[4 * j + k][l];
+          t[k] += ((int16_t)t[k] >> 15) & KYBER_Q;
+          t[k] = ((((uint32_t)t[k] << 10) + KYBER_Q / 2) / KYBER_Q) & 0x3ff;
+        }
+        o = r[l] + 320 * i + 5 * j;
+        o[0] = (t[0] >> 0);
+        o[1] = (t[0] >> 8) | (t[1] << 2);
+        o[2] = (t[1] >> 6) | (t[2] << 4);
+        o[3] = (t[2] >> 4) | (t[3] << 6);
+        o[4] = (t[3] >> 2);
+      }
+    }
+  }
+#elif (KYBER_DU == 11)
+  uint16_t t[8];
+  for (i = 0; i < KYBER_K; i++) {
+    for (j = 0; j < KYBER_N / 8; j++) {
+      for (l = 0; l < L; l++) {
+        for (k = 0; k < 8; k++) {
+          t[k] = a->vec[i].coeffs[8 * j + k][l];
+          t[k] += ((int16_t)t[k] >> 15) & KYBER_Q;
+          t[k] = ((((uint32_t)t[k] << 11) + KYBER_Q / 2) / KYBER_Q) & 0x7ff;
+        }
+        o = r[l] + 352 * i + 11 * j;
+        o[0] = (t[0] >> 0);
+        o[1] = (t[0] >> 8) | (t[1] << 3);
+        o[2] = (t[1] >> 5) | (t[2] << 6);
+        o[3] = (t[2] >> 2);
+        o[4] = (t[2] >> 10) | (t[3] << 1);
+        o[5] = (t[3] >> 7) | (t[4] << 4);
+        o[6] = (t[4] >> 4) | (t[5] << 7);
+        o[7] = (t[5] >> 1);
+        o[8] = (t[5] >> 9) | (t[6] << 2);
+        o[9] = (t[6] >> 6) | (t[7] << 5);
+        o[10] = (t[7] >> 3);
+      }
+    }
+  }
+#endif
+}
+
+static void polyvecxn_decompress(polyvecxn *r, const uint8_t *const a[L]) {
+  unsigned int i, j, k, l;
+  const uint8_t *p;
+
+#if (KYBER_DU == 10)
+  uint16_t t[4];
+  for (i = 0; i < KYBER_K; i++) {
+    for (j = 0; j < KYBER_N / 4; j++) {
+      for (l = 0; l < L; l++) {
+        p = a[l] + 320 * i + 5 * j;
+        t[0] = (p[0] >> 0) | ((uint16_t)p[1] << 8);
+        t[1] = (p[1] >> 2) | ((uint16_t)p[2] << 6);
+        t[2] = (p[2] >> 4) | ((uint16_t)p[3] << 4);
+        t[3] = (p[3] >> 6) | ((uint16_t)p[4] << 2);
+        for (k = 0; k < 4; k++)
+          r->vec[i].coeffs[4 * j + k][l] =
+              ((uint32_t)(t[k] & 0x3FF) * KYBER_Q + 512) >> 10;
+      }
+    }
+  }
+#elif (KYBER_DU == 11)
+  uint16_t t[8];
+  for (i = 0; i < KYBER_K; i++) {
+    for (j = 0; j < KYBER_N / 8; j++) {
+      for (l = 0; l < L; l++) {
+        p = a[l] + 352 * i + 11 * j;
+        t[0] = (p[0] >> 0) | ((uint16_t)p[1] << 8);
+        t[1] = (p[1] >> 3) | ((uint16_t)p[2] << 5);
+        t[2] = (p[2] >> 6) | ((uint16_t)p[3] << 2) | ((uint16_t)p[4] << 10);
+        t[3] = (p[4] >> 1) | ((uint16_t)p[5] << 7);
+        t[4] = (p[5] >> 4) | ((uint16_t)p[6] << 4);
+        t[5] = (p[6] >> 7) | ((uint16_t)p[7] << 1) | ((uint16_t)p[8] << 9);
+        t[6] = (p[8] >> 2) | ((uint16_t)p[9] << 6);
+        t[7] = (p[9] >> 5) | ((uint16_t)p[10] << 3);
+        for (k = 0; k < 8; k++)
+          r->vec[i].coeffs[8 * j + k][l] =
+              ((uint32_t)(t[k] & 0x7FF) * KYBER_Q + 1024) >> 11;
+      }
+    }
+  }
+#endif
+}
+
+static void polyxn_compress(uint8_t *const r[L], const polyxn *a) {
+  unsigned int i, j, l;
+  int16_t u;
+  uint8_t t[8];
+
+#if (KYBER_DV == 4)
+  for (i = 0; i < KYBER_N / 2; i++) {
+    for (l = 0; l < L; l++) {
+      for (j = 0; j < 2; j++) {
+        u = a->coeffs[2 * i + j][l];
+        u += ((int16_t)u >> 15) & KYBER_Q;
+        t[j] = ((((uint16_t)u << 4) + KYBER_Q / 2) / KYBER_Q) & 15;
+      }
+      r[l][i] = t[0] | (t[1] << 4);
+    }
+  }
+#elif (KYBER_DV == 5)
+  for (i = 0; i < KYBER_N / 8; i++) {
+    for (l = 0; l < L; l++) {
+      for (j = 0; j < 8; j++) {
+        u = a->coeffs[8 * i + j][l];
+        u += ((int16_t)u >> 15) & KYBER_Q;
+        t[j] = ((((uint32_t)u << 5) + KYBER_Q / 2) / KYBER_Q) & 31;
+      }
+      r[l][5 * i + 0] = (t[0] >> 0) | (t[1] << 5);
+      r[l][5 * i + 1] = (t[1] >> 3) | (t[2] << 2) | (t[3] << 7);
+      r[l][5 * i + 2] = (t[3] >> 1) | (t[4] << 4);
+      r[l][5 * i + 3] = (t[4] >> 4) | (t[5] << 1) | (t[6] << 6);
+      r[l][5 * i + 4] = (t[6] >> 2) | (t[7] << 3);
+    }
+  }
+#endif
+}
+
+static void polyxn_decompress(polyxn *r, const uint8_t *const a[L]) {
+  unsigned int i, l;
+
+#if (KYBER_DV == 4)
+  for (i = 0; i < KYBER_N / 2; i++) {
+    for (l = 0; l < L; l++) {
+      r->coeffs[2 * i + 0][l] = (((uint16_t)(a[l][i] & 15) * KYBER_Q) + 8) >> 4;
+      r->coeffs[2 * i + 1][l] = (((uint16_t)(a[l][i] >> 4) * KYBER_Q) + 8) >> 4;
+    }
+  }
+#elif (KYBER_DV == 5)
+  unsigned int j;
+  uint8_t t[8];
+  const uint8_t *p;
+  for (i = 0; i < KYBER_N / 8; i++) {
+    for (l = 0; l < L; l++) {
+      p = a[l] + 5 * i;
+      t[0] = (p[0] >> 0);
+      t[1] = (p[0] >> 5) | (p[1] << 3);
+      t[2] = (p[1] >> 2);
+      t[3] = (p[1] >> 7) | (p[2] << 1);
+      t[4] = (p[2] >> 4) | (p[3] << 4);
+      t[5] = (p[3] >> 1);
+      t[6] = (p[3] >> 6) | (p[4] << 2);
+      t[7] = (p[4] >> 3);
+      for (j = 0; j < 8; j++)
+        r->coeffs[8 * i + j][l] = (((uint32_t)(t[j] & 31) * KYBER_Q) + 16) >> 5;
+    }
+  }
+#endif
+}
+
+static void polyxn_frommsg(polyxn *r, const uint8_t *const msg[L]) {
+  unsigned int i, j, l;
+  int16_t mask;
+
+  for (i = 0; i < KYBER_N / 8; i++) {
+    for (j = 0; j < 8; j++) {
+      for (l = 0; l < L; l++) {
+        mask = -(int16_t)((msg[l][i] >> j) & 1);
+        r->coeffs[8 * i + j][l] = mask & ((KYBER_Q + 1) / 2);
+      }
+    }
+  }
+}
+
+static void polyxn_tomsg(uint8_t *const msg[L], const polyxn *a) {
+  unsigned int i, j, l;
+  uint16_t t;
+
+  for (i = 0; i < KYBER_N / 8; i++) {
+    for (l = 0; l < L; l++) {
+      msg[l][i] = 0;
+      for (j = 0; j < 8; j++) {
+        t = a->coeffs[8 * i + j][l];
+        t += ((int16_t)t >> 15) & KYBER_Q;
+        t = (((t << 1) + KYBER_Q / 2) / KYBER_Q) & 1;
+        msg[l][i] |= t << j;
+      }
+    }
+  }
+}
+
+/*************************************************
+ * Lane-major noise sampling (SHAKE256 PRF + CBD)
+ *************************************************/
+static void polyxn_cbd(polyxn *r, const uint8_t *const buf[L], int eta) {
+  unsigned int i, j, l;
+  uint32_t t, d;
+  int16_t a, b;
+  const uint8_t *p;
+
+  if (eta == 2) {
+    for (i = 0; i < KYBER_N / 8; i++) {
+      for (l = 0; l < L; l++) {
+        p = buf[l] + 4 * i;
+        t = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+            ((uint32_t)p[3] << 24);
+        d = t & 0x55555555;
+        d += (t >> 1) & 0x55555555;
+        for (j = 0; j < 8; j++) {
+          a = (d >> (4 * j + 0)) & 0x3;
+          b = (d >> (4 * j + 2)) & 0x3;
+          r->coeffs[8 * i + j][l] = a - b;
+        }
+      }
+    }
+  } else {
+    for (i = 0; i < KYBER_N / 4; i++) {
+      for (l = 0; l < L; l++) {
+        p = buf[l] + 3 * i;
+        t = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16);
+        d = t & 0x00249249;
+        d += (t >> 1) & 0x00249249;
+        d += (t >> 2) & 0x00249249;
+        for (j = 0; j < 4; j++) {
+          a = (d >> (6 * j + 0)) & 0x7;
+          b = (d >> (6 * j + 3)) & 0x7;
+          r->coeffs[4 * i + j][l] = a - b;
+        }
+      }
+    }
+  }
+}
+
+static void polyxn_getnoise(polyxn *r, const uint8_t *const seed[L],
+                            uint8_t nonce, int eta) {
+  uint8_t buf[L][3 * KYBER_N / 4];
+  uint8_t extkey[L][KYBER_SYMBYTES + 1];
+  uint8_t *bufp[L];
+  const uint8_t *extp[L];
+  unsigned int l;
+
+  for (l = 0; l < L; l++) {
+    memcpy(extkey[l], seed[l], KYBER_SYMBYTES);
+    extkey[l][KYBER_SYMBYTES] = nonce;
+    bufp[l] = buf[l];
+    extp[l] = extkey[l];
+  }
+
+  shake256xn(bufp, eta * KYBER_N / 4, extp, KYBER_SYMBYTES + 1);
+  polyxn_cbd(r, (const uint8_t *const *)bufp, eta);
+}
+
+/*************************************************
+ * Name:        indcpa_dec_xn
+ *
+ * Description: indcpa_dec on all lanes with a shared secret key
+ *************************************************/
+static void indcpa_dec_xn(uint8_t *const m[L], const uint8_t *const c[L],
+                          const polyvec *skpv) {
+  polyvecxn b;
+  polyxn v, mp;
+  const uint8_t *cv[L];
+  unsigned int i, l;
+
+  for (l = 0; l < L; l++)
+    cv[l] = c[l] + KYBER_POLYVECCOMPRESSEDBYTES;
+
+  polyvecxn_decompress(&b, c);
+  polyxn_decompress(&v, cv);
+
+  for (i = 0; i < KYBER_K; i++)
+    polyxn_ntt(&b.vec[i]);
+
+  polyvecxn_pointwise_acc_montgomery(&mp, skpv, &b);
+  polyxn_invntt(&mp);
+
+  polyxn_sub(&mp, &v, &mp);
+  polyxn_reduce(&mp);
+
+  polyxn_tomsg(m, &mp);
+}
+
+/*************************************************
+ * Name:        indcpa_enc_xn
+ *
+ * Description: indcpa_enc on all lanes with a shared public key and
+ *              a pre-expanded A^T
+ *************************************************/
+static void indcpa_enc_xn(uint8_t *const c[L], const uint8_t *const m[L],
+                          const polyvec *pkpv, const polyvec at[KYBER_K],
+                          const uint8_t *const coins[L]) {
+  polyvecxn sp, ep, b;
+  polyxn v, k, epp;
+  uint8_t *cv[L];
+  uint8_t nonce = 0;
+  unsigned int i, l;
+
+  polyxn_frommsg(&k, m);
+
+  for (i = 0; i < KYBER_K; i++)
+    polyxn_getnoise(&sp.vec[i], coins, nonce++, KYBER_ETA1);
+  for (i = 0; i < KYBER_K; i++)
+    polyxn_getnoise(&ep.vec[i], coins, nonce++, KYBER_ETA2);
+  polyxn_getnoise(&epp, coins, nonce++, KYBER_ETA2);
+
+  for (i = 0; i < KYBER_K; i++)
+    polyxn_ntt(&sp.vec[i]);
+
+  for (i = 0; i < KYBER_K; i++)
+    polyvecxn_pointwise_acc_montgomery(&b.vec[i], &at[i], &sp);
+
+  for (i = 0; i < KYBER_K; i++) {
+    polyxn_invntt(&b.vec[i]);
+    polyxn_add(&b.vec[i], &b.vec[i], &ep.vec[i]);
+    polyxn_reduce(&b.vec[i]);
+  }
+
+  polyvecxn_pointwise_acc_montgomery(&v, pkpv, &sp);
+  polyxn_invntt(&v);
+  polyxn_add(&v, &v, &epp);
+  polyxn_add(&v, &v, &k);
+  polyxn_reduce(&v);
+
+  for (l = 0; l < L; l++)
+    cv[l] = c[l] + KYBER_POLYVECCOMPRESSEDBYTES;
+  polyvecxn_compress(c, &b);
+  polyxn_compress(cv, &v);
+}
+
+/*************************************************
+ * Name:        kem_dec_xn
+ *
+ * Description: Algorithm 9 on all lanes (pointer-array interface)
+ *************************************************/
+static void kem_dec_xn(uint8_t *const ss[L], const uint8_t *const ct[L],
+                       const uint8_t sk[KYBER_SECRETKEYBYTES]) {
+  uint8_t buf[L][2 * KYBER_SYMBYTES];
+  uint8_t kr[L][2 * KYBER_SYMBYTES];
+  uint8_t cmp[L][KYBER_CIPHERTEXTBYTES];
+  uint8_t garbage[2 * KYBER_SYMBYTES];
+  uint8_t *bufp[L], *krp[L], *hcp[L], *cmpp[L];
+  const uint8_t *pk = sk + KYBER_POLYVECBYTES;
+  const uint8_t *h_pk = sk + KYBER_SECRETKEYBYTES - 2 * KYBER_SYMBYTES;
+  const uint8_t *z = sk + KYBER_SECRETKEYBYTES - KYBER_SYMBYTES;
+  polyvec skpv, pkpv, at[KYBER_K];
+  uint8_t seed[KYBER_SYMBYTES];
+  uint8_t fail;
+  unsigned int l;
+  size_t i;
+
+  KYBER_METRICS_OP_BEGIN(KYBER_OP_DEC);
+
+  for (l = 0; l < L; l++) {
+    bufp[l] = buf[l];
+    krp[l] = kr[l];
+    hcp[l] = kr[l] + KYBER_SYMBYTES;
+    cmpp[l] = cmp[l];
+  }
+
+  // Shared key material: unpack once for all lanes
+  polyvec_frombytes(&skpv, sk);
+  polyvec_frombytes(&pkpv, pk);
+  memcpy(seed, pk + KYBER_POLYVECBYTES, KYBER_SYMBYTES);
+  gen_matrix(at, seed, 1);
+
+  // Decrypt to get m'
+  indcpa_dec_xn(bufp, ct, &skpv);
+
+  // Compute (K_bar', r') = G(m' || H(pk))
+  for (l = 0; l < L; l++)
+    memcpy(buf[l] + KYBER_SYMBYTES, h_pk, KYBER_SYMBYTES);
+  sha3_512xn(krp, (const uint8_t *const *)bufp, 2 * KYBER_SYMBYTES);
+
+  // Re-encrypt to get c'
+  indcpa_enc_xn(cmpp, (const uint8_t *const *)bufp, &pkpv, at,
+                (const uint8_t *const *)hcp);
+
+  // Compute H(c)
+  sha3_256xn(hcp, ct, KYBER_CIPHERTEXTBYTES);
+
+  for (l = 0; l < L; l++) {
+    fail = 0;
+    for (i = 0; i < KYBER_CIPHERTEXTBYTES; i++)
+      fail |= ct[l][i] ^ cmp[l][i];
+    fail = (uint8_t)((0u - (uint32_t)fail) >> 31);
+    KYBER_METRICS_REJECTION(fail);
+
+    memcpy(garbage, z, KYBER_SYMBYTES);
+    memcpy(garbage + KYBER_SYMBYTES, kr[l] + KYBER_SYMBYTES, KYBER_SYMBYTES);
+    select_bytes(kr[l], garbage, kr[l], 2 * KYBER_SYMBYTES,
+                 (uint8_t)(1 - fail));
+  }
+
+  // Derive shared secrets
+  shake256xn(ss, KYBER_SSBYTES, (const uint8_t *const *)krp,
+             2 * KYBER_SYMBYTES);
+
+  KYBER_METRICS_OP_END_N(KYBER_OP_DEC, L);
+}
+
+/*************************************************
+ * Name:        crypto_kem_dec_xn
+ *
+ * Description: Decapsulates KYBER_XN_LANES ciphertexts under one key
+ *************************************************/
+int crypto_kem_dec_xn(uint8_t ss[KYBER_XN_LANES][KYBER_SSBYTES],
+                      const uint8_t ct[KYBER_XN_LANES][KYBER_CIPHERTEXTBYTES],
+                      const uint8_t sk[KYBER_SECRETKEYBYTES]) {
+  uint8_t *ssp[L];
+  const uint8_t *ctp[L];
+  unsigned int l;
+
+  for (l = 0; l < L; l++) {
+    ssp[l] = ss[l];
+    ctp[l] = ct[l];
+  }
+
+  kem_dec_xn(ssp, ctp, sk);
+  return 0;
+}
+
+/*************************************************
+ * Name:        crypto_kem_dec_xn_batch
+ *
+ * Description: Decapsulates n ciphertexts under one key
+ *************************************************/
+int crypto_kem_dec_xn_batch(uint8_t *ss, const uint8_t *ct,
+                            const uint8_t sk[KYBER_SECRETKEYBYTES], size_t n) {
+  uint8_t *ssp[L];
+  const uint8_t *ctp[L];
+  unsigned int l;
+
+  while (n >= L) {
+    for (l = 0; l < L; l++) {
+      ssp[l] = ss + l * KYBER_SSBYTES;
+      ctp[l] = ct + l * KYBER_CIPHERTEXTBYTES;
+    }
+    kem_dec_xn(ssp, ctp, sk);
+    ss += L * KYBER_SSBYTES;
+    ct += L * KYBER_CIPHERTEXTBYTES;
+    n -= L;
+  }
+
+  while (n > 0) {
+    crypto_kem_dec(ss, ct, sk);
+    ss += KYBER_SSBYTES;
+    ct += KYBER_CIPHERTEXTBYTES;
+    n--;
+  }
+
+  return 0;
+}
@@ -0,0 +1,186 @@
+/*************************************************
+ * Offline/Online Encapsulation Queue
+ *
+ * Single-producer single-consumer ring of precomputed (ct, ss) pairs
+ * for one public key. The producer encapsulates straight into the
+ * free slot, so the only copy on the online path is the one out of
+ * the queue.
+ *************************************************/
+
+#include "../include/kem_encq.h"
+#include "../include/kem.h"
+#include "../include/params.h"
+#include "../include/utils.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+/*************************************************
+ * Name:        kyber_encq_init
+ *
+ * Description: Binds a queue to a public key and entry storage
+ *************************************************/
+int kyber_encq_init(kyber_encq *q, const uint8_t pk[KYBER_PUBLICKEYBYTES],
+                    kyber_encq_entry *entries, size_t capacity) {
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+    return -1;
+
+  memset(q, 0, sizeof(*q));
+  memcpy(q->pk, pk, KYBER_PUBLICKEYBYTES);
+  q->entries = entries;
+  q->mask = capacity - 1;
+  atomic_init(&q->head, 0);
+  atomic_init(&q->tail, 0);
+  return 0;
+}
+
+/*************************************************
+ * Name:        kyber_encq_fill
+ *
+ * Description: Number of ready pairs in the queue
+ *************************************************/
+size_t kyber_encq_fill(const kyber_encq *q) {
+  size_t head = atomic_load(&q->head);
+  size_t tail = atomic_load(&q->tail);
+  return head - tail;
+}
+
+/*************************************************
+ * Name:        kyber_encq_refill_step
+ *
+ * Description: Runs one crypto_kem_enc into the next free entry
+ *************************************************/
+int kyber_encq_refill_step(kyber_encq *q) {
+  size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+  size_t tail = atomic_load(&q->tail);
+  kyber_encq_entry *e;
+
+  if (head - tail > q->mask)
+    return 0;
+
+  e = &q->entries[head & q->mask];
+  if (crypto_kem_enc(e->ct, e->ss, q->pk) != 0)
+    return -1; // Not published
+  atomic_store_explicit(&q->head, head + 1, memory_order_release);
+  return 1;
+}
+
+/*************************************************
+ * Name:        kyber_encq_get
+ *
+ * Description: Takes one ready (ct, ss) pair, wiping the queued secret
+ *************************************************/
+int kyber_encq_get(kyber_encq *q, uint8_t ct[KYBER_CIPHERTEXTBYTES],
+                   uint8_t ss[KYBER_SSBYTES]) {
+  size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+  kyber_encq_entry *e;
+
+  if (head == tail) {
+    q->misses++;
+    return crypto_kem_enc(ct, ss, q->pk);
+  }
+
+  e = &q->entries[tail & q->mask];
+  memcpy(ct, e->ct, KYBER_CIPHERTEXTBYTES);
+  memcpy(ss, e->ss, KYBER_SSBYTES);
+  secure_zero(e->ss, KYBER_SSBYTES);
+  atomic_store(&q->tail, tail + 1);
+  q->hits++;
+
+#if defined(KYBER_PLATFORM_DESKTOP)
+  // Pairs with the store/load order in encq_thread: either the producer
+  // sees the new tail, or we see it asleep and wake it
+  if (atomic_load(&q->sleeping)) {
+    pthread_mutex_lock(&q->lock);
+    pthread_cond_signal(&q->wake);
+    pthread_mutex_unlock(&q->lock);
+  }
+#endif
+
+  return 0;
+}
+
+/*************************************************
+ * Name:        kyber_encq_clear
+ *
+ * Description: Drops all queued pairs and wipes their shared secrets
+ *************************************************/
+void kyber_encq_clear(kyber_encq *q) {
+  size_t i;
+
+  for (i = 0; i <= q->mask; i++)
+    secure_zero(q->entries[i].ss, KYBER_SSBYTES);
+  atomic_store(&q->tail, atomic_load(&q->head));
+}
+
+#if defined(KYBER_PLATFORM_DESKTOP)
+
+/*************************************************
+ * Name:        encq_thread
+ *
+ * Description: Background producer; keeps the queue full
+ *************************************************/
+static void *encq_thread(void *arg) {
+  kyber_encq *q = (kyber_encq *)arg;
+
+  while (!atomic_load(&q->stop)) {
+    if (kyber_encq_refill_step(q))
+      continue;
+
+    pthread_mutex_lock(&q->lock);
+    atomic_store(&q->sleeping, 1);
+    while (!atomic_load(&q->stop) && kyber_encq_fill(q) > q->mask)
+      pthread_cond_wait(&q->wake, &q->lock);
+    atomic_store(&q->sleeping, 0);
+    pthread_mutex_unlock(&q->lock);
+  }
+
+  return NULL;
+}
+
+/*************************************************
+ * Name:        kyber_encq_start
+ *
+ * Description: Starts a background thread that keeps the queue full
+ *************************************************/
+int kyber_encq_start(kyber_encq *q) {
+  if (q->running)
+    return 0;
+
+  atomic_init(&q->sleeping, 0);
+  atomic_init(&q->stop, 0);
+  pthread_mutex_init(&q->lock, NULL);
+  pthread_cond_init(&q->wake, NULL);
+
+  if (pthread_create(&q->thread, NULL, encq_thread, q) != 0) {
+    pthread_cond_destroy(&q->wake);
+    pthread_mutex_destroy(&q->lock);
+    return -1;
+  }
+
+  q->running = 1;
+  return 0;
+}
+
+/*************************************************
+ * Name:        kyber_encq_stop
+ *
+ * Description: Stops and joins the background thread
+ *************************************************/
+void kyber_encq_stop(kyber_encq *q) {
+  if (!q->running)
+    return;
+
+  pthread_mutex_lock(&q->lock);
+  atomic_store(&q->stop, 1);
+  pthread_cond_signal(&q->wake);
+  pthread_mutex_unlock(&q->lock);
+
+  pthread_join(q->thread, NULL);
+  pthread_cond_destroy(&q->wake);
+  pthread_mutex_destroy(&q->lock);
+  q->running = 0;
+}
+
+#endif
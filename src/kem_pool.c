@@ -0,0 +1,326 @@
+/*************************************************
+ * Precomputed Keypair Pool
+ *
+ * Bounded lock-free MPMC ring (one sequence number per slot) holding
+ * ready (pk, sk) pairs. Consumers only ever dequeue; background
+ * workers sleep until the fill level drops below the low watermark,
+ * then run crypto_kem_keypair until the ring is full again.
+ *************************************************/
+
+#include "../include/kem_pool.h"
+#include "../include/kem.h"
+#include "../include/params.h"
+#include "../include/utils.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define POOL_CACHELINE 64
+
+typedef struct {
+  atomic_size_t seq;
+  uint8_t pk[KYBER_PUBLICKEYBYTES];
+  uint8_t sk[KYBER_SECRETKEYBYTES];
+} pool_slot;
+
+struct kyber_keypair_pool {
+  // Producer and consumer cursors live on separate cache lines
+  atomic_size_t head;
+  uint8_t pad0[POOL_CACHELINE - sizeof(atomic_size_t)];
+  atomic_size_t tail;
+  uint8_t pad1[POOL_CACHELINE - sizeof(atomic_size_t)];
+  atomic_uint_fast64_t hits;
+  atomic_uint_fast64_t misses;
+  uint8_t pad2[POOL_CACHELINE - 2 * sizeof(atomic_uint_fast64_t)];
+  atomic_uint_fast64_t generated;
+  atomic_int refill;
+  atomic_int stop;
+
+  pool_slot *slots;
+  size_t mask;
+  size_t low_watermark;
+
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  pthread_t *workers;
+  unsigned int nworkers;
+};
+
+/*************************************************
+ * Name:        pool_push
+ *
+ * Description: Enqueue one keypair
+ *
+ * Returns 0 on success, -1 if the ring is full
+ *************************************************/
+static int pool_push(kyber_keypair_pool *p, const uint8_t *pk,
+                     const uint8_t *sk) {
+  pool_slot *slot;
+  size_t pos, seq;
+  intptr_t dif;
+
+  pos = atomic_load_explicit(&p->head, memory_order_relaxed);
+  for (;;) {
+    slot = &p->slots[pos & p->mask];
+    seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    dif = (intptr_t)seq - (intptr_t)pos;
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&p->head, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed))
+        break;
+    } else if (dif < 0) {
+      return -1;
+    } else {
+      pos = atomic_load_explicit(&p->head, memory_order_relaxed);
+    }
+  }
+
+  memcpy(slot->pk, pk, KYBER_PUBLICKEYBYTES);
+  memcpy(slot->sk, sk, KYBER_SECRETKEYBYTES);
+  atomic_store_explicit(&slot->seq, pos + 1, memory_order_release);
+  return 0;
+}
+
+/*************************************************
+ * Name:        pool_pop
+ *
+ * Description: Dequeue one keypair and wipe the slot's secret key
+ *
+ * Returns 0 on success, -1 if the ring is empty
+ *************************************************/
+static int pool_pop(kyber_keypair_pool *p, uint8_t *pk, uint8_t *sk) {
+  pool_slot *slot;
+  size_t pos, seq;
+  intptr_t dif;
+
+  pos = atomic_load_explicit(&p->tail, memory_order_relaxed);
+  for (;;) {
+    slot = &p->slots[pos & p->mask];
+    seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    dif = (intptr_t)seq - (intptr_t)(pos + 1);
+    if (dif == 0) {
+      if (atomic_compare_exchange_weak_explicit(&p->tail, &pos, pos + 1,
+                                                memory_order_relaxed,
+                                                memory_order_relaxed))
+        break;
+    } else if (dif < 0) {
+      return -1;
+    } else {
+      pos = atomic_load_explicit(&p->tail, memory_order_relaxed);
+    }
+  }
+
+  memcpy(pk, slot->pk, KYBER_PUBLICKEYBYTES);
+  memcpy(sk, slot->sk, KYBER_SECRETKEYBYTES);
+  secure_zero(slot->sk, KYBER_SECRETKEYBYTES);
+  atomic_store_explicit(&slot->seq, pos + p->mask + 1, memory_order_release);
+  return 0;
+}
+
+/*************************************************
+ * Name:        pool_fill
+ *
+ * Description: Approximate number of ready keypairs
+ *************************************************/
+static size_t pool_fill(const kyber_keypair_pool *p) {
+  size_t head = atomic_load_explicit(&p->head, memory_order_relaxed);
+  size_t tail = atomic_load_explicit(&p->tail, memory_order_relaxed);
+  return (head > tail) ? head - tail : 0;
+}
+
+/*************************************************
+ * Name:        pool_kick
+ *
+ * Description: Wake the workers when the fill level has dropped below
+ *              the low watermark. Only the caller that flips the refill
+ *              flag takes the lock, so the hit path stays lock-free.
+ *************************************************/
+static void pool_kick(kyber_keypair_pool *p) {
+  if (pool_fill(p) >= p->low_watermark)
+    return;
+  if (atomic_load_explicit(&p->refill, memory_order_relaxed))
+    return;
+  if (atomic_exchange(&p->refill, 1) == 0) {
+    pthread_mutex_lock(&p->lock);
+    pthread_cond_broadcast(&p->wake);
+    pthread_mutex_unlock(&p->lock);
+  }
+}
+
+/*************************************************
+ * Name:        pool_worker
+ *
+ * Description: Background keygen loop. A keypair that does not fit
+ *              because the ring filled up meanwhile is kept and pushed
+ *              on the next refill round rather than thrown away.
+ *************************************************/
+static void *pool_worker(void *arg) {
+  kyber_keypair_pool *p = (kyber_keypair_pool *)arg;
+  uint8_t pk[KYBER_PUBLICKEYBYTES];
+  uint8_t sk[KYBER_SECRETKEYBYTES];
+  int pending = 0;
+
+  for (;;) {
+    if (atomic_load(&p->stop) || !atomic_load(&p->refill)) {
+      pthread_mutex_lock(&p->lock);
+      while (!atomic_load(&p->stop) && !atomic_load(&p->refill))
+        pthread_cond_wait(&p->wake, &p->lock);
+      pthread_mutex_unlock(&p->lock);
+      if (atomic_load(&p->stop))
+        break;
+    }
+
+    // A keypair whose randomness failed is not queued; try again
+    if (!pending) {
+      if (crypto_kem_keypair(pk, sk) != 0)
+        continue;
+      pending = 1;
+    }
+
+    if (pool_push(p, pk, sk) == 0) {
+      pending = 0;
+      atomic_fetch_add_explicit(&p->generated, 1, memory_order_relaxed);
+    } else {
+      // Ring is full: sleep until a consumer crosses the watermark
+      atomic_store(&p->refill, 0);
+      pool_kick(p);
+    }
+  }
+
+  secure_zero(sk, sizeof(sk));
+  return NULL;
+}
+
+/*************************************************
+ * Name:        pool_stop_workers
+ *
+ * Description: Signal and join the first n worker threads
+ *************************************************/
+static void pool_stop_workers(kyber_keypair_pool *p, unsigned int n) {
+  unsigned int i;
+
+  pthread_mutex_lock(&p->lock);
+  atomic_store(&p->stop, 1);
+  pthread_cond_broadcast(&p->wake);
+  pthread_mutex_unlock(&p->lock);
+
+  for (i = 0; i < n; i++)
+    pthread_join(p->workers[i], NULL);
+}
+
+/*************************************************
+ * Name:        kyber_keypair_pool_create
+ *
+ * Description: Allocates a keypair pool and starts its worker threads
+ *************************************************/
+int kyber_keypair_pool_create(kyber_keypair_pool **pool,
+                              const kyber_keypair_pool_config *cfg) {
+  kyber_keypair_pool *p;
+  size_t capacity, i;
+  unsigned int t;
+
+  *pool = NULL;
+  if (cfg == NULL || cfg->capacity == 0 || cfg->threads == 0 ||
+      cfg->low_watermark > cfg->capacity)
+    return -1;
+
+  capacity = 1;
+  while (capacity < cfg->capacity)
+    capacity <<= 1;
+
+  p = (kyber_keypair_pool *)calloc(1, sizeof(*p));
+  if (p == NULL)
+    return -1;
+  p->slots = (pool_slot *)calloc(capacity, sizeof(pool_slot));
+  p->workers = (pthread_t *)calloc(cfg->threads, sizeof(pthread_t));
+  if (p->slots == NULL || p->workers == NULL) {
+    free(p->slots);
+    free(p->workers);
+    free(p);
+    return -1;
+  }
+
+  p->mask = capacity - 1;
+  p->low_watermark = cfg->low_watermark;
+  p->nworkers = cfg->threads;
+  for (i = 0; i < capacity; i++)
+    atomic_init(&p->slots[i].seq, i);
+  atomic_init(&p->head, 0);
+  atomic_init(&p->tail, 0);
+  atomic_init(&p->hits, 0);
+  atomic_init(&p->misses, 0);
+  atomic_init(&p->generated, 0);
+  atomic_init(&p->refill, 1); // Fill to capacity on start-up
+  atomic_init(&p->stop, 0);
+  pthread_mutex_init(&p->lock, NULL);
+  pthread_cond_init(&p->wake, NULL);
+
+  for (t = 0; t < p->nworkers; t++) {
+    if (pthread_create(&p->workers[t], NULL, pool_worker, p) != 0) {
+      pool_stop_workers(p, t);
+      p->nworkers = 0;
+      kyber_keypair_pool_destroy(p);
+      return -1;
+    }
+  }
+
+  *pool = p;
+  return 0;
+}
+
+/*************************************************
+ * Name:        kyber_keypair_pool_get
+ *
+ * Description: Takes one keypair out of the pool, falling back to
+ *              inline generation on an empty ring
+ *************************************************/
+int kyber_keypair_pool_get(kyber_keypair_pool *pool,
+                           uint8_t pk[KYBER_PUBLICKEYBYTES],
+                           uint8_t sk[KYBER_SECRETKEYBYTES]) {
+  if (pool_pop(pool, pk, sk) == 0) {
+    atomic_fetch_add_explicit(&pool->hits, 1, memory_order_relaxed);
+    pool_kick(pool);
+    return 0;
+  }
+
+  atomic_fetch_add_explicit(&pool->misses, 1, memory_order_relaxed);
+  pool_kick(pool);
+  return crypto_kem_keypair(pk, sk);
+}
+
+/*************************************************
+ * Name:        kyber_keypair_pool_get_stats
+ *
+ * Description: Reads the hit/miss counters and current fill level
+ *************************************************/
+void kyber_keypair_pool_get_stats(const kyber_keypair_pool *pool,
+                                  kyber_keypair_pool_stats *stats) {
+  stats->hits = atomic_load_explicit(&pool->hits, memory_order_relaxed);
+  stats->misses = atomic_load_explicit(&pool->misses, memory_order_relaxed);
+  stats->generated =
+      atomic_load_explicit(&pool->generated, memory_order_relaxed);
+  stats->fill = pool_fill(pool);
+}
+
+/*************************************************
+ * Name:        kyber_keypair_pool_destroy
+ *
+ * Description: Stops the workers, wipes pooled secret keys and frees
+ *************************************************/
+void kyber_keypair_pool_destroy(kyber_keypair_pool *pool) {
+  if (pool == NULL)
+    return;
+
+  if (pool->nworkers)
+    pool_stop_workers(pool, pool->nworkers);
+
+  secure_zero(pool->slots, (pool->mask + 1) * sizeof(pool_slot));
+  pthread_cond_destroy(&pool->wake);
+  pthread_mutex_destroy(&pool->lock);
+  free(pool->slots);
+  free(pool->workers);
+  free(pool);
+}
@@ -0,0 +1,534 @@
+/*************************************************
+ * Resumable (Time-Sliced) KEM Operations
+ *
+ * State machines that replay crypto_kem_keypair/enc/dec one bounded
+ * step at a time. The arithmetic is the same as indcpa.c and kem.c;
+ * only the loop structure differs:
+ *   - A and A^T are expanded one entry per step and multiplied into
+ *     the accumulating row straight away (gen_matrix_entry)
+ *   - t and s are read from the packed keys one polynomial at a time
+ *   - e and e1 are sampled when their row is finished
+ *   - H(pk) and H(c) absorb one SHA3-256 block per step
+ *************************************************/
+
+#include "../include/kem_step.h"
+#include "../include/fips202.h"
+#include "../include/indcpa.h"
+#include "../include/kyber_metrics.h"
+#include "../include/params.h"
+#include "../include/poly.h"
+#include "../include/polyvec.h"
+#include "../include/randombytes.h"
+#include "../include/utils.h"
+#include <stdint.h>
+#include <string.h>
+
+/*************************************************
+ * Helpers
+ *************************************************/
+
+// One term of polyvec_pointwise_acc_montgomery: r (+)= a * b
+static void acc_step(poly *r, const poly *a, const poly *b, unsigned int j,
+                     poly *t) {
+  if (j == 0) {
+    poly_basemul_montgomery(r, a, b);
+  } else {
+    poly_basemul_montgomery(t, a, b);
+    poly_add(r, r, t);
+  }
+  if (j == KYBER_K - 1)
+    poly_reduce(r);
+}
+
+// One SHA3-256 block of in; returns 1 once the digest is written
+static int hash_step(keccak_state *h, size_t *off, uint8_t out[32],
+                     const uint8_t *in, size_t inlen) {
+  if (inlen - *off >= SHA3_256_RATE) {
+    sha3_256_inc_absorb_block(h, in + *off);
+    *off += SHA3_256_RATE;
+    return 0;
+  }
+  sha3_256_inc_finalize(out, h, in + *off, inlen - *off);
+  return 1;
+}
+
+/*************************************************
+ * IND-CPA encryption (Algorithm 5), shared by enc and dec
+ *************************************************/
+enum {
+  ENC_NOISE_R,  // r_i = CBD_eta1(PRF(coins, i))
+  ENC_NTT_R,    // r_i = NTT(r_i)
+  ENC_ROW,      // u_i += A^T[i][j] * r_j
+  ENC_INVNTT_U, // u_i = NTT^-1(u_i)
+  ENC_ADD_E1,   // u_i += e1_i
+  ENC_ACC_V,    // v += t_j * r_j
+  ENC_INVNTT_V, // v = NTT^-1(v)
+  ENC_PACK,     // v += e2 + Decompress(m); c = (u, v)
+  ENC_DONE
+};
+
+static void enc_core_start(kyber_indcpa_enc_state *e) {
+  e->phase = ENC_NOISE_R;
+  e->i = 0;
+  e->j = 0;
+}
+
+// Returns 1 once c has been written
+static int enc_core_step(kyber_indcpa_enc_state *e,
+                         uint8_t c[KYBER_CIPHERTEXTBYTES],
+                         const uint8_t m[KYBER_SYMBYTES],
+                         const uint8_t pk[KYBER_PUBLICKEYBYTES],
+                         const uint8_t coins[KYBER_SYMBYTES]) {
+  switch (e->phase) {
+  case ENC_NOISE_R:
+    poly_getnoise_eta1(&e->sp.vec[e->i], coins, (uint8_t)e->i);
+    if (++e->i == KYBER_K) {
+      e->i = 0;
+      e->phase = ENC_NTT_R;
+    }
+    return 0;
+
+  case ENC_NTT_R:
+    poly_ntt(&e->sp.vec[e->i]);
+    if (++e->i == KYBER_K) {
+      e->i = 0;
+      e->phase = ENC_ROW;
+    }
+    return 0;
+
+  case ENC_ROW:
+    gen_matrix_entry(&e->a, pk + KYBER_POLYVECBYTES, (uint8_t)e->i,
+                     (uint8_t)e->j);
+    acc_step(&e->b.vec[e->i], &e->a, &e->sp.vec[e->j], e->j, &e->t);
+    if (++e->j == KYBER_K) {
+      e->j = 0;
+      e->phase = ENC_INVNTT_U;
+    }
+    return 0;
+
+  case ENC_INVNTT_U:
+    poly_invntt(&e->b.vec[e->i]);
+    e->phase = ENC_ADD_E1;
+    return 0;
+
+  case ENC_ADD_E1:
+    poly_getnoise_eta2(&e->t, coins, (uint8_t)(KYBER_K + e->i));
+    poly_add(&e->b.vec[e->i], &e->b.vec[e->i], &e->t);
+    poly_reduce(&e->b.vec[e->i]);
+    if (++e->i == KYBER_K) {
+      e->i = 0;
+      e->phase = ENC_ACC_V;
+    } else {
+      e->phase = ENC_ROW;
+    }
+    return 0;
+
+  case ENC_ACC_V:
+    poly_frombytes(&e->a, pk + e->j * KYBER_POLYBYTES);
+    acc_step(&e->v, &e->a, &e->sp.vec[e->j], e->j, &e->t);
+    if (++e->j == KYBER_K) {
+      e->j = 0;
+      e->phase = ENC_INVNTT_V;
+    }
+    return 0;
+
+  case ENC_INVNTT_V:
+    poly_invntt(&e->v);
+    e->phase = ENC_PACK;
+    return 0;
+
+  case ENC_PACK:
+    poly_getnoise_eta2(&e->t, coins, (uint8_t)(2 * KYBER_K));
+    poly_add(&e->v, &e->v, &e->t);
+    poly_frommsg(&e->a, m);
+    poly_add(&e->v, &e->v, &e->a);
+    poly_reduce(&e->v);
+
+    polyvec_compress(c, &e->b);
+    poly_compress(c + KYBER_POLYVECCOMPRESSEDBYTES, &e->v, KYBER_DV);
+    e->phase = ENC_DONE;
+    return 1;
+
+  default:
+    return 1;
+  }
+}
+
+/*************************************************
+ * Key generation (Algorithms 4 and 7)
+ *************************************************/
+enum {
+  KP_SEED,     // (rho, sigma) = G(d)
+  KP_NOISE_S,  // s_i = CBD_eta1(PRF(sigma, i))
+  KP_NTT_S,    // s_i = NTT(s_i)
+  KP_ROW,      // t_i += A[i][j] * s_j
+  KP_ROW_E,    // e_i = NTT(CBD_eta1(PRF(sigma, K + i)))
+  KP_ROW_PACK, // pk_i = Encode(t_i + e_i)
+  KP_PACK,     // sk = s || pk
+  KP_HASH_PK,  // sk ||= H(pk)
+  KP_Z,        // sk ||= z
+  KP_DONE,
+  KP_FAILED
+};
+
+/*************************************************
+ * Name:        kyber_keypair_start
+ *
+ * Description: Prepares an incremental crypto_kem_keypair
+ *************************************************/
+void kyber_keypair_start(kyber_keypair_ctx *ctx,
+                         uint8_t pk[KYBER_PUBLICKEYBYTES],
+                         uint8_t sk[KYBER_SECRETKEYBYTES]) {
+  ctx->phase = KP_SEED;
+  ctx->i = 0;
+  ctx->j = 0;
+  ctx->pk = pk;
+  ctx->sk = sk;
+}
+
+/*************************************************
+ * Name:        kyber_keypair_step
+ *
+ * Description: Runs one bounded unit of key generation
+ *************************************************/
+int kyber_keypair_step(kyber_keypair_ctx *ctx) {
+  const uint8_t *publicseed = ctx->seed;
+  const uint8_t *noiseseed = ctx->seed + KYBER_SYMBYTES;
+
+  switch (ctx->phase) {
+  case KP_SEED:
+    if (randombytes(ctx->seed, KYBER_SYMBYTES) != 0) {
+      ctx->phase = KP_FAILED;
+      return -1;
+    }
+    sha3_512_32(ctx->seed, ctx->seed);
+    ctx->phase = KP_NOISE_S;
+    break;
+
+  case KP_NOISE_S:
+    poly_getnoise_eta1(&ctx->skpv.vec[ctx->i], noiseseed, (uint8_t)ctx->i);
+    if (++ctx->i == KYBER_K) {
+      ctx->i = 0;
+      ctx->phase = KP_NTT_S;
+    }
+    break;
+
+  case KP_NTT_S:
+    poly_ntt(&ctx->skpv.vec[ctx->i]);
+    if (++ctx->i == KYBER_K) {
+      ctx->i = 0;
+      ctx->phase = KP_ROW;
+    }
+    break;
+
+  case KP_ROW:
+    gen_matrix_entry(&ctx->a, publicseed, (uint8_t)ctx->j, (uint8_t)ctx->i);
+    acc_step(&ctx->row, &ctx->a, &ctx->skpv.vec[ctx->j], ctx->j, &ctx->t);
+    if (++ctx->j == KYBER_K) {
+      ctx->j = 0;
+      poly_tomont(&ctx->row);
+      ctx->phase = KP_ROW_E;
+    }
+    break;
+
+  case KP_ROW_E:
+    poly_getnoise_eta1(&ctx->t, noiseseed, (uint8_t)(KYBER_K + ctx->i));
+    poly_ntt(&ctx->t);
+    ctx->phase = KP_ROW_PACK;
+    break;
+
+  case KP_ROW_PACK:
+    poly_add(&ctx->row, &ctx->row, &ctx->t);
+    poly_reduce(&ctx->row);
+    poly_tobytes(ctx->pk + ctx->i * KYBER_POLYBYTES, &ctx->row);
+    ctx->phase = (++ctx->i == KYBER_K) ? KP_PACK : KP_ROW;
+    break;
+
+  case KP_PACK:
+    memcpy(ctx->pk + KYBER_POLYVECBYTES, publicseed, KYBER_SYMBYTES);
+    polyvec_tobytes(ctx->sk, &ctx->skpv);
+    memcpy(ctx->sk + KYBER_POLYVECBYTES, ctx->pk, KYBER_PUBLICKEYBYTES);
+    sha3_256_inc_init(&ctx->hash);
+    ctx->off = 0;
+    ctx->phase = KP_HASH_PK;
+    break;
+
+  case KP_HASH_PK:
+    if (hash_step(&ctx->hash, &ctx->off,
+                  ctx->sk + KYBER_SECRETKEYBYTES - 2 * KYBER_SYMBYTES, ctx->pk,
+                  KYBER_PUBLICKEYBYTES))
+      ctx->phase = KP_Z;
+    break;
+
+  case KP_Z:
+    if (randombytes(ctx->sk + KYBER_SECRETKEYBYTES - KYBER_SYMBYTES,
+                    KYBER_SYMBYTES) != 0) {
+      ctx->phase = KP_FAILED;
+      return -1;
+    }
+    ctx->phase = KP_DONE;
+    KYBER_METRICS_OP_UNTIMED(KYBER_OP_KEYPAIR);
+    break;
+
+  case KP_FAILED:
+    return -1;
+
+  default:
+    break;
+  }
+
+  return (ctx->phase == KP_DONE) ? KYBER_STEP_DONE : KYBER_STEP_MORE;
+}
+
+/*************************************************
+ * Name:        kyber_keypair_finish
+ *
+ * Description: Runs any remaining steps and wipes the context
+ *************************************************/
+int kyber_keypair_finish(kyber_keypair_ctx *ctx) {
+  int r;
+
+  while ((r = kyber_keypair_step(ctx)) == KYBER_STEP_MORE)
+    ;
+  secure_zero(ctx, sizeof(*ctx));
+  return r;
+}
+
+/*************************************************
+ * Encapsulation (Algorithm 8)
+ *************************************************/
+enum {
+  EN_MSG,     // m = H(randombytes)
+  EN_HASH_PK, // H(pk)
+  EN_G,       // (K_bar, r) = G(m || H(pk))
+  EN_INDCPA,  // c = Enc(pk, m, r)
+  EN_HASH_CT, // H(c)
+  EN_KDF,     // ss = KDF(K_bar || H(c))
+  EN_DONE,
+  EN_FAILED
+};
+
+/*************************************************
+ * Name:        kyber_enc_start
+ *
+ * Description: Prepares an incremental crypto_kem_enc
+ *************************************************/
+void kyber_enc_start(kyber_enc_ctx *ctx, uint8_t ct[KYBER_CIPHERTEXTBYTES],
+                     uint8_t ss[KYBER_SSBYTES],
+                     const uint8_t pk[KYBER_PUBLICKEYBYTES]) {
+  ctx->phase = EN_MSG;
+  ctx->ct = ct;
+  ctx->ss = ss;
+  ctx->pk = pk;
+}
+
+/*************************************************
+ * Name:        kyber_enc_step
+ *
+ * Description: Runs one bounded unit of encapsulation
+ *************************************************/
+int kyber_enc_step(kyber_enc_ctx *ctx) {
+  switch (ctx->phase) {
+  case EN_MSG:
+    if (randombytes(ctx->buf, KYBER_SYMBYTES) != 0) {
+      ctx->phase = EN_FAILED;
+      return -1;
+    }
+    sha3_256_32(ctx->buf, ctx->buf);
+    sha3_256_inc_init(&ctx->hash);
+    ctx->off = 0;
+    ctx->phase = EN_HASH_PK;
+    break;
+
+  case EN_HASH_PK:
+    if (hash_step(&ctx->hash, &ctx->off, ctx->buf + KYBER_SYMBYTES, ctx->pk,
+                  KYBER_PUBLICKEYBYTES))
+      ctx->phase = EN_G;
+    break;
+
+  case EN_G:
+    sha3_512_64(ctx->kr, ctx->buf);
+    enc_core_start(&ctx->enc);
+    ctx->phase = EN_INDCPA;
+    break;
+
+  case EN_INDCPA:
+    if (enc_core_step(&ctx->enc, ctx->ct, ctx->buf, ctx->pk,
+                      ctx->kr + KYBER_SYMBYTES)) {
+      sha3_256_inc_init(&ctx->hash);
+      ctx->off = 0;
+      ctx->phase = EN_HASH_CT;
+    }
+    break;
+
+  case EN_HASH_CT:
+    if (hash_step(&ctx->hash, &ctx->off, ctx->kr + KYBER_SYMBYTES, ctx->ct,
+                  KYBER_CIPHERTEXTBYTES))
+      ctx->phase = EN_KDF;
+    break;
+
+  case EN_KDF:
+    shake256_64(ctx->ss, KYBER_SSBYTES, ctx->kr);
+    ctx->phase = EN_DONE;
+    KYBER_METRICS_OP_UNTIMED(KYBER_OP_ENC);
+    break;
+
+  case EN_FAILED:
+    return -1;
+
+  default:
+    break;
+  }
+
+  return (ctx->phase == EN_DONE) ? KYBER_STEP_DONE : KYBER_STEP_MORE;
+}
+
+/*************************************************
+ * Name:        kyber_enc_finish
+ *
+ * Description: Runs any remaining steps and wipes the context
+ *************************************************/
+int kyber_enc_finish(kyber_enc_ctx *ctx) {
+  int r;
+
+  while ((r = kyber_enc_step(ctx)) == KYBER_STEP_MORE)
+    ;
+  secure_zero(ctx, sizeof(*ctx));
+  return r;
+}
+
+/*************************************************
+ * Decapsulation (Algorithms 6 and 9)
+ *************************************************/
+enum {
+  DE_UNPACK,  // u = Decompress(c1)
+  DE_NTT_U,   // u_i = NTT(u_i)
+  DE_ACC,     // w += s_j * u_j
+  DE_MSG,     // m' = Compress(v - NTT^-1(w))
+  DE_G,       // (K_bar', r') = G(m' || H(pk))
+  DE_INDCPA,  // c' = Enc(pk, m', r')
+  DE_HASH_CT, // H(c)
+  DE_FINAL,   // ss = KDF(c == c' ? K_bar' : z, H(c))
+  DE_DONE
+};
+
+/*************************************************
+ * Name:        kyber_dec_start
+ *
+ * Description: Prepares an incremental crypto_kem_dec
+ *************************************************/
+void kyber_dec_start(kyber_dec_ctx *ctx, uint8_t ss[KYBER_SSBYTES],
+                     const uint8_t ct[KYBER_CIPHERTEXTBYTES],
+                     const uint8_t sk[KYBER_SECRETKEYBYTES]) {
+  ctx->phase = DE_UNPACK;
+  ctx->ss = ss;
+  ctx->ct = ct;
+  ctx->sk = sk;
+  ctx->enc.i = 0;
+  ctx->enc.j = 0;
+}
+
+/*************************************************
+ * Name:        kyber_dec_step
+ *
+ * Description: Runs one bounded unit of decapsulation
+ *************************************************/
+int kyber_dec_step(kyber_dec_ctx *ctx) {
+  kyber_indcpa_enc_state *e = &ctx->enc;
+  const uint8_t *pk = ctx->sk + KYBER_POLYVECBYTES;
+  const uint8_t *h_pk = ctx->sk + KYBER_SECRETKEYBYTES - 2 * KYBER_SYMBYTES;
+  const uint8_t *z = ctx->sk + KYBER_SECRETKEYBYTES - KYBER_SYMBYTES;
+  uint8_t garbage[2 * KYBER_SYMBYTES];
+  uint8_t fail;
+  size_t i;
+
+  switch (ctx->phase) {
+  case DE_UNPACK:
+    polyvec_decompress(&e->b, ctx->ct);
+    ctx->phase = DE_NTT_U;
+    break;
+
+  case DE_NTT_U:
+    poly_ntt(&e->b.vec[e->i]);
+    if (++e->i == KYBER_K) {
+      e->i = 0;
+      ctx->phase = DE_ACC;
+    }
+    break;
+
+  case DE_ACC:
+    poly_frombytes(&e->a, ctx->sk + e->j * KYBER_POLYBYTES);
+    acc_step(&e->v, &e->a, &e->b.vec[e->j], e->j, &e->t);
+    if (++e->j == KYBER_K) {
+      e->j = 0;
+      ctx->phase = DE_MSG;
+    }
+    break;
+
+  case DE_MSG:
+    poly_invntt(&e->v);
+    poly_decompress(&e->a, ctx->ct + KYBER_POLYVECCOMPRESSEDBYTES, KYBER_DV);
+    poly_sub(&e->v, &e->a, &e->v);
+    poly_reduce(&e->v);
+    poly_tomsg(ctx->buf, &e->v);
+    memcpy(ctx->buf + KYBER_SYMBYTES, h_pk, KYBER_SYMBYTES);
+    ctx->phase = DE_G;
+    break;
+
+  case DE_G:
+    sha3_512_64(ctx->kr, ctx->buf);
+    enc_core_start(e);
+    ctx->phase = DE_INDCPA;
+    break;
+
+  case DE_INDCPA:
+    if (enc_core_step(e, ctx->cmp, ctx->buf, pk, ctx->kr + KYBER_SYMBYTES)) {
+      sha3_256_inc_init(&ctx->hash);
+      ctx->off = 0;
+      ctx->phase = DE_HASH_CT;
+    }
+    break;
+
+  case DE_HASH_CT:
+    // kr + 32 (r') is no longer needed once c' exists
+    if (hash_step(&ctx->hash, &ctx->off, ctx->kr + KYBER_SYMBYTES, ctx->ct,
+                  KYBER_CIPHERTEXTBYTES))
+      ctx->phase = DE_FINAL;
+    break;
+
+  case DE_FINAL:
+    fail = 0;
+    for (i = 0; i < KYBER_CIPHERTEXTBYTES; i++)
+      fail |= ctx->ct[i] ^ ctx->cmp[i];
+    fail = (uint8_t)((0u - (uint32_t)fail) >> 31);
+    KYBER_METRICS_REJECTION(fail);
+
+    memcpy(garbage, z, KYBER_SYMBYTES);
+    memcpy(garbage + KYBER_SYMBYTES, ctx->kr + KYBER_SYMBYTES, KYBER_SYMBYTES);
+    select_bytes(ctx->kr, garbage, ctx->kr, 2 * KYBER_SYMBYTES,
+                 (uint8_t)(1 - fail));
+    secure_zero(garbage, sizeof(garbage));
+
+    shake256_64(ctx->ss, KYBER_SSBYTES, ctx->kr);
+    ctx->phase = DE_DONE;
+    KYBER_METRICS_OP_UNTIMED(KYBER_OP_DEC);
+    break;
+
+  default:
+    break;
+  }
+
+  return (ctx->phase == DE_DONE) ? KYBER_STEP_DONE : KYBER_STEP_MORE;
+}
+
+/*************************************************
+ * Name:        kyber_dec_finish
+ *
+ * Description: Runs any remaining steps and wipes the context
+ *************************************************/
+int kyber_dec_finish(kyber_dec_ctx *ctx) {
+  while (kyber_dec_step(ctx) == KYBER_STEP_MORE)
+    ;
+  secure_zero(ctx, sizeof(*ctx));
+  return 0;
+}
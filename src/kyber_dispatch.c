@@ -0,0 +1,94 @@
+/*************************************************
+ * Runtime Parameter-Set Dispatch
+ *************************************************/
+
+#include "../include/kyber_dispatch.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(KYBER_MULTI_PARAMS)
+
+/*
+ * This file is compiled once, so it cannot include kem.h for three
+ * values of KYBER_K. Declare the namespaced entry points directly.
+ */
+#define KYBER_DECLARE_SET(p)                                                   \
+  int p##_crypto_kem_keypair(uint8_t *pk, uint8_t *sk);                        \
+  int p##_crypto_kem_enc(uint8_t *ct, uint8_t *ss, const uint8_t *pk);         \
+  int p##_crypto_kem_dec(uint8_t *ss, const uint8_t *ct, const uint8_t *sk);
+
+KYBER_DECLARE_SET(kyber512)
+KYBER_DECLARE_SET(kyber768)
+KYBER_DECLARE_SET(kyber1024)
+
+static const kyber_kem_impl kyber_sets[] = {
+    {KYBER_PARAM_512, "Kyber-512", KYBER512_PUBLICKEYBYTES,
+     KYBER512_SECRETKEYBYTES, KYBER512_CIPHERTEXTBYTES, KYBER_ALL_SSBYTES,
+     kyber512_crypto_kem_keypair, kyber512_crypto_kem_enc,
+     kyber512_crypto_kem_dec},
+    {KYBER_PARAM_768, "Kyber-768", KYBER768_PUBLICKEYBYTES,
+     KYBER768_SECRETKEYBYTES, KYBER768_CIPHERTEXTBYTES, KYBER_ALL_SSBYTES,
+     kyber768_crypto_kem_keypair, kyber768_crypto_kem_enc,
+     kyber768_crypto_kem_dec},
+    {KYBER_PARAM_1024, "Kyber-1024", KYBER1024_PUBLICKEYBYTES,
+     KYBER1024_SECRETKEYBYTES, KYBER1024_CIPHERTEXTBYTES, KYBER_ALL_SSBYTES,
+     kyber1024_crypto_kem_keypair, kyber1024_crypto_kem_enc,
+     kyber1024_crypto_kem_dec},
+};
+
+#else
+
+#include "../include/kem.h"
+#include "../include/params.h"
+
+#if (KYBER_K == 2)
+#define KYBER_SET_NAME "Kyber-512"
+#elif (KYBER_K == 3)
+#define KYBER_SET_NAME "Kyber-768"
+#else
+#define KYBER_SET_NAME "Kyber-1024"
+#endif
+
+static const kyber_kem_impl kyber_sets[] = {
+    {(kyber_param_id)KYBER_K, KYBER_SET_NAME, KYBER_PUBLICKEYBYTES,
+     KYBER_SECRETKEYBYTES, KYBER_CIPHERTEXTBYTES, KYBER_SSBYTES,
+     crypto_kem_keypair, crypto_kem_enc, crypto_kem_dec},
+};
+
+#endif
+
+const kyber_kem_impl *kyber_kem_get(kyber_param_id id) {
+  size_t i;
+
+  for (i = 0; i < sizeof(kyber_sets) / sizeof(kyber_sets[0]); i++) {
+    if (kyber_sets[i].id == id)
+      return &kyber_sets[i];
+  }
+  return NULL;
+}
+
+int kyber_kem_keypair(kyber_param_id id, uint8_t *pk, uint8_t *sk) {
+  const kyber_kem_impl *impl = kyber_kem_get(id);
+
+  if (impl == NULL)
+    return -1;
+  return impl->keypair(pk, sk);
+}
+
+int kyber_kem_enc(kyber_param_id id, uint8_t *ct, uint8_t *ss,
+                  const uint8_t *pk) {
+  const kyber_kem_impl *impl = kyber_kem_get(id);
+
+  if (impl == NULL)
+    return -1;
+  return impl->enc(ct, ss, pk);
+}
+
+int kyber_kem_dec(kyber_param_id id, uint8_t *ss, const uint8_t *ct,
+                  const uint8_t *sk) {
+  const kyber_kem_impl *impl = kyber_kem_get(id);
+
+  if (impl == NULL)
+    return -1;
+  return impl->dec(ss, ct, sk);
+}
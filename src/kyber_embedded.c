@@ -11,12 +11,29 @@
  *************************************************/
 
 #include "../include/kem.h"
+#include "../include/kyber_dispatch.h"
+#include "../include/ntt.h"
 #include "../include/params.h"
 #include "../include/platform.h"
 #include "../include/randombytes.h"
 #include <stdint.h>
 #include <string.h>
 
+// Stack painting needs KYBER_STACK_PAINT_BYTES of free stack, which
+// desktops have; MCU builds opt in by setting it to fit their task
+#if defined(KYBER_PLATFORM_DESKTOP) || defined(KYBER_STACK_PAINT_BYTES)
+#define KYBER_MEASURE_STACK 1
+#endif
+#include "../include/kyber_stack.h"
+
+// The desktop demo prints its report without KYBER_DEBUG
+#if defined(KYBER_PLATFORM_DESKTOP)
+#include <stdio.h>
+#define MEMINFO_PRINTF(...) printf(__VA_ARGS__)
+#else
+#define MEMINFO_PRINTF(...) KYBER_PRINTF(__VA_ARGS__)
+#endif
+
 /*************************************************
  * Benchmark Results Structure
  *************************************************/
@@ -82,7 +99,8 @@ int kyber_benchmark(kyber_benchmark_t *result) {
 #if KYBER_HAS_CYCLE_COUNTER
   start = kyber_cycles_read();
 #endif
-  crypto_kem_keypair(pk, sk);
+  if (crypto_kem_keypair(pk, sk) != 0)
+    return -1; // randombytes() failed; test_passed stays 0
 #if KYBER_HAS_CYCLE_COUNTER
   end = kyber_cycles_read();
   result->keygen_cycles = end - start;
@@ -93,7 +111,8 @@ int kyber_benchmark(kyber_benchmark_t *result) {
 #if KYBER_HAS_CYCLE_COUNTER
   start = kyber_cycles_read();
 #endif
-  crypto_kem_enc(ct, ss1, pk);
+  if (crypto_kem_enc(ct, ss1, pk) != 0)
+    return -1;
 #if KYBER_HAS_CYCLE_COUNTER
   end = kyber_cycles_read();
   result->encaps_cycles = end - start;
@@ -118,27 +137,105 @@ int kyber_benchmark(kyber_benchmark_t *result) {
   return result->test_passed ? 0 : -1;
 }
 
+#if defined(KYBER_MEASURE_STACK)
+/*************************************************
+ * Stack and working-set measurement of every built parameter set
+ *************************************************/
+static uint8_t mem_pk[KYBER_MAX_PUBLICKEYBYTES];
+static uint8_t mem_sk[KYBER_MAX_SECRETKEYBYTES];
+static uint8_t mem_ct[KYBER_MAX_CIPHERTEXTBYTES];
+static uint8_t mem_ss[KYBER_SSBYTES];
+
+#define KECCAK_TABLE_BYTES (24 * 8) // KeccakF_RoundConstants
+
+typedef struct {
+  const kyber_kem_impl *impl;
+  int op; // 0 keypair, 1 enc, 2 dec
+} mem_call;
+
+static void mem_run(void *arg) {
+  const mem_call *c = (const mem_call *)arg;
+
+  if (c->op == 0)
+    c->impl->keypair(mem_pk, mem_sk);
+  else if (c->op == 1)
+    c->impl->enc(mem_ct, mem_ss, mem_pk);
+  else
+    c->impl->dec(mem_ss, mem_ct, mem_sk);
+}
+
+static size_t mem_lines(size_t bytes) {
+  return (bytes + KYBER_STACK_LINE_BYTES - 1) / KYBER_STACK_LINE_BYTES;
+}
+
+static void kyber_memory_measure(void) {
+  static const char *const op_names[3] = {"keypair", "enc", "dec"};
+  kyber_stack_usage u;
+  mem_call c;
+  size_t io, lines;
+  int id;
+
+  MEMINFO_PRINTF("\n=== Measured Stack / L1 Working Set ===\n");
+  for (id = KYBER_PARAM_512; id <= KYBER_PARAM_1024; id++) {
+    c.impl = kyber_kem_get((kyber_param_id)id);
+    if (c.impl == NULL)
+      continue;
+    for (c.op = 0; c.op < 3; c.op++) {
+      kyber_stack_measure(&u, mem_run, &c);
+
+      // Keys, ciphertext and secret the operation reads or writes
+      if (c.op == 0)
+        io = mem_lines(c.impl->publickeybytes) +
+             mem_lines(c.impl->secretkeybytes);
+      else if (c.op == 1)
+        io = mem_lines(c.impl->publickeybytes) +
+             mem_lines(c.impl->ciphertextbytes) + 1;
+      else
+        io = mem_lines(c.impl->secretkeybytes) +
+             mem_lines(c.impl->ciphertextbytes) + 1;
+      lines = u.stack_lines + io + mem_lines(sizeof(zetas)) +
+              mem_lines(KECCAK_TABLE_BYTES);
+
+      MEMINFO_PRINTF("%-10s %-8s stack %s%lu bytes, working set %lu bytes\n",
+                     c.impl->name, op_names[c.op], u.saturated ? ">= " : "",
+                     (unsigned long)u.stack_bytes,
+                     (unsigned long)(lines * KYBER_STACK_LINE_BYTES));
+    }
+  }
+}
+#endif
+
 /*************************************************
  * Name:        kyber_memory_info
  *
- * Description: Print memory usage information
+ * Description: Print memory usage information: object sizes of the
+ *              built parameter set and, where stack painting is
+ *              enabled, measured stack high-water marks and L1 data
+ *              working sets for every parameter set in the library
  *************************************************/
 void kyber_memory_info(void) {
-  KYBER_PRINTF("=== Kyber Memory Usage ===\n");
-  KYBER_PRINTF("Public Key:  %d bytes\n", KYBER_PUBLICKEYBYTES);
-  KYBER_PRINTF("Secret Key:  %d bytes\n", KYBER_SECRETKEYBYTES);
-  KYBER_PRINTF("Ciphertext:  %d bytes\n", KYBER_CIPHERTEXTBYTES);
-  KYBER_PRINTF("Shared Key:  %d bytes\n", KYBER_SSBYTES);
-  KYBER_PRINTF("Total Keys:  %d bytes\n",
-               KYBER_PUBLICKEYBYTES + KYBER_SECRETKEYBYTES +
-                   KYBER_CIPHERTEXTBYTES + KYBER_SSBYTES);
+  MEMINFO_PRINTF("=== Kyber Memory Usage ===\n");
+  MEMINFO_PRINTF("Public Key:  %d bytes\n", KYBER_PUBLICKEYBYTES);
+  MEMINFO_PRINTF("Secret Key:  %d bytes\n", KYBER_SECRETKEYBYTES);
+  MEMINFO_PRINTF("Ciphertext:  %d bytes\n", KYBER_CIPHERTEXTBYTES);
+  MEMINFO_PRINTF("Shared Key:  %d bytes\n", KYBER_SSBYTES);
+  MEMINFO_PRINTF("Total Keys:  %d bytes\n",
+                 KYBER_PUBLICKEYBYTES + KYBER_SECRETKEYBYTES +
+                     KYBER_CIPHERTEXTBYTES + KYBER_SSBYTES);
 
 #if KYBER_K == 2
-  KYBER_PRINTF("Security:    Kyber-512 (NIST Level 1)\n");
+  MEMINFO_PRINTF("Security:    Kyber-512 (NIST Level 1)\n");
 #elif KYBER_K == 3
-  KYBER_PRINTF("Security:    Kyber-768 (NIST Level 3)\n");
+  MEMINFO_PRINTF("Security:    Kyber-768 (NIST Level 3)\n");
 #elif KYBER_K == 4
-  KYBER_PRINTF("Security:    Kyber-1024 (NIST Level 5)\n");
+  MEMINFO_PRINTF("Security:    Kyber-1024 (NIST Level 5)\n");
+#endif
+
+#if defined(KYBER_MEASURE_STACK)
+  kyber_memory_measure();
+#else
+  MEMINFO_PRINTF("Stack:       build with -DKYBER_STACK_PAINT_BYTES=<free "
+                 "stack> to measure\n");
 #endif
 }
 
@@ -220,14 +317,8 @@ int main(void) {
   printf("============================================\n\n");
 
   // Print memory info
-  printf("=== Memory Usage ===\n");
-  printf("Public Key:  %d bytes\n", KYBER_PUBLICKEYBYTES);
-  printf("Secret Key:  %d bytes\n", KYBER_SECRETKEYBYTES);
-  printf("Ciphertext:  %d bytes\n", KYBER_CIPHERTEXTBYTES);
-  printf("Shared Key:  %d bytes\n", KYBER_SSBYTES);
-  printf("Total:       %d bytes\n\n",
-         KYBER_PUBLICKEYBYTES + KYBER_SECRETKEYBYTES + KYBER_CIPHERTEXTBYTES +
-             KYBER_SSBYTES);
+  kyber_memory_info();
+  printf("\n");
 
   // Run benchmark
   printf("=== Running Benchmark ===\n");
@@ -0,0 +1,320 @@
+/*************************************************
+ * Operational Metrics
+ *************************************************/
+
+#include "../include/kyber_metrics.h"
+#include "../include/randombytes.h"
+#include "../include/platform.h"
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(KYBER_PLATFORM_DESKTOP) && !defined(_WIN32)
+#include <time.h>
+#define METRICS_UNIT KYBER_METRICS_UNIT_NS
+#else
+#define METRICS_UNIT KYBER_METRICS_UNIT_CYCLES
+#endif
+
+#if defined(KYBER_PLATFORM_DESKTOP)
+// 64-bit atomics are lock-free on every desktop target
+typedef atomic_ullong metric_t;
+#else
+// Cortex-M and Xtensa only have 32-bit atomic read-modify-write. The
+// counts fit, but a latency sum would wrap after a few thousand
+// operations, so it is kept in two words (see kyber_metrics_op_end)
+typedef atomic_uint metric_t;
+#define METRICS_SUM_HI
+#endif
+
+#if defined(KYBER_PLATFORM_DESKTOP) || defined(KYBER_PLATFORM_ESP32)
+#define METRICS_TLS _Thread_local
+#else
+#define METRICS_TLS
+#endif
+
+typedef struct {
+  _Alignas(64) metric_t ops[KYBER_OP_COUNT];
+  metric_t latency_sum[KYBER_OP_COUNT];
+#if defined(METRICS_SUM_HI)
+  metric_t latency_sum_hi[KYBER_OP_COUNT]; // carries out of latency_sum
+#endif
+  metric_t latency_hist[KYBER_OP_COUNT][KYBER_METRICS_BUCKETS];
+  metric_t rejections;
+  // Bracket every op_end update, see shard_read()
+  metric_t begun;
+  metric_t done;
+} metrics_shard;
+
+static metrics_shard shards[KYBER_METRICS_SHARDS];
+
+static const char *const op_labels[KYBER_OP_COUNT] = {"keypair", "enc",
+                                                      "dec"};
+
+// Retries of a shard with an update in flight before taking it as is
+#define METRICS_READ_TRIES 8
+
+/*************************************************
+ * Name:        shard_read
+ *
+ * Description: Copies the counters of one shard into t. Writers
+ *              count begun, update, then count done; if done before
+ *              the copy equals begun after it, no update overlapped
+ *              the copy and ops, sum and buckets agree. Returns 1 in
+ *              that case, 0 if the copy should be retried.
+ *************************************************/
+static int shard_read(metrics_shard *sh, kyber_metrics_snapshot *t) {
+  uint64_t done = atomic_load_explicit(&sh->done, memory_order_acquire);
+  unsigned int op, b;
+
+  // Acquire loads: a counter seen from an unfinished update makes its
+  // begun visible below
+  for (op = 0; op < KYBER_OP_COUNT; op++) {
+    t->ops[op] = atomic_load_explicit(&sh->ops[op], memory_order_acquire);
+    t->latency_sum[op] =
+        atomic_load_explicit(&sh->latency_sum[op], memory_order_acquire);
+#if defined(METRICS_SUM_HI)
+    t->latency_sum[op] |=
+        (uint64_t)atomic_load_explicit(&sh->latency_sum_hi[op],
+                                       memory_order_acquire)
+        << 32;
+#endif
+    for (b = 0; b < KYBER_METRICS_BUCKETS; b++)
+      t->latency_hist[op][b] = atomic_load_explicit(&sh->latency_hist[op][b],
+                                                    memory_order_acquire);
+  }
+  t->rejections = atomic_load_explicit(&sh->rejections, memory_order_relaxed);
+
+  return atomic_load_explicit(&sh->begun, memory_order_relaxed) == done;
+}
+
+/*************************************************
+ * Name:        kyber_metrics_read
+ *
+ * Description: Sums all shards into a snapshot
+ *************************************************/
+void kyber_metrics_read(kyber_metrics_snapshot *out) {
+  kyber_metrics_snapshot t;
+  unsigned int i, n, op, b;
+
+  memset(out, 0, sizeof(*out));
+  out->version = KYBER_METRICS_VERSION;
+  out->unit = METRICS_UNIT;
+
+  for (i = 0; i < KYBER_METRICS_SHARDS; i++) {
+    for (n = 0; n < METRICS_READ_TRIES; n++)
+      if (shard_read(&shards[i], &t))
+        break;
+
+    for (op = 0; op < KYBER_OP_COUNT; op++) {
+      out->ops[op] += t.ops[op];
+      out->latency_sum[op] += t.latency_sum[op];
+      for (b = 0; b < KYBER_METRICS_BUCKETS; b++)
+        out->latency_hist[op][b] += t.latency_hist[op][b];
+    }
+    out->rejections += t.rejections;
+  }
+}
+
+/*************************************************
+ * Name:        kyber_metrics_reset
+ *
+ * Description: Zeroes all shards. begun and done are only compared,
+ *              so they keep counting; zeroing them under a running
+ *              update would leave them unequal for good.
+ *************************************************/
+void kyber_metrics_reset(void) {
+  unsigned int i, op, b;
+
+  for (i = 0; i < KYBER_METRICS_SHARDS; i++) {
+    metrics_shard *sh = &shards[i];
+    for (op = 0; op < KYBER_OP_COUNT; op++) {
+      atomic_store_explicit(&sh->ops[op], 0, memory_order_relaxed);
+      atomic_store_explicit(&sh->latency_sum[op], 0, memory_order_relaxed);
+#if defined(METRICS_SUM_HI)
+      atomic_store_explicit(&sh->latency_sum_hi[op], 0, memory_order_relaxed);
+#endif
+      for (b = 0; b < KYBER_METRICS_BUCKETS; b++)
+        atomic_store_explicit(&sh->latency_hist[op][b], 0,
+                              memory_order_relaxed);
+    }
+    atomic_store_explicit(&sh->rejections, 0, memory_order_relaxed);
+  }
+}
+
+// snprintf into buf at offset pos, tracking the untruncated length
+static size_t append(char *buf, size_t len, size_t pos, const char *fmt,
+                     ...) {
+  va_list ap;
+  int n;
+
+  va_start(ap, fmt);
+  n = vsnprintf(pos < len ? buf + pos : NULL, pos < len ? len - pos : 0, fmt,
+                ap);
+  va_end(ap);
+  return pos + (n > 0 ? (size_t)n : 0);
+}
+
+/*************************************************
+ * Name:        kyber_metrics_prometheus
+ *
+ * Description: Formats a snapshot as Prometheus text
+ *************************************************/
+size_t kyber_metrics_prometheus(const kyber_metrics_snapshot *s, char *buf,
+                                size_t len) {
+  const char *hist = (s->unit == KYBER_METRICS_UNIT_NS)
+                         ? "kyber_op_latency_seconds"
+                         : "kyber_op_latency_cycles";
+  double scale = (s->unit == KYBER_METRICS_UNIT_NS) ? 1e-9 : 1.0;
+  size_t pos = 0;
+  uint64_t cum, count;
+  unsigned int op, b;
+
+  if (len > 0)
+    buf[0] = '\0';
+
+  pos = append(buf, len, pos,
+               "# HELP kyber_ops_total KEM operations completed.\n"
+               "# TYPE kyber_ops_total counter\n");
+  for (op = 0; op < KYBER_OP_COUNT; op++)
+    pos = append(buf, len, pos, "kyber_ops_total{op=\"%s\"} %llu\n",
+                 op_labels[op], (unsigned long long)s->ops[op]);
+
+  pos = append(buf, len, pos,
+               "# HELP kyber_implicit_rejections_total Decapsulations that "
+               "rejected the ciphertext.\n"
+               "# TYPE kyber_implicit_rejections_total counter\n"
+               "kyber_implicit_rejections_total %llu\n",
+               (unsigned long long)s->rejections);
+
+  pos = append(buf, len, pos,
+               "# HELP %s KEM operation latency.\n# TYPE %s histogram\n", hist,
+               hist);
+  for (op = 0; op < KYBER_OP_COUNT; op++) {
+    cum = 0;
+    // The last bucket is open-ended and only appears as +Inf
+    for (b = 0; b < KYBER_METRICS_BUCKETS - 1; b++) {
+      cum += s->latency_hist[op][b];
+      pos = append(buf, len, pos, "%s_bucket{op=\"%s\",le=\"%.9g\"} %llu\n",
+                   hist, op_labels[op], (double)(1ULL << b) * scale,
+                   (unsigned long long)cum);
+    }
+    // +Inf and _count are the bucket total, not ops[], so the series
+    // stays a valid histogram whatever the snapshot holds
+    count = cum + s->latency_hist[op][KYBER_METRICS_BUCKETS - 1];
+    pos = append(buf, len, pos,
+                 "%s_bucket{op=\"%s\",le=\"+Inf\"} %llu\n"
+                 "%s_sum{op=\"%s\"} %.9g\n%s_count{op=\"%s\"} %llu\n",
+                 hist, op_labels[op], (unsigned long long)count, hist,
+                 op_labels[op], (double)s->latency_sum[op] * scale, hist,
+                 op_labels[op], (unsigned long long)count);
+  }
+  return pos;
+}
+
+#if defined(KYBER_METRICS)
+
+static atomic_uint next_shard;
+
+typedef struct {
+  metrics_shard *shard;
+  uint32_t start[KYBER_OP_COUNT];
+} metrics_thread;
+
+static METRICS_TLS metrics_thread self;
+
+static inline uint32_t metrics_now(void) {
+#if METRICS_UNIT == KYBER_METRICS_UNIT_NS
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL +
+                    (uint64_t)ts.tv_nsec);
+#elif KYBER_HAS_CYCLE_COUNTER
+  return kyber_cycles_read();
+#else
+  return 0;
+#endif
+}
+
+static inline metrics_shard *metrics_shard_get(void) {
+  if (self.shard == NULL)
+    self.shard = &shards[atomic_fetch_add_explicit(&next_shard, 1,
+                                                   memory_order_relaxed) %
+                         KYBER_METRICS_SHARDS];
+  return self.shard;
+}
+
+// Bit length of x - 1: 0 for x <= 1, b for x in (2^(b-1), 2^b]
+static inline unsigned int metrics_bucket(uint32_t x) {
+  unsigned int b = 0;
+
+  if (x > 1)
+    b = 32 - (unsigned int)__builtin_clz(x - 1);
+  return (b < KYBER_METRICS_BUCKETS) ? b : KYBER_METRICS_BUCKETS - 1;
+}
+
+#if METRICS_UNIT == KYBER_METRICS_UNIT_CYCLES && KYBER_HAS_CYCLE_COUNTER
+static atomic_uint cycles_enabled;
+#endif
+
+void kyber_metrics_op_begin(kyber_op op) {
+#if METRICS_UNIT == KYBER_METRICS_UNIT_CYCLES && KYBER_HAS_CYCLE_COUNTER
+  // The DWT counter on Cortex-M is off until someone enables it
+  if (atomic_load_explicit(&cycles_enabled, memory_order_relaxed) == 0 &&
+      atomic_exchange_explicit(&cycles_enabled, 1, memory_order_relaxed) == 0)
+    kyber_cycles_init();
+#endif
+  self.start[op] = metrics_now();
+}
+
+/*************************************************
+ * Name:        metrics_add
+ *
+ * Description: Counts n operations of one kind taking dt in total;
+ *              hist of them go into the bucket of dt / n
+ *************************************************/
+static void metrics_add(kyber_op op, unsigned int n, uint32_t dt,
+                        unsigned int hist) {
+  metrics_shard *sh = metrics_shard_get();
+#if defined(METRICS_SUM_HI)
+  uint32_t lo;
+#endif
+
+  atomic_fetch_add_explicit(&sh->begun, 1, memory_order_relaxed);
+  atomic_fetch_add_explicit(&sh->ops[op], n, memory_order_release);
+#if defined(METRICS_SUM_HI)
+  // Exactly one adder sees the low word wrap and carries; inside the
+  // begun/done bracket, so readers never see one word without the other
+  lo = atomic_fetch_add_explicit(&sh->latency_sum[op], dt,
+                                 memory_order_release);
+  atomic_fetch_add_explicit(&sh->latency_sum_hi[op], (uint32_t)(lo + dt) < lo,
+                            memory_order_release);
+#else
+  atomic_fetch_add_explicit(&sh->latency_sum[op], dt, memory_order_release);
+#endif
+  atomic_fetch_add_explicit(&sh->latency_hist[op][metrics_bucket(dt / n)],
+                            hist, memory_order_release);
+  atomic_fetch_add_explicit(&sh->done, 1, memory_order_release);
+}
+
+void kyber_metrics_op_end(kyber_op op) { kyber_metrics_op_end_n(op, 1); }
+
+void kyber_metrics_op_end_n(kyber_op op, unsigned int n) {
+  // 32-bit difference: correct across one counter wrap (4.2 s in ns)
+  uint32_t dt = metrics_now() - self.start[op];
+
+  if (n > 0)
+    metrics_add(op, n, dt, n);
+}
+
+void kyber_metrics_op_untimed(kyber_op op) { metrics_add(op, 1, 0, 0); }
+
+void kyber_metrics_rejection(uint8_t fail) {
+  // Always add, so the update does not depend on the comparison result
+  atomic_fetch_add_explicit(&metrics_shard_get()->rejections, fail & 1,
+                            memory_order_relaxed);
+}
+
+#endif /* KYBER_METRICS */
@@ -0,0 +1,87 @@
+/*************************************************
+ * Phase Profiler
+ *************************************************/
+
+#include "../include/kyber_profile.h"
+#include "../include/randombytes.h"
+#include "../include/platform.h"
+#include <stdint.h>
+#include <string.h>
+
+static const char *const phase_names[KYBER_PHASE_COUNT] = {
+    "other", "randombytes", "gen_matrix", "noise", "ntt",
+    "invntt", "matvec",      "pack",       "hash"};
+
+const char *kyber_profile_phase_name(kyber_phase phase) {
+  if ((unsigned int)phase >= KYBER_PHASE_COUNT)
+    return "?";
+  return phase_names[phase];
+}
+
+#if defined(KYBER_PROFILE)
+
+// Bare-metal targets have no thread-local storage support
+#if defined(KYBER_PLATFORM_DESKTOP) || defined(KYBER_PLATFORM_ESP32)
+#define PROFILE_TLS _Thread_local
+#else
+#define PROFILE_TLS
+#endif
+
+typedef struct {
+  kyber_profile_stats stats;
+  kyber_phase current;
+  uint32_t phase_start;
+  uint32_t op_start[KYBER_OP_COUNT];
+} profile_state;
+
+static PROFILE_TLS profile_state prof;
+
+static inline uint32_t profile_now(void) {
+#if KYBER_HAS_CYCLE_COUNTER
+  return kyber_cycles_read();
+#else
+  return 0;
+#endif
+}
+
+void kyber_profile_begin(kyber_phase phase) {
+  prof.current = phase;
+  prof.stats.calls[phase]++;
+  prof.phase_start = profile_now();
+}
+
+void kyber_profile_end(kyber_phase phase) {
+  // 32-bit difference: correct across one counter wrap
+  prof.stats.cycles[phase] += (uint32_t)(profile_now() - prof.phase_start);
+  prof.current = KYBER_PHASE_OTHER;
+}
+
+void kyber_profile_op_begin(kyber_op op) {
+  prof.stats.op_calls[op]++;
+  prof.op_start[op] = profile_now();
+}
+
+void kyber_profile_op_end(kyber_op op) {
+  prof.stats.op_cycles[op] += (uint32_t)(profile_now() - prof.op_start[op]);
+}
+
+void kyber_profile_keccak(void) { prof.stats.keccak[prof.current]++; }
+
+void kyber_profile_read(kyber_profile_stats *out) { *out = prof.stats; }
+
+void kyber_profile_reset(void) {
+  memset(&prof, 0, sizeof(prof));
+#if KYBER_HAS_CYCLE_COUNTER
+  kyber_cycles_init();
+#endif
+}
+
+#else
+
+void kyber_profile_read(kyber_profile_stats *out) {
+  memset(out, 0, sizeof(*out));
+}
+
+void kyber_profile_reset(void) {}
+
+#endif /* KYBER_PROFILE */
@@ -0,0 +1,75 @@
+/*************************************************
+ * Stack and Working-Set Measurement
+ *************************************************/
+
+#include "../include/kyber_stack.h"
+#include <stdint.h>
+
+#define STACK_PATTERN 0xA5
+
+/*************************************************
+ * Stack pointer of the calling frame, 0 where it cannot be read. The
+ * frame address is no substitute: the frame's own locals lie below it.
+ *************************************************/
+static inline __attribute__((always_inline)) uintptr_t stack_pointer(void) {
+  uintptr_t sp = 0;
+
+#if defined(__x86_64__)
+  __asm__ __volatile__("mov %%rsp, %0" : "=r"(sp));
+#elif defined(__i386__)
+  __asm__ __volatile__("mov %%esp, %0" : "=r"(sp));
+#elif defined(__aarch64__) || defined(__arm__)
+  __asm__ __volatile__("mov %0, sp" : "=r"(sp));
+#elif defined(__riscv)
+  __asm__ __volatile__("mv %0, sp" : "=r"(sp));
+#elif defined(__XTENSA__)
+  __asm__ __volatile__("mov %0, a1" : "=r"(sp));
+#endif
+  return sp;
+}
+
+/*************************************************
+ * Paints, runs and scans from this one frame: the region is the
+ * KYBER_STACK_PAINT_BYTES right below its stack pointer, which is
+ * where fn's frames go. Nothing of this frame lives there (the
+ * function is not a leaf, so it has no red zone), and no pointer to
+ * a dead frame is involved.
+ *************************************************/
+__attribute__((noinline)) int
+kyber_stack_measure(kyber_stack_usage *u, void (*fn)(void *), void *arg) {
+  uintptr_t sp = stack_pointer();
+  volatile uint8_t *lo;
+  size_t i, j;
+
+  u->stack_bytes = 0;
+  u->stack_lines = 0;
+  u->saturated = 0;
+  if (sp == 0)
+    return -1;
+
+  // The stack grows down on every supported target
+  lo = (volatile uint8_t *)(sp - KYBER_STACK_PAINT_BYTES);
+  for (i = 0; i < KYBER_STACK_PAINT_BYTES; i++)
+    lo[i] = STACK_PATTERN;
+
+  fn(arg);
+
+  // The first byte from the bottom that lost the pattern is the
+  // high-water mark
+  for (i = 0; i < KYBER_STACK_PAINT_BYTES; i++)
+    if (lo[i] != STACK_PATTERN)
+      break;
+  u->stack_bytes = KYBER_STACK_PAINT_BYTES - i;
+  u->saturated = (i == 0);
+
+  for (i = 0; i < KYBER_STACK_PAINT_BYTES; i += KYBER_STACK_LINE_BYTES) {
+    for (j = i; j < i + KYBER_STACK_LINE_BYTES && j < KYBER_STACK_PAINT_BYTES;
+         j++)
+      if (lo[j] != STACK_PATTERN)
+        break;
+    if (j < i + KYBER_STACK_LINE_BYTES && j < KYBER_STACK_PAINT_BYTES)
+      u->stack_lines++;
+  }
+
+  return u->saturated ? -1 : 0;
+}
@@ -0,0 +1,517 @@
+/*************************************************
+ * Kernel Autotuner
+ *
+ * Candidate tables, timing, and the saved selection. The blob is
+ *
+ *   0-1    'K' 'T'
+ *   2      format version
+ *   3      KYBER_KERNEL_COUNT
+ *   4-7    FNV-1a of all candidate names (little-endian), so a blob
+ *          from a build with other kernels is refused
+ *   8-12   choice per kernel
+ *   13     zero
+ *   14-15  Fletcher-16 of bytes 0-13
+ *************************************************/
+
+#include "../include/kyber_tune.h"
+#include "../include/keccak_backend.h"
+#include "../include/ntt.h"
+#include "../include/ntt_m4.h"
+#include "../include/ntt_neon.h"
+#include "../include/ntt_rvv.h"
+#include "../include/ntt_vec.h"
+#include "../include/params.h"
+#include "../include/platform.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(KYBER_PLATFORM_DESKTOP)
+#include <stdio.h>
+#endif
+
+#if KYBER_HAS_CYCLE_COUNTER
+#define TUNE_HAVE_TIMER 1
+#elif defined(__linux__) || defined(__APPLE__)
+#include <time.h>
+#define TUNE_HAVE_TIMER 1
+#else
+#define TUNE_HAVE_TIMER 0
+#endif
+
+#define TUNE_VERSION 1
+#define TUNE_MAX_CANDIDATES 4
+
+// Scalar kernels, as poly.c runs them without a backend
+#define ntt_ref ntt
+#define invntt_ref invntt
+
+static void basemul_ref(int16_t r[256], const int16_t a[256],
+                        const int16_t b[256]) {
+  unsigned int i;
+
+  for (i = 0; i < KYBER_N / 4; i++) {
+    basemul(&r[4 * i], &a[4 * i], &b[4 * i], zetas[64 + i]);
+    basemul(&r[4 * i + 2], &a[4 * i + 2], &b[4 * i + 2], -zetas[64 + i]);
+  }
+}
+
+static void reduce_ref(int16_t r[256]) {
+  unsigned int i;
+
+  for (i = 0; i < KYBER_N; i++)
+    r[i] = barrett_reduce(r[i]);
+}
+
+// Until a selection is made: the kernels of the KYBER_BACKEND_* flag
+#if defined(KYBER_BACKEND_NEON)
+#define TUNE_DEFAULT(fn) fn##_neon
+#elif defined(KYBER_BACKEND_RVV)
+#define TUNE_DEFAULT(fn) fn##_rvv
+#elif defined(KYBER_BACKEND_M4)
+#define TUNE_DEFAULT(fn) fn##_m4
+#elif defined(KYBER_BACKEND_VEC)
+#define TUNE_DEFAULT(fn) fn##_vec
+#else
+#define TUNE_DEFAULT(fn) fn##_ref
+#endif
+
+kyber_tune_kernels kyber_tuned = {TUNE_DEFAULT(ntt), TUNE_DEFAULT(invntt),
+                                  TUNE_DEFAULT(basemul),
+                                  TUNE_DEFAULT(reduce)};
+
+typedef union {
+  void (*poly)(int16_t r[256]);
+  void (*basemul)(int16_t r[256], const int16_t a[256], const int16_t b[256]);
+  const kyber_keccak_backend *keccak;
+} tune_impl;
+
+typedef struct {
+  const char *name;
+  tune_impl impl;
+} tune_candidate;
+
+#if defined(KYBER_HAVE_VEC)
+#define VEC_CANDIDATE(m, fn) , {"vec", {.m = fn##_vec}}
+#else
+#define VEC_CANDIDATE(m, fn)
+#endif
+#if defined(KYBER_HAVE_NEON)
+#define NEON_CANDIDATE(m, fn) , {"neon", {.m = fn##_neon}}
+#else
+#define NEON_CANDIDATE(m, fn)
+#endif
+#if defined(KYBER_HAVE_RVV)
+#define RVV_CANDIDATE(m, fn) , {"rvv", {.m = fn##_rvv}}
+#else
+#define RVV_CANDIDATE(m, fn)
+#endif
+#if defined(KYBER_HAVE_M4)
+#define M4_CANDIDATE(m, fn) , {"m4", {.m = fn##_m4}}
+#else
+#define M4_CANDIDATE(m, fn)
+#endif
+
+// Every implementation of fn compiled in, scalar first
+#define CANDIDATES(m, fn)                                                      \
+  {{"ref", {.m = fn##_ref}} VEC_CANDIDATE(m, fn) NEON_CANDIDATE(m, fn)         \
+       RVV_CANDIDATE(m, fn) M4_CANDIDATE(m, fn)}
+
+static const tune_candidate ntt_candidates[] = CANDIDATES(poly, ntt);
+static const tune_candidate invntt_candidates[] = CANDIDATES(poly, invntt);
+static const tune_candidate basemul_candidates[] = CANDIDATES(basemul, basemul);
+static const tune_candidate reduce_candidates[] = CANDIDATES(poly, reduce);
+
+// Keccak can only be switched at runtime through the backend table
+static const tune_candidate keccak_candidates[] = {
+#if defined(KYBER_KECCAK_BACKEND)
+    {"ref", {.keccak = &kyber_keccak_software}},
+    {"bi32", {.keccak = &kyber_keccak_software_bi32}},
+#elif defined(KYBER_KECCAK_BI32)
+    {"bi32", {.keccak = NULL}},
+#else
+    {"ref", {.keccak = NULL}},
+#endif
+};
+
+#define COUNT(a) (sizeof(a) / sizeof((a)[0]))
+
+static const struct {
+  const tune_candidate *c;
+  unsigned int n;
+} tune_kernels[KYBER_KERNEL_COUNT] = {
+    {ntt_candidates, COUNT(ntt_candidates)},
+    {invntt_candidates, COUNT(invntt_candidates)},
+    {basemul_candidates, COUNT(basemul_candidates)},
+    {reduce_candidates, COUNT(reduce_candidates)},
+    {keccak_candidates, COUNT(keccak_candidates)},
+};
+
+/*************************************************
+ * Index of the implementation in use for k, KYBER_TUNE_KEEP if it is
+ * none of the candidates (an application Keccak backend)
+ *************************************************/
+static unsigned int tune_index(kyber_kernel k) {
+  const tune_candidate *c = tune_kernels[k].c;
+  const kyber_keccak_backend *b;
+  unsigned int i;
+
+  for (i = 0; i < tune_kernels[k].n; i++) {
+    switch (k) {
+    case KYBER_KERNEL_NTT:
+      if (c[i].impl.poly == kyber_tuned.ntt)
+        return i;
+      break;
+    case KYBER_KERNEL_INVNTT:
+      if (c[i].impl.poly == kyber_tuned.invntt)
+        return i;
+      break;
+    case KYBER_KERNEL_BASEMUL:
+      if (c[i].impl.basemul == kyber_tuned.basemul)
+        return i;
+      break;
+    case KYBER_KERNEL_REDUCE:
+      if (c[i].impl.poly == kyber_tuned.reduce)
+        return i;
+      break;
+    default:
+      b = kyber_keccak_backend_get();
+      if (c[i].impl.keccak == NULL || c[i].impl.keccak == b)
+        return i;
+      break;
+    }
+  }
+  return KYBER_TUNE_KEEP;
+}
+
+static void tune_install(kyber_kernel k, unsigned int i) {
+  const tune_candidate *c = &tune_kernels[k].c[i];
+
+  switch (k) {
+  case KYBER_KERNEL_NTT:
+    kyber_tuned.ntt = c->impl.poly;
+    break;
+  case KYBER_KERNEL_INVNTT:
+    kyber_tuned.invntt = c->impl.poly;
+    break;
+  case KYBER_KERNEL_BASEMUL:
+    kyber_tuned.basemul = c->impl.basemul;
+    break;
+  case KYBER_KERNEL_REDUCE:
+    kyber_tuned.reduce = c->impl.poly;
+    break;
+  default:
+    // Never replaces a backend the application registered
+    if (c->impl.keccak != NULL && tune_index(k) != KYBER_TUNE_KEEP)
+      kyber_keccak_register(c->impl.keccak);
+    break;
+  }
+}
+
+/*************************************************
+ * Name:        kyber_tune_candidate
+ *
+ * Description: Name of candidate i of kernel k
+ *************************************************/
+const char *kyber_tune_candidate(kyber_kernel k, unsigned int i) {
+  if ((unsigned int)k >= KYBER_KERNEL_COUNT || i >= tune_kernels[k].n)
+    return NULL;
+  return tune_kernels[k].c[i].name;
+}
+
+/*************************************************
+ * Name:        kyber_tune_selected
+ *
+ * Description: Name of the implementation in use for k
+ *************************************************/
+const char *kyber_tune_selected(kyber_kernel k) {
+  unsigned int i;
+
+  if ((unsigned int)k >= KYBER_KERNEL_COUNT)
+    return NULL;
+  i = tune_index(k);
+  if (i == KYBER_TUNE_KEEP)
+    return kyber_keccak_backend_get()->name;
+  return tune_kernels[k].c[i].name;
+}
+
+/*************************************************
+ * Name:        kyber_tune_override
+ *
+ * Description: Forces the candidate called name for k
+ *************************************************/
+int kyber_tune_override(kyber_kernel k, const char *name) {
+  unsigned int i;
+
+  if ((unsigned int)k >= KYBER_KERNEL_COUNT || name == NULL)
+    return -1;
+  // tune_install() would keep the application backend; say so
+  if (tune_index(k) == KYBER_TUNE_KEEP)
+    return -1;
+  for (i = 0; i < tune_kernels[k].n; i++) {
+    if (strcmp(tune_kernels[k].c[i].name, name) == 0) {
+      tune_install(k, i);
+      return 0;
+    }
+  }
+  return -1;
+}
+
+/*************************************************
+ * Name:        kyber_tune_current
+ *
+ * Description: Current selection
+ *************************************************/
+void kyber_tune_current(kyber_tune_config *cfg) {
+  unsigned int k;
+
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++)
+    cfg->choice[k] = (uint8_t)tune_index((kyber_kernel)k);
+}
+
+/*************************************************
+ * Name:        kyber_tune_apply
+ *
+ * Description: Selects the implementations of cfg
+ *************************************************/
+int kyber_tune_apply(const kyber_tune_config *cfg) {
+  unsigned int k;
+
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++)
+    if (cfg->choice[k] != KYBER_TUNE_KEEP &&
+        cfg->choice[k] >= tune_kernels[k].n)
+      return -1;
+
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++)
+    if (cfg->choice[k] != KYBER_TUNE_KEEP)
+      tune_install((kyber_kernel)k, cfg->choice[k]);
+  return 0;
+}
+
+/*************************************************
+ * Timing
+ *************************************************/
+
+static inline uint32_t tune_now(void) {
+#if KYBER_HAS_CYCLE_COUNTER
+  return kyber_cycles_read();
+#elif TUNE_HAVE_TIMER
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000000000ULL +
+                    (uint64_t)ts.tv_nsec);
+#else
+  return 0;
+#endif
+}
+
+typedef struct {
+  int16_t a[256];
+  int16_t b[256];
+  int16_t r[256];
+  uint64_t s[25];
+} tune_operands;
+
+// One call of candidate c of kernel k on fresh operands
+static uint32_t tune_time(kyber_kernel k, const tune_candidate *c,
+                          tune_operands *op) {
+  const kyber_keccak_backend *b = c->impl.keccak;
+  uint32_t t0, t1;
+
+  switch (k) {
+  case KYBER_KERNEL_BASEMUL:
+    t0 = tune_now();
+    c->impl.basemul(op->r, op->a, op->b);
+    t1 = tune_now();
+    break;
+  case KYBER_KERNEL_KECCAK:
+    memset(op->s, 0, sizeof(op->s));
+    t0 = tune_now();
+    b->permute(b->ctx, op->s);
+    t1 = tune_now();
+    break;
+  default:
+    memcpy(op->r, op->a, sizeof(op->r));
+    t0 = tune_now();
+    c->impl.poly(op->r);
+    t1 = tune_now();
+    break;
+  }
+  return t1 - t0;
+}
+
+/*************************************************
+ * Name:        kyber_tune_run
+ *
+ * Description: Times every candidate, selects the fastest of each
+ *              kernel. Candidates take turns within every sample, so
+ *              clock changes during the run hit all of them alike; the
+ *              fastest call of each counts, discarding interrupts.
+ *************************************************/
+int kyber_tune_run(kyber_tune_config *cfg) {
+  tune_operands op;
+  uint32_t best[TUNE_MAX_CANDIDATES], t, x = 1;
+  unsigned int k, i, n, s;
+  kyber_tune_config c;
+
+  if (!TUNE_HAVE_TIMER)
+    return -1;
+#if KYBER_HAS_CYCLE_COUNTER
+  kyber_cycles_init();
+#endif
+
+  // Coefficients in [0, q), as the kernels see them in the KEM
+  for (i = 0; i < 256; i++) {
+    x = x * 1664525u + 1013904223u;
+    op.a[i] = (int16_t)((x >> 16) % KYBER_Q);
+    op.b[i] = (int16_t)((x & 0xFFFF) % KYBER_Q);
+  }
+
+  kyber_tune_current(&c);
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++) {
+    n = tune_kernels[k].n;
+    if (n < 2 || c.choice[k] == KYBER_TUNE_KEEP)
+      continue;
+
+    for (i = 0; i < n; i++) {
+      best[i] = UINT32_MAX;
+      tune_time((kyber_kernel)k, &tune_kernels[k].c[i], &op); // Warm-up
+    }
+    for (s = 0; s < KYBER_TUNE_SAMPLES; s++) {
+      for (i = 0; i < n; i++) {
+        t = tune_time((kyber_kernel)k, &tune_kernels[k].c[i], &op);
+        if (t < best[i])
+          best[i] = t;
+      }
+    }
+
+    c.choice[k] = 0;
+    for (i = 1; i < n; i++)
+      if (best[i] < best[c.choice[k]])
+        c.choice[k] = (uint8_t)i;
+  }
+
+  kyber_tune_apply(&c);
+  if (cfg != NULL)
+    *cfg = c;
+  return 0;
+}
+
+/*************************************************
+ * Saved selection
+ *************************************************/
+
+// FNV-1a over the candidate names of this build
+static uint32_t tune_fingerprint(void) {
+  uint32_t h = 2166136261u;
+  const char *p;
+  unsigned int k, i;
+
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++) {
+    for (i = 0; i < tune_kernels[k].n; i++) {
+      p = tune_kernels[k].c[i].name;
+      do {
+        h = (h ^ (uint8_t)*p) * 16777619u;
+      } while (*p++ != '\0');
+    }
+    h = (h ^ '/') * 16777619u;
+  }
+  return h;
+}
+
+static uint16_t tune_checksum(const uint8_t *p, unsigned int len) {
+  uint16_t s1 = 0, s2 = 0;
+  unsigned int i;
+
+  for (i = 0; i < len; i++) {
+    s1 = (uint16_t)((s1 + p[i]) % 255);
+    s2 = (uint16_t)((s2 + s1) % 255);
+  }
+  return (uint16_t)(s2 << 8 | s1);
+}
+
+/*************************************************
+ * Name:        kyber_tune_save
+ *
+ * Description: Serialises cfg
+ *************************************************/
+void kyber_tune_save(uint8_t blob[KYBER_TUNE_BLOBBYTES],
+                     const kyber_tune_config *cfg) {
+  uint32_t fp = tune_fingerprint();
+  uint16_t sum;
+  unsigned int k;
+
+  memset(blob, 0, KYBER_TUNE_BLOBBYTES);
+  blob[0] = 'K';
+  blob[1] = 'T';
+  blob[2] = TUNE_VERSION;
+  blob[3] = KYBER_KERNEL_COUNT;
+  for (k = 0; k < 4; k++)
+    blob[4 + k] = (uint8_t)(fp >> (8 * k));
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++)
+    blob[8 + k] = cfg->choice[k];
+  sum = tune_checksum(blob, 14);
+  blob[14] = (uint8_t)sum;
+  blob[15] = (uint8_t)(sum >> 8);
+}
+
+/*************************************************
+ * Name:        kyber_tune_load
+ *
+ * Description: Parses and checks a saved selection
+ *************************************************/
+int kyber_tune_load(kyber_tune_config *cfg,
+                    const uint8_t blob[KYBER_TUNE_BLOBBYTES]) {
+  uint32_t fp = tune_fingerprint();
+  uint16_t sum = tune_checksum(blob, 14);
+  unsigned int k;
+
+  if (blob[0] != 'K' || blob[1] != 'T' || blob[2] != TUNE_VERSION ||
+      blob[3] != KYBER_KERNEL_COUNT || blob[13] != 0)
+    return -1;
+  if (blob[14] != (uint8_t)sum || blob[15] != (uint8_t)(sum >> 8))
+    return -1;
+  for (k = 0; k < 4; k++)
+    if (blob[4 + k] != (uint8_t)(fp >> (8 * k)))
+      return -1;
+
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++) {
+    if (blob[8 + k] != KYBER_TUNE_KEEP && blob[8 + k] >= tune_kernels[k].n)
+      return -1;
+    cfg->choice[k] = blob[8 + k];
+  }
+  return 0;
+}
+
+#if defined(KYBER_PLATFORM_DESKTOP)
+/*************************************************
+ * Name:        kyber_tune_init
+ *
+ * Description: Measure once, then load the saved selection
+ *************************************************/
+int kyber_tune_init(const char *path) {
+  uint8_t blob[KYBER_TUNE_BLOBBYTES];
+  kyber_tune_config cfg;
+  FILE *f;
+  int ok;
+
+  f = fopen(path, "rb");
+  if (f != NULL) {
+    ok = fread(blob, 1, sizeof(blob), f) == sizeof(blob);
+    fclose(f);
+    if (ok && kyber_tune_load(&cfg, blob) == 0 && kyber_tune_apply(&cfg) == 0)
+      return 1;
+  }
+
+  if (kyber_tune_run(&cfg) != 0)
+    return -1;
+  kyber_tune_save(blob, &cfg);
+
+  f = fopen(path, "wb");
+  if (f == NULL)
+    return -1;
+  ok = fwrite(blob, 1, sizeof(blob), f) == sizeof(blob);
+  if (fclose(f) != 0)
+    ok = 0;
+  return ok ? 0 : -1;
+}
+#endif
@@ -1,157 +1,157 @@
-/*************************************************
- * NTT Implementation for Kyber
- *
- * Number-Theoretic Transform for polynomial multiplication
- * in the ring Zq[X]/(X^256 + 1) where q = 3329
- *************************************************/
-
-#include "../include/ntt.h"
-#include "../include/params.h"
-#include <stdint.h>
-
-/*************************************************
- * Precomputed zetas (twiddle factors)
- * Powers of primitive 256th root of unity (zeta = 17)
- * in Montgomery form and bit-reversed order
- *************************************************/
-const int16_t zetas[128] = {
-    2285, 2571, 2970, 1812, 1493, 1422, 287,  202,  3158, 622,  1577, 182,
-    962,  2127, 1855, 1468, 573,  2004, 264,  383,  2500, 1458, 1727, 3199,
-    2648, 1017, 732,  608,  1787, 411,  3124, 1758, 1223, 652,  2777, 1015,
-    2036, 1491, 3047, 1785, 516,  3321, 3009, 2663, 1711, 2167, 126,  1469,
-    2476, 3239, 3058, 830,  107,  1908, 3082, 2378, 2931, 961,  1821, 2604,
-    448,  2264, 677,  2054, 2226, 430,  555,  843,  2078, 871,  1550, 105,
-    422,  587,  177,  3094, 3038, 2869, 1574, 1653, 3083, 778,  1159, 3182,
-    2552, 1483, 2727, 1119, 1739, 644,  2457, 349,  418,  329,  3173, 3254,
-    817,  1097, 603,  610,  1322, 2044, 1864, 384,  2114, 3193, 1218, 1994,
-    2455, 220,  2142, 1670, 2144, 1799, 2051, 794,  1819, 2475, 2459, 478,
-    3221, 3021, 996,  991,  958,  1869, 1522, 1628};
-
-/*************************************************
- * Name:        montgomery_reduce
- *
- * Description: Montgomery reduction; given a 32-bit integer a, computes
- *              16-bit integer congruent to a * R^-1 mod q, where R=2^16
- *
- * Arguments:   - int32_t a: input integer to be reduced
- *
- * Returns:     integer in {-q+1,...,q-1} congruent to a * R^-1 modulo q.
- *************************************************/
-int16_t montgomery_reduce(int32_t a) {
-  int16_t t;
-  t = (int16_t)a * QINV;
-  t = (a - (int32_t)t * KYBER_Q) >> 16;
-  return t;
-}
-
-/*************************************************
- * Name:        barrett_reduce
- *
- * Description: Barrett reduction; given a 16-bit integer a, computes
- *              centered representative congruent to a mod q in
- * {-(q-1)/2,...,(q-1)/2}
- *
- * Arguments:   - int16_t a: input integer to be reduced
- *
- * Returns:     integer in {-(q-1)/2,...,(q-1)/2} congruent to a modulo q.
- *************************************************/
-int16_t barrett_reduce(int16_t a) {
-  int16_t t;
-  const int16_t v = ((1 << 26) + KYBER_Q / 2) / KYBER_Q;
-
-  t = ((int32_t)v * a + (1 << 25)) >> 26;
-  t *= KYBER_Q;
-  return a - t;
-}
-
-/*************************************************
- * Name:        fqmul
- *
- * Description: Multiplication followed by Montgomery reduction
- *
- * Arguments:   - int16_t a: first factor
- *              - int16_t b: second factor
- *
- * Returns:     16-bit integer congruent to a*b*R^{-1} mod q
- *************************************************/
-static int16_t fqmul(int16_t a, int16_t b) {
-  return montgomery_reduce((int32_t)a * b);
-}
-
-/*************************************************
- * Name:        ntt
- *
- * Description: Inplace number-theoretic transform (NTT) in Rq.
- *              input is in standard order, output is in bit-reversed order
- *
- * Arguments:   - int16_t r[256]: pointer to input/output vector of elements of
- * Zq
- *************************************************/
-void ntt(int16_t r[KYBER_N]) {
-  unsigned int len, start, j, k;
-  int16_t t, zeta;
-
-  k = 1;
-  for (len = 128; len >= 2; len >>= 1) {
-    for (start = 0; start < 256; start = j + len) {
-      zeta = zetas[k++];
-      for (j = start; j < start + len; j++) {
-        t = fqmul(zeta, r[j + len]);
-        r[j + len] = r[j] - t;
-        r[j] = r[j] + t;
-      }
-    }
-  }
-}
-
-/*************************************************
- * Name:        invntt
- *
- * Description: Inplace inverse number-theoretic transform in Rq and
- *              multiplication by Montgomery factor 2^16.
- *              Input is in bit-reversed order, output is in standard order
- *
- * Arguments:   - int16_t r[256]: pointer to input/output vector of elements of
- * Zq
- *************************************************/
-void invntt(int16_t r[KYBER_N]) {
-  unsigned int start, len, j, k;
-  int16_t t, zeta;
-  const int16_t f = 1441; // mont^2/128
-
-  k = 127;
-  for (len = 2; len <= 128; len <<= 1) {
-    for (start = 0; start < 256; start = j + len) {
-      zeta = zetas[k--];
-      for (j = start; j < start + len; j++) {
-        t = r[j];
-        r[j] = barrett_reduce(t + r[j + len]);
-        r[j + len] = r[j + len] - t;
-        r[j + len] = fqmul(zeta, r[j + len]);
-      }
-    }
-  }
-
-  for (j = 0; j < 256; j++)
-    r[j] = fqmul(r[j], f);
-}
-
-/*************************************************
- * Name:        basemul
- *
- * Description: Multiplication of polynomials in Zq[X]/(X^2-zeta)
- *              used for multiplication of elements in Rq in NTT domain
- *
- * Arguments:   - int16_t r[2]: pointer to the output polynomial
- *              - const int16_t a[2]: pointer to the first factor
- *              - const int16_t b[2]: pointer to the second factor
- *              - int16_t zeta: integer defining the reduction polynomial
- *************************************************/
-void basemul(int16_t r[2], const int16_t a[2], const int16_t b[2],
-             int16_t zeta) {
-  r[0] = fqmul(a[1], b[1]);
-  r[0] = fqmul(r[0], zeta);
-  r[0] += fqmul(a[0], b[0]);
-  r[1] = fqmul(a[0], b[1]);
-  r[1] += fqmul(a[1], b[0]);
-}
+/*************************************************
+ * NTT Implementation for Kyber
+ *
+ * Number-Theoretic Transform for polynomial multiplication
+ * in the ring Zq[X]/(X^256 + 1) where q = 3329
+ *************************************************/
+
+#include "../include/ntt.h"
+#include "../include/params.h"
+#include <stdint.h>
+
+/*************************************************
+ * Precomputed zetas (twiddle factors)
+ * Powers of primitive 256th root of unity (zeta = 17)
+ * in Montgomery form and bit-reversed order
+ *************************************************/
+const int16_t zetas[128] = {
+    2285, 2571, 2970, 1812, 1493, 1422, 287,  202,  3158, 622,  1577, 182,
+    962,  2127, 1855, 1468, 573,  2004, 264,  383,  2500, 1458, 1727, 3199,
+    2648, 1017, 732,  608,  1787, 411,  3124, 1758, 1223, 652,  2777, 1015,
+    2036, 1491, 3047, 1785, 516,  3321, 3009, 2663, 1711, 2167, 126,  1469,
+    2476, 3239, 3058, 830,  107,  1908, 3082, 2378, 2931, 961,  1821, 2604,
+    448,  2264, 677,  2054, 2226, 430,  555,  843,  2078, 871,  1550, 105,
+    422,  587,  177,  3094, 3038, 2869, 1574, 1653, 3083, 778,  1159, 3182,
+    2552, 1483, 2727, 1119, 1739, 644,  2457, 349,  418,  329,  3173, 3254,
+    817,  1097, 603,  610,  1322, 2044, 1864, 384,  2114, 3193, 1218, 1994,
+    2455, 220,  2142, 1670, 2144, 1799, 2051, 794,  1819, 2475, 2459, 478,
+    3221, 3021, 996,  991,  958,  1869, 1522, 1628};
+
+/*************************************************
+ * Name:        montgomery_reduce
+ *
+ * Description: Montgomery reduction; given a 32-bit integer a, computes
+ *              16-bit integer congruent to a * R^-1 mod q, where R=2^16
+ *
+ * Arguments:   - int32_t a: input integer to be reduced
+ *
+ * Returns:     integer in {-q+1,...,q-1} congruent to a * R^-1 modulo q.
+ *************************************************/
+int16_t montgomery_reduce(int32_t a) {
+  int16_t t;
+  t = (int16_t)a * QINV;
+  t = (a - (int32_t)t * KYBER_Q) >> 16;
+  return t;
+}
+
+/*************************************************
+ * Name:        barrett_reduce
+ *
+ * Description: Barrett reduction; given a 16-bit integer a, computes
+ *              centered representative congruent to a mod q in
+ * {-(q-1)/2,...,(q-1)/2}
+ *
+ * Arguments:   - int16_t a: input integer to be reduced
+ *
+ * Returns:     integer in {-(q-1)/2,...,(q-1)/2} congruent to a modulo q.
+ *************************************************/
+int16_t barrett_reduce(int16_t a) {
+  int16_t t;
+  const int16_t v = ((1 << 26) + KYBER_Q / 2) / KYBER_Q;
+
+  t = ((int32_t)v * a + (1 << 25)) >> 26;
+  t *= KYBER_Q;
+  return a - t;
+}
+
+/*************************************************
+ * Name:        fqmul
+ *
+ * Description: Multiplication followed by Montgomery reduction
+ *
+ * Arguments:   - int16_t a: first factor
+ *              - int16_t b: second factor
+ *
+ * Returns:     16-bit integer congruent to a*b*R^{-1} mod q
+ *************************************************/
+static int16_t fqmul(int16_t a, int16_t b) {
+  return montgomery_reduce((int32_t)a * b);
+}
+
+/*************************************************
+ * Name:        ntt
+ *
+ * Description: Inplace number-theoretic transform (NTT) in Rq.
+ *              input is in standard order, output is in bit-reversed order
+ *
+ * Arguments:   - int16_t r[256]: pointer to input/output vector of elements of
+ * Zq
+ *************************************************/
+void ntt(int16_t r[KYBER_N]) {
+  unsigned int len, start, j, k;
+  int16_t t, zeta;
+
+  k = 1;
+  for (len = 128; len >= 2; len >>= 1) {
+    for (start = 0; start < 256; start = j + len) {
+      zeta = zetas[k++];
+      for (j = start; j < start + len; j++) {
+        t = fqmul(zeta, r[j + len]);
+        r[j + len] = r[j] - t;
+        r[j] = r[j] + t;
+      }
+    }
+  }
+}
+
+/*************************************************
+ * Name:        invntt
+ *
+ * Description: Inplace inverse number-theoretic transform in Rq and
+ *              multiplication by Montgomery factor 2^16.
+ *              Input is in bit-reversed order, output is in standard order
+ *
+ * Arguments:   - int16_t r[256]: pointer to input/output vector of elements of
+ * Zq
+ *************************************************/
+void invntt(int16_t r[KYBER_N]) {
+  unsigned int start, len, j, k;
+  int16_t t, zeta;
+  const int16_t f = 1441; // mont^2/128
+
+  k = 127;
+  for (len = 2; len <= 128; len <<= 1) {
+    for (start = 0; start < 256; start = j + len) {
+      zeta = zetas[k--];
+      for (j = start; j < start + len; j++) {
+        t = r[j];
+        r[j] = barrett_reduce(t + r[j + len]);
+        r[j + len] = r[j + len] - t;
+        r[j + len] = fqmul(zeta, r[j + len]);
+      }
+    }
+  }
+
+  for (j = 0; j < 256; j++)
+    r[j] = fqmul(r[j], f);
+}
+
+/*************************************************
+ * Name:        basemul
+ *
+ * Description: Multiplication of polynomials in Zq[X]/(X^2-zeta)
+ *              used for multiplication of elements in Rq in NTT domain
+ *
+ * Arguments:   - int16_t r[2]: pointer to the output polynomial
+ *              - const int16_t a[2]: pointer to the first factor
+ *              - const int16_t b[2]: pointer to the second factor
+ *              - int16_t zeta: integer defining the reduction polynomial
+ *************************************************/
+void basemul(int16_t r[2], const int16_t a[2], const int16_t b[2],
+             int16_t zeta) {
+  r[0] = fqmul(a[1], b[1]);
+  r[0] = fqmul(r[0], zeta);
+  r[0] += fqmul(a[0], b[0]);
+  r[1] = fqmul(a[0], b[1]);
+  r[1] += fqmul(a[1], b[0]);
+}
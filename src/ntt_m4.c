@@ -0,0 +1,264 @@
+/*************************************************
+ * Cortex-M4 DSP Backend
+ *
+ * Coefficients j and j + 1 share a 32-bit word (the natural layout of
+ * r[] on a little-endian core), which works for every layer since the
+ * smallest butterfly distance is 2. The halfword multiplies take one
+ * coefficient from either half: smulbb/smultb form the product and
+ * smulbb/smlabt with QPACK reduce it, leaving the Montgomery result in
+ * the top half and zeros below, so a pkhtb puts two results back in a
+ * word. The additions of the butterflies wrap per halfword like the
+ * int16_t arithmetic of the scalar code, which keeps every output
+ * identical to ntt.c for all inputs.
+ *
+ * The forward NTT runs layers 1-3 on 8 words spaced 32 coefficients
+ * apart, then layers 4-6 on 8 words spaced 4 apart inside each
+ * 32-coefficient block, then layer 7 on neighbouring words: three
+ * passes over r[] instead of seven. The inverse NTT does the same in
+ * reverse and scales by mont^2/128 on its last pass.
+ *************************************************/
+
+#include "../include/ntt_m4.h"
+#include "../include/ntt.h"
+#include "../include/params.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(KYBER_HAVE_M4)
+
+#include <arm_acle.h>
+
+// -q in the top half, q^-1 mod 2^16 in the bottom half
+#define QPACK ((int32_t)(((uint32_t)-KYBER_Q << 16) | (QINV & 0xFFFF)))
+
+// Barrett multiplier of barrett_reduce()
+#define BARRETT_V (((1 << 26) + KYBER_Q / 2) / KYBER_Q)
+
+// Unaligned word access is fine on ARMv7-M; memcpy becomes ldr/str
+static inline int32_t load32(const int16_t *p) {
+  int32_t w;
+
+  memcpy(&w, p, sizeof(w));
+  return w;
+}
+
+static inline void store32(int16_t *p, int32_t w) { memcpy(p, &w, sizeof(w)); }
+
+// Top halves of hi and lo, as pkhtb hi, lo, asr #16
+static inline int32_t pack_top(int32_t hi, int32_t lo) {
+  return (int32_t)(((uint32_t)hi & 0xFFFF0000u) | ((uint32_t)lo >> 16));
+}
+
+// Bottom halves of lo and hi, as pkhbt lo, hi, lsl #16
+static inline int32_t pack_bottom(int32_t lo, int32_t hi) {
+  return (int32_t)(((uint32_t)lo & 0xFFFFu) | ((uint32_t)hi << 16));
+}
+
+/*************************************************
+ * montgomery_reduce(p) in the top half, zero in the bottom half:
+ * t = (int16_t)p * QINV, then p - t * q.
+ *************************************************/
+static inline int32_t montgomery_top(int32_t p) {
+  return __smlabt(__smulbb(p, QPACK), QPACK, p);
+}
+
+// fqmul() of both halves of a with the zeta in the bottom half of z
+static inline int32_t fqmul2(int32_t a, int32_t z) {
+  return pack_top(montgomery_top(__smultb(a, z)),
+                  montgomery_top(__smulbb(a, z)));
+}
+
+// barrett_reduce() of both halves of a
+static inline int32_t barrett2(int32_t a) {
+  int32_t lo = __smlabb(a, BARRETT_V, 1 << 25) >> 26;
+  int32_t hi = __smlatb(a, BARRETT_V, 1 << 25) >> 26;
+
+  return __ssub16(a, pack_bottom(lo * KYBER_Q, hi * KYBER_Q));
+}
+
+// Cooley-Tukey butterfly of ntt() on w[i], w[k]
+#define CT(w, i, k, z)                                                         \
+  do {                                                                         \
+    int32_t t_ = fqmul2(w[k], z);                                              \
+    w[k] = __ssub16(w[i], t_);                                                 \
+    w[i] = __sadd16(w[i], t_);                                                 \
+  } while (0)
+
+// Gentleman-Sande butterfly of invntt() on w[i], w[k]
+#define GS(w, i, k, z)                                                         \
+  do {                                                                         \
+    int32_t t_ = w[i];                                                         \
+    w[i] = barrett2(__sadd16(t_, w[k]));                                       \
+    w[k] = fqmul2(__ssub16(w[k], t_), z);                                      \
+  } while (0)
+
+/*************************************************
+ * Three forward layers on the words at r + stride * m, m = 0..7:
+ * distance 4 words with z1[0], 2 words with z2[0..1], 1 word with
+ * z4[0..3].
+ *************************************************/
+static inline void ntt_3layers(int16_t *r, unsigned int stride,
+                               const int16_t *z1, const int16_t *z2,
+                               const int16_t *z4) {
+  int32_t w[8];
+  unsigned int m;
+
+  for (m = 0; m < 8; m++)
+    w[m] = load32(r + stride * m);
+
+  CT(w, 0, 4, z1[0]);
+  CT(w, 1, 5, z1[0]);
+  CT(w, 2, 6, z1[0]);
+  CT(w, 3, 7, z1[0]);
+  CT(w, 0, 2, z2[0]);
+  CT(w, 1, 3, z2[0]);
+  CT(w, 4, 6, z2[1]);
+  CT(w, 5, 7, z2[1]);
+  CT(w, 0, 1, z4[0]);
+  CT(w, 2, 3, z4[1]);
+  CT(w, 4, 5, z4[2]);
+  CT(w, 6, 7, z4[3]);
+
+  for (m = 0; m < 8; m++)
+    store32(r + stride * m, w[m]);
+}
+
+/*************************************************
+ * Three inverse layers, the mirror image of ntt_3layers(). The
+ * inverse walks zetas[] downwards, so the zetas are z4[0], z4[-1],
+ * ... and z2[0], z2[-1]. With scale set the outputs are multiplied
+ * by mont^2/128 as at the end of invntt().
+ *************************************************/
+static inline void invntt_3layers(int16_t *r, unsigned int stride,
+                                  const int16_t *z4, const int16_t *z2,
+                                  const int16_t *z1, int scale) {
+  const int32_t f = 1441; // mont^2/128
+  int32_t w[8];
+  unsigned int m;
+
+  for (m = 0; m < 8; m++)
+    w[m] = load32(r + stride * m);
+
+  GS(w, 0, 1, z4[0]);
+  GS(w, 2, 3, z4[-1]);
+  GS(w, 4, 5, z4[-2]);
+  GS(w, 6, 7, z4[-3]);
+  GS(w, 0, 2, z2[0]);
+  GS(w, 1, 3, z2[0]);
+  GS(w, 4, 6, z2[-1]);
+  GS(w, 5, 7, z2[-1]);
+  GS(w, 0, 4, z1[0]);
+  GS(w, 1, 5, z1[0]);
+  GS(w, 2, 6, z1[0]);
+  GS(w, 3, 7, z1[0]);
+
+  if (scale)
+    for (m = 0; m < 8; m++)
+      w[m] = fqmul2(w[m], f);
+
+  for (m = 0; m < 8; m++)
+    store32(r + stride * m, w[m]);
+}
+
+/*************************************************
+ * Name:        ntt_m4
+ *
+ * Description: Forward NTT, bit-identical to ntt()
+ *************************************************/
+void ntt_m4(int16_t r[256]) {
+  unsigned int i, j;
+  int32_t x, y;
+
+  // Layers 1-3: distance 128, 64, 32
+  for (j = 0; j < 32; j += 2)
+    ntt_3layers(r + j, 32, zetas + 1, zetas + 2, zetas + 4);
+
+  // Layers 4-6: distance 16, 8, 4 inside 32-coefficient block i
+  for (i = 0; i < 8; i++)
+    for (j = 0; j < 4; j += 2)
+      ntt_3layers(r + 32 * i + j, 4, zetas + 8 + i, zetas + 16 + 2 * i,
+                  zetas + 32 + 4 * i);
+
+  // Layer 7: distance 2
+  for (i = 0; i < 64; i++) {
+    x = load32(r + 4 * i);
+    y = fqmul2(load32(r + 4 * i + 2), zetas[64 + i]);
+    store32(r + 4 * i + 2, __ssub16(x, y));
+    store32(r + 4 * i, __sadd16(x, y));
+  }
+}
+
+/*************************************************
+ * Name:        invntt_m4
+ *
+ * Description: Inverse NTT and multiplication by 2^16, bit-identical
+ *              to invntt()
+ *************************************************/
+void invntt_m4(int16_t r[256]) {
+  unsigned int i, j;
+  int32_t x, y;
+
+  // Layer 7: distance 2
+  for (i = 0; i < 64; i++) {
+    x = load32(r + 4 * i);
+    y = load32(r + 4 * i + 2);
+    store32(r + 4 * i, barrett2(__sadd16(x, y)));
+    store32(r + 4 * i + 2, fqmul2(__ssub16(y, x), zetas[127 - i]));
+  }
+
+  // Layers 6-4: distance 4, 8, 16 inside 32-coefficient block i
+  for (i = 0; i < 8; i++)
+    for (j = 0; j < 4; j += 2)
+      invntt_3layers(r + 32 * i + j, 4, zetas + 63 - 4 * i,
+                     zetas + 31 - 2 * i, zetas + 15 - i, 0);
+
+  // Layers 3-1: distance 32, 64, 128, then the final scaling
+  for (j = 0; j < 32; j += 2)
+    invntt_3layers(r + j, 32, zetas + 7, zetas + 3, zetas + 1, 1);
+}
+
+// basemul() of the pairs in a and b, results packed the same way
+static inline int32_t basemul2(int32_t a, int32_t b, int32_t zeta) {
+  int32_t r0, r1;
+
+  r0 = montgomery_top(__smultt(a, b));
+  r0 = montgomery_top(__smultb(r0, zeta));
+  r0 = __sadd16(r0, montgomery_top(__smulbb(a, b)));
+  r1 = __sadd16(montgomery_top(__smulbt(a, b)), montgomery_top(__smultb(a, b)));
+  return pack_top(r1, r0);
+}
+
+/*************************************************
+ * Name:        basemul_m4
+ *
+ * Description: Pointwise multiplication in the NTT domain,
+ *              bit-identical to poly_basemul_montgomery(). Each word
+ *              holds one degree-1 factor; the products are reduced
+ *              one by one rather than summed with smlad, which would
+ *              give other (congruent) representatives than basemul().
+ *************************************************/
+void basemul_m4(int16_t r[256], const int16_t a[256], const int16_t b[256]) {
+  unsigned int i;
+  int32_t zeta;
+
+  for (i = 0; i < 64; i++) {
+    zeta = zetas[64 + i];
+    store32(r + 4 * i, basemul2(load32(a + 4 * i), load32(b + 4 * i), zeta));
+    store32(r + 4 * i + 2,
+            basemul2(load32(a + 4 * i + 2), load32(b + 4 * i + 2), -zeta));
+  }
+}
+
+/*************************************************
+ * Name:        reduce_m4
+ *
+ * Description: Barrett reduction of all coefficients
+ *************************************************/
+void reduce_m4(int16_t r[256]) {
+  unsigned int j;
+
+  for (j = 0; j < 256; j += 2)
+    store32(r + j, barrett2(load32(r + j)));
+}
+
+#endif /* KYBER_HAVE_M4 */
@@ -0,0 +1,430 @@
+/*************************************************
+ * AArch64 NEON Backend
+ *
+ * Same structure as the portable vector backend (ntt_vec.c): 8
+ * coefficients per register, whole-register butterflies down to
+ * distance 8, then the distance 4 and 2 layers on register pairs
+ * rearranged with trn/uzp/zip. Montgomery and Barrett reductions are
+ * written with smull/sqdmulh so that every result is exactly the
+ * scalar one, including for inputs the KEM never produces.
+ *************************************************/
+
+#include "../include/ntt_neon.h"
+#include "../include/ntt.h"
+#include "../include/ntt_vec.h"
+#include "../include/params.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(KYBER_HAVE_NEON)
+
+#include <arm_neon.h>
+
+// High half of the signed 32-bit products, exact for all inputs
+static inline int16x8_t mulhi(int16x8_t a, int16x8_t b) {
+  int32x4_t lo = vmull_s16(vget_low_s16(a), vget_low_s16(b));
+  int32x4_t hi = vmull_high_s16(a, b);
+
+  return vuzp2q_s16(vreinterpretq_s16_s32(lo), vreinterpretq_s16_s32(hi));
+}
+
+/*************************************************
+ * montgomery_reduce(a * b). sqdmulh(t, q) is floor(t * q / 2^15) and
+ * cannot saturate for the constant q, so halving it gives the high
+ * half of t * q.
+ *************************************************/
+static inline int16x8_t fqmul(int16x8_t a, int16x8_t b) {
+  int16x8_t t = vmulq_n_s16(vmulq_s16(a, b), (int16_t)QINV);
+
+  return vsubq_s16(mulhi(a, b), vshrq_n_s16(vqdmulhq_n_s16(t, KYBER_Q), 1));
+}
+
+// barrett_reduce(); rounding floor(a * v / 2^15) at bit 11 is exactly
+// (a * v + 2^25) >> 26
+static inline int16x8_t barrett(int16x8_t a) {
+  const int16_t v = ((1 << 26) + KYBER_Q / 2) / KYBER_Q;
+  int16x8_t t = vrshrq_n_s16(vqdmulhq_n_s16(a, v), 11);
+
+  return vmlsq_n_s16(a, t, KYBER_Q);
+}
+
+/*************************************************
+ * Lane selections, see LO_n / HI_n / TO_X_n / TO_Y_n in ntt_vec.c
+ *************************************************/
+static inline int16x8_t lo4(int16x8_t x, int16x8_t y) {
+  return vreinterpretq_s16_s64(
+      vtrn1q_s64(vreinterpretq_s64_s16(x), vreinterpretq_s64_s16(y)));
+}
+
+static inline int16x8_t hi4(int16x8_t x, int16x8_t y) {
+  return vreinterpretq_s16_s64(
+      vtrn2q_s64(vreinterpretq_s64_s16(x), vreinterpretq_s64_s16(y)));
+}
+
+static inline int16x8_t lo2(int16x8_t x, int16x8_t y) {
+  return vreinterpretq_s16_s32(
+      vuzp1q_s32(vreinterpretq_s32_s16(x), vreinterpretq_s32_s16(y)));
+}
+
+static inline int16x8_t hi2(int16x8_t x, int16x8_t y) {
+  return vreinterpretq_s16_s32(
+      vuzp2q_s32(vreinterpretq_s32_s16(x), vreinterpretq_s32_s16(y)));
+}
+
+static inline int16x8_t tox2(int16x8_t lo, int16x8_t hi) {
+  return vreinterpretq_s16_s32(
+      vzip1q_s32(vreinterpretq_s32_s16(lo), vreinterpretq_s32_s16(hi)));
+}
+
+static inline int16x8_t toy2(int16x8_t lo, int16x8_t hi) {
+  return vreinterpretq_s16_s32(
+      vzip2q_s32(vreinterpretq_s32_s16(lo), vreinterpretq_s32_s16(hi)));
+}
+
+#define tox4 lo4
+#define toy4 hi4
+
+#define NTT_LAYER(x, y, n, zp)                                                 \
+  do {                                                                         \
+    int16x8_t lo_ = lo##n(x, y), hi_ = hi##n(x, y);                            \
+    int16x8_t t_ = fqmul(vld1q_s16(zp), hi_);                                  \
+    hi_ = vsubq_s16(lo_, t_);                                                  \
+    lo_ = vaddq_s16(lo_, t_);                                                  \
+    x = tox##n(lo_, hi_);                                                      \
+    y = toy##n(lo_, hi_);                                                      \
+  } while (0)
+
+#define INVNTT_LAYER(x, y, n, zp)                                              \
+  do {                                                                         \
+    int16x8_t lo_ = lo##n(x, y), hi_ = hi##n(x, y);                            \
+    int16x8_t t_ = lo_;                                                        \
+    lo_ = barrett(vaddq_s16(t_, hi_));                                         \
+    hi_ = fqmul(vld1q_s16(zp), vsubq_s16(hi_, t_));                            \
+    x = tox##n(lo_, hi_);                                                      \
+    y = toy##n(lo_, hi_);                                                      \
+  } while (0)
+
+/*************************************************
+ * Name:        ntt_neon
+ *
+ * Description: Forward NTT, bit-identical to ntt()
+ *************************************************/
+void ntt_neon(int16_t r[256]) {
+  unsigned int len, start, j, k = 1;
+  const int16_t *zp = zetas_ntt_vec;
+  int16x8_t zeta, t, x, y;
+
+  for (len = 128; len >= 8; len >>= 1) {
+    for (start = 0; start < 256; start += 2 * len) {
+      zeta = vdupq_n_s16(zetas[k++]);
+      for (j = start; j < start + len; j += 8) {
+        x = vld1q_s16(r + j);
+        t = fqmul(zeta, vld1q_s16(r + j + len));
+        vst1q_s16(r + j + len, vsubq_s16(x, t));
+        vst1q_s16(r + j, vaddq_s16(x, t));
+      }
+    }
+  }
+
+  for (j = 0; j < 256; j += 16, zp += 16) {
+    x = vld1q_s16(r + j);
+    y = vld1q_s16(r + j + 8);
+    NTT_LAYER(x, y, 4, zp);
+    NTT_LAYER(x, y, 2, zp + 8);
+    vst1q_s16(r + j, x);
+    vst1q_s16(r + j + 8, y);
+  }
+}
+
+/*************************************************
+ * Name:        invntt_neon
+ *
+ * Description: Inverse NTT and multiplication by 2^16, bit-identical
+ *              to invntt()
+ *************************************************/
+void invntt_neon(int16_t r[256]) {
+  unsigned int len, start, j, k = 31;
+  const int16_t *zp = zetas_invntt_vec;
+  const int16x8_t f = vdupq_n_s16(1441); // mont^2/128
+  int16x8_t zeta, t, x, y;
+
+  for (j = 0; j < 256; j += 16, zp += 16) {
+    x = vld1q_s16(r + j);
+    y = vld1q_s16(r + j + 8);
+    INVNTT_LAYER(x, y, 2, zp);
+    INVNTT_LAYER(x, y, 4, zp + 8);
+    vst1q_s16(r + j, x);
+    vst1q_s16(r + j + 8, y);
+  }
+
+  for (len = 8; len <= 128; len <<= 1) {
+    for (start = 0; start < 256; start += 2 * len) {
+      zeta = vdupq_n_s16(zetas[k--]);
+      for (j = start; j < start + len; j += 8) {
+        t = vld1q_s16(r + j);
+        x = vld1q_s16(r + j + len);
+        vst1q_s16(r + j, barrett(vaddq_s16(t, x)));
+        vst1q_s16(r + j + len, fqmul(zeta, vsubq_s16(x, t)));
+      }
+    }
+  }
+
+  for (j = 0; j < 256; j += 8)
+    vst1q_s16(r + j, fqmul(vld1q_s16(r + j), f));
+}
+
+/*************************************************
+ * Name:        basemul_neon
+ *
+ * Description: Pointwise multiplication in the NTT domain,
+ *              bit-identical to poly_basemul_montgomery()
+ *************************************************/
+void basemul_neon(int16_t r[256], const int16_t a[256], const int16_t b[256]) {
+  unsigned int j;
+  int16x8_t x, y, a0, a1, b0, b1, r0, r1;
+
+  for (j = 0; j < 256; j += 16) {
+    x = vld1q_s16(a + j);
+    y = vld1q_s16(a + j + 8);
+    a0 = vuzp1q_s16(x, y);
+    a1 = vuzp2q_s16(x, y);
+    x = vld1q_s16(b + j);
+    y = vld1q_s16(b + j + 8);
+    b0 = vuzp1q_s16(x, y);
+    b1 = vuzp2q_s16(x, y);
+
+    r0 = fqmul(fqmul(a1, b1), vld1q_s16(zetas_basemul_vec + j / 2));
+    r0 = vaddq_s16(r0, fqmul(a0, b0));
+    r1 = vaddq_s16(fqmul(a0, b1), fqmul(a1, b0));
+
+    vst1q_s16(r + j, vzip1q_s16(r0, r1));
+    vst1q_s16(r + j + 8, vzip2q_s16(r0, r1));
+  }
+}
+
+/*************************************************
+ * Name:        reduce_neon
+ *
+ * Description: Barrett reduction of all coefficients
+ *************************************************/
+void reduce_neon(int16_t r[256]) {
+  unsigned int j;
+
+  for (j = 0; j < 256; j += 8)
+    vst1q_s16(r + j, barrett(vld1q_s16(r + j)));
+}
+
+/*************************************************
+ * Name:        cbd2_neon
+ *
+ * Description: CBD with eta = 2 on bytes: each byte gives two
+ *              coefficients, so one register of input gives 32
+ *************************************************/
+void cbd2_neon(int16_t r[256], const uint8_t *buf) {
+  const uint8x16_t m = vdupq_n_u8(0x55), three = vdupq_n_u8(3);
+  unsigned int i;
+  uint8x16_t t, d;
+  int8x16_t lo, hi, z;
+
+  for (i = 0; i < KYBER_N / 32; i++) {
+    t = vld1q_u8(buf + 16 * i);
+    d = vaddq_u8(vandq_u8(t, m), vandq_u8(vshrq_n_u8(t, 1), m));
+    lo = vsubq_s8(vreinterpretq_s8_u8(vandq_u8(d, three)),
+                  vreinterpretq_s8_u8(vandq_u8(vshrq_n_u8(d, 2), three)));
+    hi = vsubq_s8(vreinterpretq_s8_u8(vandq_u8(vshrq_n_u8(d, 4), three)),
+                  vreinterpretq_s8_u8(vshrq_n_u8(d, 6)));
+
+    z = vzip1q_s8(lo, hi);
+    vst1q_s16(r + 32 * i, vmovl_s8(vget_low_s8(z)));
+    vst1q_s16(r + 32 * i + 8, vmovl_high_s8(z));
+    z = vzip2q_s8(lo, hi);
+    vst1q_s16(r + 32 * i + 16, vmovl_s8(vget_low_s8(z)));
+    vst1q_s16(r + 32 * i + 24, vmovl_high_s8(z));
+  }
+}
+
+/*************************************************
+ * Name:        cbd3_neon
+ *
+ * Description: CBD with eta = 3. A table lookup gives every lane the
+ *              16-bit window holding its 6 input bits, a multiply
+ *              moves them to the top, as in cbd3_vec().
+ *************************************************/
+static const uint8_t cbd3_windows[16] = {0, 1, 0, 1, 1, 2, 2, 3,
+                                         3, 4, 3, 4, 4, 5, 5, 6};
+static const uint16_t cbd3_up[8] = {1 << 10, 1 << 4, 1 << 6, 1 << 8,
+                                    1 << 10, 1 << 4, 1 << 6, 1 << 8};
+
+static inline int16x8_t cbd3_lanes(uint16x8_t w, uint16x8_t up) {
+  const uint16x8_t m = vdupq_n_u16(0x9), seven = vdupq_n_u16(7);
+  uint16x8_t f, d;
+
+  f = vshrq_n_u16(vmulq_u16(w, up), 10);
+  d = vaddq_u16(vandq_u16(f, m), vandq_u16(vshrq_n_u16(f, 1), m));
+  d = vaddq_u16(d, vandq_u16(vshrq_n_u16(f, 2), m));
+  return vsubq_s16(vreinterpretq_s16_u16(vandq_u16(d, seven)),
+                   vreinterpretq_s16_u16(vshrq_n_u16(d, 3)));
+}
+
+void cbd3_neon(int16_t r[256], const uint8_t *buf) {
+  const uint8x16_t w0 = vld1q_u8(cbd3_windows);
+  const uint8x16_t w1 = vaddq_u8(w0, vdupq_n_u8(6));
+  const uint16x8_t up = vld1q_u16(cbd3_up);
+  unsigned int i;
+  uint8_t tmp[16] = {0};
+  uint8x16_t t;
+
+  for (i = 0; i < KYBER_N / 16; i++) {
+    // 12 bytes per 16 coefficients; copy so the last load stays in bounds
+    memcpy(tmp, buf + 12 * i, 12);
+    t = vld1q_u8(tmp);
+    vst1q_s16(r + 16 * i,
+              cbd3_lanes(vreinterpretq_u16_u8(vqtbl1q_u8(t, w0)), up));
+    vst1q_s16(r + 16 * i + 8,
+              cbd3_lanes(vreinterpretq_u16_u8(vqtbl1q_u8(t, w1)), up));
+  }
+}
+
+/*************************************************
+ * Name:        compress_neon
+ *
+ * Description: Compression to d = 4 or 5 bits per coefficient,
+ *              bit-identical to poly_compress(), with the
+ *              multiply-shift of compress_vec() instead of a division
+ *************************************************/
+static inline uint16x8_t compress_lanes(int16x8_t u, int d) {
+  uint16x8_t v;
+  uint32x4_t lo, hi;
+
+  u = vaddq_s16(u, vandq_s16(vshrq_n_s16(u, 15), vdupq_n_s16(KYBER_Q)));
+  v = vreinterpretq_u16_s16(u);
+  lo = vmovl_u16(vget_low_u16(v));
+  hi = vmovl_high_u16(v);
+  if (d == 4) {
+    lo = vmulq_n_u32(vaddq_u32(vshlq_n_u32(lo, 4), vdupq_n_u32(1665)), 80635);
+    hi = vmulq_n_u32(vaddq_u32(vshlq_n_u32(hi, 4), vdupq_n_u32(1665)), 80635);
+    lo = vshrq_n_u32(lo, 28);
+    hi = vshrq_n_u32(hi, 28);
+  } else {
+    lo = vmulq_n_u32(vaddq_u32(vshlq_n_u32(lo, 5), vdupq_n_u32(1664)), 40318);
+    hi = vmulq_n_u32(vaddq_u32(vshlq_n_u32(hi, 5), vdupq_n_u32(1664)), 40318);
+    lo = vshrq_n_u32(lo, 27);
+    hi = vshrq_n_u32(hi, 27);
+  }
+  return vmovn_high_u32(vmovn_u32(lo), hi);
+}
+
+void compress_neon(uint8_t *r, const int16_t a[256], int d) {
+  unsigned int i;
+  uint16_t t[8];
+  uint16x8_t c0, c1;
+
+  if (d == 4) {
+    for (i = 0; i < KYBER_N / 16; i++) {
+      c0 = compress_lanes(vld1q_s16(a + 16 * i), 4);
+      c1 = compress_lanes(vld1q_s16(a + 16 * i + 8), 4);
+      c0 = vorrq_u16(vuzp1q_u16(c0, c1), vshlq_n_u16(vuzp2q_u16(c0, c1), 4));
+      vst1_u8(r + 8 * i, vmovn_u16(c0));
+    }
+  } else if (d == 5) {
+    for (i = 0; i < KYBER_N / 8; i++) {
+      vst1q_u16(t, compress_lanes(vld1q_s16(a + 8 * i), 5));
+      r[5 * i + 0] = (uint8_t)((t[0] >> 0) | (t[1] << 5));
+      r[5 * i + 1] = (uint8_t)((t[1] >> 3) | (t[2] << 2) | (t[3] << 7));
+      r[5 * i + 2] = (uint8_t)((t[3] >> 1) | (t[4] << 4));
+      r[5 * i + 3] = (uint8_t)((t[4] >> 4) | (t[5] << 1) | (t[6] << 6));
+      r[5 * i + 4] = (uint8_t)((t[6] >> 2) | (t[7] << 3));
+    }
+  }
+}
+
+/*************************************************
+ * Name:        rej_uniform_neon
+ *
+ * Description: Rejection sampling, 8 candidates (12 bytes) per step.
+ *              Accepted lanes of each half are packed with a table
+ *              lookup indexed by the 4-bit acceptance mask; the
+ *              stream is consumed in the same order as the scalar
+ *              rej_uniform(), which handles the tail.
+ *************************************************/
+static const uint8_t rej_windows[16] = {0, 1, 1, 2, 3,  4,  4,  5,
+                                        6, 7, 7, 8, 9, 10, 10, 11};
+static const int16_t rej_shifts[8] = {0, -4, 0, -4, 0, -4, 0, -4};
+static const uint16_t rej_bits[8] = {1, 2, 4, 8, 1, 2, 4, 8};
+
+// Byte indices packing the accepted 16-bit lanes of a 4-lane half
+static const uint8_t rej_pack[16][8] = {
+    {255, 255, 255, 255, 255, 255, 255, 255},
+    {0, 1, 255, 255, 255, 255, 255, 255},
+    {2, 3, 255, 255, 255, 255, 255, 255},
+    {0, 1, 2, 3, 255, 255, 255, 255},
+    {4, 5, 255, 255, 255, 255, 255, 255},
+    {0, 1, 4, 5, 255, 255, 255, 255},
+    {2, 3, 4, 5, 255, 255, 255, 255},
+    {0, 1, 2, 3, 4, 5, 255, 255},
+    {6, 7, 255, 255, 255, 255, 255, 255},
+    {0, 1, 6, 7, 255, 255, 255, 255},
+    {2, 3, 6, 7, 255, 255, 255, 255},
+    {0, 1, 2, 3, 6, 7, 255, 255},
+    {4, 5, 6, 7, 255, 255, 255, 255},
+    {0, 1, 4, 5, 6, 7, 255, 255},
+    {2, 3, 4, 5, 6, 7, 255, 255},
+    {0, 1, 2, 3, 4, 5, 6, 7},
+};
+
+unsigned int rej_uniform_neon(int16_t *r, unsigned int len,
+                              const uint8_t *buf, unsigned int buflen) {
+  const uint8x16_t windows = vld1q_u8(rej_windows);
+  const int16x8_t shifts = vld1q_s16(rej_shifts);
+  const uint16x8_t bits = vld1q_u16(rej_bits);
+  const uint16x8_t q = vdupq_n_u16(KYBER_Q);
+  unsigned int ctr = 0, pos = 0, mlo, mhi, nlo, n;
+  int16_t tmp[8];
+  uint16x8_t v, m;
+  uint8x8_t plo, phi;
+  uint16_t val0, val1;
+
+  // Loads are 16 bytes wide, of which 12 are consumed
+  while (ctr < len && pos + 16 <= buflen) {
+    v = vreinterpretq_u16_u8(vqtbl1q_u8(vld1q_u8(buf + pos), windows));
+    v = vandq_u16(vshlq_u16(v, shifts), vdupq_n_u16(0xFFF));
+    m = vandq_u16(vcltq_u16(v, q), bits);
+    mlo = vaddv_u16(vget_low_u16(m));
+    mhi = vaddv_u16(vget_high_u16(m));
+    pos += 12;
+
+    plo = vtbl1_u8(vreinterpret_u8_u16(vget_low_u16(v)),
+                   vld1_u8(rej_pack[mlo]));
+    phi = vtbl1_u8(vreinterpret_u8_u16(vget_high_u16(v)),
+                   vld1_u8(rej_pack[mhi]));
+    nlo = (unsigned int)__builtin_popcount(mlo);
+    n = nlo + (unsigned int)__builtin_popcount(mhi);
+
+    if (len - ctr >= 8) {
+      vst1_s16(r + ctr, vreinterpret_s16_u8(plo));
+      vst1_s16(r + ctr + nlo, vreinterpret_s16_u8(phi));
+    } else {
+      vst1_s16(tmp, vreinterpret_s16_u8(plo));
+      vst1_s16(tmp + nlo, vreinterpret_s16_u8(phi));
+      if (n > len - ctr)
+        n = len - ctr;
+      memcpy(r + ctr, tmp, n * sizeof(int16_t));
+    }
+    ctr += n;
+  }
+
+  while (ctr < len && pos + 3 <= buflen) {
+    val0 = ((buf[pos + 0] >> 0) | ((uint16_t)buf[pos + 1] << 8)) & 0xFFF;
+    val1 = ((buf[pos + 1] >> 4) | ((uint16_t)buf[pos + 2] << 4)) & 0xFFF;
+    pos += 3;
+
+    if (val0 < KYBER_Q)
+      r[ctr++] = val0;
+    if (ctr < len && val1 < KYBER_Q)
+      r[ctr++] = val1;
+  }
+
+  return ctr;
+}
+
+#endif /* KYBER_HAVE_NEON */
@@ -0,0 +1,490 @@
+/*************************************************
+ * RISC-V Vector (RVV 1.0) Backend
+ *
+ * Every loop is strip-mined with vsetvl, so nothing here assumes a
+ * vector length: at VLEN = 128 a register holds 8 coefficients, at
+ * VLEN = 1024 it holds 64 and the distance 128 layer is a single
+ * butterfly. Layers down to distance 8 work on contiguous runs; the
+ * distance 4 and 2 layers run together on 8-coefficient segments
+ * (vlseg8e16 puts coefficient i of every segment in register i), which
+ * also makes their twiddles plain loads from zetas[]. Montgomery and
+ * Barrett reductions use vmulh, so every result is exactly the scalar
+ * one, including for inputs the KEM never produces.
+ *************************************************/
+
+#include "../include/ntt_rvv.h"
+#include "../include/ntt.h"
+#include "../include/params.h"
+#include <stdint.h>
+
+#if defined(KYBER_HAVE_RVV)
+
+#include <riscv_vector.h>
+
+// montgomery_reduce(a * b); vmulh is the exact high half of a * b
+static inline vint16m1_t fqmul(vint16m1_t a, vint16m1_t b, size_t vl) {
+  vint16m1_t t = __riscv_vmul_vx_i16m1(__riscv_vmul_vv_i16m1(a, b, vl),
+                                       (int16_t)QINV, vl);
+
+  return __riscv_vsub_vv_i16m1(__riscv_vmulh_vv_i16m1(a, b, vl),
+                               __riscv_vmulh_vx_i16m1(t, KYBER_Q, vl), vl);
+}
+
+static inline vint16m1_t fqmul_x(vint16m1_t a, int16_t b, size_t vl) {
+  vint16m1_t t = __riscv_vmul_vx_i16m1(__riscv_vmul_vx_i16m1(a, b, vl),
+                                       (int16_t)QINV, vl);
+
+  return __riscv_vsub_vv_i16m1(__riscv_vmulh_vx_i16m1(a, b, vl),
+                               __riscv_vmulh_vx_i16m1(t, KYBER_Q, vl), vl);
+}
+
+// barrett_reduce(), in the form of barrett_vec()
+static inline vint16m1_t barrett(vint16m1_t a, size_t vl) {
+  vint16m1_t t = __riscv_vmulh_vx_i16m1(a, 20159, vl);
+
+  t = __riscv_vsra_vx_i16m1(__riscv_vadd_vx_i16m1(t, 512, vl), 10, vl);
+  return __riscv_vnmsac_vx_i16m1(a, KYBER_Q, t, vl);
+}
+
+/*************************************************
+ * Segment fields: coefficient i of each 8-coefficient segment
+ *************************************************/
+#define GET8(s, i) __riscv_vget_v_i16m1x8_i16m1(s, i)
+#define SET8(s, i, v) ((s) = __riscv_vset_v_i16m1_i16m1x8(s, i, v))
+
+// Vector types cannot form arrays, so the fields go to c0..c7
+#define LOAD_SEG8(s)                                                           \
+  do {                                                                         \
+    c0 = GET8(s, 0);                                                           \
+    c1 = GET8(s, 1);                                                           \
+    c2 = GET8(s, 2);                                                           \
+    c3 = GET8(s, 3);                                                           \
+    c4 = GET8(s, 4);                                                           \
+    c5 = GET8(s, 5);                                                           \
+    c6 = GET8(s, 6);                                                           \
+    c7 = GET8(s, 7);                                                           \
+  } while (0)
+
+#define STORE_SEG8(s)                                                          \
+  do {                                                                         \
+    SET8(s, 0, c0);                                                            \
+    SET8(s, 1, c1);                                                            \
+    SET8(s, 2, c2);                                                            \
+    SET8(s, 3, c3);                                                            \
+    SET8(s, 4, c4);                                                            \
+    SET8(s, 5, c5);                                                            \
+    SET8(s, 6, c6);                                                            \
+    SET8(s, 7, c7);                                                            \
+  } while (0)
+
+// Forward butterfly on whole registers: x + zeta*y, x - zeta*y
+#define CT(x, y, zeta)                                                         \
+  do {                                                                         \
+    vint16m1_t t_ = fqmul(zeta, y, vl);                                        \
+    y = __riscv_vsub_vv_i16m1(x, t_, vl);                                      \
+    x = __riscv_vadd_vv_i16m1(x, t_, vl);                                      \
+  } while (0)
+
+// Inverse butterfly: barrett(x + y), zeta*(y - x)
+#define GS(x, y, zeta)                                                         \
+  do {                                                                         \
+    vint16m1_t t_ = x;                                                         \
+    x = barrett(__riscv_vadd_vv_i16m1(t_, y, vl), vl);                         \
+    y = fqmul(zeta, __riscv_vsub_vv_i16m1(y, t_, vl), vl);                     \
+  } while (0)
+
+/*************************************************
+ * Name:        ntt_rvv
+ *
+ * Description: Forward NTT, bit-identical to ntt()
+ *************************************************/
+void ntt_rvv(int16_t r[256]) {
+  unsigned int len, start, j, k = 1, s;
+  size_t vl;
+  int16_t zeta;
+  vint16m1_t x, y, z4, z2a, z2b, c0, c1, c2, c3, c4, c5, c6, c7;
+  vint16m1x8_t seg;
+
+  for (len = 128; len >= 8; len >>= 1) {
+    for (start = 0; start < 256; start += 2 * len) {
+      zeta = zetas[k++];
+      for (j = start; j < start + len; j += vl) {
+        vl = __riscv_vsetvl_e16m1(start + len - j);
+        x = __riscv_vle16_v_i16m1(r + j, vl);
+        y = fqmul_x(__riscv_vle16_v_i16m1(r + j + len, vl), zeta, vl);
+        __riscv_vse16_v_i16m1(r + j + len, __riscv_vsub_vv_i16m1(x, y, vl),
+                              vl);
+        __riscv_vse16_v_i16m1(r + j, __riscv_vadd_vv_i16m1(x, y, vl), vl);
+      }
+    }
+  }
+
+  // Distances 4 and 2: segment s uses zetas[32 + s], then
+  // zetas[64 + 2s] and zetas[64 + 2s + 1]
+  for (s = 0; s < 32; s += vl) {
+    vl = __riscv_vsetvl_e16m1(32 - s);
+    seg = __riscv_vlseg8e16_v_i16m1x8(r + 8 * s, vl);
+    z4 = __riscv_vle16_v_i16m1(zetas + 32 + s, vl);
+    z2a = __riscv_vlse16_v_i16m1(zetas + 64 + 2 * s, 4, vl);
+    z2b = __riscv_vlse16_v_i16m1(zetas + 65 + 2 * s, 4, vl);
+    LOAD_SEG8(seg);
+    CT(c0, c4, z4);
+    CT(c1, c5, z4);
+    CT(c2, c6, z4);
+    CT(c3, c7, z4);
+    CT(c0, c2, z2a);
+    CT(c1, c3, z2a);
+    CT(c4, c6, z2b);
+    CT(c5, c7, z2b);
+    STORE_SEG8(seg);
+    __riscv_vsseg8e16_v_i16m1x8(r + 8 * s, seg, vl);
+  }
+}
+
+/*************************************************
+ * Name:        invntt_rvv
+ *
+ * Description: Inverse NTT and multiplication by 2^16, bit-identical
+ *              to invntt()
+ *************************************************/
+void invntt_rvv(int16_t r[256]) {
+  unsigned int len, start, j, k = 31, s;
+  size_t vl;
+  int16_t zeta;
+  const int16_t f = 1441; // mont^2/128
+  vint16m1_t x, y, z4, z2a, z2b, c0, c1, c2, c3, c4, c5, c6, c7;
+  vint16m1x8_t seg;
+
+  // Distances 2 and 4: zetas[127 - 2s] and zetas[126 - 2s], then
+  // zetas[63 - s], read with negative strides
+  for (s = 0; s < 32; s += vl) {
+    vl = __riscv_vsetvl_e16m1(32 - s);
+    seg = __riscv_vlseg8e16_v_i16m1x8(r + 8 * s, vl);
+    z2a = __riscv_vlse16_v_i16m1(zetas + 127 - 2 * s, -4, vl);
+    z2b = __riscv_vlse16_v_i16m1(zetas + 126 - 2 * s, -4, vl);
+    z4 = __riscv_vlse16_v_i16m1(zetas + 63 - s, -2, vl);
+    LOAD_SEG8(seg);
+    GS(c0, c2, z2a);
+    GS(c1, c3, z2a);
+    GS(c4, c6, z2b);
+    GS(c5, c7, z2b);
+    GS(c0, c4, z4);
+    GS(c1, c5, z4);
+    GS(c2, c6, z4);
+    GS(c3, c7, z4);
+    STORE_SEG8(seg);
+    __riscv_vsseg8e16_v_i16m1x8(r + 8 * s, seg, vl);
+  }
+
+  for (len = 8; len <= 128; len <<= 1) {
+    for (start = 0; start < 256; start += 2 * len) {
+      zeta = zetas[k--];
+      for (j = start; j < start + len; j += vl) {
+        vl = __riscv_vsetvl_e16m1(start + len - j);
+        x = __riscv_vle16_v_i16m1(r + j, vl);
+        y = __riscv_vle16_v_i16m1(r + j + len, vl);
+        __riscv_vse16_v_i16m1(
+            r + j, barrett(__riscv_vadd_vv_i16m1(x, y, vl), vl), vl);
+        __riscv_vse16_v_i16m1(
+            r + j + len, fqmul_x(__riscv_vsub_vv_i16m1(y, x, vl), zeta, vl),
+            vl);
+      }
+    }
+  }
+
+  for (j = 0; j < 256; j += vl) {
+    vl = __riscv_vsetvl_e16m1(256 - j);
+    __riscv_vse16_v_i16m1(
+        r + j, fqmul_x(__riscv_vle16_v_i16m1(r + j, vl), f, vl), vl);
+  }
+}
+
+/*************************************************
+ * Name:        basemul_rvv
+ *
+ * Description: Pointwise multiplication in the NTT domain,
+ *              bit-identical to poly_basemul_montgomery(). Each
+ *              4-coefficient segment is two degree-one products, with
+ *              zeta and -zeta.
+ *************************************************/
+void basemul_rvv(int16_t r[256], const int16_t a[256], const int16_t b[256]) {
+  unsigned int s;
+  size_t vl;
+  vint16m1x4_t sa, sb, sr;
+  vint16m1_t zeta, r0, r1;
+
+#define BASEMUL(i0, i1, z)                                                     \
+  do {                                                                         \
+    vint16m1_t a0 = __riscv_vget_v_i16m1x4_i16m1(sa, i0);                      \
+    vint16m1_t a1 = __riscv_vget_v_i16m1x4_i16m1(sa, i1);                      \
+    vint16m1_t b0 = __riscv_vget_v_i16m1x4_i16m1(sb, i0);                      \
+    vint16m1_t b1 = __riscv_vget_v_i16m1x4_i16m1(sb, i1);                      \
+    r0 = fqmul(fqmul(a1, b1, vl), z, vl);                                      \
+    r0 = __riscv_vadd_vv_i16m1(r0, fqmul(a0, b0, vl), vl);                     \
+    r1 = __riscv_vadd_vv_i16m1(fqmul(a0, b1, vl), fqmul(a1, b0, vl), vl);      \
+    sr = __riscv_vset_v_i16m1_i16m1x4(sr, i0, r0);                             \
+    sr = __riscv_vset_v_i16m1_i16m1x4(sr, i1, r1);                             \
+  } while (0)
+
+  for (s = 0; s < 64; s += vl) {
+    vl = __riscv_vsetvl_e16m1(64 - s);
+    sa = __riscv_vlseg4e16_v_i16m1x4(a + 4 * s, vl);
+    sb = __riscv_vlseg4e16_v_i16m1x4(b + 4 * s, vl);
+    sr = sa;
+    zeta = __riscv_vle16_v_i16m1(zetas + 64 + s, vl);
+    BASEMUL(0, 1, zeta);
+    BASEMUL(2, 3, __riscv_vneg_v_i16m1(zeta, vl));
+    __riscv_vsseg4e16_v_i16m1x4(r + 4 * s, sr, vl);
+  }
+#undef BASEMUL
+}
+
+/*************************************************
+ * Name:        reduce_rvv
+ *
+ * Description: Barrett reduction of all coefficients
+ *************************************************/
+void reduce_rvv(int16_t r[256]) {
+  unsigned int j;
+  size_t vl;
+
+  for (j = 0; j < 256; j += vl) {
+    vl = __riscv_vsetvl_e16m1(256 - j);
+    __riscv_vse16_v_i16m1(r + j, barrett(__riscv_vle16_v_i16m1(r + j, vl), vl),
+                          vl);
+  }
+}
+
+/*************************************************
+ * Name:        cbd2_rvv
+ *
+ * Description: CBD with eta = 2 on bytes: each byte gives two
+ *              coefficients, stored interleaved with vsseg2e16
+ *************************************************/
+void cbd2_rvv(int16_t r[256], const uint8_t *buf) {
+  unsigned int i;
+  size_t vl;
+  vuint8m1_t t, d;
+  vint8m1_t lo, hi;
+  vint16m2x2_t out = __riscv_vundefined_i16m2x2();
+
+  for (i = 0; i < KYBER_N / 2; i += vl) {
+    vl = __riscv_vsetvl_e8m1(KYBER_N / 2 - i);
+    t = __riscv_vle8_v_u8m1(buf + i, vl);
+    d = __riscv_vadd_vv_u8m1(__riscv_vand_vx_u8m1(t, 0x55, vl),
+                             __riscv_vand_vx_u8m1(
+                                 __riscv_vsrl_vx_u8m1(t, 1, vl), 0x55, vl),
+                             vl);
+    lo = __riscv_vreinterpret_v_u8m1_i8m1(__riscv_vsub_vv_u8m1(
+        __riscv_vand_vx_u8m1(d, 3, vl),
+        __riscv_vand_vx_u8m1(__riscv_vsrl_vx_u8m1(d, 2, vl), 3, vl), vl));
+    hi = __riscv_vreinterpret_v_u8m1_i8m1(__riscv_vsub_vv_u8m1(
+        __riscv_vand_vx_u8m1(__riscv_vsrl_vx_u8m1(d, 4, vl), 3, vl),
+        __riscv_vsrl_vx_u8m1(d, 6, vl), vl));
+    out = __riscv_vset_v_i16m2_i16m2x2(out, 0, __riscv_vsext_vf2_i16m2(lo, vl));
+    out = __riscv_vset_v_i16m2_i16m2x2(out, 1, __riscv_vsext_vf2_i16m2(hi, vl));
+    __riscv_vsseg2e16_v_i16m2x2(r + 2 * i, out, vl);
+  }
+}
+
+/*************************************************
+ * Name:        cbd3_rvv
+ *
+ * Description: CBD with eta = 3: vlseg3e8 splits the input into the
+ *              three bytes of each 24-bit group, which give four
+ *              coefficients stored with vsseg4e16
+ *************************************************/
+// Coefficient (d >> shift) & 7 - (d >> (shift + 3)) & 7; the
+// difference wraps modulo 2^32 and its low 16 bits are the result
+static inline vint16m1_t cbd3_field(vuint32m2_t d, unsigned int shift,
+                                    size_t vl) {
+  vuint32m2_t a, b;
+
+  a = __riscv_vand_vx_u32m2(__riscv_vsrl_vx_u32m2(d, shift, vl), 7, vl);
+  b = __riscv_vand_vx_u32m2(__riscv_vsrl_vx_u32m2(d, shift + 3, vl), 7, vl);
+  return __riscv_vreinterpret_v_u16m1_i16m1(
+      __riscv_vncvt_x_x_w_u16m1(__riscv_vsub_vv_u32m2(a, b, vl), vl));
+}
+
+void cbd3_rvv(int16_t r[256], const uint8_t *buf) {
+  unsigned int i;
+  size_t vl;
+  vuint8mf2x3_t in;
+  vuint32m2_t t, d;
+  vint16m1x4_t out = __riscv_vundefined_i16m1x4();
+
+  for (i = 0; i < KYBER_N / 4; i += vl) {
+    vl = __riscv_vsetvl_e32m2(KYBER_N / 4 - i);
+    in = __riscv_vlseg3e8_v_u8mf2x3(buf + 3 * i, vl);
+    t = __riscv_vzext_vf4_u32m2(__riscv_vget_v_u8mf2x3_u8mf2(in, 0), vl);
+    t = __riscv_vor_vv_u32m2(
+        t,
+        __riscv_vsll_vx_u32m2(
+            __riscv_vzext_vf4_u32m2(__riscv_vget_v_u8mf2x3_u8mf2(in, 1), vl), 8,
+            vl),
+        vl);
+    t = __riscv_vor_vv_u32m2(
+        t,
+        __riscv_vsll_vx_u32m2(
+            __riscv_vzext_vf4_u32m2(__riscv_vget_v_u8mf2x3_u8mf2(in, 2), vl),
+            16, vl),
+        vl);
+
+    d = __riscv_vand_vx_u32m2(t, 0x00249249, vl);
+    d = __riscv_vadd_vv_u32m2(
+        d,
+        __riscv_vand_vx_u32m2(__riscv_vsrl_vx_u32m2(t, 1, vl), 0x00249249, vl),
+        vl);
+    d = __riscv_vadd_vv_u32m2(
+        d,
+        __riscv_vand_vx_u32m2(__riscv_vsrl_vx_u32m2(t, 2, vl), 0x00249249, vl),
+        vl);
+
+    out = __riscv_vset_v_i16m1_i16m1x4(out, 0, cbd3_field(d, 0, vl));
+    out = __riscv_vset_v_i16m1_i16m1x4(out, 1, cbd3_field(d, 6, vl));
+    out = __riscv_vset_v_i16m1_i16m1x4(out, 2, cbd3_field(d, 12, vl));
+    out = __riscv_vset_v_i16m1_i16m1x4(out, 3, cbd3_field(d, 18, vl));
+    __riscv_vsseg4e16_v_i16m1x4(r + 4 * i, out, vl);
+  }
+}
+
+/*************************************************
+ * Name:        compress_rvv
+ *
+ * Description: Compression to d = 4 or 5 bits per coefficient,
+ *              bit-identical to poly_compress(), with the
+ *              multiply-shift of compress_vec() instead of a division.
+ *              Segment loads group the coefficients that share output
+ *              bytes (2 for d = 4, 8 for d = 5), and d = 5 writes its
+ *              five bytes per group with vsseg5e8.
+ *************************************************/
+static inline vuint16m1_t compress_lanes(vint16m1_t u, int d, size_t vl) {
+  vuint32m2_t w;
+
+  u = __riscv_vadd_vv_i16m1(
+      u,
+      __riscv_vand_vx_i16m1(__riscv_vsra_vx_i16m1(u, 15, vl), KYBER_Q, vl),
+      vl);
+  w = __riscv_vzext_vf2_u32m2(__riscv_vreinterpret_v_i16m1_u16m1(u), vl);
+  if (d == 4) {
+    w = __riscv_vsll_vx_u32m2(w, 4, vl);
+    w = __riscv_vmul_vx_u32m2(__riscv_vadd_vx_u32m2(w, 1665, vl), 80635, vl);
+    w = __riscv_vsrl_vx_u32m2(w, 28, vl);
+  } else {
+    w = __riscv_vsll_vx_u32m2(w, 5, vl);
+    w = __riscv_vmul_vx_u32m2(__riscv_vadd_vx_u32m2(w, 1664, vl), 40318, vl);
+    w = __riscv_vsrl_vx_u32m2(w, 27, vl);
+  }
+  return __riscv_vncvt_x_x_w_u16m1(w, vl);
+}
+
+// Low byte of (x >> sx) | (y << sy) as one output byte
+static inline vuint8mf2_t pack_byte(vuint16m1_t x, unsigned int sx,
+                                    vuint16m1_t y, unsigned int sy,
+                                    size_t vl) {
+  vuint16m1_t t = __riscv_vor_vv_u16m1(__riscv_vsrl_vx_u16m1(x, sx, vl),
+                                       __riscv_vsll_vx_u16m1(y, sy, vl), vl);
+
+  return __riscv_vncvt_x_x_w_u8mf2(t, vl);
+}
+
+void compress_rvv(uint8_t *r, const int16_t a[256], int d) {
+  unsigned int i;
+  size_t vl;
+  vint16m1x2_t s2;
+  vint16m1x8_t s8;
+  vuint16m1_t c0, c1, c2, c3, c4, c5, c6, c7, t;
+  vuint8mf2x5_t out = __riscv_vundefined_u8mf2x5();
+
+  if (d == 4) {
+    for (i = 0; i < KYBER_N / 2; i += vl) {
+      vl = __riscv_vsetvl_e16m1(KYBER_N / 2 - i);
+      s2 = __riscv_vlseg2e16_v_i16m1x2(a + 2 * i, vl);
+      c0 = compress_lanes(__riscv_vget_v_i16m1x2_i16m1(s2, 0), 4, vl);
+      c1 = compress_lanes(__riscv_vget_v_i16m1x2_i16m1(s2, 1), 4, vl);
+      t = __riscv_vor_vv_u16m1(c0, __riscv_vsll_vx_u16m1(c1, 4, vl), vl);
+      __riscv_vse8_v_u8mf2(r + i, __riscv_vncvt_x_x_w_u8mf2(t, vl), vl);
+    }
+  } else if (d == 5) {
+    for (i = 0; i < KYBER_N / 8; i += vl) {
+      vl = __riscv_vsetvl_e16m1(KYBER_N / 8 - i);
+      s8 = __riscv_vlseg8e16_v_i16m1x8(a + 8 * i, vl);
+      c0 = compress_lanes(GET8(s8, 0), 5, vl);
+      c1 = compress_lanes(GET8(s8, 1), 5, vl);
+      c2 = compress_lanes(GET8(s8, 2), 5, vl);
+      c3 = compress_lanes(GET8(s8, 3), 5, vl);
+      c4 = compress_lanes(GET8(s8, 4), 5, vl);
+      c5 = compress_lanes(GET8(s8, 5), 5, vl);
+      c6 = compress_lanes(GET8(s8, 6), 5, vl);
+      c7 = compress_lanes(GET8(s8, 7), 5, vl);
+
+      out = __riscv_vset_v_u8mf2_u8mf2x5(out, 0,
+                                         pack_byte(c0, 0, c1, 5, vl));
+      t = __riscv_vor_vv_u16m1(__riscv_vsrl_vx_u16m1(c1, 3, vl),
+                               __riscv_vsll_vx_u16m1(c2, 2, vl), vl);
+      out = __riscv_vset_v_u8mf2_u8mf2x5(out, 1,
+                                         pack_byte(t, 0, c3, 7, vl));
+      out = __riscv_vset_v_u8mf2_u8mf2x5(out, 2,
+                                         pack_byte(c3, 1, c4, 4, vl));
+      t = __riscv_vor_vv_u16m1(__riscv_vsrl_vx_u16m1(c4, 4, vl),
+                               __riscv_vsll_vx_u16m1(c5, 1, vl), vl);
+      out = __riscv_vset_v_u8mf2_u8mf2x5(out, 3,
+                                         pack_byte(t, 0, c6, 6, vl));
+      out = __riscv_vset_v_u8mf2_u8mf2x5(out, 4,
+                                         pack_byte(c6, 2, c7, 3, vl));
+      __riscv_vsseg5e8_v_u8mf2x5(r + 5 * i, out, vl);
+    }
+  }
+}
+
+/*************************************************
+ * Name:        rej_uniform_rvv
+ *
+ * Description: Rejection sampling, as many 3-byte groups per step as
+ *              the vector length allows. The two 12-bit candidates of
+ *              each group are interleaved by viewing a 32-bit lane as
+ *              two 16-bit ones, then vcompress packs the accepted
+ *              ones in stream order, so the output is that of the
+ *              scalar rej_uniform().
+ *************************************************/
+unsigned int rej_uniform_rvv(int16_t *r, unsigned int len, const uint8_t *buf,
+                             unsigned int buflen) {
+  unsigned int ctr = 0, pos = 0, n;
+  size_t vl;
+  vuint8mf2x3_t in;
+  vuint16m1_t b0, b1, b2, val0, val1;
+  vuint32m2_t w;
+  vuint16m2_t v;
+  vbool8_t m;
+
+  while (ctr < len && pos + 3 <= buflen) {
+    vl = __riscv_vsetvl_e16m1((buflen - pos) / 3);
+    in = __riscv_vlseg3e8_v_u8mf2x3(buf + pos, vl);
+    b0 = __riscv_vzext_vf2_u16m1(__riscv_vget_v_u8mf2x3_u8mf2(in, 0), vl);
+    b1 = __riscv_vzext_vf2_u16m1(__riscv_vget_v_u8mf2x3_u8mf2(in, 1), vl);
+    b2 = __riscv_vzext_vf2_u16m1(__riscv_vget_v_u8mf2x3_u8mf2(in, 2), vl);
+    pos += 3 * (unsigned int)vl;
+
+    val0 = __riscv_vand_vx_u16m1(
+        __riscv_vor_vv_u16m1(b0, __riscv_vsll_vx_u16m1(b1, 8, vl), vl), 0xFFF,
+        vl);
+    val1 = __riscv_vor_vv_u16m1(__riscv_vsrl_vx_u16m1(b1, 4, vl),
+                                __riscv_vsll_vx_u16m1(b2, 4, vl), vl);
+    w = __riscv_vor_vv_u32m2(
+        __riscv_vzext_vf2_u32m2(val0, vl),
+        __riscv_vsll_vx_u32m2(__riscv_vzext_vf2_u32m2(val1, vl), 16, vl), vl);
+    v = __riscv_vreinterpret_v_u32m2_u16m2(w);
+
+    m = __riscv_vmsltu_vx_u16m2_b8(v, KYBER_Q, 2 * vl);
+    v = __riscv_vcompress_vm_u16m2(v, m, 2 * vl);
+    n = (unsigned int)__riscv_vcpop_m_b8(m, 2 * vl);
+    if (n > len - ctr)
+      n = len - ctr;
+    __riscv_vse16_v_i16m2(r + ctr, __riscv_vreinterpret_v_u16m2_i16m2(v), n);
+    ctr += n;
+  }
+
+  return ctr;
+}
+
+#endif /* KYBER_HAVE_RVV */
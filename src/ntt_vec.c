@@ -0,0 +1,398 @@
+/*************************************************
+ * Portable SIMD Backend
+ *
+ * One vector holds 8 coefficients, 128 bits: the register width of
+ * SSE2, NEON, the ESP32-S3 and common RVV configurations (compilers
+ * pair them up on wider units). Layers of the NTT whose butterflies
+ * are at least 8 apart work on whole vectors; the last two layers
+ * (distances 4 and 2) are done on pairs of vectors, 16 coefficients
+ * at a time, after shuffling the two halves of each butterfly into
+ * separate vectors. All arithmetic is the scalar code's, lane by lane.
+ *************************************************/
+
+#include "../include/ntt_vec.h"
+#include "../include/ntt.h"
+#include "../include/params.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(KYBER_HAVE_VEC)
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+typedef int16_t v16 __attribute__((vector_size(16)));
+typedef uint16_t v16u __attribute__((vector_size(16)));
+typedef int32_t v32 __attribute__((vector_size(32)));
+typedef uint32_t v32u __attribute__((vector_size(32)));
+typedef uint8_t v8 __attribute__((vector_size(8)));
+
+#if defined(__clang__) || __GNUC__ >= 12
+#define SHUFFLE(a, b, ...) __builtin_shufflevector(a, b, __VA_ARGS__)
+#else
+#define SHUFFLE(a, b, ...) __builtin_shuffle(a, b, (v16){__VA_ARGS__})
+#endif
+
+#define CVT(x, t) __builtin_convertvector(x, t)
+
+// Lane selections for butterflies at distance 4 and 2 within 16
+// coefficients: LO_n / HI_n pick the two inputs, TO_X_n / TO_Y_n put
+// the results back in place
+#define LO_4 0, 1, 2, 3, 8, 9, 10, 11
+#define HI_4 4, 5, 6, 7, 12, 13, 14, 15
+#define TO_X_4 LO_4
+#define TO_Y_4 HI_4
+#define LO_2 0, 1, 4, 5, 8, 9, 12, 13
+#define HI_2 2, 3, 6, 7, 10, 11, 14, 15
+#define TO_X_2 0, 1, 8, 9, 2, 3, 10, 11
+#define TO_Y_2 4, 5, 12, 13, 6, 7, 14, 15
+#define EVEN 0, 2, 4, 6, 8, 10, 12, 14
+#define ODD 1, 3, 5, 7, 9, 11, 13, 15
+#define ZIP_LO 0, 8, 1, 9, 2, 10, 3, 11
+#define ZIP_HI 4, 12, 5, 13, 6, 14, 7, 15
+
+/*************************************************
+ * Twiddle factors of the last two NTT layers (first two of the
+ * inverse), from zetas[] in the lane order of LO_4 and LO_2: for
+ * each block of 16 coefficients, one vector per layer. Shared with
+ * the intrinsics backends, which use the same data layout.
+ *************************************************/
+const int16_t zetas_ntt_vec[16 * 2 * 8] = {
+    1223, 1223, 1223, 1223, 652,  652,  652,  652,  2226, 2226, 430,  430,
+    555,  555,  843,  843,  2777, 2777, 2777, 2777, 1015, 1015, 1015, 1015,
+    2078, 2078, 871,  871,  1550, 1550, 105,  105,  2036, 2036, 2036, 2036,
+    1491, 1491, 1491, 1491, 422,  422,  587,  587,  177,  177,  3094, 3094,
+    3047, 3047, 3047, 3047, 1785, 1785, 1785, 1785, 3038, 3038, 2869, 2869,
+    1574, 1574, 1653, 1653, 516,  516,  516,  516,  3321, 3321, 3321, 3321,
+    3083, 3083, 778,  778,  1159, 1159, 3182, 3182, 3009, 3009, 3009, 3009,
+    2663, 2663, 2663, 2663, 2552, 2552, 1483, 1483, 2727, 2727, 1119, 1119,
+    1711, 1711, 1711, 1711, 2167, 2167, 2167, 2167, 1739, 1739, 644,  644,
+    2457, 2457, 349,  349,  126,  126,  126,  126,  1469, 1469, 1469, 1469,
+    418,  418,  329,  329,  3173, 3173, 3254, 3254, 2476, 2476, 2476, 2476,
+    3239, 3239, 3239, 3239, 817,  817,  1097, 1097, 603,  603,  610,  610,
+    3058, 3058, 3058, 3058, 830,  830,  830,  830,  1322, 1322, 2044, 2044,
+    1864, 1864, 384,  384,  107,  107,  107,  107,  1908, 1908, 1908, 1908,
+    2114, 2114, 3193, 3193, 1218, 1218, 1994, 1994, 3082, 3082, 3082, 3082,
+    2378, 2378, 2378, 2378, 2455, 2455, 220,  220,  2142, 2142, 1670, 1670,
+    2931, 2931, 2931, 2931, 961,  961,  961,  961,  2144, 2144, 1799, 1799,
+    2051, 2051, 794,  794,  1821, 1821, 1821, 1821, 2604, 2604, 2604, 2604,
+    1819, 1819, 2475, 2475, 2459, 2459, 478,  478,  448,  448,  448,  448,
+    2264, 2264, 2264, 2264, 3221, 3221, 3021, 3021, 996,  996,  991,  991,
+    677,  677,  677,  677,  2054, 2054, 2054, 2054, 958,  958,  1869, 1869,
+    1522, 1522, 1628, 1628};
+
+const int16_t zetas_invntt_vec[16 * 2 * 8] = {
+    1628, 1628, 1522, 1522, 1869, 1869, 958,  958,  2054, 2054, 2054, 2054,
+    677,  677,  677,  677,  991,  991,  996,  996,  3021, 3021, 3221, 3221,
+    2264, 2264, 2264, 2264, 448,  448,  448,  448,  478,  478,  2459, 2459,
+    2475, 2475, 1819, 1819, 2604, 2604, 2604, 2604, 1821, 1821, 1821, 1821,
+    794,  794,  2051, 2051, 1799, 1799, 2144, 2144, 961,  961,  961,  961,
+    2931, 2931, 2931, 2931, 1670, 1670, 2142, 2142, 220,  220,  2455, 2455,
+    2378, 2378, 2378, 2378, 3082, 3082, 3082, 3082, 1994, 1994, 1218, 1218,
+    3193, 3193, 2114, 2114, 1908, 1908, 1908, 1908, 107,  107,  107,  107,
+    384,  384,  1864, 1864, 2044, 2044, 1322, 1322, 830,  830,  830,  830,
+    3058, 3058, 3058, 3058, 610,  610,  603,  603,  1097, 1097, 817,  817,
+    3239, 3239, 3239, 3239, 2476, 2476, 2476, 2476, 3254, 3254, 3173, 3173,
+    329,  329,  418,  418,  1469, 1469, 1469, 1469, 126,  126,  126,  126,
+    349,  349,  2457, 2457, 644,  644,  1739, 1739, 2167, 2167, 2167, 2167,
+    1711, 1711, 1711, 1711, 1119, 1119, 2727, 2727, 1483, 1483, 2552, 2552,
+    2663, 2663, 2663, 2663, 3009, 3009, 3009, 3009, 3182, 3182, 1159, 1159,
+    778,  778,  3083, 3083, 3321, 3321, 3321, 3321, 516,  516,  516,  516,
+    1653, 1653, 1574, 1574, 2869, 2869, 3038, 3038, 1785, 1785, 1785, 1785,
+    3047, 3047, 3047, 3047, 3094, 3094, 177,  177,  587,  587,  422,  422,
+    1491, 1491, 1491, 1491, 2036, 2036, 2036, 2036, 105,  105,  1550, 1550,
+    871,  871,  2078, 2078, 1015, 1015, 1015, 1015, 2777, 2777, 2777, 2777,
+    843,  843,  555,  555,  430,  430,  2226, 2226, 652,  652,  652,  652,
+    1223, 1223, 1223, 1223};
+
+// zetas[64 + i] and -zetas[64 + i] for base multiplication pair 2i, 2i+1
+const int16_t zetas_basemul_vec[128] = {
+    2226,  -2226, 430,   -430,  555,   -555,  843,   -843,  2078,  -2078,
+    871,   -871,  1550,  -1550, 105,   -105,  422,   -422,  587,   -587,
+    177,   -177,  3094,  -3094, 3038,  -3038, 2869,  -2869, 1574,  -1574,
+    1653,  -1653, 3083,  -3083, 778,   -778,  1159,  -1159, 3182,  -3182,
+    2552,  -2552, 1483,  -1483, 2727,  -2727, 1119,  -1119, 1739,  -1739,
+    644,   -644,  2457,  -2457, 349,   -349,  418,   -418,  329,   -329,
+    3173,  -3173, 3254,  -3254, 817,   -817,  1097,  -1097, 603,   -603,
+    610,   -610,  1322,  -1322, 2044,  -2044, 1864,  -1864, 384,   -384,
+    2114,  -2114, 3193,  -3193, 1218,  -1218, 1994,  -1994, 2455,  -2455,
+    220,   -220,  2142,  -2142, 1670,  -1670, 2144,  -2144, 1799,  -1799,
+    2051,  -2051, 794,   -794,  1819,  -1819, 2475,  -2475, 2459,  -2459,
+    478,   -478,  3221,  -3221, 3021,  -3021, 996,   -996,  991,   -991,
+    958,   -958,  1869,  -1869, 1522,  -1522, 1628,  -1628};
+
+static inline v16 load(const int16_t *p) {
+  v16 v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static inline void store(int16_t *p, v16 v) { memcpy(p, &v, sizeof(v)); }
+
+static inline v16 splat(int16_t x) { return (v16){x, x, x, x, x, x, x, x}; }
+
+// High half of the signed 32-bit products. GCC does not spot the
+// pmulhw pattern in vector-extension code, so x86 gets the one builtin;
+// elsewhere (NEON smull/shrn, RVV vmulh) the generic form maps well.
+static inline v16 mulhi(v16 a, v16 b) {
+#if defined(__SSE2__)
+  return (v16)_mm_mulhi_epi16((__m128i)a, (__m128i)b);
+#else
+  return CVT((CVT(a, v32) * CVT(b, v32)) >> 16, v16);
+#endif
+}
+
+static inline v16 mullo(v16 a, v16 b) { return (v16)((v16u)a * (v16u)b); }
+
+/*************************************************
+ * montgomery_reduce(a * b). The low 16 bits of a * b and t * q are
+ * equal, so the difference of the high halves is exactly the scalar
+ * (a * b - t * q) >> 16 and no 32-bit lane arithmetic is needed.
+ *************************************************/
+static inline v16 fqmul_vec(v16 a, v16 b) {
+  v16 t = mullo(mullo(a, b), splat(QINV));
+
+  return mulhi(a, b) - mulhi(t, splat(KYBER_Q));
+}
+
+// barrett_reduce(); (a * v + 2^25) >> 26 == ((a * v >> 16) + 2^9) >> 10
+static inline v16 barrett_vec(v16 a) {
+  const int16_t v = ((1 << 26) + KYBER_Q / 2) / KYBER_Q;
+  v16 t = (mulhi(a, splat(v)) + (1 << 9)) >> 10;
+
+  return a - mullo(t, splat(KYBER_Q));
+}
+
+#define NTT_LAYER(x, y, n, zp)                                                 \
+  do {                                                                         \
+    v16 lo_ = SHUFFLE(x, y, LO_##n), hi_ = SHUFFLE(x, y, HI_##n);              \
+    v16 t_ = fqmul_vec(load(zp), hi_);                                         \
+    hi_ = lo_ - t_;                                                            \
+    lo_ = lo_ + t_;                                                            \
+    x = SHUFFLE(lo_, hi_, TO_X_##n);                                           \
+    y = SHUFFLE(lo_, hi_, TO_Y_##n);                                           \
+  } while (0)
+
+#define INVNTT_LAYER(x, y, n, zp)                                              \
+  do {                                                                         \
+    v16 lo_ = SHUFFLE(x, y, LO_##n), hi_ = SHUFFLE(x, y, HI_##n);              \
+    v16 t_ = lo_;                                                              \
+    lo_ = barrett_vec(t_ + hi_);                                               \
+    hi_ = fqmul_vec(load(zp), hi_ - t_);                                       \
+    x = SHUFFLE(lo_, hi_, TO_X_##n);                                           \
+    y = SHUFFLE(lo_, hi_, TO_Y_##n);                                           \
+  } while (0)
+
+/*************************************************
+ * Name:        ntt_vec
+ *
+ * Description: Forward NTT, bit-identical to ntt()
+ *************************************************/
+void ntt_vec(int16_t r[256]) {
+  unsigned int len, start, j, k = 1;
+  const int16_t *zp = zetas_ntt_vec;
+  v16 zeta, t, x, y;
+
+  for (len = 128; len >= 8; len >>= 1) {
+    for (start = 0; start < 256; start += 2 * len) {
+      zeta = splat(zetas[k++]);
+      for (j = start; j < start + len; j += 8) {
+        x = load(r + j);
+        t = fqmul_vec(zeta, load(r + j + len));
+        store(r + j + len, x - t);
+        store(r + j, x + t);
+      }
+    }
+  }
+
+  // Distances 4 and 2 stay within a block of 16 coefficients
+  for (j = 0; j < 256; j += 16, zp += 16) {
+    x = load(r + j);
+    y = load(r + j + 8);
+    NTT_LAYER(x, y, 4, zp);
+    NTT_LAYER(x, y, 2, zp + 8);
+    store(r + j, x);
+    store(r + j + 8, y);
+  }
+}
+
+/*************************************************
+ * Name:        invntt_vec
+ *
+ * Description: Inverse NTT and multiplication by 2^16, bit-identical
+ *              to invntt()
+ *************************************************/
+void invntt_vec(int16_t r[256]) {
+  unsigned int len, start, j, k = 31;
+  const int16_t *zp = zetas_invntt_vec;
+  const v16 f = splat(1441); // mont^2/128
+  v16 zeta, t, x, y;
+
+  for (j = 0; j < 256; j += 16, zp += 16) {
+    x = load(r + j);
+    y = load(r + j + 8);
+    INVNTT_LAYER(x, y, 2, zp);
+    INVNTT_LAYER(x, y, 4, zp + 8);
+    store(r + j, x);
+    store(r + j + 8, y);
+  }
+
+  for (len = 8; len <= 128; len <<= 1) {
+    for (start = 0; start < 256; start += 2 * len) {
+      zeta = splat(zetas[k--]);
+      for (j = start; j < start + len; j += 8) {
+        t = load(r + j);
+        x = load(r + j + len);
+        store(r + j, barrett_vec(t + x));
+        store(r + j + len, fqmul_vec(zeta, x - t));
+      }
+    }
+  }
+
+  for (j = 0; j < 256; j += 8)
+    store(r + j, fqmul_vec(load(r + j), f));
+}
+
+/*************************************************
+ * Name:        basemul_vec
+ *
+ * Description: Pointwise multiplication in the NTT domain,
+ *              bit-identical to poly_basemul_montgomery()
+ *************************************************/
+void basemul_vec(int16_t r[256], const int16_t a[256], const int16_t b[256]) {
+  unsigned int j;
+  v16 x, y, a0, a1, b0, b1, r0, r1;
+
+  for (j = 0; j < 256; j += 16) {
+    // Split 8 pairs into their even and odd coefficients
+    x = load(a + j);
+    y = load(a + j + 8);
+    a0 = SHUFFLE(x, y, EVEN);
+    a1 = SHUFFLE(x, y, ODD);
+    x = load(b + j);
+    y = load(b + j + 8);
+    b0 = SHUFFLE(x, y, EVEN);
+    b1 = SHUFFLE(x, y, ODD);
+
+    r0 = fqmul_vec(fqmul_vec(a1, b1), load(zetas_basemul_vec + j / 2));
+    r0 += fqmul_vec(a0, b0);
+    r1 = fqmul_vec(a0, b1);
+    r1 += fqmul_vec(a1, b0);
+
+    store(r + j, SHUFFLE(r0, r1, ZIP_LO));
+    store(r + j + 8, SHUFFLE(r0, r1, ZIP_HI));
+  }
+}
+
+/*************************************************
+ * Name:        reduce_vec
+ *
+ * Description: Barrett reduction of all coefficients
+ *************************************************/
+void reduce_vec(int16_t r[256]) {
+  unsigned int j;
+
+  for (j = 0; j < 256; j += 8)
+    store(r + j, barrett_vec(load(r + j)));
+}
+
+/*************************************************
+ * Name:        cbd2_vec
+ *
+ * Description: CBD with eta = 2. Each byte gives two coefficients,
+ *              so 8 bytes widened to 16-bit lanes give 16 with
+ *              uniform shifts only.
+ *************************************************/
+void cbd2_vec(int16_t r[256], const uint8_t *buf) {
+  const v16u m = (v16u){0} + 0x55;
+  unsigned int i;
+  v8 b;
+  v16u t, d;
+  v16 lo, hi;
+
+  for (i = 0; i < KYBER_N / 16; i++) {
+    memcpy(&b, buf + 8 * i, sizeof(b));
+    t = CVT(b, v16u);
+    d = (t & m) + ((t >> 1) & m);
+    lo = (v16)(d & 3) - (v16)((d >> 2) & 3);
+    hi = (v16)((d >> 4) & 3) - (v16)((d >> 6) & 3);
+    store(r + 16 * i, SHUFFLE(lo, hi, ZIP_LO));
+    store(r + 16 * i + 8, SHUFFLE(lo, hi, ZIP_HI));
+  }
+}
+
+/*************************************************
+ * Name:        cbd3_vec
+ *
+ * Description: CBD with eta = 3. Every lane takes the 16-bit window
+ *              holding its 6 input bits (bit offsets 0, 6, 12, 18 of
+ *              a 3-byte group) and moves them to the top with a
+ *              multiplication, so the shifts stay uniform.
+ *************************************************/
+void cbd3_vec(int16_t r[256], const uint8_t *buf) {
+  const v16u m = (v16u){0} + 0x9;
+  const v16u up = {1 << 10, 1 << 4, 1 << 6, 1 << 8,
+                   1 << 10, 1 << 4, 1 << 6, 1 << 8};
+  unsigned int i, j;
+  uint16_t w[8];
+  const uint8_t *p;
+  v16u t, d;
+
+  for (i = 0; i < KYBER_N / 8; i++) {
+    p = buf + 6 * i;
+    for (j = 0; j < 2; j++, p += 3) {
+      w[4 * j + 0] = (uint16_t)(p[0] | p[1] << 8);
+      w[4 * j + 1] = (uint16_t)(p[0] | p[1] << 8);
+      w[4 * j + 2] = (uint16_t)(p[1] | p[2] << 8);
+      w[4 * j + 3] = (uint16_t)(p[2]);
+    }
+    memcpy(&t, w, sizeof(t));
+    t = (t * up) >> 10;
+    d = (t & m) + ((t >> 1) & m) + ((t >> 2) & m);
+    store(r + 8 * i, (v16)(d & 7) - (v16)((d >> 3) & 7));
+  }
+}
+
+/*************************************************
+ * Name:        compress_vec
+ *
+ * Description: Compression to d = 4 or 5 bits per coefficient,
+ *              bit-identical to poly_compress(). The rounded division
+ *              by q is a multiplication and shift, exact for all
+ *              inputs in [0, q), so no divide instruction is used.
+ *************************************************/
+void compress_vec(uint8_t *r, const int16_t a[256], int d) {
+  unsigned int i, j;
+  uint16_t t[8];
+  v16 u;
+  v16u c[2];
+  v8 packed;
+
+  if (d == 4) {
+    for (i = 0; i < KYBER_N / 16; i++) {
+      for (j = 0; j < 2; j++) {
+        u = load(a + 16 * i + 8 * j);
+        u += (u >> 15) & KYBER_Q;
+        c[j] = CVT((((CVT(u, v32u) << 4) + 1665) * 80635) >> 28, v16u) & 15;
+      }
+      packed = CVT(SHUFFLE(c[0], c[1], EVEN) | (SHUFFLE(c[0], c[1], ODD) << 4),
+                   v8);
+      memcpy(r + 8 * i, &packed, sizeof(packed));
+    }
+  } else if (d == 5) {
+    for (i = 0; i < KYBER_N / 8; i++) {
+      u = load(a + 8 * i);
+      u += (u >> 15) & KYBER_Q;
+      c[0] = CVT((((CVT(u, v32u) << 5) + 1664) * 40318) >> 27, v16u) & 31;
+      memcpy(t, &c[0], sizeof(t));
+      r[5 * i + 0] = (uint8_t)((t[0] >> 0) | (t[1] << 5));
+      r[5 * i + 1] = (uint8_t)((t[1] >> 3) | (t[2] << 2) | (t[3] << 7));
+      r[5 * i + 2] = (uint8_t)((t[3] >> 1) | (t[4] << 4));
+      r[5 * i + 3] = (uint8_t)((t[4] >> 4) | (t[5] << 1) | (t[6] << 6));
+      r[5 * i + 4] = (uint8_t)((t[6] >> 2) | (t[7] << 3));
+    }
+  }
+}
+
+#endif /* KYBER_HAVE_VEC */
@@ -5,6 +5,18 @@
 #include "../include/poly.h"
 #include "../include/fips202.h"
 #include "../include/ntt.h"
+#if defined(KYBER_AUTOTUNE)
+#include "../include/kyber_tune.h"
+#endif
+#if defined(KYBER_BACKEND_NEON)
+#include "../include/ntt_neon.h"
+#elif defined(KYBER_BACKEND_RVV)
+#include "../include/ntt_rvv.h"
+#elif defined(KYBER_BACKEND_M4)
+#include "../include/ntt_m4.h"
+#elif defined(KYBER_BACKEND_VEC)
+#include "../include/ntt_vec.h"
+#endif
 #include "../include/params.h"
 #include <stdint.h>
 #include <string.h>
@@ -57,9 +69,21 @@ void poly_sub(poly *r, const poly *a, const poly *b) {
  * Arguments:   - poly *r: pointer to polynomial to be reduced
  *************************************************/
 void poly_reduce(poly *r) {
+#if defined(KYBER_AUTOTUNE)
+  kyber_tuned.reduce(r->coeffs);
+#elif defined(KYBER_BACKEND_NEON)
+  reduce_neon(r->coeffs);
+#elif defined(KYBER_BACKEND_RVV)
+  reduce_rvv(r->coeffs);
+#elif defined(KYBER_BACKEND_M4)
+  reduce_m4(r->coeffs);
+#elif defined(KYBER_BACKEND_VEC)
+  reduce_vec(r->coeffs);
+#else
   unsigned int i;
   for (i = 0; i < KYBER_N; i++)
     r->coeffs[i] = barrett_reduce(r->coeffs[i]);
+#endif
 }
 
 /*************************************************
@@ -70,7 +94,19 @@ void poly_reduce(poly *r) {
  * Arguments:   - poly *r: pointer to polynomial
  *************************************************/
 void poly_ntt(poly *r) {
+#if defined(KYBER_AUTOTUNE)
+  kyber_tuned.ntt(r->coeffs);
+#elif defined(KYBER_BACKEND_NEON)
+  ntt_neon(r->coeffs);
+#elif defined(KYBER_BACKEND_RVV)
+  ntt_rvv(r->coeffs);
+#elif defined(KYBER_BACKEND_M4)
+  ntt_m4(r->coeffs);
+#elif defined(KYBER_BACKEND_VEC)
+  ntt_vec(r->coeffs);
+#else
   ntt(r->coeffs);
+#endif
   poly_reduce(r);
 }
 
@@ -81,7 +117,21 @@ void poly_ntt(poly *r) {
  *
  * Arguments:   - poly *r: pointer to polynomial
  *************************************************/
-void poly_invntt(poly *r) { invntt(r->coeffs); }
+void poly_invntt(poly *r) {
+#if defined(KYBER_AUTOTUNE)
+  kyber_tuned.invntt(r->coeffs);
+#elif defined(KYBER_BACKEND_NEON)
+  invntt_neon(r->coeffs);
+#elif defined(KYBER_BACKEND_RVV)
+  invntt_rvv(r->coeffs);
+#elif defined(KYBER_BACKEND_M4)
+  invntt_m4(r->coeffs);
+#elif defined(KYBER_BACKEND_VEC)
+  invntt_vec(r->coeffs);
+#else
+  invntt(r->coeffs);
+#endif
+}
 
 /*************************************************
  * Name:        poly_basemul_montgomery
@@ -93,6 +143,17 @@ void poly_invntt(poly *r) { invntt(r->coeffs); }
  *              - const poly *b: pointer to second input polynomial
  *************************************************/
 void poly_basemul_montgomery(poly *r, const poly *a, const poly *b) {
+#if defined(KYBER_AUTOTUNE)
+  kyber_tuned.basemul(r->coeffs, a->coeffs, b->coeffs);
+#elif defined(KYBER_BACKEND_NEON)
+  basemul_neon(r->coeffs, a->coeffs, b->coeffs);
+#elif defined(KYBER_BACKEND_RVV)
+  basemul_rvv(r->coeffs, a->coeffs, b->coeffs);
+#elif defined(KYBER_BACKEND_M4)
+  basemul_m4(r->coeffs, a->coeffs, b->coeffs);
+#elif defined(KYBER_BACKEND_VEC)
+  basemul_vec(r->coeffs, a->coeffs, b->coeffs);
+#else
   unsigned int i;
   for (i = 0; i < KYBER_N / 4; i++) {
     basemul(&r->coeffs[4 * i], &a->coeffs[4 * i], &b->coeffs[4 * i],
@@ -100,6 +161,7 @@ void poly_basemul_montgomery(poly *r, const poly *a, const poly *b) {
     basemul(&r->coeffs[4 * i + 2], &a->coeffs[4 * i + 2], &b->coeffs[4 * i + 2],
             -zetas[64 + i]);
   }
+#endif
 }
 
 /*************************************************
@@ -169,6 +231,13 @@ void poly_frombytes(poly *r, const uint8_t *a) {
  *              - int d: number of bits per coefficient
  *************************************************/
 void poly_compress(uint8_t *r, const poly *a, int d) {
+#if defined(KYBER_BACKEND_NEON)
+  compress_neon(r, a->coeffs, d);
+#elif defined(KYBER_BACKEND_RVV)
+  compress_rvv(r, a->coeffs, d);
+#elif defined(KYBER_BACKEND_VEC)
+  compress_vec(r, a->coeffs, d);
+#else
   unsigned int i, j;
   int16_t u;
   uint8_t t[8];
@@ -196,6 +265,7 @@ void poly_compress(uint8_t *r, const poly *a, int d) {
       r[5 * i + 4] = (t[6] >> 2) | (t[7] << 3);
     }
   }
+#endif
 }
 
 /*************************************************
@@ -237,15 +307,8 @@ void poly_decompress(poly *r, const uint8_t *a, int d) {
  * Centered Binomial Distribution (CBD) sampling
  *************************************************/
 
-// Helper to load 3 bytes as uint32
-static uint32_t load24_littleendian(const uint8_t x[3]) {
-  uint32_t r;
-  r = (uint32_t)x[0];
-  r |= (uint32_t)x[1] << 8;
-  r |= (uint32_t)x[2] << 16;
-  return r;
-}
-
+#if !defined(KYBER_BACKEND_VEC) && !defined(KYBER_BACKEND_NEON) &&            \
+    !defined(KYBER_BACKEND_RVV)
 // Helper to load 4 bytes as uint32
 static uint32_t load32_littleendian(const uint8_t x[4]) {
   uint32_t r;
@@ -279,6 +342,16 @@ static void cbd2(poly *r, const uint8_t buf[2 * KYBER_N / 4]) {
   }
 }
 
+#if KYBER_ETA1 == 3
+// Helper to load 3 bytes as uint32
+static uint32_t load24_littleendian(const uint8_t x[3]) {
+  uint32_t r;
+  r = (uint32_t)x[0];
+  r |= (uint32_t)x[1] << 8;
+  r |= (uint32_t)x[2] << 16;
+  return r;
+}
+
 /*************************************************
  * Name:        cbd3
  *
@@ -302,6 +375,8 @@ static void cbd3(poly *r, const uint8_t buf[3 * KYBER_N / 4]) {
     }
   }
 }
+#endif
+#endif /* !KYBER_BACKEND_VEC && !KYBER_BACKEND_NEON && !KYBER_BACKEND_RVV */
 
 /*************************************************
  * Name:        poly_cbd_eta1
@@ -309,7 +384,19 @@ static void cbd3(poly *r, const uint8_t buf[3 * KYBER_N / 4]) {
  * Description: Sample polynomial from CBD with eta1
  *************************************************/
 void poly_cbd_eta1(poly *r, const uint8_t *buf) {
-#if KYBER_ETA1 == 2
+#if KYBER_ETA1 == 2 && defined(KYBER_BACKEND_NEON)
+  cbd2_neon(r->coeffs, buf);
+#elif KYBER_ETA1 == 3 && defined(KYBER_BACKEND_NEON)
+  cbd3_neon(r->coeffs, buf);
+#elif KYBER_ETA1 == 2 && defined(KYBER_BACKEND_RVV)
+  cbd2_rvv(r->coeffs, buf);
+#elif KYBER_ETA1 == 3 && defined(KYBER_BACKEND_RVV)
+  cbd3_rvv(r->coeffs, buf);
+#elif KYBER_ETA1 == 2 && defined(KYBER_BACKEND_VEC)
+  cbd2_vec(r->coeffs, buf);
+#elif KYBER_ETA1 == 3 && defined(KYBER_BACKEND_VEC)
+  cbd3_vec(r->coeffs, buf);
+#elif KYBER_ETA1 == 2
   cbd2(r, buf);
 #elif KYBER_ETA1 == 3
   cbd3(r, buf);
@@ -324,7 +411,13 @@ void poly_cbd_eta1(poly *r, const uint8_t *buf) {
  * Description: Sample polynomial from CBD with eta2
  *************************************************/
 void poly_cbd_eta2(poly *r, const uint8_t *buf) {
-#if KYBER_ETA2 == 2
+#if KYBER_ETA2 == 2 && defined(KYBER_BACKEND_NEON)
+  cbd2_neon(r->coeffs, buf);
+#elif KYBER_ETA2 == 2 && defined(KYBER_BACKEND_RVV)
+  cbd2_rvv(r->coeffs, buf);
+#elif KYBER_ETA2 == 2 && defined(KYBER_BACKEND_VEC)
+  cbd2_vec(r->coeffs, buf);
+#elif KYBER_ETA2 == 2
   cbd2(r, buf);
 #else
 #error "Invalid KYBER_ETA2"
@@ -345,7 +438,7 @@ void poly_getnoise_eta1(poly *r, const uint8_t seed[KYBER_SYMBYTES],
   memcpy(extkey, seed, KYBER_SYMBYTES);
   extkey[KYBER_SYMBYTES] = nonce;
 
-  shake256(buf, sizeof(buf), extkey, sizeof(extkey));
+  shake256_33(buf, sizeof(buf), extkey);
   poly_cbd_eta1(r, buf);
 }
 
@@ -363,6 +456,6 @@ void poly_getnoise_eta2(poly *r, const uint8_t seed[KYBER_SYMBYTES],
   memcpy(extkey, seed, KYBER_SYMBYTES);
   extkey[KYBER_SYMBYTES] = nonce;
 
-  shake256(buf, sizeof(buf), extkey, sizeof(extkey));
+  shake256_33(buf, sizeof(buf), extkey);
   poly_cbd_eta2(r, buf);
 }
@@ -110,7 +110,7 @@ void polyvec_frombytes(polyvec *r, const uint8_t *a) {
  *************************************************/
 void polyvec_compress(uint8_t *r, const polyvec *a) {
   unsigned int i, j, k;
-  uint16_t t[4];
+  uint16_t t[8];
 
 #if (KYBER_DU == 10)
   for (i = 0; i < KYBER_K; i++) {
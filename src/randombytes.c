@@ -5,7 +5,8 @@
  *   - STM32 (using HAL RNG peripheral)
  *   - ESP32 (using hardware RNG)
  *   - nRF52 (using cryptocell or TRNG)
- *   - Desktop (using OS random for production, LFSR for testing)
+ *   - Linux (per-thread SHAKE256 DRBG seeded from getrandom)
+ *   - Other desktop/generic (LFSR, testing only)
  *************************************************/
 
 #include "../include/randombytes.h"
@@ -14,20 +15,45 @@
 
 /*************************************************
  * STM32 Implementation
- * Requires: STM32 HAL with RNG enabled
+ * Requires: STM32 HAL with RNG enabled (and the RNG interrupt
+ * when built with KYBER_ENTROPY_RING)
  *************************************************/
 #if defined(KYBER_PLATFORM_STM32)
 
+#include "../include/utils.h"
 #include "stm32f4xx_hal.h" // Adjust for your STM32 family
 
 extern RNG_HandleTypeDef hrng; // Must be initialized in main.c
 
-int randombytes(uint8_t *out, size_t len) {
+#define RNG_TRIES 3 // per word, resetting the peripheral in between
+
+// Seed or clock error: the reference manual's recovery is to
+// re-initialise the peripheral, which also clears the error flags
+static int rng_recover(void) {
+  HAL_RNG_DeInit(&hrng);
+  return (HAL_RNG_Init(&hrng) == HAL_OK) ? 0 : -1;
+}
+
+static int rng_word(uint32_t *w) {
+  int t;
+
+  for (t = 0; t < RNG_TRIES; t++) {
+    if (HAL_RNG_GenerateRandomNumber(&hrng, w) == HAL_OK)
+      return 0;
+    if (rng_recover() != 0)
+      break;
+  }
+  return -1;
+}
+
+// Fills all of out or, on a persistent fault, none of it
+static int rng_poll(uint8_t *out, size_t len) {
   uint32_t random_word;
   size_t i = 0;
 
   while (i < len) {
-    if (HAL_RNG_GenerateRandomNumber(&hrng, &random_word) != HAL_OK) {
+    if (rng_word(&random_word) != 0) {
+      secure_zero(out, len);
       return -1;
     }
 
@@ -41,6 +67,90 @@ int randombytes(uint8_t *out, size_t len) {
   return 0;
 }
 
+#if defined(KYBER_ENTROPY_RING)
+
+#include "../include/entropy_ring.h"
+
+static uint8_t entropy_storage[KYBER_ENTROPY_RING_BYTES];
+kyber_entropy_ring kyber_entropy =
+    KYBER_ENTROPY_RING_INIT(entropy_storage, KYBER_ENTROPY_RING_BYTES);
+
+static atomic_int entropy_started = 0;
+static atomic_int entropy_armed = 0; // An RNG interrupt is pending
+static atomic_int entropy_fault = 0;
+
+// Request the next word unless a request is already outstanding
+static void entropy_arm(void) {
+  if (kyber_entropy_ring_space(&kyber_entropy) >= 4 &&
+      !atomic_exchange(&entropy_armed, 1)) {
+    if (HAL_RNG_GenerateRandomNumber_IT(&hrng) != HAL_OK)
+      atomic_store(&entropy_armed, 0);
+  }
+}
+
+void kyber_entropy_stm32_start(void) {
+  atomic_store(&entropy_started, 1);
+  entropy_arm();
+}
+
+// RNG data-ready interrupt: store the word, re-arm while there is room
+void HAL_RNG_ReadyDataCallback(RNG_HandleTypeDef *h, uint32_t random32bit) {
+  uint8_t w[4];
+
+  w[0] = (uint8_t)random32bit;
+  w[1] = (uint8_t)(random32bit >> 8);
+  w[2] = (uint8_t)(random32bit >> 16);
+  w[3] = (uint8_t)(random32bit >> 24);
+  kyber_entropy_ring_push(&kyber_entropy, w, 4);
+
+  if (kyber_entropy_ring_space(&kyber_entropy) < 4 ||
+      HAL_RNG_GenerateRandomNumber_IT(h) != HAL_OK)
+    atomic_store(&entropy_armed, 0);
+}
+
+// Seed or clock error: stop prefetching until randombytes() has
+// recovered the peripheral
+void HAL_RNG_ErrorCallback(RNG_HandleTypeDef *h) {
+  (void)h;
+  atomic_store(&entropy_fault, 1);
+  atomic_store(&entropy_armed, 0);
+}
+
+int randombytes(uint8_t *out, size_t len) {
+  uint8_t *start = out;
+  size_t total = len, n;
+
+  if (!atomic_load(&entropy_started))
+    return rng_poll(out, len);
+
+  // Normally satisfied from the ring at once; if it ran dry, wait
+  // for the interrupt to deliver the rest
+  while (len > 0) {
+    n = kyber_entropy_ring_pop(&kyber_entropy, out, len);
+    out += n;
+    len -= n;
+    if (len > 0 && atomic_load(&entropy_fault)) {
+      // The interrupt will not come: poll the rest (rng_poll resets
+      // the peripheral), and prefetch again once a word was read
+      if (rng_poll(out, len) != 0) {
+        secure_zero(start, total);
+        return -1;
+      }
+      atomic_store(&entropy_fault, 0);
+      len = 0;
+    }
+    entropy_arm();
+  }
+
+  return 0;
+}
+
+#else
+
+int randombytes(uint8_t *out, size_t len) { return rng_poll(out, len); }
+
+#endif
+
 /*************************************************
  * ESP32 Implementation
  * Uses hardware RNG (no additional setup needed)
@@ -56,21 +166,219 @@ int randombytes(uint8_t *out, size_t len) {
 
 /*************************************************
  * nRF52 Implementation
- * Uses nRF5 SDK RNG or CryptoCell
+ * Uses nRF5 SDK RNG or CryptoCell; with KYBER_ENTROPY_RING the
+ * main loop / idle hook prefetches via kyber_entropy_nrf52_idle()
  *************************************************/
 #elif defined(KYBER_PLATFORM_NRF52)
 
+#include "../include/utils.h"
 #include "nrf_crypto_rng.h"
 
+#if defined(KYBER_ENTROPY_RING)
+
+#include "../include/entropy_ring.h"
+
+static uint8_t entropy_storage[KYBER_ENTROPY_RING_BYTES];
+kyber_entropy_ring kyber_entropy =
+    KYBER_ENTROPY_RING_INIT(entropy_storage, KYBER_ENTROPY_RING_BYTES);
+
+void kyber_entropy_nrf52_idle(void) {
+  uint8_t chunk[32];
+  size_t n;
+
+  while ((n = kyber_entropy_ring_space(&kyber_entropy)) > 0) {
+    if (n > sizeof(chunk))
+      n = sizeof(chunk);
+    if (nrf_crypto_rng_vector_generate(chunk, n) != NRF_SUCCESS)
+      break;
+    kyber_entropy_ring_push(&kyber_entropy, chunk, n);
+  }
+  secure_zero(chunk, sizeof(chunk));
+}
+
 int randombytes(uint8_t *out, size_t len) {
-  ret_code_t ret = nrf_crypto_rng_vector_generate(out, len);
-  return (ret == NRF_SUCCESS) ? 0 : -1;
+  size_t n = kyber_entropy_ring_pop(&kyber_entropy, out, len);
+
+  // Generate synchronously only what the idle task has not prefetched
+  if (n == len)
+    return 0;
+  if (nrf_crypto_rng_vector_generate(out + n, len - n) != NRF_SUCCESS) {
+    secure_zero(out, len);
+    return -1;
+  }
+  return 0;
+}
+
+#else
+
+int randombytes(uint8_t *out, size_t len) {
+  if (nrf_crypto_rng_vector_generate(out, len) != NRF_SUCCESS) {
+    secure_zero(out, len);
+    return -1;
+  }
+  return 0;
+}
+
+#endif
+
+/*************************************************
+ * Linux Implementation
+ * Per-thread SHAKE256 DRBG with fast key erasure. Every refill
+ * expands the current 32-byte key into a new key followed by a buffer
+ * of output, so the old key is gone before any of its output is used
+ * and a later state compromise reveals nothing already handed out.
+ * Served bytes are wiped from the buffer.
+ *
+ * Threads never share state; the kernel is only entered to seed and
+ * reseed (every DRBG_RESEED_BYTES bytes and after fork()).
+ *
+ * Define KYBER_RANDOMBYTES_LFSR to use the LFSR below instead.
+ *************************************************/
+#elif defined(__linux__) && !defined(KYBER_RANDOMBYTES_LFSR)
+
+#include "../include/fips202.h"
+#include "../include/utils.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <sys/random.h>
+
+#define DRBG_KEYBYTES 32
+#define DRBG_POOLBYTES (8 * SHAKE256_RATE) // key followed by output buffer
+#define DRBG_RESEED_BYTES (1u << 20)
+
+enum { DRBG_UNSEEDED = 0, DRBG_SEEDED, DRBG_DETERMINISTIC };
+
+typedef struct {
+  uint8_t pool[DRBG_POOLBYTES]; // pool[0..31] is the key
+  size_t pos;                   // next unserved byte of pool
+  size_t since_reseed;          // bytes served since the last reseed
+  unsigned int generation;      // fork_generation at the last reseed
+  int mode;
+} drbg_state;
+
+static _Thread_local drbg_state drbg;
+
+// Bumped in the child after every fork() so inherited states reseed
+static atomic_uint fork_generation = 1;
+static pthread_once_t drbg_once = PTHREAD_ONCE_INIT;
+static pthread_key_t drbg_key;
+static int drbg_key_valid = 0;
+
+static void drbg_atfork_child(void) {
+  atomic_fetch_add_explicit(&fork_generation, 1, memory_order_relaxed);
+}
+
+static void drbg_thread_exit(void *p) { secure_zero(p, sizeof(drbg_state)); }
+
+static void drbg_global_init(void) {
+  pthread_atfork(NULL, NULL, drbg_atfork_child);
+  drbg_key_valid = (pthread_key_create(&drbg_key, drbg_thread_exit) == 0);
+}
+
+static int os_getrandom(uint8_t *out, size_t len) {
+  ssize_t r;
+
+  while (len > 0) {
+    r = getrandom(out, len, 0);
+    if (r < 0) {
+      if (errno == EINTR)
+        continue;
+      return -1;
+    }
+    out += r;
+    len -= (size_t)r;
+  }
+  return 0;
+}
+
+// key' || buffer = SHAKE256(key)
+static void drbg_refill(void) {
+  uint8_t key[DRBG_KEYBYTES];
+
+  memcpy(key, drbg.pool, DRBG_KEYBYTES);
+  shake256(drbg.pool, DRBG_POOLBYTES, key, DRBG_KEYBYTES);
+  secure_zero(key, DRBG_KEYBYTES);
+  drbg.pos = DRBG_KEYBYTES;
+}
+
+// key = SHAKE256(key || getrandom(32)); discards buffered output
+static int drbg_reseed(void) {
+  uint8_t in[2 * DRBG_KEYBYTES];
+
+  memcpy(in, drbg.pool, DRBG_KEYBYTES);
+  if (os_getrandom(in + DRBG_KEYBYTES, DRBG_KEYBYTES) != 0) {
+    secure_zero(in, sizeof(in));
+    return -1;
+  }
+  shake256(drbg.pool, DRBG_KEYBYTES, in, sizeof(in));
+  secure_zero(in, sizeof(in));
+  secure_zero(drbg.pool + DRBG_KEYBYTES, DRBG_POOLBYTES - DRBG_KEYBYTES);
+
+  drbg.pos = DRBG_POOLBYTES;
+  drbg.since_reseed = 0;
+  drbg.generation =
+      atomic_load_explicit(&fork_generation, memory_order_relaxed);
+  return 0;
+}
+
+int randombytes(uint8_t *out, size_t len) {
+  size_t n;
+
+  if (drbg.mode != DRBG_DETERMINISTIC) {
+    if (drbg.mode == DRBG_UNSEEDED) {
+      pthread_once(&drbg_once, drbg_global_init);
+      if (drbg_key_valid)
+        pthread_setspecific(drbg_key, &drbg);
+    }
+    if (drbg.mode == DRBG_UNSEEDED ||
+        drbg.since_reseed >= DRBG_RESEED_BYTES ||
+        drbg.generation !=
+            atomic_load_explicit(&fork_generation, memory_order_relaxed)) {
+      if (drbg_reseed() != 0)
+        return -1;
+      drbg.mode = DRBG_SEEDED;
+    }
+  }
+
+  while (len > 0) {
+    if (drbg.pos == DRBG_POOLBYTES)
+      drbg_refill();
+
+    n = DRBG_POOLBYTES - drbg.pos;
+    if (n > len)
+      n = len;
+    memcpy(out, drbg.pool + drbg.pos, n);
+    secure_zero(drbg.pool + drbg.pos, n);
+
+    drbg.pos += n;
+    drbg.since_reseed += n;
+    out += n;
+    len -= n;
+  }
+
+  return 0;
+}
+
+// Switch the calling thread to a deterministic stream for tests
+void randombytes_seed(uint32_t seed) {
+  uint8_t in[4];
+
+  in[0] = (uint8_t)seed;
+  in[1] = (uint8_t)(seed >> 8);
+  in[2] = (uint8_t)(seed >> 16);
+  in[3] = (uint8_t)(seed >> 24);
+  shake256(drbg.pool, DRBG_KEYBYTES, in, sizeof(in));
+  secure_zero(drbg.pool + DRBG_KEYBYTES, DRBG_POOLBYTES - DRBG_KEYBYTES);
+  drbg.pos = DRBG_POOLBYTES;
+  drbg.mode = DRBG_DETERMINISTIC;
 }
 
 /*************************************************
  * Desktop/Generic Implementation
- * For production on Desktop: use OS random
- * For testing: use deterministic LFSR
+ * Deterministic LFSR seeded with time: for testing only,
+ * not suitable for production keys
  *************************************************/
 #else
 
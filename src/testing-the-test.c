@@ -1,5 +1,5 @@
-#include <stdio.h>
-int hello() {
-  printf("Return 1!\n");
-  return 1;
-}
+#include <stdio.h>
+int hello() {
+  printf("Return 1!\n");
+  return 1;
+}
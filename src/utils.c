@@ -67,3 +67,20 @@ void ct_cmov(uint8_t *r, const uint8_t *x, size_t len, uint8_t b) {
   for (size_t i = 0; i < len; i++)
     r[i] ^= mask & (r[i] ^ x[i]);
 }
+
+/*************************************************
+ * Name:        secure_zero
+ *
+ * Description: Overwrite a buffer with zeros. Writes go through a
+ *              volatile pointer so they survive dead-store elimination
+ *              when the buffer is not read again (e.g. key material
+ *              about to go out of scope).
+ *
+ * Arguments:   - void *p: buffer to wipe
+ *              - size_t len: length of buffer
+ *************************************************/
+void secure_zero(void *p, size_t len) {
+  volatile uint8_t *v = (volatile uint8_t *)p;
+  for (size_t i = 0; i < len; i++)
+    v[i] = 0;
+}
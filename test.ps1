@@ -2,30 +2,65 @@ $msys2Shell = "D:\Projects\ccompilers\msys64\msys2_shell.cmd"
 $includeDirs = "-Iinclude -Itest/vendor"
 $unitySrc = "test/vendor/unity.c"
 
-# Find all test files
-$testFiles = Get-ChildItem -Path "test" -Filter "test_*.c"
-
-foreach ($file in $testFiles) {
-    $testBase = $file.BaseName
-    $srcFile = "src/" + ($testBase -replace "test_", "") + ".c"
-    $output = "build/$testBase.exe"
-    
-    Write-Host "--- Testing $testBase ---" -ForegroundColor Cyan
-    
-    # Compile the test using MSYS2 shell
-    if (Test-Path $srcFile) {
-        $compileCmd = "gcc test/$($file.Name) $srcFile $unitySrc $includeDirs -o $output"
-    } else {
-        # compile without separate src file (self-contained test)
-        $compileCmd = "gcc test/$($file.Name) $unitySrc $includeDirs -o $output"
+# Library sources: everything in src/ except the demo entry points
+$libSources = Get-ChildItem -Path "src" -Filter "*.c" |
+    Where-Object { $_.Name -notin @("kyber_embedded.c", "testing-the-test.c") }
+
+# Build the library into $dir as a static archive, with extra compiler
+# flags, so each test only pulls in the objects it references
+# (test_utils carries its own select_bytes, test_kem does not use Unity)
+function Build-Library($dir, $flags) {
+    if (-not (Test-Path "$dir/obj")) {
+        New-Item -ItemType Directory -Path "$dir/obj" | Out-Null
+    }
+    foreach ($src in $libSources) {
+        $obj = "$dir/obj/" + $src.BaseName + ".o"
+        $compileCmd = "gcc -O2 $flags -c src/$($src.Name) $includeDirs -o $obj"
+        & $msys2Shell -mingw64 -defterm -no-start -here -c $compileCmd
     }
-    
-    & $msys2Shell -mingw64 -defterm -no-start -here -c $compileCmd
-
-    if ($LASTEXITCODE -eq 0) {
-        # Run the test
-        & $output
-    } else {
-        Write-Host "Compilation failed for $testBase" -ForegroundColor Red
+    $archiveCmd = "ar rcs $dir/libkyber.a $dir/obj/*.o"
+    & $msys2Shell -mingw64 -defterm -no-start -here -c $archiveCmd
+}
+
+# Compile every test against $dir/libkyber.a with the same flags and run it
+function Run-Tests($dir, $flags) {
+    $testFiles = Get-ChildItem -Path "test" -Filter "test_*.c"
+
+    foreach ($file in $testFiles) {
+        $testBase = $file.BaseName
+        $output = "$dir/$testBase.exe"
+
+        Write-Host "--- Testing $testBase $flags ---" -ForegroundColor Cyan
+
+        # Compile the test using MSYS2 shell
+        $compileCmd = "gcc $flags test/$($file.Name) $includeDirs build/libunity.a $dir/libkyber.a -pthread -lm -o $output"
+
+        & $msys2Shell -mingw64 -defterm -no-start -here -c $compileCmd
+
+        if ($LASTEXITCODE -eq 0) {
+            # Run the test
+            & $output
+        } else {
+            Write-Host "Compilation failed for $testBase" -ForegroundColor Red
+        }
     }
 }
+
+Write-Host "--- Building libkyber.a ---" -ForegroundColor Cyan
+Build-Library "build" ""
+$unityCmd = "gcc -c $unitySrc $includeDirs -o build/unity.o && ar rcs build/libunity.a build/unity.o"
+& $msys2Shell -mingw64 -defterm -no-start -here -c $unityCmd
+Run-Tests "build" ""
+
+# The metrics hooks compile to nothing by default; this pass runs the
+# counting tests of test_kyber_metrics and the KEM with the hooks in
+Write-Host "--- Building libkyber.a with -DKYBER_METRICS ---" -ForegroundColor Cyan
+Build-Library "build/metrics" "-DKYBER_METRICS"
+Run-Tests "build/metrics" "-DKYBER_METRICS"
+
+# poly.c only calls through the autotuner's selection in this build, and
+# the Keccak candidates need the backend interface
+$tuneFlags = "-DKYBER_AUTOTUNE -DKYBER_KECCAK_BACKEND"
+Write-Host "--- Building libkyber.a with $tuneFlags ---" -ForegroundColor Cyan
+Build-Library "build/autotune" $tuneFlags
+Run-Tests "build/autotune" $tuneFlags
@@ -0,0 +1,69 @@
+#ifndef KYBER_MODEL_ARM_ACLE_H
+#define KYBER_MODEL_ARM_ACLE_H
+
+#include <stdint.h>
+
+/*************************************************
+ * Host Model of <arm_acle.h>
+ *
+ * Plain C versions of the ARMv7E-M DSP intrinsics used by ntt_m4.c,
+ * so the Cortex-M4 backend can be built and tested on any host
+ * (test/model/run.sh). B and T pick the signed bottom and top
+ * halfword of an operand. The accumulating multiplies wrap at 32 bits
+ * (the core only sets the Q flag), and sadd16/ssub16 wrap in each
+ * halfword (they only set the GE flags), which is what the kernels
+ * rely on.
+ *
+ * The model checks the arithmetic of the kernels against the scalar
+ * code; it says nothing about the code arm-none-eabi-gcc generates for
+ * them, nor about cycle counts.
+ *************************************************/
+
+#define ACLE_B(x) ((int32_t)(int16_t)(uint16_t)(x))
+#define ACLE_T(x) ((int32_t)(int16_t)(uint16_t)((uint32_t)(x) >> 16))
+
+static inline int32_t __smulbb(int32_t a, int32_t b) {
+  return ACLE_B(a) * ACLE_B(b);
+}
+
+static inline int32_t __smulbt(int32_t a, int32_t b) {
+  return ACLE_B(a) * ACLE_T(b);
+}
+
+static inline int32_t __smultb(int32_t a, int32_t b) {
+  return ACLE_T(a) * ACLE_B(b);
+}
+
+static inline int32_t __smultt(int32_t a, int32_t b) {
+  return ACLE_T(a) * ACLE_T(b);
+}
+
+// c + product, modulo 2^32
+static inline int32_t __smlabb(int32_t a, int32_t b, int32_t c) {
+  return (int32_t)((uint32_t)c + (uint32_t)__smulbb(a, b));
+}
+
+static inline int32_t __smlabt(int32_t a, int32_t b, int32_t c) {
+  return (int32_t)((uint32_t)c + (uint32_t)__smulbt(a, b));
+}
+
+static inline int32_t __smlatb(int32_t a, int32_t b, int32_t c) {
+  return (int32_t)((uint32_t)c + (uint32_t)__smultb(a, b));
+}
+
+// Both halfwords, each modulo 2^16
+static inline int32_t __sadd16(int32_t a, int32_t b) {
+  uint32_t lo = ((uint32_t)a + (uint32_t)b) & 0xFFFFu;
+  uint32_t hi = ((uint32_t)a & 0xFFFF0000u) + ((uint32_t)b & 0xFFFF0000u);
+
+  return (int32_t)(hi | lo);
+}
+
+static inline int32_t __ssub16(int32_t a, int32_t b) {
+  uint32_t lo = ((uint32_t)a - (uint32_t)b) & 0xFFFFu;
+  uint32_t hi = ((uint32_t)a & 0xFFFF0000u) - ((uint32_t)b & 0xFFFF0000u);
+
+  return (int32_t)(hi | lo);
+}
+
+#endif /* KYBER_MODEL_ARM_ACLE_H */
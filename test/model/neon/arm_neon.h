@@ -0,0 +1,277 @@
+#ifndef KYBER_MODEL_ARM_NEON_H
+#define KYBER_MODEL_ARM_NEON_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*************************************************
+ * Host Model of <arm_neon.h>
+ *
+ * Plain C versions of the AArch64 NEON intrinsics used by ntt_neon.c
+ * and fips202x2_neon.c, one loop over the lanes each, so the NEON
+ * backend can be built and tested on any host (test/model/run.sh).
+ * Only the intrinsics the backend uses are here. The lane semantics
+ * follow the Arm ARM, including the corner cases the kernels rely on:
+ * sqdmulh saturates, srshr rounds, ushl shifts right for negative
+ * counts, tbl returns 0 for indices out of range, sri keeps the top
+ * bits of the destination.
+ *
+ * The model checks the arithmetic and the data movement of the
+ * kernels against the scalar code; it says nothing about the code a
+ * real compiler generates for them, nor about speed.
+ *************************************************/
+
+#define NEON_TYPE(name, elem, lanes)                                           \
+  typedef struct {                                                             \
+    elem v[lanes];                                                             \
+  } name
+
+NEON_TYPE(int8x8_t, int8_t, 8);
+NEON_TYPE(int8x16_t, int8_t, 16);
+NEON_TYPE(uint8x8_t, uint8_t, 8);
+NEON_TYPE(uint8x16_t, uint8_t, 16);
+NEON_TYPE(int16x4_t, int16_t, 4);
+NEON_TYPE(int16x8_t, int16_t, 8);
+NEON_TYPE(uint16x4_t, uint16_t, 4);
+NEON_TYPE(uint16x8_t, uint16_t, 8);
+NEON_TYPE(int32x4_t, int32_t, 4);
+NEON_TYPE(uint32x4_t, uint32_t, 4);
+NEON_TYPE(int64x2_t, int64_t, 2);
+NEON_TYPE(uint64x1_t, uint64_t, 1);
+NEON_TYPE(uint64x2_t, uint64_t, 2);
+
+#define NEON_LANES(x) ((int)(sizeof((x).v) / sizeof((x).v[0])))
+
+// r = f(a) lane by lane, with the lane index in i
+#define NEON_MAP1(fn, rt, at, expr)                                            \
+  static inline rt fn(at a) {                                                  \
+    rt r;                                                                      \
+    int i;                                                                     \
+    for (i = 0; i < NEON_LANES(r); i++)                                        \
+      r.v[i] = (expr);                                                         \
+    return r;                                                                  \
+  }
+
+#define NEON_MAP2(fn, rt, at, bt, expr)                                        \
+  static inline rt fn(at a, bt b) {                                            \
+    rt r;                                                                      \
+    int i;                                                                     \
+    for (i = 0; i < NEON_LANES(r); i++)                                        \
+      r.v[i] = (expr);                                                         \
+    return r;                                                                  \
+  }
+
+#define NEON_LOAD(fn, vt, elem)                                                \
+  static inline vt fn(const elem *p) {                                         \
+    vt r;                                                                      \
+    memcpy(r.v, p, sizeof(r.v));                                               \
+    return r;                                                                  \
+  }
+
+#define NEON_STORE(fn, vt, elem)                                               \
+  static inline void fn(elem *p, vt a) { memcpy(p, a.v, sizeof(a.v)); }
+
+#define NEON_DUP(fn, vt, elem)                                                 \
+  static inline vt fn(elem x) {                                                \
+    vt r;                                                                      \
+    int i;                                                                     \
+    for (i = 0; i < NEON_LANES(r); i++)                                        \
+      r.v[i] = x;                                                              \
+    return r;                                                                  \
+  }
+
+#define NEON_REINTERPRET(fn, rt, at)                                           \
+  static inline rt fn(at a) {                                                  \
+    rt r;                                                                      \
+    memcpy(&r, &a, sizeof(r));                                                 \
+    return r;                                                                  \
+  }
+
+/* Loads, stores, broadcasts */
+
+NEON_LOAD(vld1_u8, uint8x8_t, uint8_t)
+NEON_LOAD(vld1q_u8, uint8x16_t, uint8_t)
+NEON_LOAD(vld1q_s16, int16x8_t, int16_t)
+NEON_LOAD(vld1q_u16, uint16x8_t, uint16_t)
+
+NEON_STORE(vst1_u8, uint8x8_t, uint8_t)
+NEON_STORE(vst1_s16, int16x4_t, int16_t)
+NEON_STORE(vst1q_s16, int16x8_t, int16_t)
+NEON_STORE(vst1q_u16, uint16x8_t, uint16_t)
+NEON_STORE(vst1q_u64, uint64x2_t, uint64_t)
+
+NEON_DUP(vdupq_n_u8, uint8x16_t, uint8_t)
+NEON_DUP(vdupq_n_s16, int16x8_t, int16_t)
+NEON_DUP(vdupq_n_u16, uint16x8_t, uint16_t)
+NEON_DUP(vdupq_n_u32, uint32x4_t, uint32_t)
+NEON_DUP(vdupq_n_u64, uint64x2_t, uint64_t)
+
+/* Lane-wise arithmetic and logic, wrapping like the instructions */
+
+NEON_MAP2(vaddq_u8, uint8x16_t, uint8x16_t, uint8x16_t,
+          (uint8_t)(a.v[i] + b.v[i]))
+NEON_MAP2(vaddq_s16, int16x8_t, int16x8_t, int16x8_t,
+          (int16_t)(a.v[i] + b.v[i]))
+NEON_MAP2(vaddq_u16, uint16x8_t, uint16x8_t, uint16x8_t,
+          (uint16_t)(a.v[i] + b.v[i]))
+NEON_MAP2(vaddq_u32, uint32x4_t, uint32x4_t, uint32x4_t, a.v[i] + b.v[i])
+NEON_MAP2(vsubq_s8, int8x16_t, int8x16_t, int8x16_t,
+          (int8_t)(a.v[i] - b.v[i]))
+NEON_MAP2(vsubq_s16, int16x8_t, int16x8_t, int16x8_t,
+          (int16_t)(a.v[i] - b.v[i]))
+NEON_MAP2(vmulq_s16, int16x8_t, int16x8_t, int16x8_t,
+          (int16_t)((int32_t)a.v[i] * b.v[i]))
+NEON_MAP2(vmulq_u16, uint16x8_t, uint16x8_t, uint16x8_t,
+          (uint16_t)((uint32_t)a.v[i] * b.v[i]))
+NEON_MAP2(vmulq_n_s16, int16x8_t, int16x8_t, int16_t,
+          (int16_t)((int32_t)a.v[i] * b))
+NEON_MAP2(vmulq_n_u32, uint32x4_t, uint32x4_t, uint32_t, a.v[i] * b)
+
+static inline int16x8_t vmlsq_n_s16(int16x8_t a, int16x8_t b, int16_t c) {
+  int i;
+
+  for (i = 0; i < 8; i++)
+    a.v[i] = (int16_t)(a.v[i] - (int32_t)b.v[i] * c);
+  return a;
+}
+
+NEON_MAP2(vandq_u8, uint8x16_t, uint8x16_t, uint8x16_t, a.v[i] & b.v[i])
+NEON_MAP2(vandq_s16, int16x8_t, int16x8_t, int16x8_t, a.v[i] & b.v[i])
+NEON_MAP2(vandq_u16, uint16x8_t, uint16x8_t, uint16x8_t, a.v[i] & b.v[i])
+NEON_MAP2(vorrq_u16, uint16x8_t, uint16x8_t, uint16x8_t, a.v[i] | b.v[i])
+NEON_MAP2(veorq_u64, uint64x2_t, uint64x2_t, uint64x2_t, a.v[i] ^ b.v[i])
+NEON_MAP2(vbicq_u64, uint64x2_t, uint64x2_t, uint64x2_t, a.v[i] & ~b.v[i])
+
+NEON_MAP2(vcltq_u16, uint16x8_t, uint16x8_t, uint16x8_t,
+          a.v[i] < b.v[i] ? 0xFFFF : 0)
+
+static inline uint16_t vaddv_u16(uint16x4_t a) {
+  return (uint16_t)(a.v[0] + a.v[1] + a.v[2] + a.v[3]);
+}
+
+// sqdmulh: high half of 2ab, saturated (only -32768 * -32768 does)
+static inline int16x8_t vqdmulhq_n_s16(int16x8_t a, int16_t b) {
+  int16x8_t r;
+  int32_t p;
+  int i;
+
+  for (i = 0; i < 8; i++) {
+    p = (int32_t)(((int64_t)2 * a.v[i] * b) >> 16);
+    r.v[i] = (int16_t)(p > INT16_MAX ? INT16_MAX : p);
+  }
+  return r;
+}
+
+/* Shifts; the count of the _n_ forms is an immediate on hardware */
+
+NEON_MAP2(vshrq_n_u8, uint8x16_t, uint8x16_t, int, (uint8_t)(a.v[i] >> b))
+NEON_MAP2(vshrq_n_s16, int16x8_t, int16x8_t, int, (int16_t)(a.v[i] >> b))
+NEON_MAP2(vshrq_n_u16, uint16x8_t, uint16x8_t, int, (uint16_t)(a.v[i] >> b))
+NEON_MAP2(vshrq_n_u32, uint32x4_t, uint32x4_t, int, a.v[i] >> b)
+NEON_MAP2(vshlq_n_u16, uint16x8_t, uint16x8_t, int,
+          (uint16_t)((uint32_t)a.v[i] << b))
+NEON_MAP2(vshlq_n_u32, uint32x4_t, uint32x4_t, int, a.v[i] << b)
+NEON_MAP2(vshlq_n_u64, uint64x2_t, uint64x2_t, int, a.v[i] << b)
+
+// srshr: shift right, rounding to nearest
+NEON_MAP2(vrshrq_n_s16, int16x8_t, int16x8_t, int,
+          (int16_t)((a.v[i] + (1 << (b - 1))) >> b))
+
+// ushl: the signed low byte of each count lane shifts left, or right
+// when negative; counts of 16 or more clear the lane
+static inline uint16x8_t vshlq_u16(uint16x8_t a, int16x8_t b) {
+  uint16x8_t r;
+  int i, k;
+
+  for (i = 0; i < 8; i++) {
+    k = (int8_t)b.v[i];
+    if (k >= 16 || k <= -16)
+      r.v[i] = 0;
+    else if (k >= 0)
+      r.v[i] = (uint16_t)((uint32_t)a.v[i] << k);
+    else
+      r.v[i] = (uint16_t)(a.v[i] >> -k);
+  }
+  return r;
+}
+
+// sri: b >> n into a, keeping the top n bits of a
+static inline uint64x2_t vsriq_n_u64(uint64x2_t a, uint64x2_t b, int n) {
+  uint64_t m = n == 64 ? 0 : ~(uint64_t)0 >> n;
+  int i;
+
+  for (i = 0; i < 2; i++)
+    a.v[i] = (a.v[i] & ~m) | (n == 64 ? 0 : b.v[i] >> n);
+  return a;
+}
+
+/* Widening and narrowing */
+
+NEON_MAP1(vmovl_s8, int16x8_t, int8x8_t, a.v[i])
+NEON_MAP1(vmovl_high_s8, int16x8_t, int8x16_t, a.v[8 + i])
+NEON_MAP1(vmovl_u16, uint32x4_t, uint16x4_t, a.v[i])
+NEON_MAP1(vmovl_high_u16, uint32x4_t, uint16x8_t, a.v[4 + i])
+NEON_MAP2(vmull_s16, int32x4_t, int16x4_t, int16x4_t,
+          (int32_t)a.v[i] * b.v[i])
+NEON_MAP2(vmull_high_s16, int32x4_t, int16x8_t, int16x8_t,
+          (int32_t)a.v[4 + i] * b.v[4 + i])
+NEON_MAP1(vmovn_u16, uint8x8_t, uint16x8_t, (uint8_t)a.v[i])
+NEON_MAP1(vmovn_u32, uint16x4_t, uint32x4_t, (uint16_t)a.v[i])
+NEON_MAP2(vmovn_high_u32, uint16x8_t, uint16x4_t, uint32x4_t,
+          i < 4 ? a.v[i] : (uint16_t)b.v[i - 4])
+
+/* Halves, permutes, table lookups */
+
+NEON_MAP1(vget_low_s8, int8x8_t, int8x16_t, a.v[i])
+NEON_MAP1(vget_low_s16, int16x4_t, int16x8_t, a.v[i])
+NEON_MAP1(vget_low_u16, uint16x4_t, uint16x8_t, a.v[i])
+NEON_MAP1(vget_high_u16, uint16x4_t, uint16x8_t, a.v[4 + i])
+NEON_MAP2(vcombine_u64, uint64x2_t, uint64x1_t, uint64x1_t,
+          i == 0 ? a.v[0] : b.v[0])
+
+// zip interleaves the low (1) or high (2) halves of a and b
+#define NEON_ZIP(t, vt, n)                                                     \
+  NEON_MAP2(vzip1q_##t, vt, vt, vt, i % 2 ? b.v[i / 2] : a.v[i / 2])          \
+  NEON_MAP2(vzip2q_##t, vt, vt, vt,                                            \
+            i % 2 ? b.v[(n) / 2 + i / 2] : a.v[(n) / 2 + i / 2])
+
+// uzp takes the even (1) or odd (2) lanes of a, then of b
+#define NEON_UZP(t, vt, n)                                                     \
+  NEON_MAP2(vuzp1q_##t, vt, vt, vt,                                            \
+            i < (n) / 2 ? a.v[2 * i] : b.v[2 * i - (n)])                       \
+  NEON_MAP2(vuzp2q_##t, vt, vt, vt,                                            \
+            i < (n) / 2 ? a.v[2 * i + 1] : b.v[2 * i + 1 - (n)])
+
+NEON_ZIP(s8, int8x16_t, 16)
+NEON_ZIP(s16, int16x8_t, 8)
+NEON_ZIP(s32, int32x4_t, 4)
+NEON_UZP(s16, int16x8_t, 8)
+NEON_UZP(u16, uint16x8_t, 8)
+NEON_UZP(s32, int32x4_t, 4)
+
+// trn on two lanes: the low (1) or high (2) lanes of a and b
+NEON_MAP2(vtrn1q_s64, int64x2_t, int64x2_t, int64x2_t,
+          i == 0 ? a.v[0] : b.v[0])
+NEON_MAP2(vtrn2q_s64, int64x2_t, int64x2_t, int64x2_t,
+          i == 0 ? a.v[1] : b.v[1])
+
+NEON_MAP2(vqtbl1q_u8, uint8x16_t, uint8x16_t, uint8x16_t,
+          b.v[i] < 16 ? a.v[b.v[i]] : 0)
+NEON_MAP2(vtbl1_u8, uint8x8_t, uint8x8_t, uint8x8_t,
+          b.v[i] < 8 ? a.v[b.v[i]] : 0)
+
+/* Reinterpretation, a byte copy on little-endian AArch64 */
+
+NEON_REINTERPRET(vreinterpret_u8_u16, uint8x8_t, uint16x4_t)
+NEON_REINTERPRET(vreinterpret_s16_u8, int16x4_t, uint8x8_t)
+NEON_REINTERPRET(vreinterpret_u64_u8, uint64x1_t, uint8x8_t)
+NEON_REINTERPRET(vreinterpretq_s8_u8, int8x16_t, uint8x16_t)
+NEON_REINTERPRET(vreinterpretq_u16_u8, uint16x8_t, uint8x16_t)
+NEON_REINTERPRET(vreinterpretq_s16_u16, int16x8_t, uint16x8_t)
+NEON_REINTERPRET(vreinterpretq_u16_s16, uint16x8_t, int16x8_t)
+NEON_REINTERPRET(vreinterpretq_s16_s32, int16x8_t, int32x4_t)
+NEON_REINTERPRET(vreinterpretq_s32_s16, int32x4_t, int16x8_t)
+NEON_REINTERPRET(vreinterpretq_s16_s64, int16x8_t, int64x2_t)
+NEON_REINTERPRET(vreinterpretq_s64_s16, int64x2_t, int16x8_t)
+
+#endif /* KYBER_MODEL_ARM_NEON_H */
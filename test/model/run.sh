@@ -0,0 +1,111 @@
+#!/bin/sh
+# Build the SIMD backends on the host against C models of their
+# intrinsics headers and run the unit tests, for when no cross
+# compiler or qemu is at hand. The models live next to this script,
+# one directory per header; -I puts them in front of the system
+# headers and -DKYBER_<ARCH>_MODEL lets the backend header enable the
+# kernels (see ntt_neon.h).
+#
+# Usage (from anywhere): test/model/run.sh [neon|rvv|m4|all]
+#
+# Environment:
+#   CC       host compiler           (cc)
+#   VLENS    modelled RVV lengths    (128 256 512 1024)
+#   OUT      build directory         (build/model)
+#
+# Every test runs for all three parameter sets with the backend routed
+# through the library (-DKYBER_BACKEND_<ARCH>), so test_kem and the
+# other end-to-end tests go through the modelled kernels as well. This
+# checks the kernel logic against the scalar code. It does not replace
+# a run on the target: code generation, intrinsic availability and
+# timings need the real toolchain, and none of the backends has had
+# one yet.
+#
+# test_kyber_stack is left out: modelled vector registers are structs
+# on the stack, so its figures say nothing about the target and grow
+# past its painted area at large VLEN.
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/../.." && pwd)
+CC=${CC:-cc}
+VLENS=${VLENS:-128 256 512 1024}
+OUT=${OUT:-$ROOT/build/model}
+WHAT=${1:-all}
+
+CFLAGS="-O2 -Wall -Wextra -I$ROOT/include -I$ROOT/test/vendor"
+LDFLAGS="-pthread -lm"
+
+# build_lib <dir> <flags...>: one static library per parameter set
+build_lib() {
+  dir=$1
+  shift
+  mkdir -p "$dir"
+  objs=""
+  for src in "$ROOT"/src/*.c; do
+    name=$(basename "$src" .c)
+    case $name in
+    kyber_embedded | testing-the-test) continue ;;
+    esac
+    $CC $CFLAGS "$@" -c "$src" -o "$dir/$name.o"
+    objs="$objs $dir/$name.o"
+  done
+  rm -f "$dir/libkyber.a"
+  ar rcs "$dir/libkyber.a" $objs
+}
+
+# run_tests <label> <flags...>
+run_tests() {
+  label=$1
+  shift
+  failed=0
+  for k in 2 3 4; do
+    dir="$OUT/$label/k$k"
+    build_lib "$dir" -DKYBER_K=$k "$@"
+    # Unity as an archive, so test_kem (no Unity) links without it
+    $CC $CFLAGS -c "$ROOT/test/vendor/unity.c" -o "$dir/unity.o"
+    ar rcs "$dir/libunity.a" "$dir/unity.o"
+    for t in "$ROOT"/test/test_*.c; do
+      name=$(basename "$t" .c)
+      [ "$name" = test_kyber_stack ] && continue
+      bin="$dir/$name"
+      if $CC $CFLAGS -DKYBER_K=$k "$@" "$t" "$dir/libunity.a" \
+        "$dir/libkyber.a" $LDFLAGS -o "$bin" &&
+        (cd "$dir" && "$bin") >"$bin.log" 2>&1; then
+        echo "  ok    $name ($label, K=$k)"
+      else
+        echo "  FAIL  $name ($label, K=$k), see $bin.log"
+        failed=1
+      fi
+    done
+  done
+  return $failed
+}
+
+status=0
+case $WHAT in
+neon | all)
+  echo "== tests (NEON model)"
+  run_tests neon -I"$ROOT/test/model/neon" -DKYBER_NEON_MODEL \
+    -DKYBER_BACKEND_NEON || status=1
+  ;;
+esac
+case $WHAT in
+rvv | all)
+  # VLEN is a compile-time constant of the model, so one build each
+  for vlen in $VLENS; do
+    echo "== tests (RVV model, VLEN=$vlen)"
+    run_tests rvv$vlen -I"$ROOT/test/model/rvv" -DKYBER_RVV_MODEL \
+      -DKYBER_RVV_MODEL_VLEN=$vlen -DKYBER_BACKEND_RVV || status=1
+  done
+  ;;
+esac
+case $WHAT in
+m4 | all)
+  # The optimised M4 configuration: DSP kernels and the bi32 Keccak
+  echo "== tests (M4 model)"
+  run_tests m4 -I"$ROOT/test/model/m4" -DKYBER_M4_MODEL \
+    -DKYBER_BACKEND_M4 -DKYBER_KECCAK_BI32 || status=1
+  ;;
+esac
+exit $status
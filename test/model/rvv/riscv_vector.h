@@ -0,0 +1,310 @@
+#ifndef KYBER_MODEL_RISCV_VECTOR_H
+#define KYBER_MODEL_RISCV_VECTOR_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/*************************************************
+ * Host Model of <riscv_vector.h>
+ *
+ * Plain C versions of the RVV 1.0 intrinsics used by ntt_rvv.c and
+ * fips202xn_rvv.c, so the RVV backend can be built and tested on any
+ * host (test/model/run.sh). A register group is an array of
+ * VLMAX = VLEN * LMUL / SEW elements, with VLEN set at compile time by
+ * KYBER_RVV_MODEL_VLEN (128 by default); building at several VLEN
+ * exercises the strip-mining of the vector-length agnostic kernels.
+ *
+ * vsetvl returns min(avl, VLMAX), as qemu does. Elements past vl are
+ * tail-agnostic on hardware; the model fills them with ones (qemu's
+ * rvv_ta_all_1s) and vundefined returns garbage, so a kernel that
+ * reads them fails its test. vl beyond VLMAX trips an assert.
+ *
+ * The model checks the arithmetic and the data movement of the
+ * kernels against the scalar code; it says nothing about the code a
+ * real compiler generates for them, nor about speed.
+ *************************************************/
+
+#ifndef KYBER_RVV_MODEL_VLEN
+#define KYBER_RVV_MODEL_VLEN 128
+#endif
+
+// Elements in a group of SEW-bit elements at LMUL = lmul8 / 8
+#define RVV_VLMAX(sew, lmul8) (KYBER_RVV_MODEL_VLEN * (lmul8) / 8 / (sew))
+
+#define RVV_TYPE(name, elem, sew, lmul8)                                       \
+  typedef struct {                                                             \
+    elem e[RVV_VLMAX(sew, lmul8)];                                             \
+  } name
+
+RVV_TYPE(vint8m1_t, int8_t, 8, 8);
+RVV_TYPE(vuint8mf2_t, uint8_t, 8, 4);
+RVV_TYPE(vuint8m1_t, uint8_t, 8, 8);
+RVV_TYPE(vint16m1_t, int16_t, 16, 8);
+RVV_TYPE(vint16m2_t, int16_t, 16, 16);
+RVV_TYPE(vuint16m1_t, uint16_t, 16, 8);
+RVV_TYPE(vuint16m2_t, uint16_t, 16, 16);
+RVV_TYPE(vuint32m2_t, uint32_t, 32, 16);
+RVV_TYPE(vuint64m1_t, uint64_t, 64, 8);
+
+// One flag per element of a SEW/LMUL = 8 group (e16m2, e8m1, ...)
+typedef struct {
+  uint8_t m[RVV_VLMAX(8, 8)];
+} vbool8_t;
+
+#define RVV_LANES(x) (sizeof((x).e) / sizeof((x).e[0]))
+
+static inline void rvv_model_tail(void *e, size_t size, size_t lanes,
+                                  size_t vl) {
+  assert(vl <= lanes);
+  memset((uint8_t *)e + vl * size, 0xFF, (lanes - vl) * size);
+}
+
+#define RVV_TAIL(r, vl)                                                        \
+  rvv_model_tail((r).e, sizeof((r).e[0]), RVV_LANES(r), vl)
+
+// rt fn params: r.e[i] = expr for i < vl, tail filled with ones
+#define RVV_MAP(fn, rt, params, expr)                                          \
+  static inline rt fn params {                                                 \
+    rt r;                                                                      \
+    size_t i;                                                                  \
+    assert(vl <= RVV_LANES(r));                                                \
+    for (i = 0; i < vl; i++)                                                   \
+      r.e[i] = (expr);                                                         \
+    RVV_TAIL(r, vl);                                                           \
+    return r;                                                                  \
+  }
+
+#define RVV_SETVL(fn, sew, lmul8)                                              \
+  static inline size_t fn(size_t avl) {                                        \
+    return avl < RVV_VLMAX(sew, lmul8) ? avl : RVV_VLMAX(sew, lmul8);          \
+  }
+
+#define RVV_LOAD(fn, vt, elem)                                                 \
+  RVV_MAP(fn, vt, (const elem *p, size_t vl), p[i])
+
+#define RVV_STORE(fn, vt, elem)                                                \
+  static inline void fn(elem *p, vt a, size_t vl) {                            \
+    size_t i;                                                                  \
+    assert(vl <= RVV_LANES(a));                                                \
+    for (i = 0; i < vl; i++)                                                   \
+      p[i] = a.e[i];                                                           \
+  }
+
+#define RVV_REINTERPRET(fn, rt, at)                                            \
+  static inline rt fn(at a) {                                                  \
+    rt r;                                                                      \
+    memcpy(&r, &a, sizeof(r));                                                 \
+    return r;                                                                  \
+  }
+
+RVV_SETVL(__riscv_vsetvl_e8m1, 8, 8)
+RVV_SETVL(__riscv_vsetvl_e16m1, 16, 8)
+RVV_SETVL(__riscv_vsetvl_e32m2, 32, 16)
+RVV_SETVL(__riscv_vsetvl_e64m1, 64, 8)
+
+/* Unit-stride and strided memory access */
+
+RVV_LOAD(__riscv_vle8_v_u8m1, vuint8m1_t, uint8_t)
+RVV_LOAD(__riscv_vle16_v_i16m1, vint16m1_t, int16_t)
+RVV_LOAD(__riscv_vle64_v_u64m1, vuint64m1_t, uint64_t)
+RVV_STORE(__riscv_vse8_v_u8mf2, vuint8mf2_t, uint8_t)
+RVV_STORE(__riscv_vse16_v_i16m1, vint16m1_t, int16_t)
+RVV_STORE(__riscv_vse16_v_i16m2, vint16m2_t, int16_t)
+RVV_STORE(__riscv_vse64_v_u64m1, vuint64m1_t, uint64_t)
+
+// Stride in bytes, negative strides walk backwards
+RVV_MAP(__riscv_vlse16_v_i16m1, vint16m1_t,
+        (const int16_t *p, ptrdiff_t stride, size_t vl),
+        *(const int16_t *)(const void *)((const uint8_t *)p +
+                                          (ptrdiff_t)i * stride))
+
+/* e16 signed arithmetic, wrapping like the instructions */
+
+RVV_MAP(__riscv_vadd_vv_i16m1, vint16m1_t, (vint16m1_t a, vint16m1_t b,
+        size_t vl), (int16_t)(a.e[i] + b.e[i]))
+RVV_MAP(__riscv_vadd_vx_i16m1, vint16m1_t, (vint16m1_t a, int16_t x,
+        size_t vl), (int16_t)(a.e[i] + x))
+RVV_MAP(__riscv_vsub_vv_i16m1, vint16m1_t, (vint16m1_t a, vint16m1_t b,
+        size_t vl), (int16_t)(a.e[i] - b.e[i]))
+RVV_MAP(__riscv_vneg_v_i16m1, vint16m1_t, (vint16m1_t a, size_t vl),
+        (int16_t)-a.e[i])
+RVV_MAP(__riscv_vmul_vv_i16m1, vint16m1_t, (vint16m1_t a, vint16m1_t b,
+        size_t vl), (int16_t)((int32_t)a.e[i] * b.e[i]))
+RVV_MAP(__riscv_vmul_vx_i16m1, vint16m1_t, (vint16m1_t a, int16_t x,
+        size_t vl), (int16_t)((int32_t)a.e[i] * x))
+RVV_MAP(__riscv_vmulh_vv_i16m1, vint16m1_t, (vint16m1_t a, vint16m1_t b,
+        size_t vl), (int16_t)(((int32_t)a.e[i] * b.e[i]) >> 16))
+RVV_MAP(__riscv_vmulh_vx_i16m1, vint16m1_t, (vint16m1_t a, int16_t x,
+        size_t vl), (int16_t)(((int32_t)a.e[i] * x) >> 16))
+// vd - x * b
+RVV_MAP(__riscv_vnmsac_vx_i16m1, vint16m1_t, (vint16m1_t d, int16_t x,
+        vint16m1_t b, size_t vl), (int16_t)(d.e[i] - (int32_t)x * b.e[i]))
+RVV_MAP(__riscv_vand_vx_i16m1, vint16m1_t, (vint16m1_t a, int16_t x,
+        size_t vl), (int16_t)(a.e[i] & x))
+// Shift counts use the low log2(SEW) bits
+RVV_MAP(__riscv_vsra_vx_i16m1, vint16m1_t, (vint16m1_t a, size_t n,
+        size_t vl), (int16_t)(a.e[i] >> (n & 15)))
+
+/* Unsigned arithmetic and logic */
+
+RVV_MAP(__riscv_vadd_vv_u8m1, vuint8m1_t, (vuint8m1_t a, vuint8m1_t b,
+        size_t vl), (uint8_t)(a.e[i] + b.e[i]))
+RVV_MAP(__riscv_vsub_vv_u8m1, vuint8m1_t, (vuint8m1_t a, vuint8m1_t b,
+        size_t vl), (uint8_t)(a.e[i] - b.e[i]))
+RVV_MAP(__riscv_vand_vx_u8m1, vuint8m1_t, (vuint8m1_t a, uint8_t x,
+        size_t vl), (uint8_t)(a.e[i] & x))
+RVV_MAP(__riscv_vsrl_vx_u8m1, vuint8m1_t, (vuint8m1_t a, size_t n,
+        size_t vl), (uint8_t)(a.e[i] >> (n & 7)))
+
+RVV_MAP(__riscv_vand_vx_u16m1, vuint16m1_t, (vuint16m1_t a, uint16_t x,
+        size_t vl), (uint16_t)(a.e[i] & x))
+RVV_MAP(__riscv_vor_vv_u16m1, vuint16m1_t, (vuint16m1_t a, vuint16m1_t b,
+        size_t vl), (uint16_t)(a.e[i] | b.e[i]))
+RVV_MAP(__riscv_vsll_vx_u16m1, vuint16m1_t, (vuint16m1_t a, size_t n,
+        size_t vl), (uint16_t)((uint32_t)a.e[i] << (n & 15)))
+RVV_MAP(__riscv_vsrl_vx_u16m1, vuint16m1_t, (vuint16m1_t a, size_t n,
+        size_t vl), (uint16_t)(a.e[i] >> (n & 15)))
+
+RVV_MAP(__riscv_vadd_vv_u32m2, vuint32m2_t, (vuint32m2_t a, vuint32m2_t b,
+        size_t vl), a.e[i] + b.e[i])
+RVV_MAP(__riscv_vadd_vx_u32m2, vuint32m2_t, (vuint32m2_t a, uint32_t x,
+        size_t vl), a.e[i] + x)
+RVV_MAP(__riscv_vsub_vv_u32m2, vuint32m2_t, (vuint32m2_t a, vuint32m2_t b,
+        size_t vl), a.e[i] - b.e[i])
+RVV_MAP(__riscv_vmul_vx_u32m2, vuint32m2_t, (vuint32m2_t a, uint32_t x,
+        size_t vl), a.e[i] * x)
+RVV_MAP(__riscv_vand_vx_u32m2, vuint32m2_t, (vuint32m2_t a, uint32_t x,
+        size_t vl), a.e[i] & x)
+RVV_MAP(__riscv_vor_vv_u32m2, vuint32m2_t, (vuint32m2_t a, vuint32m2_t b,
+        size_t vl), a.e[i] | b.e[i])
+RVV_MAP(__riscv_vsll_vx_u32m2, vuint32m2_t, (vuint32m2_t a, size_t n,
+        size_t vl), a.e[i] << (n & 31))
+RVV_MAP(__riscv_vsrl_vx_u32m2, vuint32m2_t, (vuint32m2_t a, size_t n,
+        size_t vl), a.e[i] >> (n & 31))
+
+RVV_MAP(__riscv_vand_vv_u64m1, vuint64m1_t, (vuint64m1_t a, vuint64m1_t b,
+        size_t vl), a.e[i] & b.e[i])
+RVV_MAP(__riscv_vor_vv_u64m1, vuint64m1_t, (vuint64m1_t a, vuint64m1_t b,
+        size_t vl), a.e[i] | b.e[i])
+RVV_MAP(__riscv_vxor_vv_u64m1, vuint64m1_t, (vuint64m1_t a, vuint64m1_t b,
+        size_t vl), a.e[i] ^ b.e[i])
+RVV_MAP(__riscv_vxor_vx_u64m1, vuint64m1_t, (vuint64m1_t a, uint64_t x,
+        size_t vl), a.e[i] ^ x)
+RVV_MAP(__riscv_vnot_v_u64m1, vuint64m1_t, (vuint64m1_t a, size_t vl),
+        ~a.e[i])
+RVV_MAP(__riscv_vsll_vx_u64m1, vuint64m1_t, (vuint64m1_t a, size_t n,
+        size_t vl), a.e[i] << (n & 63))
+RVV_MAP(__riscv_vsrl_vx_u64m1, vuint64m1_t, (vuint64m1_t a, size_t n,
+        size_t vl), a.e[i] >> (n & 63))
+
+/* Widening and narrowing */
+
+RVV_MAP(__riscv_vsext_vf2_i16m2, vint16m2_t, (vint8m1_t a, size_t vl),
+        a.e[i])
+RVV_MAP(__riscv_vzext_vf2_u16m1, vuint16m1_t, (vuint8mf2_t a, size_t vl),
+        a.e[i])
+RVV_MAP(__riscv_vzext_vf2_u32m2, vuint32m2_t, (vuint16m1_t a, size_t vl),
+        a.e[i])
+RVV_MAP(__riscv_vzext_vf4_u32m2, vuint32m2_t, (vuint8mf2_t a, size_t vl),
+        a.e[i])
+RVV_MAP(__riscv_vncvt_x_x_w_u8mf2, vuint8mf2_t, (vuint16m1_t a, size_t vl),
+        (uint8_t)a.e[i])
+RVV_MAP(__riscv_vncvt_x_x_w_u16m1, vuint16m1_t, (vuint32m2_t a, size_t vl),
+        (uint16_t)a.e[i])
+
+/* Masks and compression */
+
+static inline vbool8_t __riscv_vmsltu_vx_u16m2_b8(vuint16m2_t a, uint16_t x,
+                                                  size_t vl) {
+  vbool8_t m;
+  size_t i;
+
+  assert(vl <= RVV_LANES(a));
+  memset(m.m, 1, sizeof(m.m)); // Mask tail agnostic too
+  for (i = 0; i < vl; i++)
+    m.m[i] = a.e[i] < x;
+  return m;
+}
+
+static inline unsigned long __riscv_vcpop_m_b8(vbool8_t m, size_t vl) {
+  unsigned long n = 0;
+  size_t i;
+
+  for (i = 0; i < vl; i++)
+    n += m.m[i];
+  return n;
+}
+
+// Active elements packed to the front, the rest is tail
+static inline vuint16m2_t __riscv_vcompress_vm_u16m2(vuint16m2_t a,
+                                                     vbool8_t m, size_t vl) {
+  vuint16m2_t r;
+  size_t i, n = 0;
+
+  assert(vl <= RVV_LANES(a));
+  for (i = 0; i < vl; i++)
+    if (m.m[i])
+      r.e[n++] = a.e[i];
+  RVV_TAIL(r, n);
+  return r;
+}
+
+/* Reinterpretation; on a little-endian core element 2i of a u16 view
+ * is the low half of element i of the u32 view */
+
+RVV_REINTERPRET(__riscv_vreinterpret_v_u8m1_i8m1, vint8m1_t, vuint8m1_t)
+RVV_REINTERPRET(__riscv_vreinterpret_v_i16m1_u16m1, vuint16m1_t, vint16m1_t)
+RVV_REINTERPRET(__riscv_vreinterpret_v_u16m1_i16m1, vint16m1_t, vuint16m1_t)
+RVV_REINTERPRET(__riscv_vreinterpret_v_u16m2_i16m2, vint16m2_t, vuint16m2_t)
+RVV_REINTERPRET(__riscv_vreinterpret_v_u32m2_u16m2, vuint16m2_t, vuint32m2_t)
+
+/* Tuples and segment access: field k of element i at p[nf * i + k] */
+
+#define RVV_TUPLE(sfx, nf, base, elem, sew)                                    \
+  typedef struct {                                                             \
+    base##_t f[nf];                                                            \
+  } base##x##nf##_t;                                                           \
+  static inline base##x##nf##_t __riscv_vundefined_##sfx##x##nf(void) {        \
+    base##x##nf##_t t;                                                         \
+    memset(&t, 0x5A, sizeof(t));                                               \
+    return t;                                                                  \
+  }                                                                            \
+  static inline base##_t __riscv_vget_v_##sfx##x##nf##_##sfx(                  \
+      base##x##nf##_t t, size_t k) {                                           \
+    return t.f[k];                                                             \
+  }                                                                            \
+  static inline base##x##nf##_t __riscv_vset_v_##sfx##_##sfx##x##nf(           \
+      base##x##nf##_t t, size_t k, base##_t v) {                               \
+    t.f[k] = v;                                                                \
+    return t;                                                                  \
+  }                                                                            \
+  static inline base##x##nf##_t __riscv_vlseg##nf##e##sew##_v_##sfx##x##nf(    \
+      const elem *p, size_t vl) {                                              \
+    base##x##nf##_t t;                                                         \
+    size_t i, k;                                                               \
+    for (k = 0; k < (nf); k++) {                                               \
+      assert(vl <= RVV_LANES(t.f[k]));                                         \
+      for (i = 0; i < vl; i++)                                                 \
+        t.f[k].e[i] = p[(nf) * i + k];                                         \
+      RVV_TAIL(t.f[k], vl);                                                    \
+    }                                                                          \
+    return t;                                                                  \
+  }                                                                            \
+  static inline void __riscv_vsseg##nf##e##sew##_v_##sfx##x##nf(               \
+      elem *p, base##x##nf##_t t, size_t vl) {                                 \
+    size_t i, k;                                                               \
+    for (k = 0; k < (nf); k++)                                                 \
+      for (i = 0; i < vl; i++)                                                 \
+        p[(nf) * i + k] = t.f[k].e[i];                                         \
+  }
+
+RVV_TUPLE(i16m1, 2, vint16m1, int16_t, 16)
+RVV_TUPLE(i16m1, 4, vint16m1, int16_t, 16)
+RVV_TUPLE(i16m1, 8, vint16m1, int16_t, 16)
+RVV_TUPLE(i16m2, 2, vint16m2, int16_t, 16)
+RVV_TUPLE(u8mf2, 3, vuint8mf2, uint8_t, 8)
+RVV_TUPLE(u8mf2, 5, vuint8mf2, uint8_t, 8)
+
+#endif /* KYBER_MODEL_RISCV_VECTOR_H */
@@ -0,0 +1,48 @@
+#include "../bench/bench.h"
+#include "unity.h"
+#include <stdint.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Unity is built without doubles; compare p in units of 1e-7
+static long p_e7(double p) { return lround(p * 1e7); }
+
+// Complete separation, 5 vs 5: U = 25, mean 12.5, variance 25 * 11 / 12,
+// z = 12 / sqrt(22.9167) = 2.5067, p = 0.0060929 (the exact test gives
+// 1/252; this is the normal approximation bench_mann_whitney documents)
+void test_mann_whitney_separated(void) {
+  static const uint64_t a[] = {1, 2, 3, 4, 5};
+  static const uint64_t b[] = {6, 7, 8, 9, 10};
+
+  TEST_ASSERT_INT_WITHIN(1, 60929, p_e7(bench_mann_whitney(a, 5, b, 5)));
+  // Other direction: U = 0
+  TEST_ASSERT_INT_WITHIN(1, 9966923, p_e7(bench_mann_whitney(b, 5, a, 5)));
+}
+
+// With ties: the ranks of b are 3, 6, 6, 8, 9, so U = 32 - 15 = 17;
+// two groups of three ties give variance 20 / 12 * (10 - 48 / 72),
+// z = 6.5 / sqrt(15.5556) = 1.6481, p = 0.0496711
+void test_mann_whitney_ties(void) {
+  static const uint64_t a[] = {1, 2, 2, 3};
+  static const uint64_t b[] = {2, 3, 3, 4, 5};
+
+  TEST_ASSERT_INT_WITHIN(1, 496711, p_e7(bench_mann_whitney(a, 4, b, 5)));
+}
+
+// No information: empty sides or all values equal (zero variance)
+void test_mann_whitney_degenerate(void) {
+  static const uint64_t a[] = {4, 4, 4};
+
+  TEST_ASSERT_EQUAL_INT(10000000, p_e7(bench_mann_whitney(a, 0, a, 3)));
+  TEST_ASSERT_EQUAL_INT(10000000, p_e7(bench_mann_whitney(a, 3, a, 0)));
+  TEST_ASSERT_EQUAL_INT(10000000, p_e7(bench_mann_whitney(a, 3, a, 3)));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_mann_whitney_separated);
+  RUN_TEST(test_mann_whitney_ties);
+  RUN_TEST(test_mann_whitney_degenerate);
+  return UNITY_END();
+}
@@ -0,0 +1,80 @@
+#include "../include/entropy_ring.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+#define RING_BYTES 64
+
+static uint8_t storage[RING_BYTES];
+static kyber_entropy_ring ring;
+
+void setUp(void) {
+  memset(storage, 0, sizeof(storage));
+  kyber_entropy_ring_init(&ring, storage, RING_BYTES);
+}
+
+void tearDown(void) {}
+
+void test_ring_rejects_invalid_capacity(void) {
+  kyber_entropy_ring r;
+  TEST_ASSERT_EQUAL_INT(-1, kyber_entropy_ring_init(&r, storage, 0));
+  TEST_ASSERT_EQUAL_INT(-1, kyber_entropy_ring_init(&r, storage, 48));
+}
+
+void test_ring_preserves_order_across_wrap_and_wipes(void) {
+  uint8_t in[40], out[40];
+
+  for (unsigned int round = 0; round < 5; round++) {
+    for (unsigned int i = 0; i < sizeof(in); i++)
+      in[i] = (uint8_t)(round * 40 + i);
+    TEST_ASSERT_EQUAL_size_t(40, kyber_entropy_ring_push(&ring, in, 40));
+    TEST_ASSERT_EQUAL_size_t(40, kyber_entropy_ring_pop(&ring, out, 40));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(in, out, 40);
+  }
+
+  for (unsigned int i = 0; i < RING_BYTES; i++)
+    TEST_ASSERT_EQUAL_HEX8(0, storage[i]);
+}
+
+void test_ring_partial_push_and_pop(void) {
+  uint8_t in[RING_BYTES + 8], out[RING_BYTES + 8];
+
+  memset(in, 0xA5, sizeof(in));
+  TEST_ASSERT_EQUAL_size_t(RING_BYTES,
+                           kyber_entropy_ring_push(&ring, in, sizeof(in)));
+  TEST_ASSERT_EQUAL_size_t(0, kyber_entropy_ring_space(&ring));
+  TEST_ASSERT_EQUAL_size_t(0, kyber_entropy_ring_push(&ring, in, 1));
+
+  TEST_ASSERT_EQUAL_size_t(RING_BYTES,
+                           kyber_entropy_ring_pop(&ring, out, sizeof(out)));
+  TEST_ASSERT_EQUAL_size_t(0, kyber_entropy_ring_pop(&ring, out, 1));
+}
+
+#if defined(__linux__)
+void test_ring_with_emulated_trng_producer(void) {
+  kyber_entropy_sim sim;
+  uint8_t out[32], zero[32] = {0};
+  size_t got = 0;
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_entropy_sim_start(&sim, &ring, 1000));
+  while (got < 4096) {
+    size_t n = kyber_entropy_ring_pop(&ring, out, sizeof(out));
+    TEST_ASSERT_TRUE(kyber_entropy_ring_fill(&ring) <= RING_BYTES);
+    if (n == sizeof(out))
+      TEST_ASSERT_TRUE(memcmp(out, zero, sizeof(out)) != 0);
+    got += n;
+  }
+  kyber_entropy_sim_stop(&sim);
+}
+#endif
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_ring_rejects_invalid_capacity);
+  RUN_TEST(test_ring_preserves_order_across_wrap_and_wipes);
+  RUN_TEST(test_ring_partial_push_and_pop);
+#if defined(__linux__)
+  RUN_TEST(test_ring_with_emulated_trng_producer);
+#endif
+  return UNITY_END();
+}
@@ -0,0 +1,61 @@
+#include "../include/fips202.h"
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <stdint.h>
+
+/*************************************************
+ * The fixed-length entry points of fips202.c (sha3_256_32,
+ * sha3_512_32, sha3_512_64, shake256_33, shake256_64) against the
+ * generic functions. FIPS 202 vectors for the generic sponge are in
+ * test_keccak_bi32.
+ *************************************************/
+
+#define TRIALS 100
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// The single-block fast paths give the generic results, aligned or not
+void test_fixed_length_matches_generic(void) {
+  uint8_t buf[65], a[2 * SHAKE256_RATE], b[2 * SHAKE256_RATE];
+  const uint8_t *in;
+  unsigned int t;
+
+  for (t = 0; t < TRIALS; t++) {
+    randombytes(buf, sizeof(buf));
+    in = buf + (t & 1);
+
+    sha3_256_32(a, in);
+    sha3_256(b, in, 32);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, 32);
+
+    sha3_512_32(a, in);
+    sha3_512(b, in, 32);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, 64);
+
+    sha3_512_64(a, in);
+    sha3_512(b, in, 64);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, 64);
+
+    // Short, one block plus a tail, two full blocks
+    shake256_33(a, 32 + t, in);
+    shake256(b, 32 + t, in, 33);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, 32 + t);
+    shake256_33(a, sizeof(a), in);
+    shake256(b, sizeof(b), in, 33);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, sizeof(a));
+
+    shake256_64(a, 32, in);
+    shake256(b, 32, in, 64);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, 32);
+    shake256_64(a, SHAKE256_RATE + 56, in);
+    shake256(b, SHAKE256_RATE + 56, in, 64);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, SHAKE256_RATE + 56);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fixed_length_matches_generic);
+  return UNITY_END();
+}
@@ -0,0 +1,212 @@
+#include "../include/fips202.h"
+#include "../include/keccak_backend.h"
+#include "../include/kem.h"
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+/*************************************************
+ * The backend registry, the software backend and the emulated
+ * accelerator. Build with -DKYBER_KECCAK_BACKEND to also check that
+ * fips202.c hashes through whatever is registered.
+ *************************************************/
+
+void setUp(void) {}
+void tearDown(void) { kyber_keccak_register(NULL); }
+
+// Synchronous backend with whole-message hooks, counting its calls
+static unsigned int n_permute, n_absorb, n_squeeze;
+
+static void count_permute(void *ctx, uint64_t state[25]) {
+  (void)ctx;
+  n_permute++;
+  KeccakF1600_StatePermute(state);
+}
+
+static void count_absorb(void *ctx, uint64_t s[25], unsigned int r,
+                         const uint8_t *in, size_t inlen, uint8_t p) {
+  uint8_t t[200];
+  size_t i;
+
+  (void)ctx;
+  n_absorb++;
+  memset(s, 0, 25 * sizeof(uint64_t));
+  for (;;) {
+    memset(t, 0, r);
+    memcpy(t, in, inlen < r ? inlen : r);
+    if (inlen < r) {
+      t[inlen] = p;
+      t[r - 1] |= 128;
+    }
+    for (i = 0; i < r / 8; i++) {
+      uint64_t w;
+      memcpy(&w, t + 8 * i, 8);
+      s[i] ^= w;
+    }
+    if (inlen < r)
+      return;
+    KeccakF1600_StatePermute(s);
+    in += r;
+    inlen -= r;
+  }
+}
+
+static void count_squeeze(void *ctx, uint8_t *out, size_t nblocks,
+                          uint64_t s[25], unsigned int r) {
+  (void)ctx;
+  n_squeeze++;
+  while (nblocks--) {
+    KeccakF1600_StatePermute(s);
+    memcpy(out, s, r);
+    out += r;
+  }
+}
+
+static const kyber_keccak_backend counting = {
+    "counting", NULL, count_permute, NULL, NULL, count_absorb, count_squeeze};
+
+static int never_submit(void *ctx, kyber_keccak_job *job) {
+  (void)ctx;
+  (void)job;
+  return -1;
+}
+
+void test_register_rejects_incomplete_backend(void) {
+  kyber_keccak_backend half = {"half", NULL, NULL, NULL, NULL, NULL, NULL};
+
+  TEST_ASSERT_EQUAL_INT(-1, kyber_keccak_register(&half));
+  half.submit = never_submit; // Submit without poll
+  TEST_ASSERT_EQUAL_INT(-1, kyber_keccak_register(&half));
+  TEST_ASSERT_EQUAL_PTR(&kyber_keccak_software, kyber_keccak_backend_get());
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_register(&counting));
+  TEST_ASSERT_EQUAL_PTR(&counting, kyber_keccak_backend_get());
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_register(NULL));
+  TEST_ASSERT_EQUAL_PTR(&kyber_keccak_software, kyber_keccak_backend_get());
+}
+
+// A permute-only backend still serves the submit/poll style
+void test_submit_poll_on_synchronous_backend(void) {
+  uint64_t a[25], b[25];
+  kyber_keccak_job job;
+
+  randombytes((uint8_t *)a, sizeof(a));
+  memcpy(b, a, sizeof(a));
+  KeccakF1600_StatePermute(b);
+
+  job.state = a;
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_submit(&job));
+  TEST_ASSERT_EQUAL_INT(1, kyber_keccak_poll(&job));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, sizeof(a));
+
+  kyber_keccak_permute(a);
+  KeccakF1600_StatePermute(b);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, sizeof(a));
+}
+
+// Same digests through the hooks; they are only used when routed
+void test_hashing_through_registered_backend(void) {
+  uint8_t msg[300], ref[3][200], out[3][200];
+
+  randombytes(msg, sizeof(msg));
+  sha3_256(ref[0], msg, sizeof(msg));
+  sha3_512_64(ref[1], msg);
+  shake128(ref[2], sizeof(ref[2]), msg, 34);
+
+  n_permute = n_absorb = n_squeeze = 0;
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_register(&counting));
+  sha3_256(out[0], msg, sizeof(msg));
+  sha3_512_64(out[1], msg);
+  shake128(out[2], sizeof(out[2]), msg, 34);
+  kyber_keccak_register(NULL);
+
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ref[0], out[0], 32);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ref[1], out[1], 64);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ref[2], out[2], sizeof(out[2]));
+#if defined(KYBER_KECCAK_BACKEND)
+  TEST_ASSERT_EQUAL_UINT(3, n_absorb);
+  TEST_ASSERT_EQUAL_UINT(1, n_squeeze);
+  TEST_ASSERT_EQUAL_UINT(3, n_permute); // Final blocks of each
+#else
+  TEST_ASSERT_EQUAL_UINT(0, n_absorb + n_squeeze + n_permute);
+#endif
+}
+
+#if defined(__linux__)
+#define DEPTH 3
+
+// Jobs complete in order; a full queue refuses more
+void test_offload_queue_and_backpressure(void) {
+  kyber_keccak_offload o;
+  kyber_keccak_job jobs[DEPTH + 1];
+  uint64_t s[DEPTH + 1][25], ref[DEPTH + 1][25];
+  unsigned int i;
+
+  randombytes((uint8_t *)s, sizeof(s));
+  memcpy(ref, s, sizeof(s));
+  for (i = 0; i < DEPTH; i++)
+    KeccakF1600_StatePermute(ref[i]);
+
+  // Long enough that no job finishes while the queue is filled
+  TEST_ASSERT_EQUAL_INT(-1, kyber_keccak_offload_start(&o, 0, 0));
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_offload_start(&o, 20000000, DEPTH));
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_register(&o.backend));
+
+  for (i = 0; i <= DEPTH; i++)
+    jobs[i].state = s[i];
+  for (i = 0; i < DEPTH; i++)
+    TEST_ASSERT_EQUAL_INT(0, kyber_keccak_submit(&jobs[i]));
+  TEST_ASSERT_EQUAL_INT(-1, kyber_keccak_submit(&jobs[DEPTH]));
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_poll(&jobs[DEPTH - 1]));
+
+  kyber_keccak_wait(&jobs[0]);
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_poll(&jobs[DEPTH - 1]));
+  for (i = 1; i < DEPTH; i++)
+    kyber_keccak_wait(&jobs[i]);
+
+  kyber_keccak_register(NULL);
+  kyber_keccak_offload_stop(&o);
+
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ref, s, sizeof(s));
+  TEST_ASSERT_EQUAL_UINT(DEPTH, (unsigned int)o.completed);
+  TEST_ASSERT_EQUAL_UINT(1, (unsigned int)o.rejected);
+  TEST_ASSERT_EQUAL_UINT(DEPTH, o.peak);
+}
+
+// A full KEM round trip on the accelerator
+void test_offload_kem_roundtrip(void) {
+  uint8_t pk[KYBER_PUBLICKEYBYTES], sk[KYBER_SECRETKEYBYTES];
+  uint8_t ct[KYBER_CIPHERTEXTBYTES], ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+  kyber_keccak_offload o;
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_offload_start(&o, 1000, 2));
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_register(&o.backend));
+
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair(pk, sk));
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_enc(ct, ss1, pk));
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_dec(ss2, ct, sk));
+
+  kyber_keccak_register(NULL);
+  kyber_keccak_offload_stop(&o);
+
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ss1, ss2, KYBER_SSBYTES);
+#if defined(KYBER_KECCAK_BACKEND)
+  TEST_ASSERT_TRUE(o.completed > 0);
+#else
+  TEST_ASSERT_EQUAL_UINT(0, (unsigned int)o.completed);
+#endif
+}
+#endif
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_register_rejects_incomplete_backend);
+  RUN_TEST(test_submit_poll_on_synchronous_backend);
+  RUN_TEST(test_hashing_through_registered_backend);
+#if defined(__linux__)
+  RUN_TEST(test_offload_queue_and_backpressure);
+  RUN_TEST(test_offload_kem_roundtrip);
+#endif
+  return UNITY_END();
+}
@@ -0,0 +1,190 @@
+#include "../include/fips202.h"
+#include "../include/keccak_bi32.h"
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+/*************************************************
+ * The bit-interleaved permutation against a plain 64-bit one, and the
+ * sponge (in whichever form fips202.c was built) against FIPS 202
+ * values. Build with -DKYBER_KECCAK_BI32, ideally for a 32-bit target
+ * (gcc -m32, see platforms/i386/m32.sh), to cover the interleaved
+ * sponge as well.
+ *************************************************/
+
+#define TRIALS 100
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static const uint8_t sha3_256_abc[32] = {
+    0x3a, 0x98, 0x5d, 0xa7, 0x4f, 0xe2, 0x25, 0xb2, 0x04, 0x5c, 0x17, 0x2d,
+    0x6b, 0xd3, 0x90, 0xbd, 0x85, 0x5f, 0x08, 0x6e, 0x3e, 0x9d, 0x52, 0x5b,
+    0x46, 0xbf, 0xe2, 0x45, 0x11, 0x43, 0x15, 0x32};
+
+static const uint8_t sha3_512_abc[64] = {
+    0xb7, 0x51, 0x85, 0x0b, 0x1a, 0x57, 0x16, 0x8a, 0x56, 0x93, 0xcd, 0x92,
+    0x4b, 0x6b, 0x09, 0x6e, 0x08, 0xf6, 0x21, 0x82, 0x74, 0x44, 0xf7, 0x0d,
+    0x88, 0x4f, 0x5d, 0x02, 0x40, 0xd2, 0x71, 0x2e, 0x10, 0xe1, 0x16, 0xe9,
+    0x19, 0x2a, 0xf3, 0xc9, 0x1a, 0x7e, 0xc5, 0x76, 0x47, 0xe3, 0x93, 0x40,
+    0x57, 0x34, 0x0b, 0x4c, 0xf4, 0x08, 0xd5, 0xa5, 0x65, 0x92, 0xf8, 0x27,
+    0x4e, 0xec, 0x53, 0xf0};
+
+static const uint8_t sha3_256_long[32] = {
+    0xc2, 0x79, 0xa0, 0x59, 0x86, 0x94, 0xbe, 0x2d, 0x8a, 0x97, 0xf7, 0x4e,
+    0xd7, 0x33, 0xa5, 0x5a, 0xa0, 0x50, 0x12, 0xd6, 0x72, 0x31, 0x86, 0xb1,
+    0x26, 0x1d, 0xba, 0x77, 0x92, 0xaa, 0x4d, 0xfd};
+
+static const uint8_t shake128_long_tail[32] = {
+    0xd8, 0x8d, 0x3e, 0xf4, 0x06, 0x20, 0x64, 0xb5, 0x1f, 0x60, 0xa2, 0x64,
+    0x8c, 0xb5, 0x63, 0x80, 0x54, 0xc8, 0x92, 0x25, 0x40, 0x8e, 0x59, 0x59,
+    0x53, 0xba, 0x6e, 0x87, 0x76, 0x0c, 0x25, 0x8a};
+
+static const uint8_t shake256_long_tail[32] = {
+    0x45, 0x44, 0x7c, 0x2b, 0xba, 0x6e, 0xd0, 0xc9, 0xbe, 0x2f, 0x96, 0xb9,
+    0xf9, 0x35, 0x2c, 0x81, 0x8c, 0x06, 0x58, 0x19, 0x3b, 0x79, 0x76, 0x9c,
+    0x66, 0xcb, 0xe4, 0x88, 0xeb, 0x98, 0xd3, 0x7a};
+
+// Independent 64-bit Keccak-f[1600], straight from the specification
+static void keccakf_ref(uint64_t s[25]) {
+  static const unsigned int rho[25] = {0,  1,  62, 28, 27, 36, 44, 6,  55,
+                                       20, 3,  10, 43, 25, 39, 41, 45, 15,
+                                       21, 8,  18, 2,  61, 56, 14};
+  uint64_t c[5], b[25], rc;
+  unsigned int round, x, y, j, lfsr = 1;
+
+  for (round = 0; round < 24; round++) {
+    for (x = 0; x < 5; x++)
+      c[x] = s[x] ^ s[x + 5] ^ s[x + 10] ^ s[x + 15] ^ s[x + 20];
+    for (x = 0; x < 25; x++)
+      s[x] ^= c[(x + 4) % 5] ^ (c[(x + 1) % 5] << 1 | c[(x + 1) % 5] >> 63);
+    for (x = 0; x < 5; x++)
+      for (y = 0; y < 5; y++)
+        b[y + 5 * ((2 * x + 3 * y) % 5)] =
+            rho[x + 5 * y] ? s[x + 5 * y] << rho[x + 5 * y] |
+                                 s[x + 5 * y] >> (64 - rho[x + 5 * y])
+                           : s[x + 5 * y];
+    for (y = 0; y < 25; y += 5)
+      for (x = 0; x < 5; x++)
+        s[y + x] = b[y + x] ^ (~b[y + (x + 1) % 5] & b[y + (x + 2) % 5]);
+    // Round constant bits from the degree-8 LFSR of the specification
+    rc = 0;
+    for (j = 0; j < 7; j++) {
+      if (lfsr & 1)
+        rc |= 1ULL << ((1u << j) - 1);
+      lfsr = (lfsr << 1) ^ ((lfsr & 0x80) ? 0x171 : 0);
+    }
+    s[0] ^= rc;
+  }
+}
+
+// Unity's 64-bit assertions are off on 32-bit targets, so lanes are
+// compared as memory
+#define ASSERT_LANE(expected, actual)                                          \
+  do {                                                                         \
+    uint64_t e_ = (expected), a_ = (actual);                                   \
+    TEST_ASSERT_EQUAL_HEX8_ARRAY((uint8_t *)&e_, (uint8_t *)&a_, 8);           \
+  } while (0)
+
+void test_interleave_roundtrip(void) {
+  uint64_t lane;
+  unsigned int n, k;
+
+  for (k = 0; k < 32; k++) {
+    ASSERT_LANE(1ULL << k, keccak_bi32_interleave(1ULL << 2 * k));
+    ASSERT_LANE(1ULL << (32 + k), keccak_bi32_interleave(1ULL << (2 * k + 1)));
+  }
+  for (n = 0; n < 1000; n++) {
+    randombytes((uint8_t *)&lane, sizeof(lane));
+    ASSERT_LANE(lane, keccak_bi32_deinterleave(keccak_bi32_interleave(lane)));
+  }
+}
+
+void test_bi32_matches_64bit(void) {
+  uint64_t ref[25], s[25], t[25];
+  unsigned int n, i;
+
+  for (n = 0; n < TRIALS; n++) {
+    randombytes((uint8_t *)ref, sizeof(ref));
+    memcpy(s, ref, sizeof(ref));
+    for (i = 0; i < 25; i++)
+      t[i] = keccak_bi32_interleave(ref[i]);
+
+    keccakf_ref(ref);
+    KeccakF1600_StatePermute(s);
+    KeccakF1600_StatePermute_bi32(t);
+    for (i = 0; i < 25; i++)
+      t[i] = keccak_bi32_deinterleave(t[i]);
+
+    TEST_ASSERT_EQUAL_MEMORY(ref, s, sizeof(ref));
+    TEST_ASSERT_EQUAL_MEMORY(ref, t, sizeof(ref));
+  }
+}
+
+void test_zero_state(void) {
+  uint64_t s[25];
+
+  memset(s, 0, sizeof(s));
+  KeccakF1600_StatePermute(s);
+  ASSERT_LANE(0xF1258F7940E1DDE7ULL, s[0]);
+  ASSERT_LANE(0x84D5CCF933C0478AULL, s[1]);
+  ASSERT_LANE(0xEAF1FF7B5CECA249ULL, s[24]);
+}
+
+// Multi-block absorb and squeeze, partial last blocks
+void test_sponge_vectors(void) {
+  uint8_t msg[500], out[400];
+  unsigned int i;
+
+  for (i = 0; i < sizeof(msg); i++)
+    msg[i] = (uint8_t)(i * 7);
+
+  sha3_256(out, (const uint8_t *)"abc", 3);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(sha3_256_abc, out, 32);
+  sha3_512(out, (const uint8_t *)"abc", 3);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(sha3_512_abc, out, 64);
+  sha3_256(out, msg, sizeof(msg));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(sha3_256_long, out, 32);
+  shake128(out, 400, msg, sizeof(msg));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(shake128_long_tail, out + 400 - 32, 32);
+  shake256(out, 300, msg, sizeof(msg));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(shake256_long_tail, out + 300 - 32, 32);
+}
+
+// The incremental interfaces keep the state between calls
+void test_incremental_matches_oneshot(void) {
+  uint8_t msg[500], a[3 * SHAKE128_RATE], b[3 * SHAKE128_RATE];
+  keccak_state st;
+
+  randombytes(msg, sizeof(msg));
+
+  shake128_absorb(&st, msg, 34);
+  shake128_squeezeblocks(a, 1, &st);
+  shake128_squeezeblocks(a + SHAKE128_RATE, 2, &st);
+  shake128(b, sizeof(b), msg, 34);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, sizeof(a));
+
+  shake256_absorb(&st, msg, sizeof(msg));
+  shake256_squeezeblocks(a, 2, &st);
+  shake256(b, 2 * SHAKE256_RATE, msg, sizeof(msg));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, 2 * SHAKE256_RATE);
+
+  sha3_256_inc_init(&st);
+  sha3_256_inc_absorb_block(&st, msg);
+  sha3_256_inc_absorb_block(&st, msg + SHA3_256_RATE);
+  sha3_256_inc_finalize(a, &st, msg + 2 * SHA3_256_RATE,
+                        sizeof(msg) - 3 * SHA3_256_RATE);
+  sha3_256(b, msg, sizeof(msg) - SHA3_256_RATE);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(b, a, 32);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_interleave_roundtrip);
+  RUN_TEST(test_bi32_matches_64bit);
+  RUN_TEST(test_zero_state);
+  RUN_TEST(test_sponge_vectors);
+  RUN_TEST(test_incremental_matches_oneshot);
+  return UNITY_END();
+}
@@ -5,6 +5,7 @@
  * keygen -> encaps -> decaps -> compare keys
  *************************************************/
 
+#include "../include/fips202.h"
 #include "../include/kem.h"
 #include "../include/params.h"
 #include <stdio.h>
@@ -16,6 +17,8 @@ int main(void) {
   uint8_t ct[KYBER_CIPHERTEXTBYTES];
   uint8_t ss1[KYBER_SSBYTES]; // Sender's shared secret
   uint8_t ss2[KYBER_SSBYTES]; // Receiver's shared secret
+  uint8_t ss3[KYBER_SSBYTES]; // Decapsulation of a tampered ciphertext
+  uint8_t rej[2 * KYBER_SYMBYTES];
   int i;
 
   printf("===========================================\n");
@@ -40,15 +43,33 @@ int main(void) {
 
   // Compare shared secrets
   printf("[4] Comparing shared secrets...\n");
-  if (memcmp(ss1, ss2, KYBER_SSBYTES) == 0) {
-    printf("    SUCCESS! Shared secrets match.\n\n");
-    printf("Shared secret (hex): ");
-    for (i = 0; i < KYBER_SSBYTES && i < 16; i++)
-      printf("%02x", ss1[i]);
-    printf("...\n");
-    return 0;
-  } else {
+  if (memcmp(ss1, ss2, KYBER_SSBYTES) != 0) {
     printf("    FAILURE! Shared secrets do NOT match.\n");
     return 1;
   }
+  printf("    SUCCESS! Shared secrets match.\n\n");
+  printf("Shared secret (hex): ");
+  for (i = 0; i < KYBER_SSBYTES && i < 16; i++)
+    printf("%02x", ss1[i]);
+  printf("...\n\n");
+
+  // Implicit rejection: a modified ciphertext must decapsulate to
+  // KDF(z || H(c)), the rejection key, and not to the real secret
+  printf("[5] Decapsulating a tampered ciphertext...\n");
+  ct[KYBER_CIPHERTEXTBYTES / 2] ^= 0x01;
+  crypto_kem_dec(ss3, ct, sk);
+  memcpy(rej, sk + KYBER_SECRETKEYBYTES - KYBER_SYMBYTES, KYBER_SYMBYTES);
+  sha3_256(rej + KYBER_SYMBYTES, ct, KYBER_CIPHERTEXTBYTES);
+  shake256(ss2, KYBER_SSBYTES, rej, sizeof(rej));
+
+  if (memcmp(ss3, ss1, KYBER_SSBYTES) == 0) {
+    printf("    FAILURE! Tampered ciphertext gave the real secret.\n");
+    return 1;
+  }
+  if (memcmp(ss3, ss2, KYBER_SSBYTES) != 0) {
+    printf("    FAILURE! Output is not the rejection key.\n");
+    return 1;
+  }
+  printf("    SUCCESS! Rejection key returned.\n");
+  return 0;
 }
@@ -0,0 +1,105 @@
+#include "../include/kem.h"
+#include "../include/kem_batch.h"
+#include "../include/params.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+#define WORKERS 3
+#define MAX_ITEMS (4 * WORKERS + 1)
+
+static uint8_t pk[MAX_ITEMS * KYBER_PUBLICKEYBYTES];
+static uint8_t sk[MAX_ITEMS * KYBER_SECRETKEYBYTES];
+static uint8_t ct[MAX_ITEMS * KYBER_CIPHERTEXTBYTES];
+static uint8_t ss[MAX_ITEMS * KYBER_SSBYTES];
+static uint8_t ss_dec[MAX_ITEMS * KYBER_SSBYTES];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Keypair, enc and dec batches of n items, each item checked against
+// the single-shot API
+static void check_batch(size_t n) {
+  uint8_t ref[KYBER_SSBYTES];
+  size_t i;
+
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair_batch(pk, sk, n));
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_enc_batch(ct, ss, pk, n));
+
+  // Tamper with every other ciphertext so dec covers both outcomes
+  for (i = 1; i < n; i += 2)
+    ct[i * KYBER_CIPHERTEXTBYTES] ^= 0x01;
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_dec_batch(ss_dec, ct, sk, n));
+
+  for (i = 0; i < n; i++) {
+    crypto_kem_dec(ref, ct + i * KYBER_CIPHERTEXTBYTES,
+                   sk + i * KYBER_SECRETKEYBYTES);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ref, ss_dec + i * KYBER_SSBYTES,
+                                 KYBER_SSBYTES);
+    if (i % 2 == 0)
+      TEST_ASSERT_EQUAL_HEX8_ARRAY(ss + i * KYBER_SSBYTES, ref,
+                                   KYBER_SSBYTES);
+    else
+      TEST_ASSERT_FALSE(memcmp(ss + i * KYBER_SSBYTES, ref,
+                               KYBER_SSBYTES) == 0);
+  }
+
+  // Keys of the batch serve the single-shot API too
+  for (i = 0; i < n; i++) {
+    uint8_t c[KYBER_CIPHERTEXTBYTES], k[KYBER_SSBYTES];
+
+    crypto_kem_enc(c, k, pk + i * KYBER_PUBLICKEYBYTES);
+    crypto_kem_dec(ref, c, sk + i * KYBER_SECRETKEYBYTES);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(k, ref, KYBER_SSBYTES);
+  }
+}
+
+void test_batch_init_and_shutdown(void) {
+  TEST_ASSERT_EQUAL_UINT(0, kyber_batch_threads());
+  TEST_ASSERT_EQUAL_INT(0, kyber_batch_init(WORKERS));
+  TEST_ASSERT_EQUAL_INT(-1, kyber_batch_init(WORKERS));
+  TEST_ASSERT_EQUAL_UINT(WORKERS, kyber_batch_threads());
+  kyber_batch_shutdown();
+  TEST_ASSERT_EQUAL_UINT(0, kyber_batch_threads());
+  kyber_batch_shutdown();
+}
+
+// An empty batch touches nothing
+void test_batch_zero_items(void) {
+  TEST_ASSERT_EQUAL_INT(0, kyber_batch_init(WORKERS));
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair_batch(NULL, NULL, 0));
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_enc_batch(NULL, NULL, NULL, 0));
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_dec_batch(NULL, NULL, NULL, 0));
+  kyber_batch_shutdown();
+}
+
+void test_batch_one_item(void) {
+  TEST_ASSERT_EQUAL_INT(0, kyber_batch_init(WORKERS));
+  check_batch(1);
+  kyber_batch_shutdown();
+}
+
+// More items than workers, an uneven split, so ranges get stolen
+void test_batch_more_items_than_workers(void) {
+  TEST_ASSERT_EQUAL_INT(0, kyber_batch_init(WORKERS));
+  check_batch(MAX_ITEMS);
+  check_batch(WORKERS + 1);
+  kyber_batch_shutdown();
+}
+
+// Without kyber_batch_init the pool starts on first use
+void test_batch_starts_on_demand(void) {
+  check_batch(WORKERS);
+  TEST_ASSERT_TRUE(kyber_batch_threads() >= 1);
+  kyber_batch_shutdown();
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_batch_init_and_shutdown);
+  RUN_TEST(test_batch_zero_items);
+  RUN_TEST(test_batch_one_item);
+  RUN_TEST(test_batch_more_items_than_workers);
+  RUN_TEST(test_batch_starts_on_demand);
+  return UNITY_END();
+}
@@ -0,0 +1,68 @@
+#include "../include/kem.h"
+#include "../include/kem_dec_xn.h"
+#include "../include/params.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+#define N_BATCH (2 * KYBER_XN_LANES + 3)
+
+static uint8_t pk[KYBER_PUBLICKEYBYTES];
+static uint8_t sk[KYBER_SECRETKEYBYTES];
+static uint8_t ct[N_BATCH][KYBER_CIPHERTEXTBYTES];
+static uint8_t ss_enc[N_BATCH][KYBER_SSBYTES];
+static uint8_t ss_ref[N_BATCH][KYBER_SSBYTES];
+static uint8_t ss_xn[N_BATCH][KYBER_SSBYTES];
+
+void setUp(void) {
+  crypto_kem_keypair(pk, sk);
+  for (int i = 0; i < N_BATCH; i++)
+    crypto_kem_enc(ct[i], ss_enc[i], pk);
+  memset(ss_xn, 0, sizeof(ss_xn));
+}
+
+void tearDown(void) {}
+
+void test_dec_xn_matches_scalar(void) {
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_dec_xn(ss_xn, ct, sk));
+
+  for (int i = 0; i < KYBER_XN_LANES; i++)
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ss_enc[i], ss_xn[i], KYBER_SSBYTES);
+}
+
+void test_dec_xn_implicit_rejection_matches_scalar(void) {
+  // Corrupt every other lane so accept and reject paths are mixed
+  for (int i = 0; i < KYBER_XN_LANES; i += 2)
+    ct[i][(i * 37) % KYBER_CIPHERTEXTBYTES] ^= 1 << (i % 8);
+
+  for (int i = 0; i < KYBER_XN_LANES; i++)
+    crypto_kem_dec(ss_ref[i], ct[i], sk);
+  crypto_kem_dec_xn(ss_xn, ct, sk);
+
+  for (int i = 0; i < KYBER_XN_LANES; i++) {
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ss_ref[i], ss_xn[i], KYBER_SSBYTES);
+    if (i % 2 == 0)
+      TEST_ASSERT_TRUE(memcmp(ss_enc[i], ss_xn[i], KYBER_SSBYTES) != 0);
+  }
+}
+
+void test_dec_xn_batch_handles_tail(void) {
+  ct[N_BATCH - 1][0] ^= 0x80;
+  crypto_kem_dec(ss_ref[N_BATCH - 1], ct[N_BATCH - 1], sk);
+
+  TEST_ASSERT_EQUAL_INT(
+      0, crypto_kem_dec_xn_batch(&ss_xn[0][0], &ct[0][0], sk, N_BATCH));
+
+  for (int i = 0; i < N_BATCH - 1; i++)
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ss_enc[i], ss_xn[i], KYBER_SSBYTES);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ss_ref[N_BATCH - 1], ss_xn[N_BATCH - 1],
+                               KYBER_SSBYTES);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_dec_xn_matches_scalar);
+  RUN_TEST(test_dec_xn_implicit_rejection_matches_scalar);
+  RUN_TEST(test_dec_xn_batch_handles_tail);
+  return UNITY_END();
+}
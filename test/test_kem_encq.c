@@ -0,0 +1,152 @@
+#include "../include/kem.h"
+#include "../include/kem_encq.h"
+#include "../include/params.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#define CAPACITY 4
+
+static uint8_t pk[KYBER_PUBLICKEYBYTES];
+static uint8_t sk[KYBER_SECRETKEYBYTES];
+static kyber_encq_entry entries[CAPACITY];
+static kyber_encq q;
+
+void setUp(void) {
+  crypto_kem_keypair(pk, sk);
+  TEST_ASSERT_EQUAL_INT(0, kyber_encq_init(&q, pk, entries, CAPACITY));
+}
+void tearDown(void) {
+#if defined(KYBER_PLATFORM_DESKTOP)
+  kyber_encq_stop(&q);
+#endif
+}
+
+// Takes one pair and checks it decapsulates under sk
+static void get_and_check(void) {
+  uint8_t ct[KYBER_CIPHERTEXTBYTES];
+  uint8_t ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_encq_get(&q, ct, ss1));
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_dec(ss2, ct, sk));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ss1, ss2, KYBER_SSBYTES);
+}
+
+void test_encq_rejects_invalid_capacity(void) {
+  kyber_encq r;
+
+  TEST_ASSERT_EQUAL_INT(-1, kyber_encq_init(&r, pk, entries, 0));
+  TEST_ASSERT_EQUAL_INT(-1, kyber_encq_init(&r, pk, entries, 3));
+  TEST_ASSERT_EQUAL_INT(0, kyber_encq_init(&r, pk, entries, 1));
+}
+
+void test_encq_queued_pairs_decapsulate(void) {
+  unsigned int i;
+
+  for (i = 0; i < CAPACITY; i++)
+    TEST_ASSERT_EQUAL_INT(1, kyber_encq_refill_step(&q));
+  TEST_ASSERT_EQUAL_UINT(CAPACITY, (unsigned int)kyber_encq_fill(&q));
+
+  for (i = 0; i < CAPACITY; i++)
+    get_and_check();
+  TEST_ASSERT_EQUAL_UINT(0, (unsigned int)kyber_encq_fill(&q));
+  TEST_ASSERT_EQUAL_UINT32(CAPACITY, q.hits);
+  TEST_ASSERT_EQUAL_UINT32(0, q.misses);
+}
+
+// A full queue produces nothing and keeps its pairs
+void test_encq_full_refuses_refill(void) {
+  uint8_t ct[KYBER_CIPHERTEXTBYTES];
+  unsigned int i;
+
+  for (i = 0; i < CAPACITY; i++)
+    kyber_encq_refill_step(&q);
+  memcpy(ct, entries[0].ct, sizeof(ct));
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_encq_refill_step(&q));
+  TEST_ASSERT_EQUAL_UINT(CAPACITY, (unsigned int)kyber_encq_fill(&q));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ct, entries[0].ct, sizeof(ct));
+
+  // One slot frees up, one more pair fits, in the wrapped slot
+  get_and_check();
+  TEST_ASSERT_EQUAL_INT(1, kyber_encq_refill_step(&q));
+  TEST_ASSERT_EQUAL_INT(0, kyber_encq_refill_step(&q));
+  for (i = 0; i < CAPACITY; i++)
+    get_and_check();
+}
+
+// An empty queue encapsulates inline and counts a miss
+void test_encq_empty_falls_back_inline(void) {
+  kyber_encq_refill_step(&q);
+  get_and_check();
+  get_and_check();
+  get_and_check();
+
+  TEST_ASSERT_EQUAL_UINT32(1, q.hits);
+  TEST_ASSERT_EQUAL_UINT32(2, q.misses);
+  TEST_ASSERT_EQUAL_UINT(0, (unsigned int)kyber_encq_fill(&q));
+}
+
+// Taken and cleared secrets do not stay in the entry storage
+void test_encq_wipes_consumed_secrets(void) {
+  const uint8_t zero[KYBER_SSBYTES] = {0};
+  unsigned int i;
+
+  for (i = 0; i < CAPACITY; i++)
+    kyber_encq_refill_step(&q);
+  get_and_check();
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(zero, entries[0].ss, KYBER_SSBYTES);
+
+  kyber_encq_clear(&q);
+  TEST_ASSERT_EQUAL_UINT(0, (unsigned int)kyber_encq_fill(&q));
+  for (i = 0; i < CAPACITY; i++)
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(zero, entries[i].ss, KYBER_SSBYTES);
+  get_and_check(); // Miss after clear
+  TEST_ASSERT_EQUAL_UINT32(1, q.misses);
+}
+
+#if defined(KYBER_PLATFORM_DESKTOP)
+static void wait_for_fill(size_t fill) {
+  struct timespec ts = {0, 1000000};
+
+  for (int i = 0; i < 10000; i++) {
+    if (kyber_encq_fill(&q) >= fill)
+      return;
+    nanosleep(&ts, NULL);
+  }
+  TEST_FAIL_MESSAGE("queue did not fill up");
+}
+
+// The thread fills the queue, sleeps, and is woken by get
+void test_encq_background_refill(void) {
+  unsigned int i;
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_encq_start(&q));
+  wait_for_fill(CAPACITY);
+
+  for (i = 0; i < 2 * CAPACITY; i++) {
+    wait_for_fill(1);
+    get_and_check();
+  }
+  wait_for_fill(CAPACITY);
+  kyber_encq_stop(&q);
+
+  TEST_ASSERT_EQUAL_UINT32(2 * CAPACITY, q.hits);
+  TEST_ASSERT_EQUAL_UINT32(0, q.misses);
+  TEST_ASSERT_EQUAL_UINT(CAPACITY, (unsigned int)kyber_encq_fill(&q));
+}
+#endif
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_encq_rejects_invalid_capacity);
+  RUN_TEST(test_encq_queued_pairs_decapsulate);
+  RUN_TEST(test_encq_full_refuses_refill);
+  RUN_TEST(test_encq_empty_falls_back_inline);
+  RUN_TEST(test_encq_wipes_consumed_secrets);
+#if defined(KYBER_PLATFORM_DESKTOP)
+  RUN_TEST(test_encq_background_refill);
+#endif
+  return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include "../include/kem.h"
+#include "../include/kem_pool.h"
+#include "../include/params.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+static kyber_keypair_pool *pool;
+
+void setUp(void) { pool = NULL; }
+void tearDown(void) { kyber_keypair_pool_destroy(pool); }
+
+static void wait_for_fill(size_t fill) {
+  kyber_keypair_pool_stats stats;
+  struct timespec ts = {0, 1000000};
+
+  for (int i = 0; i < 10000; i++) {
+    kyber_keypair_pool_get_stats(pool, &stats);
+    if (stats.fill >= fill)
+      return;
+    nanosleep(&ts, NULL);
+  }
+  TEST_FAIL_MESSAGE("pool did not fill up");
+}
+
+void test_pool_rejects_invalid_config(void) {
+  kyber_keypair_pool_config cfg = {4, 8, 1};
+
+  TEST_ASSERT_EQUAL_INT(-1, kyber_keypair_pool_create(&pool, &cfg));
+  TEST_ASSERT_NULL(pool);
+
+  cfg.low_watermark = 2;
+  cfg.threads = 0;
+  TEST_ASSERT_EQUAL_INT(-1, kyber_keypair_pool_create(&pool, &cfg));
+}
+
+void test_pool_fills_to_capacity_and_counts_hits(void) {
+  kyber_keypair_pool_config cfg = {8, 2, 2};
+  kyber_keypair_pool_stats stats;
+  uint8_t pk[KYBER_PUBLICKEYBYTES];
+  uint8_t sk[KYBER_SECRETKEYBYTES];
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_keypair_pool_create(&pool, &cfg));
+  wait_for_fill(8);
+
+  for (int i = 0; i < 6; i++)
+    TEST_ASSERT_EQUAL_INT(0, kyber_keypair_pool_get(pool, pk, sk));
+
+  kyber_keypair_pool_get_stats(pool, &stats);
+  TEST_ASSERT_EQUAL_UINT64(6, stats.hits);
+  TEST_ASSERT_EQUAL_UINT64(0, stats.misses);
+  TEST_ASSERT_TRUE(stats.generated >= 8);
+}
+
+void test_pool_refills_below_watermark(void) {
+  kyber_keypair_pool_config cfg = {4, 2, 1};
+  uint8_t pk[KYBER_PUBLICKEYBYTES];
+  uint8_t sk[KYBER_SECRETKEYBYTES];
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_keypair_pool_create(&pool, &cfg));
+  wait_for_fill(4);
+
+  for (int i = 0; i < 3; i++)
+    kyber_keypair_pool_get(pool, pk, sk);
+
+  wait_for_fill(4);
+}
+
+void test_pool_keypairs_round_trip(void) {
+  kyber_keypair_pool_config cfg = {2, 1, 1};
+  kyber_keypair_pool_stats stats;
+  uint8_t pk[KYBER_PUBLICKEYBYTES];
+  uint8_t sk[KYBER_SECRETKEYBYTES];
+  uint8_t ct[KYBER_CIPHERTEXTBYTES];
+  uint8_t ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_keypair_pool_create(&pool, &cfg));
+
+  // Drain faster than one worker can refill: mixes hits and misses
+  for (int i = 0; i < 8; i++) {
+    TEST_ASSERT_EQUAL_INT(0, kyber_keypair_pool_get(pool, pk, sk));
+    crypto_kem_enc(ct, ss1, pk);
+    crypto_kem_dec(ss2, ct, sk);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ss1, ss2, KYBER_SSBYTES);
+  }
+
+  kyber_keypair_pool_get_stats(pool, &stats);
+  TEST_ASSERT_EQUAL_UINT64(8, stats.hits + stats.misses);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_pool_rejects_invalid_config);
+  RUN_TEST(test_pool_fills_to_capacity_and_counts_hits);
+  RUN_TEST(test_pool_refills_below_watermark);
+  RUN_TEST(test_pool_keypairs_round_trip);
+  return UNITY_END();
+}
@@ -0,0 +1,135 @@
+#include "../include/fips202.h"
+#include "../include/kem.h"
+#include "../include/kem_batch.h"
+#include "../include/kem_encq.h"
+#include "../include/params.h"
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+/*************************************************
+ * The KEM when randombytes() fails. This file defines randombytes()
+ * itself, so the linker takes it instead of the library's: calls are
+ * counted, and the one numbered fail_at (from 1) fails the way the
+ * library's do, zeroing out. Other calls return SHAKE256 of a counter.
+ *************************************************/
+
+static atomic_uint calls;
+static atomic_uint fail_at; // 0: never fail
+
+int randombytes(uint8_t *out, size_t len) {
+  unsigned int n = atomic_fetch_add(&calls, 1) + 1;
+  uint8_t in[4];
+
+  if (n == atomic_load(&fail_at)) {
+    memset(out, 0, len);
+    return -1;
+  }
+  in[0] = (uint8_t)n;
+  in[1] = (uint8_t)(n >> 8);
+  in[2] = (uint8_t)(n >> 16);
+  in[3] = (uint8_t)(n >> 24);
+  shake256(out, len, in, sizeof(in));
+  return 0;
+}
+
+static uint8_t pk[KYBER_PUBLICKEYBYTES];
+static uint8_t sk[KYBER_SECRETKEYBYTES];
+static uint8_t ct[KYBER_CIPHERTEXTBYTES];
+static uint8_t ss[KYBER_SSBYTES];
+
+static void fail_call(unsigned int n) {
+  atomic_store(&calls, 0);
+  atomic_store(&fail_at, n);
+}
+
+static int all_zero(const uint8_t *p, size_t len) {
+  size_t i;
+
+  for (i = 0; i < len; i++)
+    if (p[i] != 0)
+      return 0;
+  return 1;
+}
+
+void setUp(void) { fail_call(0); }
+void tearDown(void) {}
+
+// The seed of indcpa_keypair (call 1) or z (call 2)
+void test_keypair_fails_without_randomness(void) {
+  unsigned int n;
+
+  for (n = 1; n <= 2; n++) {
+    memset(sk, 0xA5, sizeof(sk));
+    fail_call(n);
+    TEST_ASSERT_EQUAL_INT(-1, crypto_kem_keypair(pk, sk));
+    TEST_ASSERT_TRUE(all_zero(sk, sizeof(sk)));
+  }
+
+  fail_call(0);
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair(pk, sk));
+  TEST_ASSERT_FALSE(all_zero(sk + KYBER_SECRETKEYBYTES - KYBER_SYMBYTES,
+                             KYBER_SYMBYTES));
+}
+
+void test_enc_fails_without_randomness(void) {
+  uint8_t ct0[KYBER_CIPHERTEXTBYTES], ss0[KYBER_SSBYTES];
+
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair(pk, sk));
+  memset(ct, 0x5A, sizeof(ct));
+  memset(ss, 0x5A, sizeof(ss));
+  memcpy(ct0, ct, sizeof(ct));
+  memcpy(ss0, ss, sizeof(ss));
+
+  fail_call(1);
+  TEST_ASSERT_EQUAL_INT(-1, crypto_kem_enc(ct, ss, pk));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ct0, ct, sizeof(ct));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ss0, ss, sizeof(ss));
+
+  fail_call(0);
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_enc(ct, ss, pk));
+}
+
+// One failed item fails the whole batch
+void test_batch_reports_a_failed_item(void) {
+  static uint8_t pks[4 * KYBER_PUBLICKEYBYTES];
+  static uint8_t sks[4 * KYBER_SECRETKEYBYTES];
+  static uint8_t cts[4 * KYBER_CIPHERTEXTBYTES];
+  static uint8_t sss[4 * KYBER_SSBYTES];
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_batch_init(2));
+  fail_call(5);
+  TEST_ASSERT_EQUAL_INT(-1, crypto_kem_keypair_batch(pks, sks, 4));
+  fail_call(0);
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair_batch(pks, sks, 4));
+  fail_call(3);
+  TEST_ASSERT_EQUAL_INT(-1, crypto_kem_enc_batch(cts, sss, pks, 4));
+  fail_call(0);
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_enc_batch(cts, sss, pks, 4));
+  kyber_batch_shutdown();
+}
+
+// A failed refill queues nothing
+void test_encq_does_not_queue_a_failed_pair(void) {
+  static kyber_encq_entry entries[2];
+  kyber_encq q;
+
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair(pk, sk));
+  TEST_ASSERT_EQUAL_INT(0, kyber_encq_init(&q, pk, entries, 2));
+  fail_call(1);
+  TEST_ASSERT_EQUAL_INT(-1, kyber_encq_refill_step(&q));
+  TEST_ASSERT_EQUAL_UINT(0, (unsigned int)kyber_encq_fill(&q));
+  TEST_ASSERT_EQUAL_INT(1, kyber_encq_refill_step(&q));
+  TEST_ASSERT_EQUAL_UINT(1, (unsigned int)kyber_encq_fill(&q));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_keypair_fails_without_randomness);
+  RUN_TEST(test_enc_fails_without_randomness);
+  RUN_TEST(test_batch_reports_a_failed_item);
+  RUN_TEST(test_encq_does_not_queue_a_failed_pair);
+  return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include "../include/kem.h"
+#include "../include/kem_step.h"
+#include "../include/params.h"
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+static uint8_t pk1[KYBER_PUBLICKEYBYTES], pk2[KYBER_PUBLICKEYBYTES];
+static uint8_t sk1[KYBER_SECRETKEYBYTES], sk2[KYBER_SECRETKEYBYTES];
+static uint8_t ct1[KYBER_CIPHERTEXTBYTES], ct2[KYBER_CIPHERTEXTBYTES];
+static uint8_t ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_keypair_steps_match_monolithic(void) {
+  kyber_keypair_ctx ctx;
+  int steps = 0;
+
+  randombytes_seed(7);
+  crypto_kem_keypair(pk1, sk1);
+
+  randombytes_seed(7);
+  kyber_keypair_start(&ctx, pk2, sk2);
+  while (kyber_keypair_step(&ctx) == KYBER_STEP_MORE)
+    steps++;
+  TEST_ASSERT_EQUAL_INT(0, kyber_keypair_finish(&ctx));
+
+  TEST_ASSERT_TRUE(steps > KYBER_K * KYBER_K);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(pk1, pk2, KYBER_PUBLICKEYBYTES);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(sk1, sk2, KYBER_SECRETKEYBYTES);
+}
+
+void test_enc_steps_match_monolithic(void) {
+  kyber_enc_ctx ctx;
+
+  crypto_kem_keypair(pk1, sk1);
+
+  randombytes_seed(11);
+  crypto_kem_enc(ct1, ss1, pk1);
+
+  randombytes_seed(11);
+  kyber_enc_start(&ctx, ct2, ss2, pk1);
+  while (kyber_enc_step(&ctx) == KYBER_STEP_MORE)
+    ;
+  TEST_ASSERT_EQUAL_INT(0, kyber_enc_finish(&ctx));
+
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ct1, ct2, KYBER_CIPHERTEXTBYTES);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ss1, ss2, KYBER_SSBYTES);
+}
+
+void test_dec_steps_match_monolithic(void) {
+  kyber_dec_ctx ctx;
+
+  crypto_kem_keypair(pk1, sk1);
+  crypto_kem_enc(ct1, ss1, pk1);
+
+  // Valid ciphertext, then a corrupted one (implicit rejection)
+  for (int round = 0; round < 2; round++) {
+    if (round == 1)
+      ct1[3] ^= 0x10;
+    crypto_kem_dec(ss1, ct1, sk1);
+
+    kyber_dec_start(&ctx, ss2, ct1, sk1);
+    while (kyber_dec_step(&ctx) == KYBER_STEP_MORE)
+      ;
+    kyber_dec_finish(&ctx);
+
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ss1, ss2, KYBER_SSBYTES);
+  }
+}
+
+void test_finish_completes_unstepped_operation(void) {
+  kyber_keypair_ctx kctx;
+  kyber_enc_ctx ectx;
+  kyber_dec_ctx dctx;
+
+  kyber_keypair_start(&kctx, pk2, sk2);
+  kyber_keypair_step(&kctx);
+  TEST_ASSERT_EQUAL_INT(0, kyber_keypair_finish(&kctx));
+
+  kyber_enc_start(&ectx, ct2, ss1, pk2);
+  TEST_ASSERT_EQUAL_INT(0, kyber_enc_finish(&ectx));
+
+  kyber_dec_start(&dctx, ss2, ct2, sk2);
+  TEST_ASSERT_EQUAL_INT(0, kyber_dec_finish(&dctx));
+
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ss1, ss2, KYBER_SSBYTES);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_keypair_steps_match_monolithic);
+  RUN_TEST(test_enc_steps_match_monolithic);
+  RUN_TEST(test_dec_steps_match_monolithic);
+  RUN_TEST(test_finish_completes_unstepped_operation);
+  return UNITY_END();
+}
@@ -0,0 +1,64 @@
+#include "../include/kyber_dispatch.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+static const kyber_param_id ids[] = {KYBER_PARAM_512, KYBER_PARAM_768,
+                                     KYBER_PARAM_1024};
+
+void setUp(void) {}
+void tearDown(void) {}
+
+void test_dispatch_reports_built_sets(void) {
+  int available = 0;
+
+  for (int i = 0; i < 3; i++) {
+    const kyber_kem_impl *impl = kyber_kem_get(ids[i]);
+    if (impl == NULL)
+      continue;
+    available++;
+    TEST_ASSERT_EQUAL_INT(ids[i], impl->id);
+    TEST_ASSERT_EQUAL_size_t(32, impl->ssbytes);
+    TEST_ASSERT_TRUE(impl->publickeybytes <= KYBER_MAX_PUBLICKEYBYTES);
+    TEST_ASSERT_TRUE(impl->secretkeybytes <= KYBER_MAX_SECRETKEYBYTES);
+    TEST_ASSERT_TRUE(impl->ciphertextbytes <= KYBER_MAX_CIPHERTEXTBYTES);
+  }
+
+#if defined(KYBER_MULTI_PARAMS)
+  TEST_ASSERT_EQUAL_INT(3, available);
+#else
+  TEST_ASSERT_EQUAL_INT(1, available);
+#endif
+}
+
+void test_dispatch_rejects_unknown_id(void) {
+  uint8_t pk[KYBER_MAX_PUBLICKEYBYTES], sk[KYBER_MAX_SECRETKEYBYTES];
+
+  TEST_ASSERT_NULL(kyber_kem_get((kyber_param_id)5));
+  TEST_ASSERT_EQUAL_INT(-1, kyber_kem_keypair((kyber_param_id)5, pk, sk));
+}
+
+void test_dispatch_round_trip_every_set(void) {
+  uint8_t pk[KYBER_MAX_PUBLICKEYBYTES], sk[KYBER_MAX_SECRETKEYBYTES];
+  uint8_t ct[KYBER_MAX_CIPHERTEXTBYTES];
+  uint8_t ss1[32], ss2[32];
+
+  for (int i = 0; i < 3; i++) {
+    if (kyber_kem_get(ids[i]) == NULL) {
+      TEST_ASSERT_EQUAL_INT(-1, kyber_kem_keypair(ids[i], pk, sk));
+      continue;
+    }
+    TEST_ASSERT_EQUAL_INT(0, kyber_kem_keypair(ids[i], pk, sk));
+    TEST_ASSERT_EQUAL_INT(0, kyber_kem_enc(ids[i], ct, ss1, pk));
+    kyber_kem_dec(ids[i], ss2, ct, sk);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(ss1, ss2, 32);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_dispatch_reports_built_sets);
+  RUN_TEST(test_dispatch_rejects_unknown_id);
+  RUN_TEST(test_dispatch_round_trip_every_set);
+  return UNITY_END();
+}
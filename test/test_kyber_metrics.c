@@ -0,0 +1,234 @@
+#include "../include/kem.h"
+#include "../include/kem_dec_xn.h"
+#include "../include/kem_step.h"
+#include "../include/kyber_metrics.h"
+#include "../include/params.h"
+#include "unity.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
+static uint8_t pk[KYBER_PUBLICKEYBYTES];
+static uint8_t sk[KYBER_SECRETKEYBYTES];
+static uint8_t ct[KYBER_CIPHERTEXTBYTES];
+static uint8_t ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+static char text[16384];
+
+void setUp(void) { kyber_metrics_reset(); }
+void tearDown(void) {}
+
+#if defined(KYBER_METRICS)
+
+static uint64_t hist_total(const kyber_metrics_snapshot *s, int op) {
+  uint64_t n = 0;
+  int b;
+  for (b = 0; b < KYBER_METRICS_BUCKETS; b++)
+    n += s->latency_hist[op][b];
+  return n;
+}
+
+void test_counts_ops_and_latencies(void) {
+  kyber_metrics_snapshot s;
+  int i;
+
+  crypto_kem_keypair(pk, sk);
+  for (i = 0; i < 3; i++) {
+    crypto_kem_enc(ct, ss1, pk);
+    crypto_kem_dec(ss2, ct, sk);
+  }
+  kyber_metrics_read(&s);
+
+  TEST_ASSERT_EQUAL_UINT32(KYBER_METRICS_VERSION, s.version);
+  TEST_ASSERT_EQUAL_UINT64(1, s.ops[KYBER_OP_KEYPAIR]);
+  TEST_ASSERT_EQUAL_UINT64(3, s.ops[KYBER_OP_ENC]);
+  TEST_ASSERT_EQUAL_UINT64(3, s.ops[KYBER_OP_DEC]);
+  TEST_ASSERT_EQUAL_UINT64(3, hist_total(&s, KYBER_OP_DEC));
+  TEST_ASSERT_EQUAL_UINT64(0, s.rejections);
+  if (s.unit == KYBER_METRICS_UNIT_NS)
+    TEST_ASSERT_TRUE(s.latency_sum[KYBER_OP_ENC] > 0);
+}
+
+void test_counts_implicit_rejections(void) {
+  kyber_metrics_snapshot s;
+
+  crypto_kem_keypair(pk, sk);
+  crypto_kem_enc(ct, ss1, pk);
+  ct[0] ^= 1;
+  crypto_kem_dec(ss2, ct, sk);
+  ct[0] ^= 1;
+  crypto_kem_dec(ss2, ct, sk);
+  kyber_metrics_read(&s);
+
+  TEST_ASSERT_EQUAL_UINT64(2, s.ops[KYBER_OP_DEC]);
+  TEST_ASSERT_EQUAL_UINT64(1, s.rejections);
+
+  kyber_metrics_reset();
+  kyber_metrics_read(&s);
+  TEST_ASSERT_EQUAL_UINT64(0, s.rejections);
+  TEST_ASSERT_EQUAL_UINT64(0, s.ops[KYBER_OP_DEC]);
+}
+
+// Lane 1 is corrupted; the time-sliced decapsulation is counted but
+// not timed
+void test_counts_lanes_and_steps(void) {
+  static uint8_t cts[KYBER_XN_LANES][KYBER_CIPHERTEXTBYTES];
+  static uint8_t sss[KYBER_XN_LANES][KYBER_SSBYTES];
+  kyber_metrics_snapshot s;
+  kyber_dec_ctx ctx;
+  unsigned int l;
+
+  crypto_kem_keypair(pk, sk);
+  for (l = 0; l < KYBER_XN_LANES; l++)
+    crypto_kem_enc(cts[l], sss[l], pk);
+  cts[1][0] ^= 1;
+  kyber_metrics_reset();
+
+  crypto_kem_dec_xn(sss, cts, sk);
+  kyber_metrics_read(&s);
+  TEST_ASSERT_EQUAL_UINT64(KYBER_XN_LANES, s.ops[KYBER_OP_DEC]);
+  TEST_ASSERT_EQUAL_UINT64(KYBER_XN_LANES, hist_total(&s, KYBER_OP_DEC));
+  TEST_ASSERT_EQUAL_UINT64(1, s.rejections);
+
+  kyber_dec_start(&ctx, ss2, cts[1], sk);
+  kyber_dec_finish(&ctx);
+  kyber_metrics_read(&s);
+  TEST_ASSERT_EQUAL_UINT64(KYBER_XN_LANES + 1, s.ops[KYBER_OP_DEC]);
+  TEST_ASSERT_EQUAL_UINT64(KYBER_XN_LANES, hist_total(&s, KYBER_OP_DEC));
+  TEST_ASSERT_EQUAL_UINT64(2, s.rejections);
+}
+
+#if defined(__linux__)
+#define THREADS 4
+#define OPS_PER_THREAD 8
+
+static void *worker(void *arg) {
+  uint8_t tpk[KYBER_PUBLICKEYBYTES], tsk[KYBER_SECRETKEYBYTES];
+  uint8_t tct[KYBER_CIPHERTEXTBYTES], tss[KYBER_SSBYTES];
+  int i;
+
+  (void)arg;
+  crypto_kem_keypair(tpk, tsk);
+  for (i = 0; i < OPS_PER_THREAD; i++)
+    crypto_kem_enc(tct, tss, tpk);
+  return NULL;
+}
+
+void test_shards_sum_across_threads(void) {
+  kyber_metrics_snapshot s;
+  pthread_t t[THREADS];
+  int i;
+
+  for (i = 0; i < THREADS; i++)
+    pthread_create(&t[i], NULL, worker, NULL);
+  for (i = 0; i < THREADS; i++)
+    pthread_join(t[i], NULL);
+  kyber_metrics_read(&s);
+
+  TEST_ASSERT_EQUAL_UINT64(THREADS, s.ops[KYBER_OP_KEYPAIR]);
+  TEST_ASSERT_EQUAL_UINT64(THREADS * OPS_PER_THREAD, s.ops[KYBER_OP_ENC]);
+  TEST_ASSERT_EQUAL_UINT64(THREADS * OPS_PER_THREAD,
+                           hist_total(&s, KYBER_OP_ENC));
+}
+
+// Snapshots taken while other threads update agree with themselves
+void test_read_is_consistent_under_load(void) {
+  kyber_metrics_snapshot s;
+  pthread_t t[THREADS];
+  int i, op;
+
+  for (i = 0; i < THREADS; i++)
+    pthread_create(&t[i], NULL, worker, NULL);
+  for (i = 0; i < 200; i++) {
+    kyber_metrics_read(&s);
+    for (op = 0; op < KYBER_OP_COUNT; op++)
+      TEST_ASSERT_EQUAL_UINT64(s.ops[op], hist_total(&s, op));
+  }
+  for (i = 0; i < THREADS; i++)
+    pthread_join(t[i], NULL);
+}
+#endif
+
+#else
+
+void test_disabled_metrics_read_zero(void) {
+  kyber_metrics_snapshot s;
+
+  crypto_kem_keypair(pk, sk);
+  crypto_kem_enc(ct, ss1, pk);
+  crypto_kem_dec(ss2, ct, sk);
+  TEST_ASSERT_EQUAL_MEMORY(ss1, ss2, KYBER_SSBYTES);
+  kyber_metrics_read(&s);
+  TEST_ASSERT_EQUAL_UINT64(0, s.ops[KYBER_OP_KEYPAIR]);
+  TEST_ASSERT_EQUAL_UINT64(0, s.ops[KYBER_OP_DEC]);
+  TEST_ASSERT_EQUAL_UINT32(KYBER_METRICS_VERSION, s.version);
+}
+
+#endif
+
+void test_prometheus_text(void) {
+  kyber_metrics_snapshot s;
+  size_t n, m;
+  char small[64];
+
+  memset(&s, 0, sizeof(s));
+  s.version = KYBER_METRICS_VERSION;
+  s.unit = KYBER_METRICS_UNIT_NS;
+  s.ops[KYBER_OP_ENC] = 5;
+  s.latency_hist[KYBER_OP_ENC][17] = 5; // (65.5 us, 131 us]
+  s.latency_sum[KYBER_OP_ENC] = 500000;
+  s.rejections = 2;
+
+  n = kyber_metrics_prometheus(&s, text, sizeof(text));
+  TEST_ASSERT_TRUE(n < sizeof(text));
+  TEST_ASSERT_EQUAL_size_t(strlen(text), n);
+  TEST_ASSERT_NOT_NULL(strstr(text, "kyber_ops_total{op=\"enc\"} 5\n"));
+  TEST_ASSERT_NOT_NULL(strstr(text, "kyber_implicit_rejections_total 2\n"));
+  TEST_ASSERT_NOT_NULL(strstr(text, "kyber_op_latency_seconds_bucket"
+                                    "{op=\"enc\",le=\"6.5536e-05\"} 0\n"));
+  TEST_ASSERT_NOT_NULL(strstr(text, "kyber_op_latency_seconds_bucket"
+                                    "{op=\"enc\",le=\"0.000131072\"} 5\n"));
+  TEST_ASSERT_NOT_NULL(
+      strstr(text, "kyber_op_latency_seconds_sum{op=\"enc\"} 0.0005\n"));
+
+  TEST_ASSERT_NOT_NULL(strstr(text, "kyber_op_latency_seconds_bucket"
+                                    "{op=\"enc\",le=\"+Inf\"} 5\n"));
+  TEST_ASSERT_NOT_NULL(
+      strstr(text, "kyber_op_latency_seconds_count{op=\"enc\"} 5\n"));
+
+  // +Inf and _count follow the buckets, not ops[]
+  s.ops[KYBER_OP_ENC] = 7;
+  s.latency_hist[KYBER_OP_ENC][KYBER_METRICS_BUCKETS - 1] = 1;
+  kyber_metrics_prometheus(&s, text, sizeof(text));
+  TEST_ASSERT_NOT_NULL(strstr(text, "kyber_op_latency_seconds_bucket"
+                                    "{op=\"enc\",le=\"+Inf\"} 6\n"));
+  TEST_ASSERT_NOT_NULL(
+      strstr(text, "kyber_op_latency_seconds_count{op=\"enc\"} 6\n"));
+  s.ops[KYBER_OP_ENC] = 5;
+  s.latency_hist[KYBER_OP_ENC][KYBER_METRICS_BUCKETS - 1] = 0;
+
+  // Truncated output still reports the full length
+  m = kyber_metrics_prometheus(&s, small, sizeof(small));
+  TEST_ASSERT_EQUAL_size_t(n, m);
+  TEST_ASSERT_EQUAL_size_t(sizeof(small) - 1, strlen(small));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+#if defined(KYBER_METRICS)
+  RUN_TEST(test_counts_ops_and_latencies);
+  RUN_TEST(test_counts_implicit_rejections);
+  RUN_TEST(test_counts_lanes_and_steps);
+#if defined(__linux__)
+  RUN_TEST(test_shards_sum_across_threads);
+  RUN_TEST(test_read_is_consistent_under_load);
+#endif
+#else
+  RUN_TEST(test_disabled_metrics_read_zero);
+#endif
+  RUN_TEST(test_prometheus_text);
+  return UNITY_END();
+}
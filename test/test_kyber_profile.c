@@ -0,0 +1,164 @@
+#include "../include/fips202.h"
+#include "../include/keccak_backend.h"
+#include "../include/kem.h"
+#include "../include/kyber_profile.h"
+#include "../include/params.h"
+#include "../include/platform.h"
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+static uint8_t pk[KYBER_PUBLICKEYBYTES];
+static uint8_t sk[KYBER_SECRETKEYBYTES];
+static uint8_t ct[KYBER_CIPHERTEXTBYTES];
+static uint8_t ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+
+#if defined(KYBER_KECCAK_BACKEND) && defined(__linux__)
+// Static and stopped in tearDown, so a failed assertion does not leave
+// a dead backend registered
+static kyber_keccak_offload offload;
+static int offload_running;
+#endif
+
+void setUp(void) { kyber_profile_reset(); }
+
+void tearDown(void) {
+#if defined(KYBER_KECCAK_BACKEND) && defined(__linux__)
+  if (offload_running) {
+    kyber_keccak_register(NULL);
+    kyber_keccak_offload_stop(&offload);
+    offload_running = 0;
+  }
+#endif
+}
+
+static void run_kem(void) {
+  crypto_kem_keypair(pk, sk);
+  crypto_kem_enc(ct, ss1, pk);
+  crypto_kem_dec(ss2, ct, sk);
+  TEST_ASSERT_EQUAL_MEMORY(ss1, ss2, KYBER_SSBYTES);
+}
+
+#if defined(KYBER_PROFILE)
+
+void test_counts_ops_and_phases(void) {
+  kyber_profile_stats st;
+  int op;
+
+  run_kem();
+  kyber_profile_read(&st);
+
+  for (op = 0; op < KYBER_OP_COUNT; op++)
+    TEST_ASSERT_EQUAL_UINT64(1, st.op_calls[op]);
+
+  // keypair, enc and the re-encryption in dec each expand A once
+  TEST_ASSERT_EQUAL_UINT64(3, st.calls[KYBER_PHASE_GEN_MATRIX]);
+  TEST_ASSERT_TRUE(st.calls[KYBER_PHASE_NTT] >= 3);
+  TEST_ASSERT_TRUE(st.calls[KYBER_PHASE_HASH] >= 6);
+}
+
+static void check_attribution(void) {
+  kyber_profile_stats st;
+
+  run_kem();
+  kyber_profile_read(&st);
+
+  // All Keccak work on these paths happens inside a phase
+  TEST_ASSERT_EQUAL_UINT64(0, st.keccak[KYBER_PHASE_OTHER]);
+  TEST_ASSERT_EQUAL_UINT64(0, st.keccak[KYBER_PHASE_NTT]);
+  TEST_ASSERT_EQUAL_UINT64(0, st.keccak[KYBER_PHASE_MATVEC]);
+  // At least one SHAKE128 block per matrix entry, three expansions
+  TEST_ASSERT_TRUE(st.keccak[KYBER_PHASE_GEN_MATRIX] >=
+                   3 * KYBER_K * KYBER_K);
+  TEST_ASSERT_TRUE(st.keccak[KYBER_PHASE_NOISE] >= 2 * (3 * KYBER_K + 1));
+  // H(pk) alone takes KYBER_PUBLICKEYBYTES / SHA3_256_RATE blocks
+  TEST_ASSERT_TRUE(st.keccak[KYBER_PHASE_HASH] >=
+                   KYBER_PUBLICKEYBYTES / SHA3_256_RATE);
+}
+
+void test_every_permutation_is_attributed(void) { check_attribution(); }
+
+#if defined(KYBER_KECCAK_BACKEND) && defined(__linux__)
+// Permutations run on the accelerator's worker thread still count on
+// the thread that hashed
+void test_offloaded_permutations_count_here(void) {
+  kyber_profile_stats st;
+  uint8_t out[2 * SHAKE128_RATE];
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_offload_start(&offload, 0, 2));
+  offload_running = 1;
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_register(&offload.backend));
+
+  // One permutation per squeezed block, outside any phase
+  shake128(out, sizeof(out), (const uint8_t *)"abc", 3);
+  kyber_profile_read(&st);
+  TEST_ASSERT_EQUAL_UINT64(2, st.keccak[KYBER_PHASE_OTHER]);
+
+  kyber_profile_reset();
+  check_attribution();
+  TEST_ASSERT_TRUE(offload.completed > 2);
+}
+#endif
+
+void test_cycles_and_reset(void) {
+  kyber_profile_stats st;
+  uint64_t phases = 0;
+  int i;
+
+  run_kem();
+  kyber_profile_read(&st);
+
+#if KYBER_HAS_CYCLE_COUNTER
+  for (i = 0; i < KYBER_PHASE_COUNT; i++)
+    phases += st.cycles[i];
+  TEST_ASSERT_TRUE(st.cycles[KYBER_PHASE_GEN_MATRIX] > 0);
+  TEST_ASSERT_TRUE(phases <= st.op_cycles[KYBER_OP_KEYPAIR] +
+                                 st.op_cycles[KYBER_OP_ENC] +
+                                 st.op_cycles[KYBER_OP_DEC]);
+#else
+  (void)phases;
+  (void)i;
+#endif
+
+  kyber_profile_reset();
+  kyber_profile_read(&st);
+  TEST_ASSERT_EQUAL_UINT64(0, st.op_calls[KYBER_OP_ENC]);
+  TEST_ASSERT_EQUAL_UINT64(0, st.keccak[KYBER_PHASE_HASH]);
+}
+
+#else
+
+void test_disabled_profiler_reads_zero(void) {
+  kyber_profile_stats st, zero;
+
+  run_kem();
+  kyber_profile_read(&st);
+  memset(&zero, 0, sizeof(zero));
+  TEST_ASSERT_EQUAL_MEMORY(&zero, &st, sizeof(st));
+}
+
+#endif
+
+void test_phase_names(void) {
+  TEST_ASSERT_EQUAL_STRING("gen_matrix",
+                           kyber_profile_phase_name(KYBER_PHASE_GEN_MATRIX));
+  TEST_ASSERT_EQUAL_STRING("hash", kyber_profile_phase_name(KYBER_PHASE_HASH));
+  TEST_ASSERT_EQUAL_STRING("?", kyber_profile_phase_name(KYBER_PHASE_COUNT));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+#if defined(KYBER_PROFILE)
+  RUN_TEST(test_counts_ops_and_phases);
+  RUN_TEST(test_every_permutation_is_attributed);
+#if defined(KYBER_KECCAK_BACKEND) && defined(__linux__)
+  RUN_TEST(test_offloaded_permutations_count_here);
+#endif
+  RUN_TEST(test_cycles_and_reset);
+#else
+  RUN_TEST(test_disabled_profiler_reads_zero);
+#endif
+  RUN_TEST(test_phase_names);
+  return UNITY_END();
+}
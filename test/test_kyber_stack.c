@@ -0,0 +1,87 @@
+#include "../include/kem.h"
+#include "../include/kyber_stack.h"
+#include "../include/params.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+static uint8_t pk[KYBER_PUBLICKEYBYTES];
+static uint8_t sk[KYBER_SECRETKEYBYTES];
+static uint8_t ct[KYBER_CIPHERTEXTBYTES];
+static uint8_t ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Painting below the stack pointer is not for ASan builds
+#if defined(__SANITIZE_ADDRESS__)
+#define NOT_UNDER_ASAN() TEST_IGNORE_MESSAGE("not for ASan builds")
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define NOT_UNDER_ASAN() TEST_IGNORE_MESSAGE("not for ASan builds")
+#endif
+#endif
+#ifndef NOT_UNDER_ASAN
+#define NOT_UNDER_ASAN() ((void)0)
+#endif
+
+#define LOCAL_BYTES 4096
+
+static void touch_local(void *arg) {
+  volatile uint8_t local[LOCAL_BYTES];
+  size_t i;
+
+  (void)arg;
+  for (i = 0; i < LOCAL_BYTES; i++)
+    local[i] = (uint8_t)i;
+  (void)local[0];
+}
+
+static void run_nothing(void *arg) { (void)arg; }
+
+static void run_dec(void *arg) {
+  (void)arg;
+  crypto_kem_dec(ss2, ct, sk);
+}
+
+void test_measures_local_array(void) {
+  kyber_stack_usage u;
+
+  NOT_UNDER_ASAN();
+  TEST_ASSERT_EQUAL_INT(0, kyber_stack_measure(&u, touch_local, NULL));
+  TEST_ASSERT_EQUAL_INT(0, u.saturated);
+  TEST_ASSERT_TRUE(u.stack_bytes >= LOCAL_BYTES);
+  TEST_ASSERT_TRUE(u.stack_bytes < LOCAL_BYTES + 1024);
+  TEST_ASSERT_TRUE(u.stack_lines >= LOCAL_BYTES / KYBER_STACK_LINE_BYTES);
+}
+
+void test_empty_call_is_small(void) {
+  kyber_stack_usage u;
+
+  NOT_UNDER_ASAN();
+  kyber_stack_measure(&u, run_nothing, NULL);
+  TEST_ASSERT_TRUE(u.stack_bytes < 256);
+}
+
+void test_measures_decapsulation(void) {
+  kyber_stack_usage u;
+
+  NOT_UNDER_ASAN();
+  crypto_kem_keypair(pk, sk);
+  crypto_kem_enc(ct, ss1, pk);
+  TEST_ASSERT_EQUAL_INT(0, kyber_stack_measure(&u, run_dec, NULL));
+  TEST_ASSERT_EQUAL_MEMORY(ss1, ss2, KYBER_SSBYTES);
+
+  // dec holds at least the re-encryption matrix on the stack
+  TEST_ASSERT_TRUE(u.stack_bytes > KYBER_K * KYBER_K * KYBER_POLYBYTES);
+  TEST_ASSERT_TRUE(u.stack_lines * KYBER_STACK_LINE_BYTES <=
+                   u.stack_bytes + 2 * KYBER_STACK_LINE_BYTES);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_measures_local_array);
+  RUN_TEST(test_empty_call_is_small);
+  RUN_TEST(test_measures_decapsulation);
+  return UNITY_END();
+}
@@ -0,0 +1,176 @@
+#include "../include/keccak_backend.h"
+#include "../include/kem.h"
+#include "../include/kyber_tune.h"
+#include "../include/platform.h"
+#include "unity.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/*************************************************
+ * Selection, override and the saved blob. Build with -DKYBER_AUTOTUNE
+ * (and -DKYBER_KECCAK_BACKEND) to run the KEM on the selection too.
+ *************************************************/
+
+static kyber_tune_config initial;
+
+void setUp(void) { kyber_tune_current(&initial); }
+void tearDown(void) {
+  kyber_tune_apply(&initial);
+  kyber_keccak_register(NULL);
+}
+
+static unsigned int count_candidates(kyber_kernel k) {
+  unsigned int n = 0;
+
+  while (kyber_tune_candidate(k, n) != NULL)
+    n++;
+  return n;
+}
+
+static void kem_roundtrip(void) {
+  uint8_t pk[KYBER_PUBLICKEYBYTES], sk[KYBER_SECRETKEYBYTES];
+  uint8_t ct[KYBER_CIPHERTEXTBYTES], ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair(pk, sk));
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_enc(ct, ss1, pk));
+  TEST_ASSERT_EQUAL_INT(0, crypto_kem_dec(ss2, ct, sk));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(ss1, ss2, KYBER_SSBYTES);
+}
+
+// Until anything is selected the compile-time backend is in use
+void test_defaults_follow_build(void) {
+  unsigned int k;
+
+  for (k = 0; k < KYBER_KERNEL_KECCAK; k++) {
+    TEST_ASSERT_EQUAL_STRING("ref", kyber_tune_candidate((kyber_kernel)k, 0));
+    TEST_ASSERT_EQUAL_STRING(KYBER_BACKEND_NAME,
+                             kyber_tune_selected((kyber_kernel)k));
+  }
+  TEST_ASSERT_NOT_NULL(kyber_tune_selected(KYBER_KERNEL_KECCAK));
+  TEST_ASSERT_NULL(kyber_tune_selected(KYBER_KERNEL_COUNT));
+}
+
+void test_override(void) {
+  unsigned int k, i;
+  const char *name;
+
+  TEST_ASSERT_EQUAL_INT(-1, kyber_tune_override(KYBER_KERNEL_NTT, "avx9"));
+  TEST_ASSERT_EQUAL_INT(-1, kyber_tune_override(KYBER_KERNEL_COUNT, "ref"));
+#if !defined(KYBER_AUTOTUNE)
+  // The roundtrips below would not run the overridden kernels
+  TEST_IGNORE_MESSAGE("poly.c is not routed through kyber_tuned");
+#endif
+
+  // Every combination is valid, so walk each kernel through its list
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++) {
+    for (i = 0; (name = kyber_tune_candidate((kyber_kernel)k, i)); i++) {
+      TEST_ASSERT_EQUAL_INT(0, kyber_tune_override((kyber_kernel)k, name));
+      TEST_ASSERT_EQUAL_STRING(name, kyber_tune_selected((kyber_kernel)k));
+      kem_roundtrip();
+    }
+  }
+}
+
+void test_run_selects_a_candidate(void) {
+  kyber_tune_config cfg;
+  unsigned int k;
+
+  if (kyber_tune_run(&cfg) != 0)
+    TEST_IGNORE_MESSAGE("no timer on this platform");
+
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++) {
+    TEST_ASSERT_TRUE(cfg.choice[k] < count_candidates((kyber_kernel)k));
+    TEST_ASSERT_EQUAL_STRING(kyber_tune_candidate((kyber_kernel)k,
+                                                  cfg.choice[k]),
+                             kyber_tune_selected((kyber_kernel)k));
+  }
+  kem_roundtrip();
+}
+
+#if defined(KYBER_KECCAK_BACKEND)
+// An application backend is neither timed nor replaced
+void test_application_backend_is_kept(void) {
+  kyber_keccak_backend accel = kyber_keccak_software;
+  kyber_tune_config cfg;
+
+  accel.name = "accel";
+  TEST_ASSERT_EQUAL_INT(0, kyber_keccak_register(&accel));
+  kyber_tune_current(&cfg);
+  TEST_ASSERT_EQUAL_HEX8(KYBER_TUNE_KEEP, cfg.choice[KYBER_KERNEL_KECCAK]);
+  TEST_ASSERT_EQUAL_STRING("accel", kyber_tune_selected(KYBER_KERNEL_KECCAK));
+
+  kyber_tune_run(NULL);
+  TEST_ASSERT_EQUAL_INT(-1, kyber_tune_override(KYBER_KERNEL_KECCAK, "ref"));
+  TEST_ASSERT_EQUAL_PTR(&accel, kyber_keccak_backend_get());
+}
+#endif
+
+void test_blob_roundtrip_and_rejects(void) {
+  uint8_t blob[KYBER_TUNE_BLOBBYTES], bad[KYBER_TUNE_BLOBBYTES];
+  kyber_tune_config cfg, out;
+  unsigned int k, i, n;
+
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++)
+    cfg.choice[k] = (uint8_t)(count_candidates((kyber_kernel)k) - 1);
+  kyber_tune_save(blob, &cfg);
+  TEST_ASSERT_EQUAL_INT(0, kyber_tune_load(&out, blob));
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(cfg.choice, out.choice, KYBER_KERNEL_COUNT);
+
+  TEST_ASSERT_EQUAL_INT(0, kyber_tune_apply(&out));
+  for (k = 0; k < KYBER_KERNEL_COUNT; k++)
+    TEST_ASSERT_EQUAL_STRING(
+        kyber_tune_candidate((kyber_kernel)k, cfg.choice[k]),
+        kyber_tune_selected((kyber_kernel)k));
+
+  // Erased flash, and every single-bit flip
+  memset(bad, 0xFF, sizeof(bad));
+  TEST_ASSERT_EQUAL_INT(-1, kyber_tune_load(&out, bad));
+  for (i = 0; i < 8 * KYBER_TUNE_BLOBBYTES; i++) {
+    memcpy(bad, blob, sizeof(bad));
+    bad[i / 8] ^= (uint8_t)(1 << (i % 8));
+    TEST_ASSERT_EQUAL_INT(-1, kyber_tune_load(&out, bad));
+  }
+
+  // Out-of-range choices are refused by apply as well
+  n = count_candidates(KYBER_KERNEL_NTT);
+  cfg.choice[KYBER_KERNEL_NTT] = (uint8_t)n;
+  TEST_ASSERT_EQUAL_INT(-1, kyber_tune_apply(&cfg));
+}
+
+#if defined(KYBER_PLATFORM_DESKTOP)
+void test_init_measures_once(void) {
+  const char *path = "test_kyber_tune.bin";
+  kyber_tune_config first, second;
+  int r;
+
+  remove(path);
+  r = kyber_tune_init(path);
+  if (r == -1)
+    TEST_IGNORE_MESSAGE("no timer on this platform");
+  TEST_ASSERT_EQUAL_INT(0, r);
+  kyber_tune_current(&first);
+
+  kyber_tune_apply(&initial);
+  TEST_ASSERT_EQUAL_INT(1, kyber_tune_init(path));
+  kyber_tune_current(&second);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(first.choice, second.choice,
+                               KYBER_KERNEL_COUNT);
+  remove(path);
+}
+#endif
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_defaults_follow_build);
+  RUN_TEST(test_override);
+  RUN_TEST(test_run_selects_a_candidate);
+#if defined(KYBER_KECCAK_BACKEND)
+  RUN_TEST(test_application_backend_is_kept);
+#endif
+  RUN_TEST(test_blob_roundtrip_and_rejects);
+#if defined(KYBER_PLATFORM_DESKTOP)
+  RUN_TEST(test_init_measures_once);
+#endif
+  return UNITY_END();
+}
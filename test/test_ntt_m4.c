@@ -0,0 +1,140 @@
+#include "../include/kem.h"
+#include "../include/ntt.h"
+#include "../include/ntt_m4.h"
+#include "../include/params.h"
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+#define TRIALS 200
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#if defined(KYBER_HAVE_M4)
+
+static void random_coeffs(int16_t r[256], int16_t bound) {
+  uint16_t t[256];
+  unsigned int i;
+
+  randombytes((uint8_t *)t, sizeof(t));
+  for (i = 0; i < 256; i++)
+    r[i] = (int16_t)(t[i] % (2 * bound + 1)) - bound;
+}
+
+void test_ntt_matches_scalar(void) {
+  int16_t a[256], b[256];
+  unsigned int n, i;
+
+  for (n = 0; n < TRIALS; n++) {
+    random_coeffs(a, KYBER_Q - 1);
+    memcpy(b, a, sizeof(a));
+    ntt(a);
+    ntt_m4(b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(a, b, 256);
+
+    for (i = 0; i < 256; i++)
+      a[i] = barrett_reduce(a[i]);
+    reduce_m4(b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(a, b, 256);
+  }
+}
+
+void test_invntt_matches_scalar(void) {
+  int16_t a[256], b[256];
+  unsigned int n;
+
+  for (n = 0; n < TRIALS; n++) {
+    random_coeffs(a, INT16_MAX);
+    memcpy(b, a, sizeof(a));
+    invntt(a);
+    invntt_m4(b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(a, b, 256);
+  }
+}
+
+void test_basemul_matches_scalar(void) {
+  int16_t a[256], b[256], r[256], s[256];
+  unsigned int n, i;
+
+  for (n = 0; n < TRIALS; n++) {
+    random_coeffs(a, INT16_MAX);
+    random_coeffs(b, INT16_MAX);
+    for (i = 0; i < 64; i++) {
+      basemul(&r[4 * i], &a[4 * i], &b[4 * i], zetas[64 + i]);
+      basemul(&r[4 * i + 2], &a[4 * i + 2], &b[4 * i + 2], -zetas[64 + i]);
+    }
+    basemul_m4(s, a, b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(r, s, 256);
+  }
+}
+
+void test_reduce_all_inputs(void) {
+  int16_t a[256], b[256];
+  int32_t x = INT16_MIN;
+  unsigned int i;
+
+  while (x <= INT16_MAX) {
+    for (i = 0; i < 256; i++, x++)
+      a[i] = (int16_t)(x <= INT16_MAX ? x : 0);
+    for (i = 0; i < 256; i++)
+      b[i] = barrett_reduce(a[i]);
+    reduce_m4(a);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(b, a, 256);
+  }
+}
+
+// r[] only needs 2-byte alignment: the word loads and stores must
+// cope with a polynomial that starts halfway into a word
+void test_unaligned_buffers(void) {
+  int16_t a[256], b[256 + 1], c[256 + 1], r[256], s[256 + 1];
+  unsigned int i;
+
+  random_coeffs(a, KYBER_Q - 1);
+  random_coeffs(c + 1, INT16_MAX);
+  memcpy(b + 1, a, sizeof(a));
+  ntt(a);
+  ntt_m4(b + 1);
+  TEST_ASSERT_EQUAL_INT16_ARRAY(a, b + 1, 256);
+
+  for (i = 0; i < 64; i++) {
+    basemul(&r[4 * i], &a[4 * i], &c[4 * i + 1], zetas[64 + i]);
+    basemul(&r[4 * i + 2], &a[4 * i + 2], &c[4 * i + 3], -zetas[64 + i]);
+  }
+  basemul_m4(s + 1, b + 1, c + 1);
+  TEST_ASSERT_EQUAL_INT16_ARRAY(r, s + 1, 256);
+
+  invntt(r);
+  invntt_m4(s + 1);
+  TEST_ASSERT_EQUAL_INT16_ARRAY(r, s + 1, 256);
+}
+
+#endif
+
+void test_kem_roundtrip(void) {
+  uint8_t pk[KYBER_PUBLICKEYBYTES], sk[KYBER_SECRETKEYBYTES];
+  uint8_t ct[KYBER_CIPHERTEXTBYTES];
+  uint8_t ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+  int n;
+
+  for (n = 0; n < 10; n++) {
+    TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair(pk, sk));
+    TEST_ASSERT_EQUAL_INT(0, crypto_kem_enc(ct, ss1, pk));
+    TEST_ASSERT_EQUAL_INT(0, crypto_kem_dec(ss2, ct, sk));
+    TEST_ASSERT_EQUAL_MEMORY(ss1, ss2, KYBER_SSBYTES);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+#if defined(KYBER_HAVE_M4)
+  RUN_TEST(test_ntt_matches_scalar);
+  RUN_TEST(test_invntt_matches_scalar);
+  RUN_TEST(test_basemul_matches_scalar);
+  RUN_TEST(test_reduce_all_inputs);
+  RUN_TEST(test_unaligned_buffers);
+#endif
+  RUN_TEST(test_kem_roundtrip);
+  return UNITY_END();
+}
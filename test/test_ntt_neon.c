@@ -0,0 +1,237 @@
+#include "../include/fips202.h"
+#include "../include/fips202x2_neon.h"
+#include "../include/kem.h"
+#include "../include/ntt.h"
+#include "../include/ntt_neon.h"
+#include "../include/params.h"
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+#define TRIALS 200
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#if defined(KYBER_HAVE_NEON)
+
+static void random_coeffs(int16_t r[256], int16_t bound) {
+  uint16_t t[256];
+  unsigned int i;
+
+  randombytes((uint8_t *)t, sizeof(t));
+  for (i = 0; i < 256; i++)
+    r[i] = (int16_t)(t[i] % (2 * bound + 1)) - bound;
+}
+
+void test_ntt_matches_scalar(void) {
+  int16_t a[256], b[256];
+  unsigned int n, i;
+
+  for (n = 0; n < TRIALS; n++) {
+    random_coeffs(a, KYBER_Q - 1);
+    memcpy(b, a, sizeof(a));
+    ntt(a);
+    ntt_neon(b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(a, b, 256);
+
+    for (i = 0; i < 256; i++)
+      a[i] = barrett_reduce(a[i]);
+    reduce_neon(b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(a, b, 256);
+  }
+}
+
+void test_invntt_matches_scalar(void) {
+  int16_t a[256], b[256];
+  unsigned int n;
+
+  for (n = 0; n < TRIALS; n++) {
+    random_coeffs(a, INT16_MAX);
+    memcpy(b, a, sizeof(a));
+    invntt(a);
+    invntt_neon(b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(a, b, 256);
+  }
+}
+
+void test_basemul_matches_scalar(void) {
+  int16_t a[256], b[256], r[256], s[256];
+  unsigned int n, i;
+
+  for (n = 0; n < TRIALS; n++) {
+    random_coeffs(a, INT16_MAX);
+    random_coeffs(b, INT16_MAX);
+    for (i = 0; i < 64; i++) {
+      basemul(&r[4 * i], &a[4 * i], &b[4 * i], zetas[64 + i]);
+      basemul(&r[4 * i + 2], &a[4 * i + 2], &b[4 * i + 2], -zetas[64 + i]);
+    }
+    basemul_neon(s, a, b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(r, s, 256);
+  }
+}
+
+void test_reduce_all_inputs(void) {
+  int16_t a[256], b[256];
+  int32_t x = INT16_MIN;
+  unsigned int i;
+
+  while (x <= INT16_MAX) {
+    for (i = 0; i < 256; i++, x++)
+      a[i] = (int16_t)(x <= INT16_MAX ? x : 0);
+    for (i = 0; i < 256; i++)
+      b[i] = barrett_reduce(a[i]);
+    reduce_neon(a);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(b, a, 256);
+  }
+}
+
+void test_cbd_matches_scalar(void) {
+  uint8_t buf[3 * KYBER_N / 4];
+  int16_t r[256], s[256];
+  uint32_t t, d;
+  unsigned int n, i, j;
+
+  for (n = 0; n < TRIALS; n++) {
+    randombytes(buf, sizeof(buf));
+
+    for (i = 0; i < KYBER_N / 8; i++) {
+      memcpy(&t, buf + 4 * i, 4);
+      d = (t & 0x55555555) + ((t >> 1) & 0x55555555);
+      for (j = 0; j < 8; j++)
+        r[8 * i + j] =
+            (int16_t)((d >> (4 * j)) & 3) - (int16_t)((d >> (4 * j + 2)) & 3);
+    }
+    cbd2_neon(s, buf);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(r, s, 256);
+
+    for (i = 0; i < KYBER_N / 4; i++) {
+      t = buf[3 * i] | (uint32_t)buf[3 * i + 1] << 8 |
+          (uint32_t)buf[3 * i + 2] << 16;
+      d = (t & 0x249249) + ((t >> 1) & 0x249249) + ((t >> 2) & 0x249249);
+      for (j = 0; j < 4; j++)
+        r[4 * i + j] =
+            (int16_t)((d >> (6 * j)) & 7) - (int16_t)((d >> (6 * j + 3)) & 7);
+    }
+    cbd3_neon(s, buf);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(r, s, 256);
+  }
+}
+
+void test_compress_all_inputs(void) {
+  int16_t a[256];
+  uint8_t r[160], s[160];
+  uint32_t u;
+  int x = -(KYBER_Q - 1), d;
+  unsigned int i, j;
+
+  while (x < KYBER_Q) {
+    for (i = 0; i < 256; i++, x++)
+      a[i] = (int16_t)(x < KYBER_Q ? x : 0);
+
+    for (d = 4; d <= 5; d++) {
+      memset(r, 0, sizeof(r));
+      for (i = 0; i < 256; i++) {
+        u = (uint32_t)(a[i] + ((a[i] >> 15) & KYBER_Q));
+        u = (((u << d) + KYBER_Q / 2) / KYBER_Q) & ((1u << d) - 1);
+        for (j = 0; j < (unsigned int)d; j++)
+          r[(i * d + j) / 8] |= (uint8_t)(((u >> j) & 1) << ((i * d + j) % 8));
+      }
+      compress_neon(s, a, d);
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(r, s, 32 * d);
+    }
+  }
+}
+
+static unsigned int rej_uniform_ref(int16_t *r, unsigned int len,
+                                    const uint8_t *buf, unsigned int buflen) {
+  unsigned int ctr = 0, pos = 0;
+  uint16_t val0, val1;
+
+  while (ctr < len && pos + 3 <= buflen) {
+    val0 = (buf[pos] | (uint16_t)buf[pos + 1] << 8) & 0xFFF;
+    val1 = (buf[pos + 1] >> 4 | (uint16_t)buf[pos + 2] << 4) & 0xFFF;
+    pos += 3;
+    if (val0 < KYBER_Q)
+      r[ctr++] = (int16_t)val0;
+    if (ctr < len && val1 < KYBER_Q)
+      r[ctr++] = (int16_t)val1;
+  }
+  return ctr;
+}
+
+// Every length limit and buffer length around the vector/tail switch
+void test_rej_uniform_matches_scalar(void) {
+  uint8_t buf[3 * 168 + 2];
+  int16_t r[KYBER_N + 8], s[KYBER_N + 8];
+  unsigned int n, len, buflen, cr, cs;
+
+  for (n = 0; n < 20; n++) {
+    randombytes(buf, sizeof(buf));
+    // Many rejections: values 0xFFF and above q
+    if (n % 2)
+      memset(buf + 24, 0xFF, 60);
+    for (len = 0; len <= KYBER_N; len += (len < 16 || len > 240) ? 1 : 13) {
+      for (buflen = 0; buflen <= sizeof(buf); buflen += 7) {
+        memset(r, 0x55, sizeof(r));
+        memset(s, 0x55, sizeof(s));
+        cr = rej_uniform_ref(r, len, buf, buflen);
+        cs = rej_uniform_neon(s, len, buf, buflen);
+        TEST_ASSERT_EQUAL_UINT(cr, cs);
+        TEST_ASSERT_EQUAL_INT16_ARRAY(r, s, cr ? cr : 1);
+        // Nothing written past len
+        TEST_ASSERT_EQUAL_INT16(0x5555, s[len]);
+      }
+    }
+  }
+}
+
+void test_shake128x2_matches_shake128(void) {
+  uint8_t in[2][400], out[2][3 * 168 + 2], ref[3 * 168 + 2];
+  size_t inlen, outlen, l;
+
+  randombytes(in[0], sizeof(in[0]));
+  randombytes(in[1], sizeof(in[1]));
+  for (inlen = 0; inlen <= sizeof(in[0]); inlen += 33) {
+    for (outlen = 1; outlen <= sizeof(ref); outlen += 84) {
+      shake128x2(out[0], out[1], outlen, in[0], in[1], inlen);
+      for (l = 0; l < 2; l++) {
+        shake128(ref, outlen, in[l], inlen);
+        TEST_ASSERT_EQUAL_MEMORY(ref, out[l], outlen);
+      }
+    }
+  }
+}
+
+#endif
+
+void test_kem_roundtrip(void) {
+  uint8_t pk[KYBER_PUBLICKEYBYTES], sk[KYBER_SECRETKEYBYTES];
+  uint8_t ct[KYBER_CIPHERTEXTBYTES];
+  uint8_t ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+  int n;
+
+  for (n = 0; n < 10; n++) {
+    TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair(pk, sk));
+    TEST_ASSERT_EQUAL_INT(0, crypto_kem_enc(ct, ss1, pk));
+    TEST_ASSERT_EQUAL_INT(0, crypto_kem_dec(ss2, ct, sk));
+    TEST_ASSERT_EQUAL_MEMORY(ss1, ss2, KYBER_SSBYTES);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+#if defined(KYBER_HAVE_NEON)
+  RUN_TEST(test_ntt_matches_scalar);
+  RUN_TEST(test_invntt_matches_scalar);
+  RUN_TEST(test_basemul_matches_scalar);
+  RUN_TEST(test_reduce_all_inputs);
+  RUN_TEST(test_cbd_matches_scalar);
+  RUN_TEST(test_compress_all_inputs);
+  RUN_TEST(test_rej_uniform_matches_scalar);
+  RUN_TEST(test_shake128x2_matches_shake128);
+#endif
+  RUN_TEST(test_kem_roundtrip);
+  return UNITY_END();
+}
@@ -0,0 +1,174 @@
+#include "../include/kem.h"
+#include "../include/ntt.h"
+#include "../include/ntt_vec.h"
+#include "../include/params.h"
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+#define TRIALS 200
+
+void setUp(void) {}
+void tearDown(void) {}
+
+#if defined(KYBER_HAVE_VEC)
+
+static void random_coeffs(int16_t r[256], int16_t bound) {
+  uint16_t t[256];
+  unsigned int i;
+
+  randombytes((uint8_t *)t, sizeof(t));
+  for (i = 0; i < 256; i++)
+    r[i] = (int16_t)(t[i] % (2 * bound + 1)) - bound;
+}
+
+void test_ntt_matches_scalar(void) {
+  int16_t a[256], b[256];
+  unsigned int n, i;
+
+  for (n = 0; n < TRIALS; n++) {
+    random_coeffs(a, KYBER_Q - 1);
+    memcpy(b, a, sizeof(a));
+    ntt(a);
+    ntt_vec(b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(a, b, 256);
+
+    for (i = 0; i < 256; i++)
+      a[i] = barrett_reduce(a[i]);
+    reduce_vec(b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(a, b, 256);
+  }
+}
+
+void test_invntt_matches_scalar(void) {
+  int16_t a[256], b[256];
+  unsigned int n;
+
+  for (n = 0; n < TRIALS; n++) {
+    random_coeffs(a, INT16_MAX);
+    memcpy(b, a, sizeof(a));
+    invntt(a);
+    invntt_vec(b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(a, b, 256);
+  }
+}
+
+void test_basemul_matches_scalar(void) {
+  int16_t a[256], b[256], r[256], s[256];
+  unsigned int n, i;
+
+  for (n = 0; n < TRIALS; n++) {
+    random_coeffs(a, KYBER_Q - 1);
+    random_coeffs(b, KYBER_Q - 1);
+    for (i = 0; i < 64; i++) {
+      basemul(&r[4 * i], &a[4 * i], &b[4 * i], zetas[64 + i]);
+      basemul(&r[4 * i + 2], &a[4 * i + 2], &b[4 * i + 2], -zetas[64 + i]);
+    }
+    basemul_vec(s, a, b);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(r, s, 256);
+  }
+}
+
+void test_reduce_all_inputs(void) {
+  int16_t a[256], b[256];
+  int32_t x = INT16_MIN;
+  unsigned int i;
+
+  while (x <= INT16_MAX) {
+    for (i = 0; i < 256; i++, x++)
+      a[i] = (int16_t)(x <= INT16_MAX ? x : 0);
+    for (i = 0; i < 256; i++)
+      b[i] = barrett_reduce(a[i]);
+    reduce_vec(a);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(b, a, 256);
+  }
+}
+
+void test_cbd_matches_scalar(void) {
+  uint8_t buf[3 * KYBER_N / 4];
+  int16_t r[256], s[256];
+  uint32_t t, d;
+  unsigned int n, i, j;
+
+  for (n = 0; n < TRIALS; n++) {
+    randombytes(buf, sizeof(buf));
+
+    for (i = 0; i < KYBER_N / 8; i++) {
+      memcpy(&t, buf + 4 * i, 4);
+      d = (t & 0x55555555) + ((t >> 1) & 0x55555555);
+      for (j = 0; j < 8; j++)
+        r[8 * i + j] =
+            (int16_t)((d >> (4 * j)) & 3) - (int16_t)((d >> (4 * j + 2)) & 3);
+    }
+    cbd2_vec(s, buf);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(r, s, 256);
+
+    for (i = 0; i < KYBER_N / 4; i++) {
+      t = buf[3 * i] | (uint32_t)buf[3 * i + 1] << 8 |
+          (uint32_t)buf[3 * i + 2] << 16;
+      d = (t & 0x249249) + ((t >> 1) & 0x249249) + ((t >> 2) & 0x249249);
+      for (j = 0; j < 4; j++)
+        r[4 * i + j] =
+            (int16_t)((d >> (6 * j)) & 7) - (int16_t)((d >> (6 * j + 3)) & 7);
+    }
+    cbd3_vec(s, buf);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(r, s, 256);
+  }
+}
+
+// Every coefficient in (-q, q), the range poly_compress() accepts
+void test_compress_all_inputs(void) {
+  int16_t a[256];
+  uint8_t r[160], s[160];
+  uint32_t u;
+  int x = -(KYBER_Q - 1), d;
+  unsigned int i, j;
+
+  while (x < KYBER_Q) {
+    for (i = 0; i < 256; i++, x++)
+      a[i] = (int16_t)(x < KYBER_Q ? x : 0);
+
+    for (d = 4; d <= 5; d++) {
+      memset(r, 0, sizeof(r));
+      for (i = 0; i < 256; i++) {
+        u = (uint32_t)(a[i] + ((a[i] >> 15) & KYBER_Q));
+        u = (((u << d) + KYBER_Q / 2) / KYBER_Q) & ((1u << d) - 1);
+        for (j = 0; j < (unsigned int)d; j++)
+          r[(i * d + j) / 8] |= (uint8_t)(((u >> j) & 1) << ((i * d + j) % 8));
+      }
+      compress_vec(s, a, d);
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(r, s, 32 * d);
+    }
+  }
+}
+
+#endif
+
+void test_kem_roundtrip(void) {
+  uint8_t pk[KYBER_PUBLICKEYBYTES], sk[KYBER_SECRETKEYBYTES];
+  uint8_t ct[KYBER_CIPHERTEXTBYTES];
+  uint8_t ss1[KYBER_SSBYTES], ss2[KYBER_SSBYTES];
+  int n;
+
+  for (n = 0; n < 10; n++) {
+    TEST_ASSERT_EQUAL_INT(0, crypto_kem_keypair(pk, sk));
+    TEST_ASSERT_EQUAL_INT(0, crypto_kem_enc(ct, ss1, pk));
+    TEST_ASSERT_EQUAL_INT(0, crypto_kem_dec(ss2, ct, sk));
+    TEST_ASSERT_EQUAL_MEMORY(ss1, ss2, KYBER_SSBYTES);
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+#if defined(KYBER_HAVE_VEC)
+  RUN_TEST(test_ntt_matches_scalar);
+  RUN_TEST(test_invntt_matches_scalar);
+  RUN_TEST(test_basemul_matches_scalar);
+  RUN_TEST(test_reduce_all_inputs);
+  RUN_TEST(test_cbd_matches_scalar);
+  RUN_TEST(test_compress_all_inputs);
+#endif
+  RUN_TEST(test_kem_roundtrip);
+  return UNITY_END();
+}
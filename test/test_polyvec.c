@@ -0,0 +1,99 @@
+#include "../include/params.h"
+#include "../include/polyvec.h"
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <stdint.h>
+#include <string.h>
+
+/*************************************************
+ * Ciphertext vector compression, for the KYBER_DU of the build. Run
+ * with -DKYBER_K=4 for the 11-bit path.
+ *************************************************/
+
+#define TRIALS 100
+
+void setUp(void) {}
+void tearDown(void) {}
+
+// Largest rounding error of compress/decompress: ceil(q / 2^(du+1))
+#define DU_ERROR ((KYBER_Q + (1 << (KYBER_DU + 1)) - 1) >> (KYBER_DU + 1))
+
+static void random_polyvec(polyvec *a) {
+  uint16_t t[KYBER_N];
+  unsigned int i, j;
+
+  for (i = 0; i < KYBER_K; i++) {
+    randombytes((uint8_t *)t, sizeof(t));
+    for (j = 0; j < KYBER_N; j++)
+      a->vec[i].coeffs[j] = (int16_t)(t[j] % KYBER_Q);
+  }
+}
+
+void test_compress_roundtrip_within_bound(void) {
+  polyvec a, b;
+  uint8_t buf[KYBER_POLYVECCOMPRESSEDBYTES];
+  unsigned int n, i, j;
+  int d;
+
+  for (n = 0; n < TRIALS; n++) {
+    random_polyvec(&a);
+    polyvec_compress(buf, &a);
+    polyvec_decompress(&b, buf);
+
+    for (i = 0; i < KYBER_K; i++) {
+      for (j = 0; j < KYBER_N; j++) {
+        d = b.vec[i].coeffs[j] - a.vec[i].coeffs[j];
+        if (d < 0)
+          d = -d;
+        if (d > KYBER_Q / 2)
+          d = KYBER_Q - d; // Distance mod q
+        TEST_ASSERT_TRUE(d <= DU_ERROR);
+      }
+    }
+  }
+}
+
+// Negative representatives compress like their value plus q
+void test_compress_accepts_negative_coeffs(void) {
+  polyvec a, b;
+  uint8_t x[KYBER_POLYVECCOMPRESSEDBYTES], y[KYBER_POLYVECCOMPRESSEDBYTES];
+  unsigned int i, j;
+
+  random_polyvec(&a);
+  b = a;
+  for (i = 0; i < KYBER_K; i++)
+    for (j = 0; j < KYBER_N; j += 2)
+      b.vec[i].coeffs[j] = (int16_t)(b.vec[i].coeffs[j] - KYBER_Q);
+
+  polyvec_compress(x, &a);
+  polyvec_compress(y, &b);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(x, y, sizeof(x));
+}
+
+// Output is exactly KYBER_POLYVECCOMPRESSEDBYTES
+void test_compress_writes_exact_length(void) {
+  polyvec a;
+  uint8_t buf[KYBER_POLYVECCOMPRESSEDBYTES + 16];
+  uint8_t guard[16];
+  unsigned int i;
+
+  random_polyvec(&a);
+  memset(buf, 0xA5, sizeof(buf));
+  memset(guard, 0xA5, sizeof(guard));
+  polyvec_compress(buf, &a);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(guard, buf + KYBER_POLYVECCOMPRESSEDBYTES,
+                               sizeof(guard));
+
+  for (i = 0; i < KYBER_POLYVECCOMPRESSEDBYTES; i++)
+    if (buf[i] != 0xA5)
+      return;
+  TEST_FAIL_MESSAGE("nothing written");
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_compress_roundtrip_within_bound);
+  RUN_TEST(test_compress_accepts_negative_coeffs);
+  RUN_TEST(test_compress_writes_exact_length);
+  return UNITY_END();
+}
@@ -0,0 +1,94 @@
+#include "../include/randombytes.h"
+#include "unity.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#define OUTBYTES 64
+
+void setUp(void) {}
+void tearDown(void) {}
+
+static void *draw_thread(void *arg) {
+  randombytes((uint8_t *)arg, OUTBYTES);
+  return NULL;
+}
+
+// Runs in its own thread so the main thread keeps its OS-seeded stream
+static void *seeded_thread(void *arg) {
+  uint8_t(*out)[OUTBYTES] = arg;
+
+  randombytes_seed(1);
+  randombytes(out[0], OUTBYTES);
+  randombytes_seed(1);
+  randombytes(out[1], OUTBYTES);
+  randombytes_seed(2);
+  randombytes(out[2], OUTBYTES);
+  return NULL;
+}
+
+void test_randombytes_seed_is_deterministic(void) {
+  uint8_t out[3][OUTBYTES];
+  pthread_t t;
+
+  TEST_ASSERT_EQUAL_INT(0, pthread_create(&t, NULL, seeded_thread, out));
+  pthread_join(t, NULL);
+
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(out[0], out[1], OUTBYTES);
+  TEST_ASSERT_TRUE(memcmp(out[0], out[2], OUTBYTES) != 0);
+}
+
+// The per-thread DRBG and its fork handling are Linux-only
+#if defined(__linux__)
+void test_threads_get_independent_streams(void) {
+  uint8_t a[OUTBYTES], b[OUTBYTES];
+  pthread_t t1, t2;
+
+  pthread_create(&t1, NULL, draw_thread, a);
+  pthread_create(&t2, NULL, draw_thread, b);
+  pthread_join(t1, NULL);
+  pthread_join(t2, NULL);
+
+  TEST_ASSERT_TRUE(memcmp(a, b, OUTBYTES) != 0);
+}
+
+void test_fork_child_reseeds(void) {
+  uint8_t parent[OUTBYTES], child[OUTBYTES];
+  int fds[2];
+  pid_t pid;
+
+  // Leave buffered output behind that both processes would inherit
+  TEST_ASSERT_EQUAL_INT(0, randombytes(parent, 1));
+  TEST_ASSERT_EQUAL_INT(0, pipe(fds));
+
+  pid = fork();
+  TEST_ASSERT_TRUE(pid >= 0);
+  if (pid == 0) {
+    randombytes(child, OUTBYTES);
+    _exit(write(fds[1], child, OUTBYTES) == OUTBYTES ? 0 : 1);
+  }
+
+  randombytes(parent, OUTBYTES);
+  TEST_ASSERT_EQUAL_INT(OUTBYTES, read(fds[0], child, OUTBYTES));
+  waitpid(pid, NULL, 0);
+  close(fds[0]);
+  close(fds[1]);
+
+  TEST_ASSERT_TRUE(memcmp(parent, child, OUTBYTES) != 0);
+}
+#endif
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_randombytes_seed_is_deterministic);
+#if defined(__linux__)
+  RUN_TEST(test_threads_get_independent_streams);
+  RUN_TEST(test_fork_child_reseeds);
+#endif
+  return UNITY_END();
+}